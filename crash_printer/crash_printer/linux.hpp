@@ -6,10 +6,15 @@
 
 namespace crash_printer {
 
+// an empty 'log_file' writes nothing, only the on_crash callback is called
 bool init(const std::string &log_file);
 
 void deinit();
 
+// called first when a crash is caught, before anything is written to the log file, from inside the signal handler
+// used to save what would be lost with the process, like buffered debug log lines
+void set_on_crash(void (*callback)());
+
 }
 
 #endif // _CRASH_PRINTER_LINUX
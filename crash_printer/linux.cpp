@@ -25,6 +25,8 @@ static struct sigaction oldact_SIGBUS{};
 
 static std::string logs_filepath{};
 
+static void (*on_crash)() = nullptr;
+
 static void restore_handlers()
 {
     if (old_SIGILL) {
@@ -46,7 +48,11 @@ static void restore_handlers()
 
 static void exception_handler(int signal, siginfo_t *info, void *context, struct sigaction *oldact)
 {
-    if (!common_helpers::create_dir(logs_filepath)) {
+    if (on_crash) {
+        on_crash();
+    }
+
+    if (logs_filepath.empty() || !common_helpers::create_dir(logs_filepath)) {
         return;
     }
     
@@ -163,3 +169,8 @@ void crash_printer::deinit()
 {
     restore_handlers();
 }
+
+void crash_printer::set_on_crash(void (*callback)())
+{
+    on_crash = callback;
+}
@@ -16,6 +16,8 @@ static LPTOP_LEVEL_EXCEPTION_FILTER originalExceptionFilter = nullptr;
 
 static std::string logs_filepath{};
 
+static void (*on_crash)() = nullptr;
+
 static void print_stacktrace(std::ofstream &file, CONTEXT* context) {
     auto this_proc = GetCurrentProcess();
     auto this_thread = GetCurrentThread();
@@ -100,7 +102,7 @@ static void print_stacktrace(std::ofstream &file, CONTEXT* context) {
 
 static void log_exception(LPEXCEPTION_POINTERS ex_pointers)
 {
-    if (!common_helpers::create_dir(logs_filepath)) {
+    if (logs_filepath.empty() || !common_helpers::create_dir(logs_filepath)) {
         return;
     }
     
@@ -123,6 +125,10 @@ static void log_exception(LPEXCEPTION_POINTERS ex_pointers)
 
 static LONG WINAPI exception_handler(LPEXCEPTION_POINTERS ex_pointers)
 {
+    if (on_crash) {
+        on_crash();
+    }
+
     log_exception(ex_pointers);
 
     if (originalExceptionFilter) {
@@ -146,3 +152,8 @@ void crash_printer::deinit()
         SetUnhandledExceptionFilter(originalExceptionFilter);
     }
 }
+
+void crash_printer::set_on_crash(void (*callback)())
+{
+    on_crash = callback;
+}
@@ -260,7 +260,7 @@ Steam_AppTicket::Steam_AppTicket(class Settings *settings) :
 uint32 Steam_AppTicket::GetAppOwnershipTicketData( uint32 nAppID, void *pvBuffer, uint32 cbBufferLength, uint32 *piAppId, uint32 *piSteamId, uint32 *piSignature, uint32 *pcbSignature )
 {
     PRINT_DEBUG("TODO %u, %p, %u, %p, %p, %p, %p", nAppID, pvBuffer, cbBufferLength, piAppId, piSteamId, piSignature, pcbSignature);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return 0;
 }
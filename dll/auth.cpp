@@ -11,6 +11,17 @@
 //Steam returns 234
 #define STEAM_AUTH_TICKET_SIZE 256 //234
 
+// signatures made between two reseeds of the ticket signer's random generator
+#define TICKET_SIGNER_RESEED_INTERVAL 1000
+
+// where AppTicket::Serialize() writes TicketGeneratedDate and TicketGeneratedExpireDate,
+// after Version, steam id, AppId, ExternalIP, InternalIP and AlwaysZero
+#define APP_TICKET_GENERATED_DATE_OFFSET (4 + 8 + 4 + 4 + 4 + 4)
+#define APP_TICKET_EXPIRE_DATE_OFFSET (APP_TICKET_GENERATED_DATE_OFFSET + 4)
+
+// ended inbound users whose allocations are kept for reuse
+#define MAX_FREE_INBOUND_USERS 128
+
 
 static inline int generate_random_int() {
     int a;
@@ -57,123 +68,107 @@ const static std::string app_ticket_key =
     "-----END PRIVATE KEY-----\n";
 
 
-static std::vector<uint8_t> sign_auth_data(const std::string &private_key_content, const std::vector<uint8_t> &data, size_t effective_data_len)
+static void print_mbedtls_error(const char *what, int result)
 {
-    std::vector<uint8_t> signature{};
-
-    // Hash the data using SHA-1
-    constexpr static int SHA1_DIGEST_LENGTH = 20;
-    uint8_t hash[SHA1_DIGEST_LENGTH]{};
-    int result = mbedtls_sha1(data.data(), effective_data_len, hash);
-    if (result != 0) {
 #ifndef EMU_RELEASE_BUILD
-        // we nedd a live object until the printf does its job, hence this special handling
-        std::string err_msg(256, 0);
-        mbedtls_strerror(result, &err_msg[0], err_msg.size());
-        PRINT_DEBUG("failed to hash the data via SHA1: %s", err_msg.c_str());
+    // we nedd a live object until the printf does its job, hence this special handling
+    std::string err_msg(256, 0);
+    mbedtls_strerror(result, &err_msg[0], err_msg.size());
+    PRINT_DEBUG("%s: %s", what, err_msg.c_str());
 #endif
+}
 
-        return signature;
-    }
-
-    mbedtls_entropy_context entropy_ctx; // entropy context for random number generation
+Ticket_Signer::Ticket_Signer()
+{
     mbedtls_entropy_init(&entropy_ctx);
-
-    mbedtls_ctr_drbg_context ctr_drbg_ctx; // CTR-DRBG context for deterministic random number generation
     mbedtls_ctr_drbg_init(&ctr_drbg_ctx);
+    mbedtls_pk_init(&private_key_ctx);
+}
 
-    // seed the CTR-DRBG context with random numbers
-    result = mbedtls_ctr_drbg_seed(&ctr_drbg_ctx, mbedtls_entropy_func, &entropy_ctx, nullptr, 0);
-    if (mbedtls_ctr_drbg_seed(&ctr_drbg_ctx, mbedtls_entropy_func, &entropy_ctx, nullptr, 0) != 0) {
-        mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
-        mbedtls_entropy_free(&entropy_ctx);
+Ticket_Signer &Ticket_Signer::instance()
+{
+    // never freed, a ticket may still be signed by another thread while the process exits
+    static Ticket_Signer *signer = new Ticket_Signer();
+    return *signer;
+}
 
-#ifndef EMU_RELEASE_BUILD
-        // we nedd a live object until the printf does its job, hence this special handling
-        std::string err_msg(256, 0);
-        mbedtls_strerror(result, &err_msg[0], err_msg.size());
-        PRINT_DEBUG("failed to seed the CTR-DRBG context: %s", err_msg.c_str());
-#endif
+bool Ticket_Signer::setup()
+{
+    if (ready) return true;
+
+    // seed the CTR-DRBG context with random numbers,
+    // it reseeds itself from the entropy source every TICKET_SIGNER_RESEED_INTERVAL requests, always under our lock
+    int result = 0;
+    if (!seeded) {
+        result = mbedtls_ctr_drbg_seed(&ctr_drbg_ctx, mbedtls_entropy_func, &entropy_ctx, nullptr, 0);
+        if (result != 0) {
+            print_mbedtls_error("failed to seed the CTR-DRBG context", result);
+            return false;
+        }
 
-        return signature;
+        mbedtls_ctr_drbg_set_reseed_interval(&ctr_drbg_ctx, TICKET_SIGNER_RESEED_INTERVAL);
+        seeded = true;
     }
 
-    mbedtls_pk_context private_key_ctx; // holds the parsed private key
-    mbedtls_pk_init(&private_key_ctx);
-
     result = mbedtls_pk_parse_key(
         &private_key_ctx,                                      // will hold the parsed private key
-        (const unsigned char *)private_key_content.c_str(),
-        private_key_content.size() + 1,                        // we MUST include the null terminator, otherwise this API returns an error!
+        (const unsigned char *)app_ticket_key.c_str(),
+        app_ticket_key.size() + 1,                             // we MUST include the null terminator, otherwise this API returns an error!
         nullptr, 0,                                            // no password stuff, private key isn't protected
         mbedtls_ctr_drbg_random, &ctr_drbg_ctx                 // random number generation function + the CTR-DRBG context it requires as an input
     );
 
     if (result != 0) {
         mbedtls_pk_free(&private_key_ctx);
-        mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
-        mbedtls_entropy_free(&entropy_ctx);
-
-#ifndef EMU_RELEASE_BUILD
-        // we nedd a live object until the printf does its job, hence this special handling
-        std::string err_msg(256, 0);
-        mbedtls_strerror(result, &err_msg[0], err_msg.size());
-        PRINT_DEBUG("failed to parse private key: %s", err_msg.c_str());
-#endif
-
-        return signature;
+        mbedtls_pk_init(&private_key_ctx);
+        print_mbedtls_error("failed to parse private key", result);
+        return false;
     }
 
     // private key must be valid RSA key
     if (mbedtls_pk_get_type(&private_key_ctx) != MBEDTLS_PK_RSA ||  // invalid type
-        mbedtls_pk_can_do(&private_key_ctx, MBEDTLS_PK_RSA) == 0) { // or initialized but not properly setup (maybe freed?)
+        mbedtls_pk_can_do(&private_key_ctx, MBEDTLS_PK_RSA) == 0 || // or initialized but not properly setup (maybe freed?)
+        mbedtls_pk_get_len(&private_key_ctx) == 0) {                 // TODO must be 128 siglen
         mbedtls_pk_free(&private_key_ctx);
-        mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
-        mbedtls_entropy_free(&entropy_ctx);
-
+        mbedtls_pk_init(&private_key_ctx);
         PRINT_DEBUG("parsed key is not a valid RSA private key");
-        return signature;
+        return false;
     }
 
-    // get the underlying RSA context from the parsed private key
-    mbedtls_rsa_context* rsa_ctx = mbedtls_pk_rsa(private_key_ctx);
+    PRINT_DEBUG("computed private key (final buffer) length = %zu", mbedtls_pk_get_len(&private_key_ctx));
+    ready = true;
+    return true;
+}
 
-    // resize the output buffer to accomodate the size of the private key
-    const size_t private_key_len = mbedtls_pk_get_len(&private_key_ctx);
-    if (private_key_len == 0) { // TODO must be 128 siglen
-        mbedtls_pk_free(&private_key_ctx);
-        mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
-        mbedtls_entropy_free(&entropy_ctx);
+std::vector<uint8_t> Ticket_Signer::sign_locked(const uint8_t *data, size_t data_len)
+{
+    std::vector<uint8_t> signature{};
+    if (!setup()) return signature;
 
-        PRINT_DEBUG("failed to get private key (final buffer) length");
+    // Hash the data using SHA-1
+    constexpr static int SHA1_DIGEST_LENGTH = 20;
+    uint8_t hash[SHA1_DIGEST_LENGTH]{};
+    int result = mbedtls_sha1(data, data_len, hash);
+    if (result != 0) {
+        print_mbedtls_error("failed to hash the data via SHA1", result);
         return signature;
     }
 
-    PRINT_DEBUG("computed private key (final buffer) length = %zu", private_key_len);
-    signature.resize(private_key_len);
+    // resize the output buffer to accomodate the size of the private key
+    signature.resize(mbedtls_pk_get_len(&private_key_ctx));
 
     // finally sign the computed hash using RSA and PKCS#1 padding
     result = mbedtls_rsa_pkcs1_sign(
-        rsa_ctx,
+        mbedtls_pk_rsa(private_key_ctx),
         mbedtls_ctr_drbg_random, &ctr_drbg_ctx,
         MBEDTLS_MD_SHA1, // we used SHA1 to hash the data
         sizeof(hash), hash,
         signature.data() // output
     );
 
-    mbedtls_pk_free(&private_key_ctx);
-    mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
-    mbedtls_entropy_free(&entropy_ctx);
-
     if (result != 0) {
         signature.clear();
-
-#ifndef EMU_RELEASE_BUILD
-        // we nedd a live object until the printf does its job, hence this special handling
-        std::string err_msg(256, 0);
-        mbedtls_strerror(result, &err_msg[0], err_msg.size());
-        PRINT_DEBUG("RSA signing failed: %s", err_msg.c_str());
-#endif
+        print_mbedtls_error("RSA signing failed", result);
     }
 
 #ifndef EMU_RELEASE_BUILD
@@ -185,6 +180,24 @@ static std::vector<uint8_t> sign_auth_data(const std::string &private_key_conten
     return signature;
 }
 
+std::vector<uint8_t> Ticket_Signer::sign(const uint8_t *data, size_t data_len)
+{
+    std::lock_guard lock(mutex);
+    return sign_locked(data, data_len);
+}
+
+std::vector<std::vector<uint8_t>> Ticket_Signer::sign_batch(const std::vector<std::pair<const uint8_t *, size_t>> &items)
+{
+    std::vector<std::vector<uint8_t>> signatures{};
+    signatures.reserve(items.size());
+
+    std::lock_guard lock(mutex);
+    for (const auto &item : items) {
+        signatures.push_back(sign_locked(item.first, item.second));
+    }
+
+    return signatures;
+}
 
 
 
@@ -448,6 +461,11 @@ pBuffer += sizeof(v)
 }
 
 std::vector<uint8_t> Auth_Data::Serialize() const
+{
+    return Serialize(Ticket.Serialize());
+}
+
+std::vector<uint8_t> Auth_Data::Serialize(const std::vector<uint8_t> &tickedData) const
 {
     /*
         * layout of Auth_Data with GC:
@@ -501,7 +519,6 @@ std::vector<uint8_t> Auth_Data::Serialize() const
         * 
         * total layout length = 4 + Y
         */
-    std::vector<uint8_t> tickedData = Ticket.Serialize();
     // we need this variable because we depend on the sizeof, must be 4 bytes
     const uint32_t ticket_data_layout_length =
         sizeof(uint32_t) + // size of this uint32_t because it is included!
@@ -574,7 +591,8 @@ pBuffer += sizeof(v)
 #endif
 
     //Todo make a signature
-    std::vector<uint8_t> signature = sign_auth_data(app_ticket_key, tickedData, total_size_without_siglen);
+    // only the ticket data layout is signed, not the GC data in front of it
+    std::vector<uint8_t> signature = Ticket_Signer::instance().sign(buffer.data() + gc_data_layout_length, ticket_data_layout_length);
     if (signature.size() == STEAM_APPTICKET_SIGLEN) {
         memcpy(buffer.data() + total_size_without_siglen, signature.data(), signature.size());
 
@@ -622,6 +640,35 @@ Auth_Manager::~Auth_Manager()
 }
 
 
+void Auth_Manager::add_inbound(CSteamID id, uint64_t number, std::chrono::high_resolution_clock::time_point created)
+{
+    const uint64 key = id.ConvertToUint64();
+    auto user = inbound.find(key);
+    if (inbound.end() == user) {
+        if (free_inbound.size()) {
+            auto node = std::move(free_inbound.back());
+            free_inbound.pop_back();
+            node.key() = key;
+            user = inbound.insert(std::move(node)).position;
+        } else {
+            user = inbound.emplace(key, std::vector<struct Inbound_Auth_Session>()).first;
+        }
+    }
+
+    user->second.push_back(Inbound_Auth_Session{ number, created });
+    ++inbound_count;
+}
+
+void Auth_Manager::remove_inbound_user(Inbound_Auth_Map::iterator user)
+{
+    inbound_count -= static_cast<uint32>(user->second.size());
+    auto node = inbound.extract(user);
+    if (free_inbound.size() < MAX_FREE_INBOUND_USERS) {
+        node.mapped().clear();
+        free_inbound.push_back(std::move(node));
+    }
+}
+
 void Auth_Manager::launch_callback(CSteamID id, EAuthSessionResponse resp, double delay)
 {
     ValidateAuthTicketResponse_t data{};
@@ -645,6 +692,54 @@ void Auth_Manager::launch_callback_gs(CSteamID id, bool approved)
     }
 }
 
+const std::vector<uint8_t> &Auth_Manager::get_ticket_template(CSteamID steam_id, uint32 appid)
+{
+#define IP4_AS_DWORD_LITTLE_ENDIAN(a,b,c,d) (((uint32_t)d)<<24 | ((uint32_t)c)<<16 | ((uint32_t)b)<<8 | (uint32_t)a)
+
+    const uint32 dlcs_version = settings->getDLCsVersion();
+    if (ticket_template.size() &&
+        ticket_template_steam_id == steam_id.ConvertToUint64() &&
+        ticket_template_appid == appid &&
+        ticket_template_dlcs_version == dlcs_version) {
+        return ticket_template;
+    }
+
+    AppTicket ticket{};
+    ticket.Version = 4;
+    ticket.id = steam_id;
+    ticket.AppId = appid;
+    ticket.ExternalIP = IP4_AS_DWORD_LITTLE_ENDIAN(127, 0, 0, 1); //TODO
+    ticket.InternalIP = IP4_AS_DWORD_LITTLE_ENDIAN(127, 0, 0, 1);
+    ticket.AlwaysZero = 0;
+    // dates are written by the caller for each ticket
+    ticket.TicketGeneratedDate = 0;
+    ticket.TicketGeneratedExpireDate = 0;
+    ticket.Licenses.push_back(0); //TODO
+    unsigned int dlcCount = settings->DLCCount();
+    ticket.DLCs.reserve(dlcCount);
+    for (unsigned i = 0; i < dlcCount; ++i)
+    {
+        DLC dlc;
+        AppId_t dlc_appid;
+        bool available;
+        std::string name;
+        if (!settings->getDLC(i, dlc_appid, available, name)) break;
+        dlc.AppId = (uint32_t)dlc_appid;
+        dlc.Licenses.resize(0); //TODO
+        ticket.DLCs.push_back(dlc);
+    }
+
+    ticket_template = ticket.Serialize();
+    ticket_template_steam_id = steam_id.ConvertToUint64();
+    ticket_template_appid = appid;
+    ticket_template_dlcs_version = dlcs_version;
+    PRINT_DEBUG("rebuilt ticket template for app %u with %u DLCs [%zu bytes]", appid, dlcCount, ticket_template.size());
+
+#undef IP4_AS_DWORD_LITTLE_ENDIAN
+
+    return ticket_template;
+}
+
 Auth_Data Auth_Manager::getTicketData( void *pTicket, int cbMaxTicket, uint32 *pcbTicket )
 {
 
@@ -667,21 +762,10 @@ Auth_Data Auth_Manager::getTicketData( void *pTicket, int cbMaxTicket, uint32 *p
         ticket_data.Ticket.TicketGeneratedDate = (uint32_t)GenDate.count();
         uint32_t expTime = (uint32_t)(GenDate + std::chrono::hours(24)).count();
         ticket_data.Ticket.TicketGeneratedExpireDate = expTime;
-        ticket_data.Ticket.Licenses.resize(0);
-        ticket_data.Ticket.Licenses.push_back(0); //TODO
-        unsigned int dlcCount = settings->DLCCount();
-        ticket_data.Ticket.DLCs.resize(0);  //currently set to 0
-        for (unsigned i = 0; i < dlcCount; ++i)
-        {
-            DLC dlc;
-            AppId_t appid;
-            bool available;
-            std::string name;
-            if (!settings->getDLC(i, appid, available, name)) break;
-            dlc.AppId = (uint32_t)appid;
-            dlc.Licenses.resize(0); //TODO
-            ticket_data.Ticket.DLCs.push_back(dlc);
-        }
+        // licenses and DLCs are only in the template
+        std::vector<uint8_t> ticket_blob = get_ticket_template(steam_id, ticket_data.Ticket.AppId);
+        memcpy(&ticket_blob[APP_TICKET_GENERATED_DATE_OFFSET], &ticket_data.Ticket.TicketGeneratedDate, sizeof(ticket_data.Ticket.TicketGeneratedDate));
+        memcpy(&ticket_blob[APP_TICKET_EXPIRE_DATE_OFFSET], &ticket_data.Ticket.TicketGeneratedExpireDate, sizeof(ticket_data.Ticket.TicketGeneratedExpireDate));
         ticket_data.HasGC = false;
         if (settings->use_gc_token)
         {
@@ -694,7 +778,7 @@ Auth_Data Auth_Manager::getTicketData( void *pTicket, int cbMaxTicket, uint32 *p
             ticket_data.GC.TimeSinceStartup = (uint32_t)std::chrono::duration_cast<std::chrono::seconds>(curTime - startup_time).count();
             ticket_data.GC.TicketGeneratedCount = get_ticket_count();
         }
-        std::vector<uint8_t> ser = ticket_data.Serialize();
+        std::vector<uint8_t> ser = ticket_data.Serialize(ticket_blob);
         uint32_t ser_size = static_cast<uint32_t>(ser.size());
         *pcbTicket = ser_size;
         if (cbMaxTicket > 0 && static_cast<uint32_t>(cbMaxTicket) >= ser_size) {
@@ -746,7 +830,7 @@ HAuthTicket Auth_Manager::getTicket( void *pTicket, int cbMaxTicket, uint32 *pcb
     data.m_eResult = EResult::k_EResultOK;
     
     callbacks->addCBResult(data.k_iCallback, &data, sizeof(data), STEAM_TICKET_PROCESS_TIME);
-    outbound.push_back(ticket_data);
+    outbound.insert(ticket_data.number);
 
     return data.m_hAuthTicket;
 }
@@ -766,23 +850,21 @@ HAuthTicket Auth_Manager::getWebApiTicket( const char* pchIdentity )
     data.m_hAuthTicket = (HAuthTicket)ticket_data.number;
     data.m_eResult = EResult::k_EResultOK;
     callbacks->addCBResult(data.k_iCallback, &data, sizeof(data), STEAM_TICKET_PROCESS_TIME);
-    outbound.push_back(ticket_data);
+    outbound.insert(ticket_data.number);
 
     return data.m_hAuthTicket;
 }
 
 CSteamID Auth_Manager::fakeUser()
 {
-    Auth_Data data = {};
-    data.id = generate_steam_anon_user();
-    inbound.push_back(data);
-    return data.id;
+    CSteamID id = generate_steam_anon_user();
+    add_inbound(id, 0, {});
+    return id;
 }
 
 void Auth_Manager::cancelTicket(uint32 number)
 {
-    auto ticket = std::find_if(outbound.begin(), outbound.end(), [&number](Auth_Data const& item) { return item.number == number; });
-    if (outbound.end() == ticket)
+    if (!outbound.erase(number))
         return;
 
     Auth_Ticket *auth_ticket = new Auth_Ticket();
@@ -792,8 +874,6 @@ void Auth_Manager::cancelTicket(uint32 number)
     msg.set_source_id(settings->get_local_steam_id().ConvertToUint64());
     msg.set_allocated_auth_ticket(auth_ticket);
     network->sendToAll(&msg, true);
-
-    outbound.erase(ticket);
 }
 
 bool Auth_Manager::SendUserConnectAndAuthenticate( uint32 unIPClient, const void *pvAuthBlob, uint32 cubAuthBlobSize, CSteamID *pSteamIDUser )
@@ -809,15 +889,13 @@ bool Auth_Manager::SendUserConnectAndAuthenticate( uint32 unIPClient, const void
     data.number = number;
     if (pSteamIDUser) *pSteamIDUser = data.id;
 
-    for (auto & t : inbound) {
-        if (t.id == data.id) {
-            //Should this return false?
-            launch_callback_gs(id, true);
-            return true;
-        }
+    if (inbound.count(id)) {
+        //Should this return false?
+        launch_callback_gs(id, true);
+        return true;
     }
 
-    inbound.push_back(data);
+    add_inbound(data.id, data.number, data.created);
     launch_callback_gs(id, true);
     return true;
 }
@@ -835,36 +913,32 @@ EBeginAuthSessionResult Auth_Manager::beginAuth(const void *pAuthTicket, int cbA
     data.number = number;
     data.created = std::chrono::high_resolution_clock::now();
 
-    for (auto & t : inbound) {
-        if (t.id == data.id && !check_timedout(t.created, STEAM_TICKET_PROCESS_TIME)) {
-            return k_EBeginAuthSessionResultDuplicateRequest;
+    auto user = inbound.find(id);
+    if (inbound.end() != user) {
+        for (auto & t : user->second) {
+            if (!check_timedout(t.created, STEAM_TICKET_PROCESS_TIME, data.created)) {
+                return k_EBeginAuthSessionResultDuplicateRequest;
+            }
         }
     }
 
-    inbound.push_back(data);
+    add_inbound(data.id, data.number, data.created);
     launch_callback(steamID, k_EAuthSessionResponseOK, STEAM_TICKET_PROCESS_TIME);
     return k_EBeginAuthSessionResultOK;
 }
 
 uint32 Auth_Manager::countInboundAuth()
 {
-    return static_cast<uint32>(inbound.size());
+    return inbound_count;
 }
 
 bool Auth_Manager::endAuth(CSteamID id)
 {
-    bool erased = false;
-    auto t = std::begin(inbound);
-    while (t != std::end(inbound)) {
-        if (t->id == id) {
-            erased = true;
-            t = inbound.erase(t);
-        } else {
-            ++t;
-        }
-    }
+    auto user = inbound.find(id.ConvertToUint64());
+    if (inbound.end() == user) return false;
 
-    return erased;
+    remove_inbound_user(user);
+    return true;
 }
 
 
@@ -878,14 +952,13 @@ void Auth_Manager::Callback(Common_Message *msg)
 
         if (msg->low_level().type() == Low_Level::DISCONNECT) {
             PRINT_DEBUG("TICKET DISCONNECT");
-            auto t = std::begin(inbound);
-            while (t != std::end(inbound)) {
-                if (t->id.ConvertToUint64() == msg->source_id()) {
-                    launch_callback(t->id, k_EAuthSessionResponseUserNotConnectedToSteam);
-                    t = inbound.erase(t);
-                } else {
-                    ++t;
+            auto user = inbound.find(msg->source_id());
+            if (inbound.end() != user) {
+                for (size_t i = 0; i < user->second.size(); ++i) {
+                    launch_callback(CSteamID((uint64)msg->source_id()), k_EAuthSessionResponseUserNotConnectedToSteam);
                 }
+
+                remove_inbound_user(user);
             }
         }
     }
@@ -894,15 +967,22 @@ void Auth_Manager::Callback(Common_Message *msg)
         if (msg->auth_ticket().type() == Auth_Ticket::CANCEL) {
             PRINT_DEBUG("TICKET CANCEL " "%" PRIu64, msg->source_id());
             uint32 number = msg->auth_ticket().number();
-            auto t = std::begin(inbound);
-            while (t != std::end(inbound)) {
-                if (t->id.ConvertToUint64() == msg->source_id() && t->number == number) {
-                    PRINT_DEBUG("TICKET CANCELED");
-                    launch_callback(t->id, k_EAuthSessionResponseAuthTicketCanceled);
-                    t = inbound.erase(t);
-                } else {
-                    ++t;
+            auto user = inbound.find(msg->source_id());
+            if (inbound.end() != user) {
+                auto &sessions = user->second;
+                auto t = std::begin(sessions);
+                while (t != std::end(sessions)) {
+                    if (t->number == number) {
+                        PRINT_DEBUG("TICKET CANCELED");
+                        launch_callback(CSteamID((uint64)msg->source_id()), k_EAuthSessionResponseAuthTicketCanceled);
+                        t = sessions.erase(t);
+                        --inbound_count;
+                    } else {
+                        ++t;
+                    }
                 }
+
+                if (sessions.empty()) remove_inbound_user(user);
             }
         }
     }
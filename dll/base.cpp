@@ -17,20 +17,26 @@
 
 #include "dll/base.h"
 #include "dll/settings_parser.h"
+#include "dll/metrics.h"
 
 #ifndef EMU_RELEASE_BUILD
 #include "dbg_log/dbg_log.hpp"
 #endif
 
 
-std::recursive_mutex global_mutex{};
+Emu_Mutex global_mutex("global_mutex");
 // some arbitrary counter/time for reference
 const std::chrono::time_point<std::chrono::high_resolution_clock> startup_counter = std::chrono::high_resolution_clock::now();
 const std::chrono::time_point<std::chrono::system_clock> startup_time = std::chrono::system_clock::now();
 
 #ifndef EMU_RELEASE_BUILD
+#if defined(EMU_BINARY_TRACE)
+// decode it with tool_trace_decoder
+dbg_log dbg_logger(get_full_program_path() + "STEAM_LOG.bin", true);
+#else
 dbg_log dbg_logger(get_full_program_path() + "STEAM_LOG.txt");
 #endif
+#endif
 
 
 #ifdef __WINDOWS__
@@ -126,7 +132,7 @@ CSteamID generate_steam_anon_user()
 
 SteamAPICall_t generate_steam_api_call_id() {
     static SteamAPICall_t a;
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     randombytes((char *)&a, sizeof(a));
     ++a;
@@ -154,11 +160,163 @@ CSteamID generate_steam_id_lobby()
     return CSteamID(generate_account_id(), k_EChatInstanceFlagLobby | k_EChatInstanceFlagMMSLobby, k_EUniversePublic, k_EAccountTypeChat);
 }
 
+struct Lock_Contention_Site {
+    const char *lock_name{};
+    const char *function{};
+    uint64 waits{};
+    std::chrono::high_resolution_clock::duration total{};
+    std::chrono::high_resolution_clock::duration longest{};
+};
+
+// how many call sites report_lock_contention() prints
+#define LOCK_CONTENTION_REPORT_MAX 32
+
+static std::atomic<bool> lock_contention_enabled{};
+
+#ifndef EMU_RELEASE_BUILD
+struct Lock_Contention_Profile {
+    std::mutex mutex{};
+    // keyed by file and line of the call site, the file pointer is a string literal so comparing it is enough
+    std::map<std::pair<const char *, int>, struct Lock_Contention_Site> sites{};
+};
+
+static Lock_Contention_Profile *get_lock_contention_profile()
+{
+    // never freed, locks are still taken while the static destructors run
+    static Lock_Contention_Profile *profile = new Lock_Contention_Profile();
+    return profile;
+}
+
+static void record_lock_contention(const char *lock_name, const char *file, int line, const char *function, std::chrono::high_resolution_clock::duration waited)
+{
+    auto profile = get_lock_contention_profile();
+    std::lock_guard<std::mutex> lock(profile->mutex);
+    auto &site = profile->sites[std::make_pair(file ? file : "", line)];
+    site.lock_name = lock_name;
+    site.function = function ? function : "";
+    site.waits += 1;
+    site.total += waited;
+    site.longest = std::max(site.longest, waited);
+}
+#endif
+
+void set_lock_contention_profiling(bool enable)
+{
+    lock_contention_enabled = enable;
+}
+
+bool lock_contention_profiling()
+{
+    return lock_contention_enabled;
+}
+
+void report_lock_contention()
+{
+#ifndef EMU_RELEASE_BUILD
+    if (!lock_contention_enabled) return;
+
+    std::vector<std::pair<std::pair<const char *, int>, struct Lock_Contention_Site>> sites{};
+    {
+        auto profile = get_lock_contention_profile();
+        std::lock_guard<std::mutex> lock(profile->mutex);
+        sites.assign(profile->sites.begin(), profile->sites.end());
+    }
+
+    std::sort(sites.begin(), sites.end(), [](const auto &a, const auto &b) { return a.second.total > b.second.total; });
+    PRINT_DEBUG("%zu contended call sites", sites.size());
+    for (size_t i = 0; i < sites.size() && i < LOCK_CONTENTION_REPORT_MAX; ++i) {
+        const auto &site = sites[i].second;
+        PRINT_DEBUG(
+            "  %s at %s:%i (%s): %llu waits, total %.3f ms, longest %.3f ms",
+            site.lock_name, sites[i].first.first, sites[i].first.second, site.function, site.waits,
+            std::chrono::duration<double, std::milli>(site.total).count(), std::chrono::duration<double, std::milli>(site.longest).count()
+        );
+    }
+#endif
+}
+
+Emu_Mutex::Emu_Mutex(const char *name)
+{
+    this->name = name;
+}
+
+void Emu_Mutex::acquired()
+{
+    if (depth++ == 0) owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void Emu_Mutex::lock(const char *file, int line, const char *function)
+{
+#ifndef EMU_RELEASE_BUILD
+    bool profile = lock_contention_enabled.load(std::memory_order_relaxed);
+#else
+    bool profile = false;
+#endif
+    bool measure = this == &global_mutex && metrics_enabled();
+
+    // only a contended lock is timed, taking a free one costs the same as without profiling
+    if ((profile || measure) && !mutex.try_lock()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        mutex.lock();
+        auto waited = std::chrono::high_resolution_clock::now() - start;
+#ifndef EMU_RELEASE_BUILD
+        if (profile) record_lock_contention(name, file, line, function, waited);
+#endif
+        if (measure) {
+            metrics_add(METRIC_GLOBAL_MUTEX_CONTENDED);
+            metrics_record(METRIC_GLOBAL_MUTEX_WAIT, waited);
+        }
+
+        acquired();
+        return;
+    }
+
+    mutex.lock();
+    acquired();
+}
+
+bool Emu_Mutex::try_lock()
+{
+    if (!mutex.try_lock()) return false;
+
+    acquired();
+    return true;
+}
+
+void Emu_Mutex::unlock()
+{
+    if (--depth == 0) owner.store(std::thread::id(), std::memory_order_relaxed);
+    mutex.unlock();
+}
+
+bool Emu_Mutex::unlock_for_call()
+{
+    if (owner.load(std::memory_order_relaxed) != std::this_thread::get_id()) return false;
+    if (depth != 1) {
+        PRINT_DEBUG("'%s' held %u times, kept locked around the call", name, depth);
+        return false;
+    }
+
+    unlock();
+    return true;
+}
+
+void Emu_Mutex::relock()
+{
+    lock();
+}
+
 bool check_timedout(std::chrono::high_resolution_clock::time_point old, double timeout)
 {
     if (timeout == 0.0) return true;
 
-    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+    return check_timedout(old, timeout, std::chrono::high_resolution_clock::now());
+}
+
+bool check_timedout(std::chrono::high_resolution_clock::time_point old, double timeout, std::chrono::high_resolution_clock::time_point now)
+{
+    if (timeout == 0.0) return true;
+
     if (std::chrono::duration_cast<std::chrono::duration<double>>(now - old).count() > timeout) {
         return true;
     }
@@ -16,6 +16,7 @@
    <http://www.gnu.org/licenses/>.  */
 
 #include "dll/callsystem.h"
+#include "dll/metrics.h"
 
 
 void CCallbackMgr::SetRegister(class CCallbackBase *pCallback, int iCallback)
@@ -37,13 +38,234 @@ bool CCallbackMgr::isServer(class CCallbackBase *pCallback)
 
 
 
+Callback_Payload::Callback_Payload(const void *data, unsigned int size)
+{
+    assign(data, size);
+}
+
+Callback_Payload::Callback_Payload(Callback_Payload &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+Callback_Payload &Callback_Payload::operator=(Callback_Payload &&other) noexcept
+{
+    if (this == &other) return *this;
+
+    heap_data = std::move(other.heap_data);
+    data_size = other.data_size;
+    if (!heap_data && data_size) {
+        memcpy(inline_data, other.inline_data, data_size);
+    }
+
+    other.data_size = 0;
+    return *this;
+}
+
+void Callback_Payload::assign(const void *data, unsigned int size)
+{
+    if (size > CALLBACK_PAYLOAD_INLINE_SIZE) {
+        heap_data.reset(new char[size]);
+    } else {
+        heap_data.reset();
+    }
+
+    data_size = size;
+    if (!size) return;
+
+    if (data) {
+        memcpy(this->data(), data, size);
+    } else {
+        memset(this->data(), 0, size);
+    }
+}
+
+Callback_Payload Callback_Payload::clone() const
+{
+    return Callback_Payload(data(), data_size);
+}
+
+void Callback_Payload::clear()
+{
+    heap_data.reset();
+    data_size = 0;
+}
+
+
+
+static std::chrono::high_resolution_clock::time_point time_after(std::chrono::high_resolution_clock::time_point start, double seconds)
+{
+    return start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+static unsigned timer_wheel_level_bits(unsigned level)
+{
+    return level ? TIMER_WHEEL_LEVELN_BITS : TIMER_WHEEL_LEVEL0_BITS;
+}
+
+// log2 of the ticks one slot of this level covers
+static unsigned timer_wheel_level_shift(unsigned level)
+{
+    return level ? TIMER_WHEEL_LEVEL0_BITS + (level - 1) * TIMER_WHEEL_LEVELN_BITS : 0;
+}
+
+Timer_Wheel::Timer_Wheel()
+{
+    start = frame_time = std::chrono::high_resolution_clock::now();
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        levels[level].resize(1ull << timer_wheel_level_bits(level));
+    }
+}
+
+void Timer_Wheel::place(struct Timer_Entry &&entry)
+{
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        unsigned shift = timer_wheel_level_shift(level);
+        unsigned next_shift = timer_wheel_level_shift(level + 1);
+        // same block of this level as the current tick, so its slot comes around before the block ends
+        if ((entry.tick >> next_shift) == (current_tick >> next_shift)) {
+            levels[level][(entry.tick >> shift) & ((1ull << timer_wheel_level_bits(level)) - 1)].push_back(std::move(entry));
+            return;
+        }
+    }
+
+    overflow.push_back(std::move(entry));
+}
+
+void Timer_Wheel::cascade(std::vector<struct Timer_Entry> &slot)
+{
+    if (slot.empty()) return;
+
+    std::vector<struct Timer_Entry> entries{};
+    entries.swap(slot);
+    for (auto &e : entries) {
+        place(std::move(e));
+    }
+}
+
+void Timer_Wheel::add(std::chrono::high_resolution_clock::time_point deadline, void (*function)(void *object, uint64 data), void *object, uint64 data)
+{
+    uint64 tick = 0;
+    auto since_start = deadline - start;
+    if (since_start.count() > 0) {
+        tick = (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(since_start).count();
+        // round up, a timer never fires before its deadline
+        if (std::chrono::milliseconds(tick) < since_start) ++tick;
+    }
+
+    // the slot of the current tick was already fired
+    tick = std::max(tick, current_tick + 1);
+
+    struct Timer_Entry entry{};
+    entry.tick = tick;
+    entry.order = next_order++;
+    entry.function = function;
+    entry.object = object;
+    entry.data = data;
+    place(std::move(entry));
+    ++count;
+}
+
+void Timer_Wheel::add(double seconds, void (*function)(void *object, uint64 data), void *object, uint64 data)
+{
+    add(time_after(std::chrono::high_resolution_clock::now(), seconds), function, object, data);
+}
+
+void Timer_Wheel::add(std::chrono::high_resolution_clock::time_point start, double seconds, void (*function)(void *object, uint64 data), void *object, uint64 data)
+{
+    add(time_after(start, seconds), function, object, data);
+}
+
+void Timer_Wheel::remove(void *object)
+{
+    auto remove_from = [this, object](std::vector<struct Timer_Entry> &slot) {
+        auto it = std::remove_if(slot.begin(), slot.end(), [object](const struct Timer_Entry &e) { return e.object == object; });
+        count -= std::distance(it, slot.end());
+        slot.erase(it, slot.end());
+    };
+
+    for (auto &level : levels) {
+        for (auto &slot : level) {
+            remove_from(slot);
+        }
+    }
+
+    remove_from(overflow);
+
+    for (auto &e : expired) {
+        if (e.object == object) e.function = nullptr;
+    }
+}
+
+size_t Timer_Wheel::size() const
+{
+    return count;
+}
+
+void Timer_Wheel::advance()
+{
+    frame_time = std::chrono::high_resolution_clock::now();
+    // a timer callback ended up running the callbacks again, the outer advance() fires whatever is left
+    if (advancing) return;
+
+    uint64 target = (uint64)std::chrono::duration_cast<std::chrono::milliseconds>(frame_time - start).count();
+    while (current_tick < target) {
+        if (!count) {
+            current_tick = target;
+            break;
+        }
+
+        uint64 tick = ++current_tick;
+        // move the timers of the slots that just came around down a level, highest level first
+        if ((tick & ((1ull << timer_wheel_level_shift(TIMER_WHEEL_LEVELS)) - 1)) == 0) cascade(overflow);
+
+        for (unsigned level = TIMER_WHEEL_LEVELS - 1; level > 0; --level) {
+            unsigned shift = timer_wheel_level_shift(level);
+            if (tick & ((1ull << shift) - 1)) continue;
+            cascade(levels[level][(tick >> shift) & ((1ull << timer_wheel_level_bits(level)) - 1)]);
+        }
+
+        auto &slot = levels[0][tick & ((1ull << TIMER_WHEEL_LEVEL0_BITS) - 1)];
+        if (slot.size()) {
+            count -= slot.size();
+            std::move(slot.begin(), slot.end(), std::back_inserter(expired));
+            slot.clear();
+        }
+    }
+
+    if (expired.empty()) return;
+
+    std::sort(expired.begin(), expired.end(), [](const struct Timer_Entry &a, const struct Timer_Entry &b) {
+        return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+    });
+
+    // callbacks may add (goes to the wheel) or remove (clears the function here) timers, so go by index
+    advancing = true;
+    for (size_t i = 0; i < expired.size(); ++i) {
+        struct Timer_Entry e = expired[i];
+        if (e.function) e.function(e.object, e.data);
+    }
+
+    expired.clear();
+    advancing = false;
+}
+
+std::chrono::high_resolution_clock::time_point Timer_Wheel::now() const
+{
+    return frame_time;
+}
+
+bool Timer_Wheel::passed(std::chrono::high_resolution_clock::time_point start, double seconds) const
+{
+    return time_after(start, seconds) <= frame_time;
+}
+
+
+
 Steam_Call_Result::Steam_Call_Result(SteamAPICall_t a, int icb, void *r, unsigned int s, double r_in, bool run_cc_cb)
 {
     api_call = a;
-    result.resize(s);
-    if (s > 0 && r != NULL) {
-        memcpy(&(result[0]), r, s);
-    }
+    result.assign(r, s);
     run_in = r_in;
     run_call_completed_cb = run_cc_cb;
     iCallback = icb;
@@ -65,9 +287,14 @@ bool Steam_Call_Result::call_completed() const
     return (!reserved) && check_timedout(created, run_in);
 }
 
-bool Steam_Call_Result::can_execute() const
+bool Steam_Call_Result::call_completed(std::chrono::high_resolution_clock::time_point now) const
 {
-    return (!to_delete) && call_completed() && (has_cb() || check_timedout(created, STEAM_CALLRESULT_WAIT_FOR_CB));
+    return (!reserved) && check_timedout(created, run_in, now);
+}
+
+bool Steam_Call_Result::can_execute(std::chrono::high_resolution_clock::time_point now) const
+{
+    return (!to_delete) && call_completed(now) && (has_cb() || check_timedout(created, STEAM_CALLRESULT_WAIT_FOR_CB, now));
 }
 
 bool Steam_Call_Result::has_cb() const
@@ -77,6 +304,16 @@ bool Steam_Call_Result::has_cb() const
 
 
 
+SteamCallResults::SteamCallResults(Timer_Wheel *timers)
+{
+    this->timers = timers;
+}
+
+SteamCallResults::~SteamCallResults()
+{
+    timers->remove(this);
+}
+
 void SteamCallResults::addCallCompleted(class CCallbackBase *cb)
 {
     if (std::find(completed_callbacks.begin(), completed_callbacks.end(), cb) == completed_callbacks.end()) {
@@ -94,36 +331,114 @@ void SteamCallResults::rmCallCompleted(class CCallbackBase *cb)
     }
 }
 
+struct Steam_Call_Result *SteamCallResults::find_result(SteamAPICall_t api_call)
+{
+    auto it = callresults_index.find(api_call);
+    if (it == callresults_index.end()) return nullptr;
+    return &callresults[it->second];
+}
+
+const struct Steam_Call_Result *SteamCallResults::find_result(SteamAPICall_t api_call) const
+{
+    auto it = callresults_index.find(api_call);
+    if (it == callresults_index.end()) return nullptr;
+    return &callresults[it->second];
+}
+
+struct Steam_Call_Result *SteamCallResults::new_result(struct Steam_Call_Result &&res)
+{
+    res.serial = next_serial++;
+    unsigned slot;
+    if (free_slots.size()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        // hand the old callbacks vector (already cleared) to the new result so it doesn't have to allocate one
+        std::vector<class CCallbackBase *> old_callbacks = std::move(callresults[slot].callbacks);
+        callresults[slot] = std::move(res);
+        if (callresults[slot].callbacks.empty()) callresults[slot].callbacks.swap(old_callbacks);
+    } else {
+        slot = static_cast<unsigned>(callresults.size());
+        callresults.push_back(std::move(res));
+    }
+
+    struct Steam_Call_Result &added = callresults[slot];
+    callresults_index[added.api_call] = slot;
+    // results are kept around after running so GetAPICallResult() still works, this reclaims them
+    timers->add(time_after(added.created, STEAM_CALLRESULT_TIMEOUT), &SteamCallResults::result_expired, this, added.api_call);
+    schedule(added);
+    return &added;
+}
+
+void SteamCallResults::free_result(SteamAPICall_t api_call)
+{
+    auto it = callresults_index.find(api_call);
+    if (it == callresults_index.end()) return;
+
+    unsigned slot = it->second;
+    callresults_index.erase(it);
+    PRINT_DEBUG("removed callresult %i", callresults[slot].iCallback);
+    callresults[slot].api_call = k_uAPICallInvalid;
+    callresults[slot].callbacks.clear();
+    callresults[slot].result.clear();
+    free_slots.push_back(slot);
+}
+
+// wake up when this result might become executable, nothing to do if only an outside event can make it executable
+void SteamCallResults::schedule(const struct Steam_Call_Result &res)
+{
+    if (res.to_delete || res.reserved) return;
+
+    auto time = time_after(res.created, res.run_in);
+    if (!res.has_cb()) time = std::max(time, time_after(res.created, STEAM_CALLRESULT_WAIT_FOR_CB));
+    // already due (a zero timeout), the wheel would only fire it on a later tick, so a frame late if the next one comes within the same ms
+    if (time <= std::chrono::high_resolution_clock::now()) {
+        due.push_back(res.api_call);
+        return;
+    }
+
+    timers->add(time, &SteamCallResults::result_wakeup, this, res.api_call);
+}
+
+void SteamCallResults::result_wakeup(void *object, uint64 api_call)
+{
+    SteamCallResults *obj = (SteamCallResults *)object;
+    obj->due.push_back(api_call);
+}
+
+void SteamCallResults::result_expired(void *object, uint64 api_call)
+{
+    SteamCallResults *obj = (SteamCallResults *)object;
+    obj->free_result(api_call);
+}
+
 void SteamCallResults::addCallBack(SteamAPICall_t api_call, class CCallbackBase *cb)
 {
-    auto cb_result = std::find_if(callresults.begin(), callresults.end(), [api_call](struct Steam_Call_Result const& item) { return item.api_call == api_call; });
-    if (cb_result != callresults.end()) {
+    auto cb_result = find_result(api_call);
+    if (cb_result) {
         cb_result->callbacks.push_back(cb);
         CCallbackMgr::SetRegister(cb, cb->GetICallback());
         PRINT_DEBUG("new cb for call result [api id=%llu, result k_iCallback=%i] %p", api_call, cb ? (cb->GetICallback()) : -1, cb);
+        // it no longer has to wait for STEAM_CALLRESULT_WAIT_FOR_CB
+        schedule(*cb_result);
     }
 }
 
 bool SteamCallResults::exists(SteamAPICall_t api_call) const
 {
-    auto cr = std::find_if(callresults.begin(), callresults.end(), [api_call](struct Steam_Call_Result const& item) {
-        return item.api_call == api_call;
-    });
-    if (callresults.end() == cr) return false;
+    auto cr = find_result(api_call);
+    if (!cr) return false;
     if (!cr->call_completed()) return false;
     return true;
 }
 
 bool SteamCallResults::callback_result(SteamAPICall_t api_call, void *copy_to, unsigned int size)
 {
-    auto cb_result = std::find_if(callresults.begin(), callresults.end(), [api_call](struct Steam_Call_Result const& item) {
-        return item.api_call == api_call;
-    });
-    if (cb_result != callresults.end()) {
+    auto cb_result = find_result(api_call);
+    if (cb_result) {
         if (!cb_result->call_completed()) return false;
         if (cb_result->result.size() > size) return false;
 
-        memcpy(copy_to, &(cb_result->result[0]), cb_result->result.size());
+        memcpy(copy_to, cb_result->result.data(), cb_result->result.size());
         cb_result->to_delete = true;
         return true;
     } else {
@@ -133,8 +448,8 @@ bool SteamCallResults::callback_result(SteamAPICall_t api_call, void *copy_to, u
 
 void SteamCallResults::rmCallBack(SteamAPICall_t api_call, class CCallbackBase *cb)
 {
-    auto cb_result = std::find_if(callresults.begin(), callresults.end(), [api_call](struct Steam_Call_Result const& item) { return item.api_call == api_call; });
-    if (cb_result != callresults.end()) {
+    auto cb_result = find_result(api_call);
+    if (cb_result) {
         auto it = std::find(cb_result->callbacks.begin(), cb_result->callbacks.end(), cb);
         if (it != cb_result->callbacks.end()) {
             cb_result->callbacks.erase(it);
@@ -148,6 +463,8 @@ void SteamCallResults::rmCallBack(class CCallbackBase *cb)
 {
     //TODO: check if callback is callback or call result?
     for (auto & cr: callresults) {
+        if (cr.api_call == k_uAPICallInvalid) continue;
+
         auto it = std::find(cr.callbacks.begin(), cr.callbacks.end(), cb);
         if (it != cr.callbacks.end()) {
             cr.callbacks.erase(it);
@@ -163,21 +480,22 @@ void SteamCallResults::rmCallBack(class CCallbackBase *cb)
 SteamAPICall_t SteamCallResults::addCallResult(SteamAPICall_t api_call, int iCallback, void *result, unsigned int size, double timeout, bool run_call_completed_cb)
 {
     PRINT_DEBUG("%i", iCallback);
-    auto cb_result = std::find_if(callresults.begin(), callresults.end(), [api_call](struct Steam_Call_Result const& item) { return item.api_call == api_call; });
-    if (cb_result != callresults.end()) {
+    auto cb_result = find_result(api_call);
+    if (cb_result) {
         // only change the data if this is a previously reserved callresult
         if (cb_result->reserved) {
             std::chrono::high_resolution_clock::time_point created = cb_result->created;
+            uint64 serial = cb_result->serial;
             std::vector<class CCallbackBase *> temp_cbs = cb_result->callbacks;
             *cb_result = Steam_Call_Result(api_call, iCallback, result, size, timeout, run_call_completed_cb);
             cb_result->callbacks = temp_cbs;
             cb_result->created = created;
+            cb_result->serial = serial;
+            schedule(*cb_result);
             return cb_result->api_call;
         }
     } else {
-        struct Steam_Call_Result res = Steam_Call_Result(api_call, iCallback, result, size, timeout, run_call_completed_cb);
-        callresults.push_back(res);
-        return callresults.back().api_call;
+        return new_result(Steam_Call_Result(api_call, iCallback, result, size, timeout, run_call_completed_cb))->api_call;
     }
 
     PRINT_DEBUG("ERROR");
@@ -188,8 +506,7 @@ SteamAPICall_t SteamCallResults::reserveCallResult()
 {
     struct Steam_Call_Result res = Steam_Call_Result(generate_steam_api_call_id(), 0, NULL, 0, 0.0, true);
     res.reserved = true;
-    callresults.push_back(res);
-    return callresults.back().api_call;
+    return new_result(std::move(res))->api_call;
 }
 
 SteamAPICall_t SteamCallResults::addCallResult(int iCallback, void *result, unsigned int size, double timeout, bool run_call_completed_cb)
@@ -197,100 +514,109 @@ SteamAPICall_t SteamCallResults::addCallResult(int iCallback, void *result, unsi
     return addCallResult(generate_steam_api_call_id(), iCallback, result, size, timeout, run_call_completed_cb);
 }
 
-void SteamCallResults::setCbAll(void (*cb_all)(std::vector<char> result, int callback))
+void SteamCallResults::setCbAll(void (*cb_all)(Callback_Payload &&result, int callback))
 {
     this->cb_all = cb_all;
 }
 
 void SteamCallResults::runCallResults()
 {
-    unsigned long current_size = static_cast<unsigned long>(callresults.size());
-    for (unsigned i = 0; i < current_size; ++i) {
-        unsigned index = i;
-
-        if (!callresults[index].to_delete) {
-            if (callresults[index].can_execute()) {
-                std::vector<char> result = callresults[index].result;
-                SteamAPICall_t api_call = callresults[index].api_call;
-                bool run_call_completed_cb = callresults[index].run_call_completed_cb;
-                int iCallback = callresults[index].iCallback;
-                if (run_call_completed_cb) {
-                    callresults[index].run_call_completed_cb = false;
-                }
+    // the wheel was advanced at the start of this frame, a result is visible on the first frame at or after its deadline
+    auto now = timers->now();
+
+    // only the results which are due right now, anything added by the callbacks below waits for the next run
+    std::vector<std::pair<uint64, SteamAPICall_t>> ready{};
+    std::vector<SteamAPICall_t> woken{};
+    ready.swap(ready_spare);
+    woken.swap(woken_spare);
+    woken.swap(due);
+    for (auto api_call : woken) {
+        auto cr = find_result(api_call);
+        if (!cr || cr->to_delete) continue;
+
+        if (cr->can_execute(now)) {
+            ready.emplace_back(cr->serial, api_call);
+        } else {
+            schedule(*cr);
+        }
+    }
 
-                callresults[index].to_delete = true;
-                if (callresults[index].has_cb()) {
-                    std::vector<class CCallbackBase *> temp_cbs = callresults[index].callbacks;
-                    for (auto & cb : temp_cbs) {
-                        PRINT_DEBUG("Calling callresult %p %i, kind=%i (0=callback, 1=call result)", cb, cb->GetICallback(), (int)run_call_completed_cb);
-                        global_mutex.unlock();
-
-                        //TODO: unlock relock doesn't work if mutex was locked more than once.
-                        if (run_call_completed_cb) { //run the right function depending on if it's a callback or a call result.
-                            cb->Run(&(result[0]), false, api_call);
-                        } else { // if this is a callback
-                            cb->Run(&(result[0]));
-                        }
-
-                        // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-                        //COULD BE DELETED SO DON'T TOUCH CB
-                        // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-
-                        global_mutex.lock();
-                        PRINT_DEBUG("callresult done");
-                    }
-                }
+    woken.clear();
+    if (woken.capacity() > woken_spare.capacity()) woken_spare.swap(woken);
+
+    std::sort(ready.begin(), ready.end());
+    ready.erase(std::unique(ready.begin(), ready.end()), ready.end());
+    metrics_record(METRIC_CALL_RESULTS_PENDING, callresults_index.size());
+    metrics_record(METRIC_CALL_RESULTS_READY, ready.size());
+
+    for (auto &r : ready) {
+        SteamAPICall_t api_call = r.second;
+        auto cr = find_result(api_call);
+        if (!cr || cr->to_delete) continue;
+
+        // call results must stay readable through GetAPICallResult(), but nothing reads a callback's data after this
+        Callback_Payload result = cr->run_call_completed_cb ? cr->result.clone() : std::move(cr->result);
+        bool run_call_completed_cb = cr->run_call_completed_cb;
+        int iCallback = cr->iCallback;
+        if (run_call_completed_cb) {
+            cr->run_call_completed_cb = false;
+        }
 
-                if (run_call_completed_cb) {
-                    //can it happen that one is removed during the callback?
-                    std::vector<class CCallbackBase *> callbacks = completed_callbacks;
-                    SteamAPICallCompleted_t data{};
-                    data.m_hAsyncCall = api_call;
-                    data.m_iCallback = iCallback;
-                    data.m_cubParam = (uint32)result.size();
-
-                    for (auto & cb: callbacks) {
-                        PRINT_DEBUG("Calling complete cb %p %i %llu", cb, iCallback, api_call);
-                        //TODO: check if this is a problem or not.
-                        SteamAPICallCompleted_t temp = data;
-                        global_mutex.unlock();
-                        cb->Run(&temp);
-                        global_mutex.lock();
-                    }
-
-                    if (cb_all) {
-                        std::vector<char> res{};
-                        res.resize(sizeof(data));
-                        memcpy(&(res[0]), &data, sizeof(data));
-                        cb_all(res, data.k_iCallback);
-                    }
-                } else {
-                    if (cb_all) {
-                        cb_all(result, iCallback);
-                    }
-                }
-            } else {
-                if (callresults[index].timed_out()) {
-                    callresults[index].to_delete = true;
+        cr->to_delete = true;
+        metrics_add(METRIC_CALL_RESULTS_DISPATCHED);
+        metrics_record(METRIC_CALL_RESULT_AGE, now - cr->created);
+        if (cr->has_cb()) {
+            std::vector<class CCallbackBase *> temp_cbs = cr->callbacks;
+            for (auto & cb : temp_cbs) {
+                PRINT_DEBUG("Calling callresult %p %i, kind=%i (0=callback, 1=call result)", cb, cb->GetICallback(), (int)run_call_completed_cb);
+                // other threads may call into the emu while the game handles it
+                bool unlocked = global_mutex.unlock_for_call();
+
+                if (run_call_completed_cb) { //run the right function depending on if it's a callback or a call result.
+                    cb->Run(result.data(), false, api_call);
+                } else { // if this is a callback
+                    cb->Run(result.data());
                 }
+
+                // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+                //COULD BE DELETED SO DON'T TOUCH CB
+                // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+
+                if (unlocked) global_mutex.relock();
+                PRINT_DEBUG("callresult done");
             }
         }
-    }
 
-    PRINT_DEBUG("erase to_delete");
-    auto c = std::begin(callresults);
-    while (c != std::end(callresults)) {
-        if (c->to_delete) {
-            if (c->timed_out()) {
-                PRINT_DEBUG("removed callresult %i", c->iCallback);
-                c = callresults.erase(c);
-            } else {
-                ++c;
+        // 'cr' may point to a moved slot after the callbacks, don't use it past here
+        if (run_call_completed_cb) {
+            //can it happen that one is removed during the callback?
+            std::vector<class CCallbackBase *> callbacks = completed_callbacks;
+            SteamAPICallCompleted_t data{};
+            data.m_hAsyncCall = api_call;
+            data.m_iCallback = iCallback;
+            data.m_cubParam = (uint32)result.size();
+
+            for (auto & cb: callbacks) {
+                PRINT_DEBUG("Calling complete cb %p %i %llu", cb, iCallback, api_call);
+                //TODO: check if this is a problem or not.
+                SteamAPICallCompleted_t temp = data;
+                bool unlocked = global_mutex.unlock_for_call();
+                cb->Run(&temp);
+                if (unlocked) global_mutex.relock();
+            }
+
+            if (cb_all) {
+                cb_all(Callback_Payload(&data, sizeof(data)), data.k_iCallback);
             }
         } else {
-            ++c;
+            if (cb_all) {
+                cb_all(std::move(result), iCallback);
+            }
         }
     }
+
+    ready.clear();
+    if (ready.capacity() > ready_spare.capacity()) ready_spare.swap(ready);
 }
 
 
@@ -313,9 +639,11 @@ void SteamCallBacks::addCallBack(int iCallback, class CCallbackBase *cb)
         callbacks[iCallback].callbacks.push_back(cb);
         PRINT_DEBUG("new cb for callback [result k_iCallback=%i] %p", iCallback, cb);
         CCallbackMgr::SetRegister(cb, iCallback);
-        for (auto & res: callbacks[iCallback].results) {
+        auto &history = callbacks[iCallback].results;
+        for (size_t i = 0; i < history.size(); ++i) {
+            auto &res = history[i];
             //TODO: timeout?
-            SteamAPICall_t api_id = results->addCallResult(iCallback, &(res[0]), static_cast<unsigned long>(res.size()), 0.0, false);
+            SteamAPICall_t api_id = results->addCallResult(iCallback, res.data(), res.size(), 0.0, false);
             results->addCallBack(api_id, cb);
         }
     }
@@ -323,10 +651,12 @@ void SteamCallBacks::addCallBack(int iCallback, class CCallbackBase *cb)
 
 void SteamCallBacks::addCBResult(int iCallback, void *result, unsigned int size, double timeout, bool dont_post_if_already)
 {
+    auto &history = callbacks[iCallback].results;
     if (dont_post_if_already) {
-        for (auto & r : callbacks[iCallback].results) {
+        for (size_t i = 0; i < history.size(); ++i) {
+            auto &r = history[i];
             if (r.size() == size) {
-                if (memcmp(&(r[0]), result, size) == 0) {
+                if (memcmp(r.data(), result, size) == 0) {
                     //cb already posted
                     return;
                 }
@@ -334,10 +664,8 @@ void SteamCallBacks::addCBResult(int iCallback, void *result, unsigned int size,
         }
     }
 
-    std::vector<char> temp{};
-    temp.resize(size);
-    memcpy(&(temp[0]), result, size);
-    callbacks[iCallback].results.push_back(temp);
+    if (history.size() >= CALLBACK_HISTORY_MAX) history.pop_front();
+    history.push_back().assign(result, size);
     for (auto cb: callbacks[iCallback].callbacks) {
         SteamAPICall_t api_id = results->addCallResult(iCallback, result, size, timeout, false);
         results->addCallBack(api_id, cb);
@@ -382,9 +710,13 @@ void SteamCallBacks::rmCallBack(int iCallback, class CCallbackBase *cb)
 
 void SteamCallBacks::runCallBacks()
 {
+    size_t queued = 0;
     for (auto & c : callbacks) {
+        queued += c.second.results.size();
         c.second.results.clear();
     }
+
+    metrics_record(METRIC_CALLBACKS_QUEUED, queued);
 }
 
 
@@ -410,10 +742,17 @@ void RunEveryRunCB::remove(void (*cb)(void *object), void *object)
     }
 }
 
-void RunEveryRunCB::run() const
+void RunEveryRunCB::run()
 {
+    timers.advance();
+
     std::vector<struct RunCBs> temp_cbs = cbs;
     for (auto c : temp_cbs) {
         c.function(c.object);
     }
 }
+
+Timer_Wheel *RunEveryRunCB::get_timers()
+{
+    return &timers;
+}
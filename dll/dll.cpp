@@ -82,7 +82,7 @@ static void load_old_steam_interfaces()
 {
     static bool loaded = false;
     
-    std::lock_guard lck(global_mutex);
+    Emu_Lock_Guard lck(global_mutex);
     if (loaded) return;
     loaded = true;
 
@@ -172,7 +172,7 @@ static Steam_Client *steamclient_instance{};
 Steam_Client *get_steam_client()
 {
     if (!steamclient_instance) {
-        std::lock_guard<std::recursive_mutex> lock(global_mutex);
+        Emu_Lock_Guard lock(global_mutex);
         // if we win the thread arbitration for the first time, this will still be null
         if (!steamclient_instance) {
             load_old_steam_interfaces();
@@ -185,7 +185,7 @@ Steam_Client *get_steam_client()
 
 void destroy_client()
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (steamclient_instance) {
         delete steamclient_instance;
         steamclient_instance = nullptr;
@@ -210,7 +210,7 @@ bool steamclient_has_ipv6_functions()
 
 static void *create_client_interface(const char *ver)
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     void *steam_client = nullptr;
 
     if (strstr(ver, "SteamClient") == ver) {
@@ -513,14 +513,14 @@ STEAMAPI_API void S_CALLTYPE SteamAPI_RunCallbacks()
 STEAMAPI_API void S_CALLTYPE SteamAPI_RegisterCallback( class CCallbackBase *pCallback, int iCallback )
 {
     PRINT_DEBUG("%p %u funct:%u", pCallback, iCallback, pCallback->GetICallback());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     get_steam_client()->RegisterCallback(pCallback, iCallback);
 }
 
 STEAMAPI_API void S_CALLTYPE SteamAPI_UnregisterCallback( class CCallbackBase *pCallback )
 {
     PRINT_DEBUG("%p", pCallback);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!steamclient_instance) return;
     get_steam_client()->UnregisterCallback(pCallback);
 }
@@ -1047,27 +1047,25 @@ STEAMAPI_API void S_CALLTYPE SteamAPI_SetBreakpadAppID( uint32 unAppID )
 
 struct cb_data {
     int cb_id{};
-    std::vector<char> result{};
+    Callback_Payload result{};
 };
-static std::queue<struct cb_data> client_cb{};
-static std::queue<struct cb_data> server_cb{};
+static Slot_Queue<struct cb_data> client_cb{};
+static Slot_Queue<struct cb_data> server_cb{};
 
-static void cb_add_queue_server(std::vector<char> result, int callback)
+static void cb_add_queue_server(Callback_Payload &&result, int callback)
 {
-    PRINT_DEBUG("adding callback=%i, size=%zu", callback, result.size());
-    struct cb_data cb{};
+    PRINT_DEBUG("adding callback=%i, size=%u", callback, result.size());
+    struct cb_data &cb = server_cb.push_back();
     cb.cb_id = callback;
-    cb.result = result;
-    server_cb.push(cb);
+    cb.result = std::move(result);
 }
 
-static void cb_add_queue_client(std::vector<char> result, int callback)
+static void cb_add_queue_client(Callback_Payload &&result, int callback)
 {
-    PRINT_DEBUG("adding callback=%i, m_iCallback=%i", callback, ((SteamAPICallCompleted_t *)&result[0])->m_iCallback);
-    struct cb_data cb{};
+    PRINT_DEBUG("adding callback=%i, m_iCallback=%i", callback, ((SteamAPICallCompleted_t *)result.data())->m_iCallback);
+    struct cb_data &cb = client_cb.push_back();
     cb.cb_id = callback;
-    cb.result = result;
-    client_cb.push(cb);
+    cb.result = std::move(result);
 }
 
 /// Inform the API that you wish to use manual event dispatch.  This must be called after SteamAPI_Init, but before
@@ -1109,7 +1107,7 @@ STEAMAPI_API steam_bool S_CALLTYPE SteamAPI_ManualDispatch_GetNextCallback( HSte
     PRINT_DEBUG("%i %p", hSteamPipe, pCallbackMsg);
     Steam_Client *steam_client = get_steam_client();
     if (!steam_client->steamclient_server_inited) {
-        while(!server_cb.empty()) server_cb.pop();
+        server_cb.clear();
     }
 
     auto it = steam_client->steam_pipes.find(hSteamPipe);
@@ -1118,7 +1116,7 @@ STEAMAPI_API steam_bool S_CALLTYPE SteamAPI_ManualDispatch_GetNextCallback( HSte
         return false;
     }
 
-    std::queue<struct cb_data> *q = NULL;
+    Slot_Queue<struct cb_data> *q = NULL;
     HSteamUser m_hSteamUser = 0;
     if (it->second == Steam_Pipe::SERVER) {
         q = &server_cb;
@@ -1139,8 +1137,8 @@ STEAMAPI_API steam_bool S_CALLTYPE SteamAPI_ManualDispatch_GetNextCallback( HSte
     if (pCallbackMsg) {
         pCallbackMsg->m_hSteamUser = m_hSteamUser;
         pCallbackMsg->m_iCallback = q->front().cb_id;
-        pCallbackMsg->m_pubParam = (uint8 *)&(q->front().result[0]);
-        pCallbackMsg->m_cubParam = static_cast<unsigned long>(q->front().result.size());
+        pCallbackMsg->m_pubParam = (uint8 *)q->front().result.data();
+        pCallbackMsg->m_cubParam = q->front().result.size();
         PRINT_DEBUG("cb number %i", q->front().cb_id);
         return true;
     }
@@ -1153,7 +1151,7 @@ STEAMAPI_API steam_bool S_CALLTYPE SteamAPI_ManualDispatch_GetNextCallback( HSte
 STEAMAPI_API void S_CALLTYPE SteamAPI_ManualDispatch_FreeLastCallback( HSteamPipe hSteamPipe )
 {
     PRINT_DEBUG("%i", hSteamPipe);
-    std::queue<struct cb_data> *q = NULL;
+    Slot_Queue<struct cb_data> *q = NULL;
     Steam_Client *steam_client = get_steam_client();
     auto it = steam_client->steam_pipes.find(hSteamPipe);
     if (steam_client->steam_pipes.end() == it) {
@@ -1168,7 +1166,7 @@ STEAMAPI_API void S_CALLTYPE SteamAPI_ManualDispatch_FreeLastCallback( HSteamPip
         return;
     }
 
-    if (!q->empty()) q->pop();
+    if (!q->empty()) q->pop_front();
 }
 
 /// Return the call result for the specified call on the specified pipe.  You really should
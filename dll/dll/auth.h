@@ -14,6 +14,29 @@ constexpr const static uint32_t STEAM_APPTICKET_GCLen = 20;
 constexpr const static uint32_t STEAM_APPTICKET_SESSIONLEN = 24;
 
 
+// signs app tickets, the key is parsed and the random generator seeded on the first ticket and then kept for the
+// life of the process, calls from different threads are serialized since the mbedtls contexts aren't thread safe
+class Ticket_Signer {
+    std::mutex mutex{};
+    bool seeded{};
+    bool ready{};
+    mbedtls_entropy_context entropy_ctx{};
+    mbedtls_ctr_drbg_context ctr_drbg_ctx{};
+    mbedtls_pk_context private_key_ctx{};
+
+    Ticket_Signer();
+    bool setup();
+    std::vector<uint8_t> sign_locked(const uint8_t *data, size_t data_len);
+
+public:
+    static Ticket_Signer &instance();
+
+    // empty on failure
+    std::vector<uint8_t> sign(const uint8_t *data, size_t data_len);
+    // one signature per {data, length}, for callers minting many tickets at once, the lock is only taken once
+    std::vector<std::vector<uint8_t>> sign_batch(const std::vector<std::pair<const uint8_t *, size_t>> &items);
+};
+
 struct DLC {
     uint32_t AppId{};
     std::vector<uint32_t> Licenses{};
@@ -63,17 +86,43 @@ struct Auth_Data {
     std::chrono::high_resolution_clock::time_point created{};
 
     std::vector<uint8_t> Serialize() const;
+    // same as Serialize() but with the ticket already serialized, it's copied as it is instead of Ticket
+    std::vector<uint8_t> Serialize(const std::vector<uint8_t> &tickedData) const;
 };
 
 
 
+struct Inbound_Auth_Session {
+    uint64_t number{};
+    std::chrono::high_resolution_clock::time_point created{};
+};
+
+// sessions of each user keyed by steam id, a user rarely has more than one
+typedef std::unordered_map<uint64, std::vector<struct Inbound_Auth_Session>> Inbound_Auth_Map;
+
 class Auth_Manager {
     class Settings *settings{};
     class Networking *network{};
     class SteamCallBacks *callbacks{};
 
-    std::vector<struct Auth_Data> inbound{};
-    std::vector<struct Auth_Data> outbound{};
+    Inbound_Auth_Map inbound{};
+    // entries of users whose sessions all ended, reused for the next users so a busy server doesn't keep allocating
+    std::vector<Inbound_Auth_Map::node_type> free_inbound{};
+    uint32 inbound_count{};
+    // numbers of the tickets handed out and not canceled yet
+    std::unordered_set<uint64_t> outbound{};
+
+    // the serialized AppTicket shared by every ticket we hand out, only the dates differ between them
+    // rebuilt when the steam id, the app id or the list of DLCs it was made from changes
+    std::vector<uint8_t> ticket_template{};
+    uint64 ticket_template_steam_id{};
+    uint32 ticket_template_appid{};
+    uint32 ticket_template_dlcs_version{};
+
+    const std::vector<uint8_t> &get_ticket_template(CSteamID steam_id, uint32 appid);
+
+    void add_inbound(CSteamID id, uint64_t number, std::chrono::high_resolution_clock::time_point created);
+    void remove_inbound_user(Inbound_Auth_Map::iterator user);
 
     void launch_callback(CSteamID id, EAuthSessionResponse resp, double delay=0);
     void launch_callback_gs(CSteamID id, bool approved);
@@ -24,7 +24,80 @@
 #define PUSH_BACK_IF_NOT_IN(vector, element) { if(std::find(vector.begin(), vector.end(), element) == vector.end()) vector.push_back(element); }
 
 
-extern std::recursive_mutex global_mutex;
+// where a lock was taken, filled in by the compiler at the Emu_Lock_Guard
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+    #define EMU_CALLER_FILE __builtin_FILE()
+    #define EMU_CALLER_LINE __builtin_LINE()
+    #define EMU_CALLER_FUNCTION __builtin_FUNCTION()
+#else
+    #define EMU_CALLER_FILE ""
+    #define EMU_CALLER_LINE 0
+    #define EMU_CALLER_FUNCTION ""
+#endif
+
+// recursive mutex used for the emu's own locks
+// it knows its owner and how deep it is held, so it is only released around game callbacks when no outer guard holds it,
+// and in debug builds it reports how long each call site waited for it (lock_contention_profile in configs.main.ini)
+//
+// lock order, a thread holding one of these may only take the ones after it, never the other way around:
+//   1. global_mutex
+//   1b. Networking::flush_mutex, held while the network thread runs the Nagle flush callbacks
+//   2. subsystem locks: Steam_Networking::messages_mutex -> Steam_Networking::connections_edit_mutex,
+//      shared_between_client_server::mutex (sockets), Settings::images_mutex,
+//      Local_Storage::flush_mutex -> Local_Storage::pending_mutex, Local_Storage::index_mutex -> Local_Storage::handles_mutex
+//   3. Networking::mutex
+//   4. leaf locks which never call out: the networking message pool, the contention profiler, the debug log
+// the network message callbacks are dispatched without Networking::mutex held, so they can take any subsystem lock
+class Emu_Mutex {
+    std::recursive_mutex mutex{};
+    std::atomic<std::thread::id> owner{};
+    // only touched by the owner
+    unsigned depth{};
+    const char *name{};
+
+    void acquired();
+
+public:
+    Emu_Mutex(const char *name);
+
+    void lock(const char *file = nullptr, int line = 0, const char *function = nullptr);
+    bool try_lock();
+    void unlock();
+
+    // releases the lock around a call into the game, returns whether relock() must be called afterwards
+    // only done when this thread holds it exactly once (the level taken by RunCallbacks()), outer levels belong to
+    // Emu_Lock_Guards further up the stack which still rely on it, so a nested hold is kept and reported instead
+    bool unlock_for_call();
+    void relock();
+};
+
+// std::lock_guard for Emu_Mutex, remembers the call site for the contention profiler
+class Emu_Lock_Guard {
+    Emu_Mutex &mutex;
+
+public:
+    explicit Emu_Lock_Guard(Emu_Mutex &mutex, const char *file = EMU_CALLER_FILE, int line = EMU_CALLER_LINE, const char *function = EMU_CALLER_FUNCTION)
+        : mutex(mutex)
+    {
+        mutex.lock(file, line, function);
+    }
+
+    ~Emu_Lock_Guard()
+    {
+        mutex.unlock();
+    }
+
+    Emu_Lock_Guard(const Emu_Lock_Guard &) = delete;
+    Emu_Lock_Guard &operator=(const Emu_Lock_Guard &) = delete;
+};
+
+// contention profiler, only waits are recorded so an uncontended lock costs nothing extra
+void set_lock_contention_profiling(bool enable);
+bool lock_contention_profiling();
+// prints the wait time of every call site to the debug log, longest total first
+void report_lock_contention();
+
+extern Emu_Mutex global_mutex;
 extern const std::chrono::time_point<std::chrono::high_resolution_clock> startup_counter;
 extern const std::chrono::time_point<std::chrono::system_clock> startup_time;
 
@@ -37,6 +110,8 @@ bool set_env_variable(const std::string &name, const std::string &value);
 /// @param timeout The max allowed time in seconds
 /// @return true if the timepoint has exceeded the max allowed timeout, false otherwise
 bool check_timedout(std::chrono::high_resolution_clock::time_point old, double timeout);
+// same but against a clock reading taken by the caller, e.g. the frame time of the timer wheel
+bool check_timedout(std::chrono::high_resolution_clock::time_point old, double timeout, std::chrono::high_resolution_clock::time_point now);
 
 unsigned generate_account_id();
 CSteamID generate_steam_anon_user();
@@ -24,6 +24,16 @@
 #define STEAM_CALLRESULT_TIMEOUT 120.0
 #define STEAM_CALLRESULT_WAIT_FOR_CB 0.01
 
+// nearly every steam callback struct fits in this, the few bigger ones (UGC details, web api tickets) go on the heap
+#define CALLBACK_PAYLOAD_INLINE_SIZE 768
+// how many posted callbacks of each kind are kept to be replayed to a callback registered later in the same frame
+#define CALLBACK_HISTORY_MAX 64
+
+// timer wheel resolution is 1ms, level 0 covers 256ms and every level above it 64 times the one below
+#define TIMER_WHEEL_LEVEL0_BITS 8
+#define TIMER_WHEEL_LEVELN_BITS 6
+#define TIMER_WHEEL_LEVELS 3
+
 
 class CCallbackMgr
 {
@@ -34,16 +44,132 @@ public:
     static bool isServer(class CCallbackBase *pCallback);
 };
 
+// data of a callback/call result, moved from the poster to the dispatch (or ManualDispatch queue) instead of copied
+class Callback_Payload {
+    alignas(8) char inline_data[CALLBACK_PAYLOAD_INLINE_SIZE];
+    std::unique_ptr<char[]> heap_data{};
+    unsigned data_size{};
+
+public:
+    Callback_Payload() = default;
+    Callback_Payload(const void *data, unsigned int size);
+    Callback_Payload(Callback_Payload &&other) noexcept;
+    Callback_Payload &operator=(Callback_Payload &&other) noexcept;
+    Callback_Payload(const Callback_Payload &) = delete;
+    Callback_Payload &operator=(const Callback_Payload &) = delete;
+
+    // copies 'size' bytes of 'data', or zeroes if 'data' is NULL
+    void assign(const void *data, unsigned int size);
+    Callback_Payload clone() const;
+    void clear();
+
+    char *data() { return heap_data ? heap_data.get() : inline_data; }
+    const char *data() const { return heap_data ? heap_data.get() : inline_data; }
+    unsigned int size() const { return data_size; }
+    bool empty() const { return data_size == 0; }
+};
+
+// FIFO over a vector of reused slots, it only allocates when it holds more than it ever did before
+// a popped slot is reset to T() right away, so big payloads don't stay around
+template<typename T>
+class Slot_Queue {
+    std::vector<T> slots{};
+    size_t head{};
+    size_t count{};
+
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // 0 is the oldest entry
+    T &operator[](size_t i) { return slots[(head + i) % slots.size()]; }
+    T &front() { return slots[head]; }
+
+    // the new last slot, holding a reset T
+    T &push_back()
+    {
+        if (count == slots.size()) {
+            std::vector<T> grown(slots.size() ? slots.size() * 2 : 4);
+            for (size_t i = 0; i < count; ++i) grown[i] = std::move((*this)[i]);
+            slots.swap(grown);
+            head = 0;
+        }
+
+        ++count;
+        return (*this)[count - 1];
+    }
+
+    void pop_front()
+    {
+        slots[head] = T();
+        head = (head + 1) % slots.size();
+        --count;
+    }
+
+    void clear()
+    {
+        while (count) pop_front();
+        head = 0;
+    }
+};
+
+struct Timer_Entry {
+    uint64 tick{};
+    // insertion order, timers expiring on the same tick fire in this order
+    uint64 order{};
+    void (*function)(void *object, uint64 data) = nullptr;
+    void *object{};
+    uint64 data{};
+};
+
+// hierarchical timing wheel, adding/removing a timer is O(1) and advancing only touches the slots that expire
+// everything in here is guarded by global_mutex
+class Timer_Wheel {
+    std::chrono::high_resolution_clock::time_point start{};
+    std::chrono::high_resolution_clock::time_point frame_time{};
+    uint64 current_tick{};
+    uint64 next_order{};
+    size_t count{};
+    bool advancing{};
+    std::vector<std::vector<struct Timer_Entry>> levels[TIMER_WHEEL_LEVELS]{};
+    // deadlines past the last level, looked at again each time the last level wraps around
+    std::vector<struct Timer_Entry> overflow{};
+    std::vector<struct Timer_Entry> expired{};
+
+    void place(struct Timer_Entry &&entry);
+    void cascade(std::vector<struct Timer_Entry> &slot);
+
+public:
+    Timer_Wheel();
+
+    // calls function(object, data) on the first advance() at or after 'deadline', a deadline in the past fires on the next one
+    void add(std::chrono::high_resolution_clock::time_point deadline, void (*function)(void *object, uint64 data), void *object, uint64 data = 0);
+    void add(double seconds, void (*function)(void *object, uint64 data), void *object, uint64 data = 0);
+    void add(std::chrono::high_resolution_clock::time_point start, double seconds, void (*function)(void *object, uint64 data), void *object, uint64 data = 0);
+    // drops every timer of this object, including the ones about to fire in the current advance()
+    void remove(void *object);
+    size_t size() const;
+
+    // reads the clock once and fires every timer that expired since the last call
+    void advance();
+    // clock reading of the last advance(), use this instead of now() for timeouts checked during a frame
+    std::chrono::high_resolution_clock::time_point now() const;
+    // true once 'seconds' after 'start' have passed as of the last advance(), a timer added for that deadline sees this as true
+    bool passed(std::chrono::high_resolution_clock::time_point start, double seconds) const;
+};
+
 struct Steam_Call_Result {
     SteamAPICall_t api_call{};
     std::vector<class CCallbackBase *> callbacks{};
-    std::vector<char> result{};
+    Callback_Payload result{};
     bool to_delete = false;
     bool reserved = false;
     std::chrono::high_resolution_clock::time_point created{};
     double run_in{};
     bool run_call_completed_cb{};
     int iCallback{};
+    // creation order, results that are due together run in this order
+    uint64 serial{};
 
     Steam_Call_Result(SteamAPICall_t a, int icb, void *r, unsigned int s, double r_in, bool run_cc_cb);
 
@@ -52,19 +178,47 @@ struct Steam_Call_Result {
     bool timed_out() const;
 
     bool call_completed() const;
+    bool call_completed(std::chrono::high_resolution_clock::time_point now) const;
 
-    bool can_execute() const;
+    bool can_execute(std::chrono::high_resolution_clock::time_point now) const;
 
     bool has_cb() const;
 
 };
 
 class SteamCallResults {
+    // slot map, a free slot has api_call == k_uAPICallInvalid and is reused by the next result
+    // slots can move when this grows, so only hold on to an index/api_call across callbacks
     std::vector<struct Steam_Call_Result> callresults{};
+    std::vector<unsigned> free_slots{};
+    std::unordered_map<SteamAPICall_t, unsigned> callresults_index{};
+    // wakeups (when a result might become executable) and expiry (STEAM_CALLRESULT_TIMEOUT after creation) are timers
+    // on this wheel, they only carry the api_call and are re-checked (and may be stale) when they fire
+    Timer_Wheel *timers{};
+    // api calls whose wakeup fired since the last runCallResults()
+    std::vector<SteamAPICall_t> due{};
+    // the buffers runCallResults() works with, kept between frames so they don't have to grow again,
+    // a nested runCallResults() from inside a callback finds them taken and uses its own
+    std::vector<SteamAPICall_t> woken_spare{};
+    std::vector<std::pair<uint64, SteamAPICall_t>> ready_spare{};
+    uint64 next_serial{};
+
     std::vector<class CCallbackBase *> completed_callbacks{};
-    void (*cb_all)(std::vector<char> result, int callback) = nullptr;
+    void (*cb_all)(Callback_Payload &&result, int callback) = nullptr;
+
+    struct Steam_Call_Result *find_result(SteamAPICall_t api_call);
+    const struct Steam_Call_Result *find_result(SteamAPICall_t api_call) const;
+    struct Steam_Call_Result *new_result(struct Steam_Call_Result &&res);
+    void free_result(SteamAPICall_t api_call);
+    void schedule(const struct Steam_Call_Result &res);
+
+    static void result_wakeup(void *object, uint64 api_call);
+    static void result_expired(void *object, uint64 api_call);
 
 public:
+    SteamCallResults(Timer_Wheel *timers);
+    ~SteamCallResults();
+
     void addCallCompleted(class CCallbackBase *cb);
 
     void rmCallCompleted(class CCallbackBase *cb);
@@ -85,14 +239,15 @@ public:
 
     SteamAPICall_t addCallResult(int iCallback, void *result, unsigned int size, double timeout=DEFAULT_CB_TIMEOUT, bool run_call_completed_cb=true);
 
-    void setCbAll(void (*cb_all)(std::vector<char> result, int callback));
+    void setCbAll(void (*cb_all)(Callback_Payload &&result, int callback));
 
     void runCallResults();
 };
 
 struct Steam_Call_Back {
     std::vector<class CCallbackBase *> callbacks{};
-    std::vector<std::vector<char>> results{};
+    // posted since the last runCallBacks(), at most CALLBACK_HISTORY_MAX (oldest dropped first)
+    Slot_Queue<Callback_Payload> results{};
 };
 
 class SteamCallBacks {
@@ -120,13 +275,17 @@ struct RunCBs {
 
 class RunEveryRunCB {
     std::vector<struct RunCBs> cbs{};
+    Timer_Wheel timers{};
 
 public:
     void add(void (*cb)(void *object), void *object);
 
     void remove(void (*cb)(void *object), void *object);
 
-    void run() const;
+    // advances the timers first, so every run_callback() sees the same frame time
+    void run();
+
+    Timer_Wheel *get_timers();
 };
 
 #endif // __INCLUDED_CALLSYSTEM_H__
@@ -45,12 +45,17 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <set>
 #include <queue>
+#include <deque>
 #include <list>
 
 #include <thread>
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 
 #include <string.h>
@@ -124,6 +129,8 @@ static inline void reset_LastError()
     #include <sys/stat.h>
     #include <sys/statvfs.h>
     #include <sys/time.h>
+    #include <sys/epoll.h>
+    #include <sys/inotify.h>
 
     #include <netinet/in.h>
     #include <netinet/tcp.h>
@@ -174,7 +181,14 @@ static inline void reset_LastError()
     #elif defined(__LINUX__)
         #include <sys/syscall.h> // syscall
 
-        #define PRINT_DEBUG_TID() (long long)syscall(SYS_gettid)
+        // the syscall costs more than writing a whole line, ask once per thread
+        inline long long print_debug_tid()
+        {
+            static thread_local long long tid = (long long)syscall(SYS_gettid);
+            return tid;
+        }
+
+        #define PRINT_DEBUG_TID() print_debug_tid()
         #define PRINT_DEBUG_CLEANUP() (void)0
     #else
         #warning  "Unrecognized OS"
@@ -185,15 +199,33 @@ static inline void reset_LastError()
 
     extern dbg_log dbg_logger;
 
-    #define PRINT_DEBUG(a, ...) do {                                                                \
-        dbg_logger.write("[tid %lld] %s " a, PRINT_DEBUG_TID(), EMU_FUNC_NAME, ##__VA_ARGS__);      \
-        PRINT_DEBUG_CLEANUP();                                                                      \
+    // 'lvl' is one of dbg_log::level, lines above debug_log_level or not matching debug_log_filter are never formatted
+    #if defined(EMU_BINARY_TRACE)
+    // only the call site id and the raw arguments are recorded, see dbg_log_trace.hpp
+    #define PRINT_DEBUG_LEVEL(lvl, a, ...) do {                                                         \
+        if (dbg_logger.enabled(dbg_log::level::lvl, EMU_FUNC_NAME)) {                                   \
+            static dbg_log_trace::site print_debug_site{ a, EMU_FUNC_NAME };                            \
+            dbg_logger.trace(print_debug_site, PRINT_DEBUG_TID(), ##__VA_ARGS__);                       \
+        }                                                                                               \
+        PRINT_DEBUG_CLEANUP();                                                                          \
+    } while (0)
+    #else
+    #define PRINT_DEBUG_LEVEL(lvl, a, ...) do {                                                         \
+        if (dbg_logger.enabled(dbg_log::level::lvl, EMU_FUNC_NAME)) {                                   \
+            dbg_logger.write("[tid %lld] %s " a, PRINT_DEBUG_TID(), EMU_FUNC_NAME, ##__VA_ARGS__);      \
+        }                                                                                               \
+        PRINT_DEBUG_CLEANUP();                                                                          \
     } while (0)
+    #endif
 
 #else // EMU_RELEASE_BUILD
-    #define PRINT_DEBUG(...)
+    #define PRINT_DEBUG_LEVEL(...)
 #endif // EMU_RELEASE_BUILD
 
+#define PRINT_DEBUG(a, ...) PRINT_DEBUG_LEVEL(debug, a, ##__VA_ARGS__)
+// per packet/per frame lines, drop them with debug_log_level=debug
+#define PRINT_DEBUG_TRACE(a, ...) PRINT_DEBUG_LEVEL(trace, a, ##__VA_ARGS__)
+
 // function entry
 #define PRINT_DEBUG_ENTRY() PRINT_DEBUG("")
 #define PRINT_DEBUG_TODO() PRINT_DEBUG("// TODO")
@@ -39,6 +39,64 @@ struct image_t {
     std::vector<image_pixel_t> pix_map{};
 };
 
+// a write kept in memory until the next flush, a newer write to the same file replaces it
+struct Pending_Write {
+    std::string data{};
+    // json files are only serialized when they are flushed
+    nlohmann::json json{};
+    bool is_json{};
+    std::time_t modified{};
+    std::chrono::steady_clock::time_point dirty_since{};
+    // bumped by every deferred write, a flush only drops the entry it wrote
+    uint64_t generation{};
+};
+
+struct Indexed_File {
+    uint64_t size{};
+    uint64_t timestamp{};
+};
+
+// file names compare like the file system does, ignoring case on Windows
+struct Index_Name_Less {
+    bool operator()(const std::string &a, const std::string &b) const;
+};
+
+// every file in a storage folder and its sub folders, names are relative to the folder
+struct Folder_Index {
+    std::map<std::string, Indexed_File, Index_Name_Less> files{};
+    // the same files by position for iterate_file(), rebuilt after a change
+    std::vector<std::map<std::string, Indexed_File, Index_Name_Less>::const_iterator> listing{};
+    bool listing_valid{};
+};
+
+// a file opened once for reading, reads at an offset go straight into the caller's buffer
+// shared between readers through a shared_ptr, the file is closed once the last one lets go of it
+class Local_File_Handle {
+private:
+#if defined(__WINDOWS__)
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+
+public:
+    Local_File_Handle(const std::string &full_path);
+    ~Local_File_Handle();
+    Local_File_Handle(const Local_File_Handle &) = delete;
+    Local_File_Handle &operator=(const Local_File_Handle &) = delete;
+
+    bool is_open() const;
+    // false once the file at 'full_path' was replaced or deleted, the handle then still reads the old one
+    bool is_current(const std::string &full_path) const;
+    // returns the number of bytes read, less than 'length' at the end of the file, or -1
+    int read(char *data, unsigned int length, uint64_t offset) const;
+};
+
+struct Cached_File_Handle {
+    std::shared_ptr<Local_File_Handle> handle{};
+    uint64_t last_used{};
+};
+
 class Local_Storage {
 private:
     static std::string saves_folder_name;
@@ -58,6 +116,7 @@ public:
     static std::string get_user_appdata_path();
 
     static int get_file_data(const std::string &full_path, char *data, unsigned int max_length, unsigned int offset=0);
+    // the file is written next to its final path then renamed over it, so a crash never leaves a half written file
     static int store_file_data(std::string folder, std::string file, const char *data, unsigned int length);
     
     static std::vector<std::string> get_filenames_path(std::string path);
@@ -69,15 +128,64 @@ public:
 private:
     std::string save_directory{};
     std::string appid{}; // game appid
+
+    // write-behind cache, keyed by full path
+    std::map<std::string, Pending_Write> pending_writes{};
+    std::mutex pending_mutex{};
+    uint64_t pending_generation{};
+    // held for a whole flush so an older copy of a file can never be renamed over a newer one
+    std::mutex flush_mutex{};
+    common_helpers::KillableWorker *flush_worker{};
+
+    // directory index, keyed by the full path of the folder, built the first time a folder is looked at
+    std::map<std::string, Folder_Index> folder_indexes{};
+    std::mutex index_mutex{};
+#if !defined(__WINDOWS__)
+    // changes made by anything else are picked up through inotify, the index is then only as stale as the last lookup
+    int inotify_fd = -1;
+    std::map<int, std::string> watched_dirs{};
+
+    void read_folder_changes();
+#endif
+
+    void add_pending_write(std::string &&full_path, Pending_Write &&write);
+    // runs 'visit' on the pending write under pending_mutex, nothing is copied out unless 'visit' does it
+    template<typename Visitor>
+    bool visit_pending_write(const std::string &full_path, Visitor visit);
+    bool drop_pending_write(const std::string &full_path);
+    // writes the pending files under 'prefix', only those dirty for a while unless 'all'
+    void flush_pending(const std::string &prefix, bool all);
+    bool flush_worker_proc();
+    // index_mutex must be held
+    Folder_Index &get_folder_index(const std::string &folder_path);
+    void drop_folder_indexes(const std::string &path);
+    // looks the file up again on disk and updates every index it is in
+    void index_file(const std::string &full_path);
+    // same as index_file() but takes index_mutex
+    void file_changed(const std::string &full_path);
+    bool find_indexed_file(std::string folder, std::string file, Indexed_File &indexed);
+
+    // files recently read, kept open, keyed by full path
+    std::map<std::string, Cached_File_Handle> file_handles{};
+    uint64_t file_handles_clock{};
+    std::mutex handles_mutex{};
+
+    // must be called before the file is replaced or deleted, Windows can't do either while it is open
+    void drop_file_handle(const std::string &full_path);
     
 public:
     Local_Storage(const std::string &save_directory);
+    ~Local_Storage();
 
     const std::string& get_current_save_directory() const;
     void setAppId(uint32 appid);
     int store_data(std::string folder, std::string file, char *data, unsigned int length);
+    // like store_data() but only kept in memory until the next flush, for files rewritten very often like stats
+    int store_data_deferred(std::string folder, std::string file, const char *data, unsigned int length);
     int store_data_settings(std::string file, const char *data, unsigned int length);
     int get_data(std::string folder, std::string file, char *data, unsigned int max_length, unsigned int offset=0);
+    // the handle is shared with every other reader of the same file, nullptr if it can't be opened
+    std::shared_ptr<Local_File_Handle> open_file(const std::string &full_path);
     unsigned int data_settings_size(std::string file);
     int get_data_settings(std::string file, char *data, unsigned int max_length);
     int count_files(std::string folder);
@@ -94,6 +202,9 @@ public:
     bool load_json(const std::string &full_path, nlohmann::json& json);
     bool load_json_file(std::string folder, std::string const& file, nlohmann::json& json);
     bool write_json_file(std::string folder, std::string const& file, nlohmann::json const& json);
+    bool write_json_file_deferred(std::string folder, std::string const& file, nlohmann::json const& json);
+    // write every deferred file to disk now
+    void flush();
 
     std::vector<image_pixel_t> load_image(std::string const& image_path);
     static std::string load_image_resized(std::string const& image_path, std::string const& image_data, int resolution);
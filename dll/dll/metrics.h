@@ -0,0 +1,127 @@
+/* Copyright (C) 2019 Mr Goldberg
+   This file is part of the Goldberg Emulator
+
+   The Goldberg Emulator is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   The Goldberg Emulator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the Goldberg Emulator; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#ifndef __INCLUDED_METRICS_H__
+#define __INCLUDED_METRICS_H__
+
+#include "common_includes.h"
+
+// counters and latency histograms about the emu itself, collected only when metrics_file is set in configs.main.ini
+// every thread writes to its own block, so recording is a couple of plain stores and never takes a lock,
+// the blocks are summed up when a snapshot is written
+
+// room for every Callback_Ids channel (checked in metrics.cpp)
+#define METRICS_NETWORK_CHANNELS 16
+
+enum Metric_Counters {
+    METRIC_RUNCALLBACKS,
+    METRIC_CALL_RESULTS_DISPATCHED,
+    METRIC_GLOBAL_MUTEX_CONTENDED,
+
+    METRIC_COUNTERS_MAX
+};
+
+enum Metric_Histograms {
+    // time spent in each phase of Steam_Client::RunCallbacks() in ns
+    METRIC_RUNCALLBACKS_TOTAL,
+    METRIC_RUNCALLBACKS_NETWORK,
+    METRIC_RUNCALLBACKS_MATCHMAKING_SERVERS,
+    METRIC_RUNCALLBACKS_RUN_EVERY_RUNCB,
+    METRIC_RUNCALLBACKS_GAMESERVER,
+    METRIC_RUNCALLBACKS_CALL_RESULTS_CLIENT,
+    METRIC_RUNCALLBACKS_CALL_RESULTS_SERVER,
+    METRIC_RUNCALLBACKS_CALLBACKS,
+    // ns spent waiting for global_mutex when it was already taken
+    METRIC_GLOBAL_MUTEX_WAIT,
+    // ns between posting a call result and handing it to the game
+    METRIC_CALL_RESULT_AGE,
+    // queue depths, sampled once per runCallResults()/runCallBacks()
+    METRIC_CALL_RESULTS_PENDING,
+    METRIC_CALL_RESULTS_READY,
+    METRIC_CALLBACKS_QUEUED,
+
+    METRIC_HISTOGRAMS_MAX
+};
+
+enum Metric_Direction {
+    METRIC_NETWORK_IN,
+    METRIC_NETWORK_OUT,
+};
+
+namespace metrics_detail {
+    extern std::atomic<bool> enabled;
+
+    void add(Metric_Counters counter, uint64 value);
+    void record(Metric_Histograms histogram, uint64 value);
+    void network(Metric_Direction direction, unsigned channel, uint64 bytes);
+}
+
+// true when metrics are collected, check it before doing any work only needed for a metric
+inline bool metrics_enabled()
+{
+    return metrics_detail::enabled.load(std::memory_order_relaxed);
+}
+
+inline void metrics_add(Metric_Counters counter, uint64 value = 1)
+{
+    if (metrics_enabled()) metrics_detail::add(counter, value);
+}
+
+inline void metrics_record(Metric_Histograms histogram, uint64 value)
+{
+    if (metrics_enabled()) metrics_detail::record(histogram, value);
+}
+
+inline void metrics_record(Metric_Histograms histogram, std::chrono::high_resolution_clock::duration duration)
+{
+    if (metrics_enabled()) metrics_detail::record(histogram, (uint64)std::max<long long>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+}
+
+// one packet of 'bytes' sent or received on a Callback_Ids channel
+inline void metrics_network(Metric_Direction direction, unsigned channel, uint64 bytes)
+{
+    if (metrics_enabled()) metrics_detail::network(direction, channel, bytes);
+}
+
+// times consecutive phases of a function, each next() closes the current phase and starts another one
+// it doesn't read the clock at all while metrics are disabled
+class Metrics_Timer {
+    std::chrono::high_resolution_clock::time_point start{};
+    Metric_Histograms histogram{};
+    bool active{};
+
+public:
+    Metrics_Timer(Metric_Histograms histogram);
+    ~Metrics_Timer();
+
+    void next(Metric_Histograms histogram);
+    void stop();
+};
+
+// 'path' is where snapshots are written, an empty path disables the metrics
+// 'interval' is the seconds between two automatic snapshots, 0 only writes them on request and on shutdown
+void metrics_configure(const std::string &path, double interval);
+double metrics_dump_interval();
+
+// write a JSON snapshot of everything recorded since startup
+void metrics_dump();
+// ask for a snapshot from a signal handler or a timer, written by the next metrics_dump_pending()
+void metrics_request_dump();
+// write the snapshot asked by metrics_request_dump(), if any, must be called without global_mutex held
+void metrics_dump_pending();
+
+#endif // __INCLUDED_METRICS_H__
@@ -22,6 +22,8 @@
 #include <curl/curl.h>
 
 #define DEFAULT_PORT 47584
+// small game messages held back by the Nagle timer are coalesced into one packet up to this size
+#define NAGLE_BATCH_MTU 1200
 
 #if defined(STEAM_WIN32)
 typedef unsigned int sock_t;
@@ -70,18 +72,149 @@ enum Callback_Ids {
     CALLBACK_IDS_MAX
 };
 
+// flushes the send queues a subsystem holds back for the Nagle timer, see Networking::scheduleFlush()
+struct Network_Flush_Callback {
+    void (*flush)(void *object) = nullptr;
+    void *object{};
+};
+
 struct Network_Callback_Container {
     std::vector<struct Network_Callback> callbacks{};
 };
 
+// a message received by the network I/O thread, waiting to be dispatched by Run()
+struct Network_Queued_Message {
+    Common_Message msg{};
+    // dispatch to CALLBACK_ID_USER_STATUS instead of the normal message callbacks
+    bool user_status = false;
+};
+
+// bounded lock-free multi-producer/single-consumer queue, based on Dmitry Vyukov's bounded MPMC queue
+// push() may be called from any thread, pop() must only be called by one thread at a time
+template<typename T, size_t Size>
+class Bounded_MPSC_Queue {
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "queue size must be a power of 2");
+
+    struct Cell {
+        std::atomic<size_t> sequence{};
+        T data{};
+    };
+
+    Cell cells[Size]{};
+    alignas(64) std::atomic<size_t> enqueue_pos{};
+    alignas(64) size_t dequeue_pos{};
+
+public:
+    Bounded_MPSC_Queue()
+    {
+        for (size_t i = 0; i < Size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // returns false if the queue is full
+    bool push(T data)
+    {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell *cell = &cells[pos & (Size - 1)];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell->data = std::move(data);
+                    cell->sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // returns false if the queue is empty
+    bool pop(T &data)
+    {
+        Cell *cell = &cells[dequeue_pos & (Size - 1)];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(dequeue_pos + 1) < 0) {
+            return false;
+        }
+
+        data = std::move(cell->data);
+        cell->sequence.store(dequeue_pos + Size, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+};
+
+// contiguous byte queue for the TCP stream, consumed bytes are skipped by moving an offset
+// and the storage is only compacted once the consumed part is at least half of it,
+// so queued frames are always contiguous (one send() / in-place parsing) and each byte is moved at most once
+struct TCP_Buffer {
+    std::vector<char> storage{};
+    size_t offset{};
+
+    size_t size() const { return storage.size() - offset; }
+    bool empty() const { return storage.size() == offset; }
+    char *data() { return storage.data() + offset; }
+
+    // grow by 'count' bytes and return a pointer to the new space
+    char *extend(size_t count)
+    {
+        if (offset && offset >= storage.size() / 2) {
+            size_t used = size();
+            if (used) memmove(storage.data(), storage.data() + offset, used);
+            storage.resize(used);
+            offset = 0;
+        }
+
+        size_t old_size = storage.size();
+        storage.resize(old_size + count);
+        return storage.data() + old_size;
+    }
+
+    // drop the last 'count' bytes added by extend() which were never written
+    void unextend(size_t count)
+    {
+        storage.resize(storage.size() - count);
+    }
+
+    void consume(size_t count)
+    {
+        offset += count;
+        if (offset >= storage.size()) {
+            storage.clear(); // keeps the capacity
+            offset = 0;
+        }
+    }
+};
+
 struct TCP_Socket {
     sock_t sock = static_cast<sock_t>(~0);
     bool received_data = false;
-    std::vector<char> recv_buffer{};
-    std::vector<char> send_buffer{};
+    TCP_Buffer recv_buffer{};
+    TCP_Buffer send_buffer{};
     std::chrono::high_resolution_clock::time_point last_heartbeat_sent{}, last_heartbeat_received{};
 };
 
+struct UDP_Packet {
+    IP_PORT ip_port{};
+    std::vector<char> data{};
+};
+
+struct Fragment_Reassembly {
+    std::vector<std::string> parts{};
+    uint32 received{};
+    // payload bytes received so far
+    size_t data_size{};
+    // memory held, counted against UDP_REASSEMBLY_MAX_SIZE
+    size_t size{};
+    std::chrono::high_resolution_clock::time_point started{};
+};
+
 struct Connection {
     struct TCP_Socket tcp_socket_outgoing{}, tcp_socket_incoming{};
     bool connected = false;
@@ -91,6 +224,13 @@ struct Connection {
     std::vector<CSteamID> ids{};
     uint32 appid{};
     std::chrono::high_resolution_clock::time_point last_received{};
+    // creation order, lookups prefer the oldest connection when several of them share an id
+    uint64 serial{};
+};
+
+struct Fanout_Target {
+    struct Connection *conn{};
+    CSteamID steam_id{};
 };
 
 class Networking
@@ -101,12 +241,27 @@ class Networking
     sock_t query_socket, udp_socket{}, tcp_socket{};
     uint16 udp_port{}, tcp_port{};
     uint32 own_ip{};
-    std::vector<struct Connection> connections{};
+    // a list so that Connection pointers stay valid until that connection is removed
+    std::list<struct Connection> connections{};
+    uint64 next_connection_serial{};
+    // steam id -> every connection which has this id, must be updated whenever Connection::ids changes
+    std::unordered_map<uint64, std::vector<struct Connection *>> connection_index{};
+    // precomputed targets of sendToAll(), sendToAllIndividuals() and sendToAllGameservers()
+    // rebuilt lazily by the next broadcast after any id/connection change
+    std::vector<struct Fanout_Target> fanout_all{}, fanout_individuals{}, fanout_gameservers{};
+    bool fanout_dirty = true;
 
     std::vector<CSteamID> ids;
     uint32 appid;
     std::chrono::high_resolution_clock::time_point last_broadcast;
     std::vector<IP_PORT> custom_broadcasts;
+    // reused by every announce so broadcasting doesn't allocate once they've grown
+    std::vector<char> announce_buffer{};
+    std::vector<IP_PORT> broadcast_destinations{};
+    std::vector<char *> broadcast_datas{};
+    std::vector<unsigned long> broadcast_lengths{};
+    // serialized unreliable message sent right away (outside of a batch)
+    std::vector<char> udp_buffer{};
 
     std::vector<struct TCP_Socket> accepted;
     std::recursive_mutex mutex;
@@ -114,12 +269,90 @@ class Networking
     struct Network_Callback_Container callbacks[CALLBACK_IDS_MAX];
     std::vector<Common_Message> local_send;
 
+#if defined(__LINUX__)
+    // edge-triggered epoll instance watching every socket we own
+    // Run() only touches the sockets reported here
+    int epoll_fd = -1;
+    // sockets reported ready, 'in_ready' is indexed by the fd and says whether it's listed and still pending,
+    // serviced sockets are only flagged and dropped from the list by the next poll
+    // both keep their capacity so readiness events don't allocate
+    enum Ready_State : uint8_t { READY_NONE, READY_PENDING, READY_SERVICED };
+    std::vector<sock_t> ready_socks{};
+    std::vector<uint8_t> in_ready{};
+    void mark_ready(sock_t sock);
+#endif
+
+    // optional dedicated thread which owns the sockets and parses incoming messages,
+    // Run() then only dispatches what this thread has queued
+    common_helpers::KillableWorker *io_thread{};
+    Bounded_MPSC_Queue<Network_Queued_Message *, 4096> io_queue{};
+    // dispatched messages handed back for reuse, so receiving doesn't allocate one per message
+    // pushed by whoever dispatches, popped with 'mutex' held
+    Bounded_MPSC_Queue<Network_Queued_Message *, 4096> io_free{};
+    // messages that didn't fit in io_queue, kept in order until there's room again (guarded by 'mutex')
+    std::deque<Network_Queued_Message *> io_backlog{};
+
+    // without the I/O thread, what Run() received is collected here and dispatched once it has released 'mutex'
+    std::vector<Network_Queued_Message> received{};
+    std::vector<Network_Queued_Message> dispatching{};
+
+    // called by the network thread (the I/O thread, or 'flush_thread' without it) once the earliest
+    // deadline given to scheduleFlush() has passed, without 'mutex' held
+    std::mutex flush_mutex{};
+    std::vector<struct Network_Flush_Callback> flush_callbacks{};
+    // steady_clock ticks, INT64_MAX while nothing is scheduled
+    std::atomic<int64_t> flush_deadline{INT64_MAX};
+    common_helpers::KillableWorker *flush_thread{};
+
+    void io_thread_proc();
+    int flush_wait_ms(int max_ms);
+    void run_flushes();
+    Network_Queued_Message *new_queued_message();
+    void queue_message(Network_Queued_Message *queued);
+    void flush_io_backlog();
+    void dispatch_message(Network_Queued_Message &queued);
+    void dispatch_io_messages();
+    void deliver_message(Common_Message *msg);
+
+    void run_query();
+    void run_sockets();
+
+    // receive buffers for batched datagram reads
+    struct UDP_Batch *udp_batch{};
+    // while true, unreliable sends are queued and then sent together by flush_udp_sends()
+    bool batch_udp_sends = false;
+    // entries are reused to keep their buffers allocated, only the first 'udp_send_count' are pending
+    std::vector<struct UDP_Packet> udp_send_queue{};
+    size_t udp_send_count{};
+    void flush_udp_sends();
+    void queue_udp_packet(IP_PORT ip_port, Common_Message *msg, size_t size);
+
+    // unreliable messages too big for one datagram are split into fragments and rebuilt on the other side
+    uint64 next_fragment_id{};
+    // (sender steam id, message id) -> fragments received so far, bounded by UDP_REASSEMBLY_MAX_SIZE bytes of memory in total
+    std::map<std::pair<uint64, uint64>, struct Fragment_Reassembly> reassembly{};
+    size_t reassembly_size{};
+    void send_fragmented(IP_PORT ip_port, Common_Message *msg, size_t size);
+    bool handle_fragment(Common_Message *msg, IP_PORT ip_port);
+    void drop_reassembly(std::map<std::pair<uint64, uint64>, struct Fragment_Reassembly>::iterator pending);
+    void expire_fragments();
+
+    void watch_socket(sock_t sock);
+    void poll_sockets(int timeout_ms = 0);
+    bool take_ready_socket(sock_t sock);
+    void recv_tcp_ready(struct TCP_Socket &socket);
+
     struct Connection *find_connection(CSteamID id, uint32 appid = 0);
     struct Connection *new_connection(CSteamID id, uint32 appid);
+    void index_connection_id(struct Connection *conn, CSteamID steam_id);
+    void unindex_connection_id(struct Connection *conn, CSteamID steam_id);
+    void rebuild_fanout();
 
     bool handle_announce(Common_Message *msg, IP_PORT ip_port);
     bool handle_low_level_udp(Common_Message *msg, IP_PORT ip_port);
+    void handle_udp(Common_Message *msg, IP_PORT ip_port);
     bool handle_tcp(Common_Message *msg, struct TCP_Socket &socket);
+    bool send_broadcasts(uint16 port, char *data, unsigned long length);
     void send_announce_broadcasts();
 
     bool add_id_connection(struct Connection *connection, CSteamID steam_id);
@@ -131,7 +364,7 @@ class Networking
 
 
 public:
-    Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT> *custom_broadcasts, bool disable_sockets);
+    Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT> *custom_broadcasts, bool disable_sockets, bool use_io_thread = false);
     ~Networking();
     
     //NOTE: for all functions ips/ports are passed/returned in host byte order
@@ -161,6 +394,12 @@ public:
     bool setCallback(Callback_Ids id, CSteamID steam_id, void (*message_callback)(void *object, Common_Message *msg), void *object);
     void rmCallback(Callback_Ids id, CSteamID steam_id, void (*message_callback)(void *object, Common_Message *msg), void *object);
 
+    // the callback must flush whatever is due and call scheduleFlush() again for what it still holds
+    void addFlushCallback(void (*flush)(void *object), void *object);
+    void rmFlushCallback(void (*flush)(void *object), void *object);
+    // make the network thread run the flush callbacks at 'deadline', lock-free so it can be called with any lock held
+    void scheduleFlush(std::chrono::steady_clock::time_point deadline);
+
     uint32 getIP(CSteamID id);
     uint32 getOwnIP();
 
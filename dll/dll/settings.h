@@ -198,6 +198,8 @@ private:
 
     bool unlockAllDLCs = true;
     std::vector<struct DLC_entry> DLCs{};
+    // bumped whenever an app id is added to the DLC list
+    uint32 dlcs_version{};
     
     //installed app ids, Steam_Apps::BIsAppInstalled()
     bool assume_any_app_installed = true;
@@ -221,6 +223,11 @@ public:
 
     //networking
     bool disable_networking = false;
+    // run the sockets on a dedicated thread, Steam_RunCallbacks() then only dispatches the received messages
+    bool network_io_thread = false;
+    // how long small outgoing game messages are held back to be coalesced with the next ones, 0 = send immediately
+    // off by default, older emu builds drop the coalesced packets
+    int nagle_time_us = 0;
 
     //gameserver source query
     bool disable_source_query = false;
@@ -262,7 +269,9 @@ public:
     // enable owning Steam Applications IDs (mostly builtin apps + dedicated servers)
     bool enable_builtin_preowned_ids = false;
 
+    // read from game threads without global_mutex, use the image functions below instead of touching this directly
     std::map<int, struct Image_Data> images{};
+    mutable std::shared_mutex images_mutex{};
 
     //subscribed lobby/group ids
     std::set<uint64> subscribed_groups{};
@@ -353,6 +362,8 @@ public:
     unsigned int DLCCount() const;
     bool hasDLC(AppId_t appID);
     bool getDLC(unsigned int index, AppId_t &appID, bool &available, std::string &name);
+    // changes every time the list of DLC app ids does, anything built from that list can compare it to know when to rebuild
+    uint32 getDLCsVersion() const;
 
     //installed apps, used by Steam_Apps::BIsAppInstalled()
     void assumeAnyAppInstalled(bool val);
@@ -380,6 +391,10 @@ public:
 
     //images
     int add_image(const std::string &data, uint32 width, uint32 height);
+    bool get_image_size(int image, uint32 *width, uint32 *height) const;
+    // copies at most 'size' bytes of the RGBA data
+    bool copy_image_data(int image, void *dest, size_t size) const;
+    std::string get_image_data(int image) const;
 
     // overlay auto accept stuff
     void acceptAnyOverlayInvites(bool value);
@@ -53,6 +53,7 @@ public ISteamGameServer
     class Settings *settings{};
     class Networking *network{};
     class SteamCallBacks *callbacks{};
+    class RunEveryRunCB *run_every_runcb{};
 
     CSteamID steam_id{};
 
@@ -65,14 +66,17 @@ public ISteamGameServer
     uint32 flags{};
     bool policy_response_called{};
 
-    std::chrono::high_resolution_clock::time_point last_sent_server_info{};
+    // set by a SEND_SERVER_RATE timer after each send, the server info goes out on the next RunCallbacks() while logged in
+    bool send_server_info{true};
     Auth_Manager *auth_manager{};
 
     std::vector<struct Gameserver_Outgoing_Packet> outgoing_packets{};
 
+    static void send_server_info_timer(void *object, uint64 data);
+
 
 public:
-    Steam_GameServer(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks);
+    Steam_GameServer(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb);
     ~Steam_GameServer();
 
     std::vector<std::pair<CSteamID, Gameserver_Player_Info_t>>* get_players();
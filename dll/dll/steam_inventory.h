@@ -68,6 +68,8 @@ private:
     void read_inventory_db();
 
     static void run_every_runcb_cb(void *object);
+    // posts the result of a request once its timeout passed
+    static void request_timer(void *object, uint64 inventory_result);
 
 public:
     Steam_Inventory(class Settings *settings, class SteamCallResults *callback_results, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb, class Local_Storage *local_storage);
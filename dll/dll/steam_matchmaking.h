@@ -73,7 +73,6 @@ public ISteamMatchmaking
     class RunEveryRunCB *run_every_runcb{};
 
     std::vector<Lobby> lobbies{};
-    std::chrono::high_resolution_clock::time_point last_sent_lobbies{};
     std::vector<struct Pending_Joins> pending_joins{};
     std::vector<struct Pending_Creates> pending_creates{};
 
@@ -114,14 +113,22 @@ public ISteamMatchmaking
     void remove_lobbies();
     void on_self_enter_leave_lobby(CSteamID id, int type, bool leaving);
 
-    void create_pending_lobbies();
-    void run_background();
+    void create_pending_lobby(SteamAPICall_t api_id);
+    void search_lobbies();
+    void send_lobby_enter_result(SteamAPICall_t api_id, CSteamID lobby_id, EChatRoomEnterResponse response);
     void RunCallbacks();
     void Callback(Common_Message *msg);
 
     static void steam_matchmaking_callback(void *object, Common_Message *msg);
     static void steam_matchmaking_run_every_runcb(void *object);
 
+    // the delays and timeouts below are timers on the RunEveryRunCB wheel, 'data' is the api call or lobby they belong to
+    static void send_lobbies_timer(void *object, uint64 data);
+    static void lobby_create_timer(void *object, uint64 api_id);
+    static void lobby_search_timer(void *object, uint64 api_id);
+    static void pending_join_timer(void *object, uint64 api_id);
+    static void lobby_data_timer(void *object, uint64 lobby_id);
+
 public:
     Steam_Matchmaking(class Settings *settings, class Local_Storage *local_storage, class Networking *network, class SteamCallResults *callback_results, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb);
     ~Steam_Matchmaking();
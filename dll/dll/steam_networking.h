@@ -23,6 +23,12 @@
 struct Steam_Networking_Connection {
     CSteamID remote{};
     std::set<int> open_channels{};
+
+    // buffered packets waiting for the Nagle timer, sent together as one DATA_BATCH
+    std::vector<Network_pb> send_queue{};
+    size_t send_queue_size{};
+    bool send_queue_reliable{};
+    std::chrono::steady_clock::time_point send_queue_deadline{};
 };
 
 struct steam_listen_socket {
@@ -68,26 +74,33 @@ public ISteamNetworking
     std::list<Common_Message> messages{};
     std::list<Common_Message> unprocessed_messages{};
 
-    std::recursive_mutex connections_edit_mutex{};
+    // guards connections, their send queues and the new connection bookkeeping, so SendP2PPacket() doesn't need global_mutex
+    Emu_Mutex connections_edit_mutex{"Steam_Networking::connections_edit_mutex"};
     std::vector<struct Steam_Networking_Connection> connections{};
 
     std::vector<struct steam_listen_socket> listen_sockets{};
     std::vector<struct steam_connection_socket> connection_sockets{};
 
+    // when the first packet of a user without a connection was seen, the P2PSessionRequest_t and the timeout are timers
     std::map<CSteamID, std::chrono::high_resolution_clock::time_point> new_connection_times{};
-    std::queue<CSteamID> new_connections_to_call_cb{};
+    bool orphaned_packets_timer_pending{};
     
     SNetListenSocket_t socket_number = 0;
 
     bool connection_exists(CSteamID id);
     struct Steam_Networking_Connection *get_or_create_connection(CSteamID id);
     void remove_connection(CSteamID id);
+    bool flush_send_queue(struct Steam_Networking_Connection *conn);
     SNetSocket_t create_connection_socket(CSteamID target, int nVirtualPort, uint32 nIP, uint16 nPort, SNetListenSocket_t id=0, enum steam_socket_connection_status status=SOCKET_CONNECTING, SNetSocket_t other_id=0);
     struct steam_connection_socket *get_connection_socket(SNetSocket_t id);
     void remove_killed_connection_sockets();
 
     static void steam_networking_callback(void *object, Common_Message *msg);
     static void steam_networking_run_every_runcp(void *object);
+    static void steam_networking_flush(void *object);
+    static void new_connection_timer(void *object, uint64 steam_id);
+    static void new_connection_timeout_timer(void *object, uint64 steam_id);
+    static void orphaned_packets_timer(void *object, uint64 data);
 
 public:
     Steam_Networking(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb);
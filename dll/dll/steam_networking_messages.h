@@ -54,6 +54,8 @@ public ISteamNetworkingMessages
 
     static void steam_callback(void *object, Common_Message *msg);
     static void steam_run_every_runcb(void *object);
+    // drops a connection the game never accepted, NETWORKING_MESSAGES_TIMEOUT after it was created
+    static void connection_timeout_timer(void *object, uint64 steam_id);
 
     std::map<CSteamID, Steam_Message_Connection>::iterator find_or_create_message_connection(SteamNetworkingIdentity identityRemote, bool incoming, bool restartbroken);
 
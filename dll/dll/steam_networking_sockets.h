@@ -20,6 +20,12 @@
 
 #include "base.h"
 
+// received messages are recycled through a pool instead of new/malloc for each one,
+// small payloads are copied into the buffer the message kept from its last use, big ones are moved out of the received protobuf
+struct Pooled_Steam_Message : public SteamNetworkingMessage_t {
+    std::string payload{};
+};
+
 struct Listen_Socket {
     HSteamListenSocket socket_id{};
 
@@ -27,6 +33,15 @@ struct Listen_Socket {
     int real_port{};
 
     CSteamID created_by{};
+
+    // accepted connections with received messages waiting, see Connect_Socket::listen_ready
+    std::deque<HSteamNetConnection> ready{};
+};
+
+struct Poll_Group {
+    std::list<HSteamNetConnection> connections{};
+    // member connections with received messages waiting, in the order they got them, see Connect_Socket::poll_ready
+    std::deque<HSteamNetConnection> ready{};
 };
 
 enum connect_socket_status {
@@ -38,13 +53,12 @@ enum connect_socket_status {
     CONNECT_SOCKET_TIMEDOUT
 };
 
-struct Connect_Socket {
-    struct compare_snm_for_queue {
-        bool operator()(const Networking_Sockets &left, const Networking_Sockets &right) {
-            return left.message_number() > right.message_number();
-        }
-    };
+struct Connect_Socket_Traffic {
+    unsigned packets{};
+    unsigned bytes{};
+};
 
+struct Connect_Socket {
     int virtual_port{};
     int real_port{};
 
@@ -56,20 +70,46 @@ struct Connect_Socket {
     enum connect_socket_status status{};
     int64 user_data{};
 
-    std::priority_queue<Networking_Sockets, std::vector<Networking_Sockets>, compare_snm_for_queue> data{};
+    // messages ready to be received, reliable ones only get here in order
+    std::deque<Networking_Sockets> data{};
+    // reliable messages which arrived ahead of a gap, slot = reliable_number % RELIABLE_REORDER_WINDOW
+    // an empty slot has reliable_number 0, allocated on the first out of order message
+    std::vector<Networking_Sockets> reorder_ring{};
+    unsigned reorder_count{};
+    uint64 next_reliable_number = 1;
+    std::chrono::steady_clock::time_point gap_since{};
     HSteamNetPollGroup poll_group{};
+    // queued once in the ready list of its poll group/listen socket, cleared when that entry is popped or dropped
+    bool poll_ready{};
+    bool listen_ready{};
 
     unsigned long long packet_send_counter{};
+    unsigned long long reliable_send_counter{};
     CSteamID created_by{};
 
     std::chrono::steady_clock::time_point connect_request_last_sent{};
     unsigned connect_requests_sent{};
+
+    // small messages waiting for the Nagle timer, sent together as one DATA_BATCH
+    std::vector<Networking_Sockets> send_queue{};
+    size_t send_queue_size{};
+    size_t send_queue_reliable_size{};
+    bool send_queue_reliable{};
+    std::chrono::steady_clock::time_point send_queue_deadline{};
+
+    // traffic of the current window and rates of the last full one, for GetConnectionRealTimeStatus()
+    Connect_Socket_Traffic sent{}, received{};
+    float out_packets_per_sec{}, out_bytes_per_sec{}, in_packets_per_sec{}, in_bytes_per_sec{};
+    std::chrono::steady_clock::time_point traffic_window_start{};
 };
 
 struct shared_between_client_server {
+    // guards everything in here, taken after global_mutex
+    // the send paths only take this one so game threads can send while the callbacks run
+    Emu_Mutex mutex{"shared_between_client_server::mutex"};
     std::vector<struct Listen_Socket> listen_sockets{};
     std::map<HSteamNetConnection, struct Connect_Socket> connect_sockets{};
-    std::map<HSteamNetPollGroup, std::list<HSteamNetConnection>> poll_groups{};
+    std::map<HSteamNetPollGroup, struct Poll_Group> poll_groups{};
     unsigned used{};
 };
 
@@ -96,10 +136,12 @@ public ISteamNetworkingSockets
 
     static void steam_callback(void *object, Common_Message *msg);
     static void steam_run_every_runcb(void *object);
+    static void steam_network_flush(void *object);
 
     SteamNetworkingMessage_t *get_steam_message_connection(HSteamNetConnection hConn);
-    static void free_steam_message_data(SteamNetworkingMessage_t *pMsg);
-    static void delete_steam_message(SteamNetworkingMessage_t *pMsg);
+    static Pooled_Steam_Message *alloc_pooled_message();
+    static void free_pooled_message_data(SteamNetworkingMessage_t *pMsg);
+    static void release_pooled_message(SteamNetworkingMessage_t *pMsg);
 
     static unsigned long get_socket_id();
 
@@ -107,6 +149,12 @@ public ISteamNetworkingSockets
     struct Listen_Socket *get_connection_socket(HSteamListenSocket id);
 
     bool send_packet_new_connection(HSteamNetConnection m_hConn);
+    bool flush_send_queue(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket);
+    void push_received_data(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket, Networking_Sockets &data);
+    void mark_ready(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket);
+    void receive_message(Connect_Socket &connect_socket, Networking_Sockets &message);
+    void skip_reliable_gap(Connect_Socket &connect_socket);
+    void update_traffic_rates(Connect_Socket &connect_socket, std::chrono::steady_clock::time_point now);
 
     HSteamListenSocket new_listen_socket(int nSteamConnectVirtualPort, int real_port);
 
@@ -50,6 +50,8 @@ struct Downloaded_File {
     // *** used in any case
     std::string file{};
     uint64 total_size{};
+    // kept open between UGCRead() chunks
+    std::shared_ptr<Local_File_Handle> handle{};
 
     // put any additional data needed by other sources here
     
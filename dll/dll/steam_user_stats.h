@@ -57,6 +57,41 @@ struct achievement_trigger {
     bool should_indicate_progress(int32 stat) const;
 };
 
+// achievement names are case insensitive
+struct Achievement_Name_Hash {
+    size_t operator()(std::string_view name) const;
+};
+
+struct Achievement_Name_Equal {
+    bool operator()(std::string_view lhs, std::string_view rhs) const;
+};
+
+// the achievements.json schema flattened once when it's loaded, the getters called by games every frame
+// only look up a name in 'index' and read the columns at that position
+struct Achievement_Definitions {
+    // one entry per achievement, in the order of achievements.json
+    // reserved up front and never modified once 'index' is built, the keys of 'index' point into these strings
+    std::vector<std::string> names{};
+    // already in the language of the user
+    std::vector<std::string> display_names{};
+    std::vector<std::string> descriptions{};
+    std::vector<std::string> hidden{}; // "0" or "1"
+    std::vector<std::string> icons{};
+    std::vector<std::string> icons_gray{};
+
+    // views of 'names'
+    std::unordered_map<std::string_view, uint32, Achievement_Name_Hash, Achievement_Name_Equal> index{};
+
+    Achievement_Definitions() = default;
+    // a copy of 'index' would still point into the original 'names'
+    Achievement_Definitions(const Achievement_Definitions &) = delete;
+    Achievement_Definitions &operator=(const Achievement_Definitions &) = delete;
+
+    // position of the achievement or -1
+    int find(std::string_view name) const;
+    size_t size() const;
+};
+
 class Steam_User_Stats :
 public ISteamUserStats003,
 public ISteamUserStats004,
@@ -71,6 +106,8 @@ public ISteamUserStats
 {
 public:
     static constexpr auto achievements_user_file = "achievements.json";
+    // every stat of the user in a single file, replaces one file per stat in Local_Storage::stats_storage_folder
+    static constexpr auto stats_store_file = "stats.bin";
 
 private:
     template<typename T>
@@ -92,10 +129,18 @@ private:
     std::vector<struct Steam_Leaderboard> cached_leaderboards{};
 
     nlohmann::json defined_achievements{};
+    Achievement_Definitions achievement_definitions{};
     nlohmann::json user_achievements{};
     std::vector<std::string> sorted_achievement_names{};
     std::map<std::string, int32> stats_cache_int{};
     std::map<std::string, float> stats_cache_float{};
+    // stat name -> the bytes saved for it in stats_store_file
+    std::map<std::string, std::string> stored_stats{};
+    // stored_stats changed since it was last handed to local storage, it is serialized once per StoreStats() or a few seconds later
+    bool stats_store_dirty{};
+    std::chrono::steady_clock::time_point stats_store_dirty_since{};
+    // stats_store_file has a version this build doesn't know, it is never overwritten
+    bool stats_store_read_only{};
 
     std::map<std::string, std::vector<achievement_trigger>> achievement_stat_trigger{};
     
@@ -109,7 +154,13 @@ private:
     void load_achievements();
     void save_achievements();
 
-    nlohmann::detail::iter_impl<nlohmann::json> defined_achievements_find(const std::string &key);
+    void load_stats_store();
+    bool parse_stats_store(const std::string &buffer, std::map<std::string, std::string> &stats, uint32 &version);
+    void mark_stats_store_dirty();
+    bool save_stats_store();
+
+    // position of the achievement in defined_achievements or -1
+    int defined_achievements_find(std::string_view key) const;
     std::string get_value_for_language(const nlohmann::json &json, std::string_view key, std::string_view language);
 
     std::vector<Steam_Leaderboard_Entry> load_leaderboard_entries(const std::string &name);
@@ -156,6 +207,9 @@ public:
     Steam_User_Stats(Settings *settings, class Networking *network, Local_Storage *local_storage, class SteamCallResults *callback_results, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb, Steam_Overlay* overlay);
     ~Steam_User_Stats();
 
+    // hands changed stats to local storage, which still has to be flushed
+    void flush_stats_store();
+
     // Ask the server to send down this user's data and achievements for this game
     STEAM_CALL_BACK( UserStatsReceived_t )
     bool RequestCurrentStats();
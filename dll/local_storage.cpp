@@ -17,6 +17,20 @@
 
 #include "dll/local_storage.h"
 
+// how long a deferred write may stay in memory before the background thread writes it
+#define WRITE_BEHIND_DELAY_SECONDS 5
+// how often the background thread looks for deferred writes to flush
+#define WRITE_BEHIND_POLL_MS 1000
+// files kept open after a read, the least recently read one is closed first
+#define MAX_OPEN_FILE_HANDLES 16
+
+#if defined(__WINDOWS__)
+#include <io.h>
+#endif
+
+// write_file_atomic() writes "<file>.~emu_tmp.<pid>-<n>" and renames it over the file, never shown as a file of the game
+#define TEMP_FILE_MARKER ".~emu_tmp."
+
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
 #define STBI_ONLY_PNG
@@ -35,8 +49,32 @@
 
 struct File_Data {
     std::string name{};
+    uint64_t size{};
+    uint64_t timestamp{};
 };
 
+// also true for the ones left behind by a crash
+static bool is_temp_file_name(const std::string &name)
+{
+    size_t marker = name.rfind(TEMP_FILE_MARKER);
+    if (marker == std::string::npos) return false;
+
+    size_t suffix = marker + sizeof(TEMP_FILE_MARKER) - 1;
+    if (suffix == name.size()) return false;
+    return name.find_first_not_of("0123456789-", suffix) == std::string::npos;
+}
+
+bool Index_Name_Less::operator()(const std::string &a, const std::string &b) const
+{
+#if defined(__WINDOWS__)
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) < std::tolower(static_cast<unsigned char>(y));
+    });
+#else
+    return a < b;
+#endif
+}
+
 
 std::string Local_Storage::saves_folder_name = "Steam Emulator Saves";
 
@@ -45,6 +83,31 @@ std::string Local_Storage::saves_folder_name = "Steam Emulator Saves";
 
 static const std::string empty_str{};
 
+Local_File_Handle::Local_File_Handle(const std::string &full_path)
+{
+
+}
+
+Local_File_Handle::~Local_File_Handle()
+{
+
+}
+
+bool Local_File_Handle::is_open() const
+{
+    return false;
+}
+
+bool Local_File_Handle::is_current(const std::string &full_path) const
+{
+    return false;
+}
+
+int Local_File_Handle::read(char *data, unsigned int length, uint64_t offset) const
+{
+    return -1;
+}
+
 std::string Local_Storage::get_program_path()
 {
     return " ";
@@ -105,6 +168,11 @@ Local_Storage::Local_Storage(const std::string &save_directory)
 
 }
 
+Local_Storage::~Local_Storage()
+{
+
+}
+
 const std::string& Local_Storage::get_current_save_directory() const
 {
     return empty_str;
@@ -120,6 +188,11 @@ int Local_Storage::store_data(std::string folder, std::string file, char *data,
     return -1;
 }
 
+int Local_Storage::store_data_deferred(std::string folder, std::string file, const char *data, unsigned int length)
+{
+    return -1;
+}
+
 int Local_Storage::store_data_settings(std::string file, const char *data, unsigned int length)
 {
     return -1;
@@ -130,6 +203,11 @@ int Local_Storage::get_data(std::string folder, std::string file, char *data, un
     return -1;
 }
 
+std::shared_ptr<Local_File_Handle> Local_Storage::open_file(const std::string &full_path)
+{
+    return nullptr;
+}
+
 unsigned int Local_Storage::data_settings_size(std::string file)
 {
     return 0;
@@ -190,6 +268,16 @@ bool Local_Storage::write_json_file(std::string folder, std::string const&file,
     return false;
 }
 
+bool Local_Storage::write_json_file_deferred(std::string folder, std::string const&file, nlohmann::json const& json)
+{
+    return false;
+}
+
+void Local_Storage::flush()
+{
+
+}
+
 std::vector<image_pixel_t> Local_Storage::load_image(std::string const& image_path)
 {
     return std::vector<image_pixel_t>();
@@ -262,6 +350,7 @@ static std::vector<struct File_Data> get_filenames(std::string in_path)
             if (wcscmp(L"..", ffd.cFileName) == 0) continue;
             struct File_Data f_data;
             f_data.name = utf8_encode(ffd.cFileName);
+            if (is_temp_file_name(f_data.name)) continue;
             output.push_back(f_data);
         } while (::FindNextFileW(hFind, &ffd) == TRUE);
         ::FindClose(hFind);
@@ -303,6 +392,11 @@ static std::vector<struct File_Data> get_filenames_recursive_w(std::wstring base
             } else {
                 File_Data f;
                 f.name = utf8_encode(ffd.cFileName);
+                if (is_temp_file_name(f.name)) continue;
+                f.size = (static_cast<uint64_t>(ffd.nFileSizeHigh) << 32) | ffd.nFileSizeLow;
+                // FILETIME counts 100ns intervals since 1601
+                uint64_t write_time = (static_cast<uint64_t>(ffd.ftLastWriteTime.dwHighDateTime) << 32) | ffd.ftLastWriteTime.dwLowDateTime;
+                f.timestamp = write_time > 116444736000000000ULL ? (write_time - 116444736000000000ULL) / 10000000ULL : 0;
                 output.push_back(f);
             }
         } while (::FindNextFileW(hFind, &ffd) == TRUE);
@@ -398,6 +492,7 @@ static std::vector<struct File_Data> get_filenames(std::string strPath)
       if (memcmp(ep->d_name, ".", 2) != 0 && memcmp(ep->d_name, "..", 3) != 0) {
         struct File_Data f_data;
         f_data.name = ep->d_name;
+        if (is_temp_file_name(f_data.name)) continue;
         output.push_back(f_data);
         i++;
       }
@@ -409,7 +504,8 @@ static std::vector<struct File_Data> get_filenames(std::string strPath)
   return output;
 }
 
-static std::vector<struct File_Data> get_filenames_recursive(std::string base_path)
+// 'dirs' gets every directory that was listed
+static std::vector<struct File_Data> get_filenames_recursive(std::string base_path, std::vector<std::string> *dirs = nullptr)
 {
     std::vector<struct File_Data> output;
     std::string path;
@@ -420,6 +516,8 @@ static std::vector<struct File_Data> get_filenames_recursive(std::string base_pa
     if (!dir)
         return output;
 
+    if (dirs) dirs->push_back(base_path);
+
     while ((dp = readdir(dir)) != NULL)
     {
         if (strcmp(dp->d_name, ".") != 0 && strcmp(dp->d_name, "..") != 0)
@@ -427,6 +525,12 @@ static std::vector<struct File_Data> get_filenames_recursive(std::string base_pa
             if (dp->d_type == DT_REG) {
                 File_Data f;
                 f.name = dp->d_name;
+                if (is_temp_file_name(f.name)) continue;
+                struct stat buffer = {};
+                if (fstatat(dirfd(dir), dp->d_name, &buffer, 0) == 0) {
+                    f.size = buffer.st_size;
+                    f.timestamp = buffer.st_mtime;
+                }
                 output.push_back(f);
             } else if (dp->d_type == DT_DIR) {
                 // Construct new path from our base path
@@ -436,7 +540,7 @@ static std::vector<struct File_Data> get_filenames_recursive(std::string base_pa
                 path += "/";
                 path += dir_name;
 
-                std::vector<struct File_Data> lower = get_filenames_recursive(path);
+                std::vector<struct File_Data> lower = get_filenames_recursive(path, dirs);
                 std::transform(lower.begin(), lower.end(), std::back_inserter(output), [&dir_name](File_Data f) {f.name = dir_name + "/" + f.name; return f;});
             }
         }
@@ -537,6 +641,163 @@ static std::string desanitize_file_name(std::string name)
     return name;
 }
 
+static int write_file_atomic(const std::string &full_path, const char *data, unsigned int length)
+{
+    static std::atomic<unsigned long> temp_counter{};
+#if defined(__WINDOWS__)
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    // unique, so a file of the game which happens to be called like 'full_path' + something is never touched
+    std::string temp_name(full_path + TEMP_FILE_MARKER + std::to_string(pid) + "-" + std::to_string(++temp_counter));
+    const auto path(std::filesystem::u8path(full_path));
+    const auto temp_path(std::filesystem::u8path(temp_name));
+
+#if defined(__WINDOWS__)
+    std::FILE *file = _wfopen(temp_path.c_str(), L"wb");
+#else
+    std::FILE *file = std::fopen(temp_path.c_str(), "wb");
+#endif
+    if (!file) return -1;
+
+    bool ok = std::fwrite(data, 1, length, file) == length && std::fflush(file) == 0;
+    // on the disk before the rename, otherwise a power loss may leave an empty file in place of the old one
+#if defined(__WINDOWS__)
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+
+    std::error_code ec{};
+    if (!ok) {
+        std::filesystem::remove(temp_path, ec);
+        return -1;
+    }
+
+    // replaces the old file in one step, on Windows too
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        PRINT_DEBUG("failed to replace '%s': %s", full_path.c_str(), ec.message().c_str());
+        std::filesystem::remove(temp_path, ec);
+        return -1;
+    }
+
+#if !defined(__WINDOWS__)
+    // the rename itself only survives a power loss once the folder is synced
+    int dir = open(path.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+#endif
+
+    return static_cast<int>(length);
+}
+
+static bool stat_file(const std::string &full_path, Indexed_File &indexed)
+{
+#if defined(STEAM_WIN32)
+    struct _stat buffer = {};
+    if (_wstat(utf8_decode(full_path).c_str(), &buffer) != 0 || !(buffer.st_mode & _S_IFREG)) return false;
+#else
+    struct stat buffer = {};
+    if (stat(full_path.c_str(), &buffer) != 0 || !S_ISREG(buffer.st_mode)) return false;
+#endif
+    indexed.size = buffer.st_size;
+    indexed.timestamp = buffer.st_mtime;
+    return true;
+}
+
+static const std::string& pending_data(Pending_Write &write)
+{
+    if (write.is_json) {
+        write.data = write.json.dump(2);
+        write.json = nlohmann::json();
+        write.is_json = false;
+    }
+
+    return write.data;
+}
+
+Local_File_Handle::Local_File_Handle(const std::string &full_path)
+{
+#if defined(__WINDOWS__)
+    // others may still rename over the file or delete it while it's open
+    handle = CreateFileW(utf8_decode(full_path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+    fd = open(full_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+Local_File_Handle::~Local_File_Handle()
+{
+#if defined(__WINDOWS__)
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+#else
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool Local_File_Handle::is_open() const
+{
+#if defined(__WINDOWS__)
+    return handle != INVALID_HANDLE_VALUE;
+#else
+    return fd >= 0;
+#endif
+}
+
+bool Local_File_Handle::is_current(const std::string &full_path) const
+{
+    if (!is_open()) return false;
+
+#if defined(__WINDOWS__)
+    // a file renamed over this path has its own size and write time
+    BY_HANDLE_FILE_INFORMATION opened{};
+    WIN32_FILE_ATTRIBUTE_DATA current{};
+    if (!GetFileInformationByHandle(handle, &opened) || !GetFileAttributesExW(utf8_decode(full_path).c_str(), GetFileExInfoStandard, &current)) return false;
+    return opened.nFileSizeLow == current.nFileSizeLow && opened.nFileSizeHigh == current.nFileSizeHigh &&
+        CompareFileTime(&opened.ftLastWriteTime, &current.ftLastWriteTime) == 0;
+#else
+    // changes made in place are seen through the fd anyway, only a different inode makes it stale
+    struct stat opened{}, current{};
+    if (fstat(fd, &opened) != 0 || stat(full_path.c_str(), &current) != 0) return false;
+    return opened.st_dev == current.st_dev && opened.st_ino == current.st_ino;
+#endif
+}
+
+int Local_File_Handle::read(char *data, unsigned int length, uint64_t offset) const
+{
+    if (!is_open()) return -1;
+
+    unsigned int done = 0;
+    while (done < length) {
+#if defined(__WINDOWS__)
+        // an explicit offset leaves nothing shared between readers
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset + done);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+        DWORD count = 0;
+        if (!ReadFile(handle, data + done, length - done, &count, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            return -1;
+        }
+#else
+        ssize_t count = pread(fd, data + done, length - done, static_cast<off_t>(offset + done));
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+#endif
+        if (count == 0) break;
+        done += static_cast<unsigned int>(count);
+    }
+
+    return static_cast<int>(done);
+}
+
 Local_Storage::Local_Storage(const std::string &save_directory)
 {
     this->save_directory = save_directory;
@@ -546,6 +807,303 @@ Local_Storage::Local_Storage(const std::string &save_directory)
     }
 }
 
+Local_Storage::~Local_Storage()
+{
+    if (flush_worker) {
+        flush_worker->kill();
+        delete flush_worker;
+        flush_worker = nullptr;
+    }
+
+    flush();
+
+#if !defined(__WINDOWS__)
+    if (inotify_fd >= 0) close(inotify_fd);
+#endif
+}
+
+#if !defined(__WINDOWS__)
+void Local_Storage::read_folder_changes()
+{
+    if (inotify_fd < 0) return;
+
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t len;
+    while ((len = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + len; ) {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                PRINT_DEBUG("inotify queue overflow, dropping every folder index");
+                folder_indexes.clear();
+                continue;
+            }
+
+            auto dir = watched_dirs.find(event->wd);
+            if (watched_dirs.end() == dir) continue;
+
+            if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                drop_folder_indexes(dir->second);
+                if (event->mask & IN_IGNORED) watched_dirs.erase(dir);
+                continue;
+            }
+
+            if (!event->len) continue;
+
+            std::string full_path(dir->second + event->name);
+            if (event->mask & IN_ISDIR) {
+                // the new folder needs its own watch, easier to list everything again
+                drop_folder_indexes(full_path);
+            } else {
+                index_file(full_path);
+            }
+        }
+    }
+}
+#endif
+
+Folder_Index &Local_Storage::get_folder_index(const std::string &folder_path)
+{
+#if !defined(__WINDOWS__)
+    read_folder_changes();
+#endif
+
+    auto it = folder_indexes.find(folder_path);
+    if (folder_indexes.end() != it) return it->second;
+
+    std::string base_path(folder_path);
+    if (base_path.size() > 1 && base_path.back() == *PATH_SEPARATOR) base_path.pop_back();
+
+    Folder_Index &index = folder_indexes[folder_path];
+#if defined(__WINDOWS__)
+    std::vector<struct File_Data> files = get_filenames_recursive(base_path);
+#else
+    std::vector<std::string> dirs{};
+    std::vector<struct File_Data> files = get_filenames_recursive(base_path, &dirs);
+
+    if (inotify_fd < 0) inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd >= 0) {
+        for (auto &dir : dirs) {
+            int wd = inotify_add_watch(inotify_fd, dir.c_str(), IN_CREATE | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+            if (wd >= 0) watched_dirs[wd] = dir + PATH_SEPARATOR;
+        }
+    }
+#endif
+
+    for (auto &f : files) {
+        index.files[f.name] = Indexed_File{ f.size, f.timestamp };
+    }
+
+    PRINT_DEBUG("indexed %zu files in '%s'", index.files.size(), folder_path.c_str());
+    reset_LastError();
+    return index;
+}
+
+// drops the indexes of 'path' itself, the folders containing it and the ones inside it
+void Local_Storage::drop_folder_indexes(const std::string &path)
+{
+    for (auto it = folder_indexes.begin(); it != folder_indexes.end(); ) {
+        if (path.compare(0, it->first.size(), it->first) == 0 || it->first.compare(0, path.size(), path) == 0) {
+            it = folder_indexes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Local_Storage::index_file(const std::string &full_path)
+{
+    if (is_temp_file_name(full_path)) return;
+
+    // changed by someone else, the open file might not be the one at this path anymore
+    drop_file_handle(full_path);
+    if (folder_indexes.empty()) return;
+
+    Indexed_File indexed{};
+    bool exists = stat_file(full_path, indexed);
+    for (auto &index : folder_indexes) {
+        if (full_path.size() <= index.first.size() || full_path.compare(0, index.first.size(), index.first) != 0) continue;
+
+        std::string name(full_path.substr(index.first.size()));
+        if (exists) {
+            auto res = index.second.files.insert_or_assign(name, indexed);
+            if (res.second) index.second.listing_valid = false;
+        } else if (index.second.files.erase(name)) {
+            index.second.listing_valid = false;
+        }
+    }
+}
+
+void Local_Storage::file_changed(const std::string &full_path)
+{
+    std::lock_guard lock(index_mutex);
+    index_file(full_path);
+}
+
+std::shared_ptr<Local_File_Handle> Local_Storage::open_file(const std::string &full_path)
+{
+    std::lock_guard lock(handles_mutex);
+    auto it = file_handles.find(full_path);
+    if (file_handles.end() != it) {
+        // the folder may not be watched (never indexed, or a workshop path outside the saves), so check the file itself
+        if (it->second.handle->is_current(full_path)) {
+            it->second.last_used = ++file_handles_clock;
+            return it->second.handle;
+        }
+
+        PRINT_DEBUG("'%s' was replaced, opening it again", full_path.c_str());
+        file_handles.erase(it);
+    }
+
+    auto handle = std::make_shared<Local_File_Handle>(full_path);
+    if (!handle->is_open()) {
+        reset_LastError();
+        return nullptr;
+    }
+
+    if (file_handles.size() >= MAX_OPEN_FILE_HANDLES) {
+        auto oldest = std::min_element(file_handles.begin(), file_handles.end(), [](const auto &a, const auto &b) {
+            return a.second.last_used < b.second.last_used;
+        });
+        // whoever is still reading from it keeps it open
+        file_handles.erase(oldest);
+    }
+
+    file_handles[full_path] = Cached_File_Handle{ handle, ++file_handles_clock };
+    return handle;
+}
+
+void Local_Storage::drop_file_handle(const std::string &full_path)
+{
+    std::lock_guard lock(handles_mutex);
+    file_handles.erase(full_path);
+}
+
+bool Local_Storage::find_indexed_file(std::string folder, std::string file, Indexed_File &indexed)
+{
+    file = sanitize_file_name(file);
+    if (folder.size() && folder.back() != *PATH_SEPARATOR) {
+        folder.append(PATH_SEPARATOR);
+    }
+
+    std::string folder_path(save_directory + appid + folder);
+    std::unique_lock lock(index_mutex);
+    // the root holds every other folder, listing and watching all of them to find one file isn't worth it
+    if (folder.empty() && folder_indexes.end() == folder_indexes.find(folder_path)) {
+        lock.unlock();
+        bool found = stat_file(folder_path + file, indexed);
+        reset_LastError();
+        return found;
+    }
+
+    const Folder_Index &index = get_folder_index(folder_path);
+    auto it = index.files.find(file);
+    if (index.files.end() == it) return false;
+
+    indexed = it->second;
+    return true;
+}
+
+void Local_Storage::add_pending_write(std::string &&full_path, Pending_Write &&write)
+{
+    std::lock_guard lock(pending_mutex);
+    write.modified = std::time(nullptr);
+    write.dirty_since = std::chrono::steady_clock::now();
+    write.generation = ++pending_generation;
+
+    auto it = pending_writes.find(full_path);
+    if (pending_writes.end() != it) {
+        // keep the time it first became dirty, or a file rewritten every frame would never be flushed
+        write.dirty_since = it->second.dirty_since;
+        it->second = std::move(write);
+    } else {
+        pending_writes.emplace(std::move(full_path), std::move(write));
+    }
+
+    // started on the first deferred write rather than in the constructor, which may run while the module is being loaded
+    if (!flush_worker) {
+        flush_worker = new common_helpers::KillableWorker(
+            [this](void *){ return flush_worker_proc(); },
+            std::chrono::milliseconds(WRITE_BEHIND_POLL_MS),
+            std::chrono::milliseconds(WRITE_BEHIND_POLL_MS)
+        );
+        flush_worker->start();
+    }
+}
+
+template<typename Visitor>
+bool Local_Storage::visit_pending_write(const std::string &full_path, Visitor visit)
+{
+    std::lock_guard lock(pending_mutex);
+    auto it = pending_writes.find(full_path);
+    if (pending_writes.end() == it) return false;
+
+    visit(it->second);
+    return true;
+}
+
+bool Local_Storage::drop_pending_write(const std::string &full_path)
+{
+    std::lock_guard lock(pending_mutex);
+    return pending_writes.erase(full_path) > 0;
+}
+
+void Local_Storage::flush_pending(const std::string &prefix, bool all)
+{
+    std::lock_guard flush_lock(flush_mutex);
+    struct Flushed_Write {
+        std::string full_path{};
+        std::string data{};
+        uint64_t generation{};
+    };
+    std::vector<Flushed_Write> writes{};
+    {
+        std::lock_guard lock(pending_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = pending_writes.lower_bound(prefix); it != pending_writes.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            if (all || now - it->second.dirty_since >= std::chrono::seconds(WRITE_BEHIND_DELAY_SECONDS)) {
+                // the entry stays until the file is on disk, readers keep getting the new contents from it meanwhile
+                writes.push_back(Flushed_Write{ it->first, pending_data(it->second), it->second.generation });
+            }
+        }
+    }
+
+    for (auto &write : writes) {
+        const std::string &full_path = write.full_path;
+        const std::string &data = write.data;
+        std::string::size_type pos = full_path.rfind(PATH_SEPARATOR);
+        if (pos != std::string::npos) create_directory(full_path.substr(0, pos));
+        drop_file_handle(full_path);
+
+        if (write_file_atomic(full_path, data.data(), static_cast<unsigned int>(data.size())) < 0) {
+            PRINT_DEBUG("failed to flush '%s', will retry", full_path.c_str());
+            continue;
+        }
+
+        file_changed(full_path);
+        std::lock_guard lock(pending_mutex);
+        auto it = pending_writes.find(full_path);
+        // unless it was written again in the meantime
+        if (pending_writes.end() != it && it->second.generation == write.generation) {
+            pending_writes.erase(it);
+        }
+    }
+
+    reset_LastError();
+}
+
+bool Local_Storage::flush_worker_proc()
+{
+    flush_pending(std::string(), false);
+    return false;
+}
+
+void Local_Storage::flush()
+{
+    flush_pending(std::string(), true);
+}
+
 const std::string& Local_Storage::get_current_save_directory() const
 {
     return this->save_directory;
@@ -573,13 +1131,7 @@ int Local_Storage::store_file_data(std::string folder, std::string file, const c
     }
 
     create_directory(folder + file_folder);
-    std::ofstream myfile;
-    myfile.open(std::filesystem::u8path(folder + file), std::ios::binary | std::ios::out);
-    if (!myfile.is_open()) return -1;
-    myfile.write(data, length);
-    int position = myfile.tellp();
-    myfile.close();
-    return position;
+    return write_file_atomic(folder + file, data, length);
 }
 
 std::string Local_Storage::get_path(std::string folder)
@@ -647,7 +1199,26 @@ int Local_Storage::store_data(std::string folder, std::string file, char *data,
         folder.append(PATH_SEPARATOR);
     }
 
-    return store_file_data(save_directory + appid + folder, file, data, length);
+    // a deferred copy of this file must not be flushed over this one later
+    std::lock_guard flush_lock(flush_mutex);
+    std::string full_path(save_directory + appid + folder + sanitize_file_name(file));
+    drop_pending_write(full_path);
+    drop_file_handle(full_path);
+    int ret = store_file_data(save_directory + appid + folder, file, data, length);
+    file_changed(full_path);
+    return ret;
+}
+
+int Local_Storage::store_data_deferred(std::string folder, std::string file, const char *data, unsigned int length)
+{
+    if (folder.size() && folder.back() != *PATH_SEPARATOR) {
+        folder.append(PATH_SEPARATOR);
+    }
+
+    Pending_Write write{};
+    write.data.assign(data, length);
+    add_pending_write(save_directory + appid + folder + sanitize_file_name(file), std::move(write));
+    return length;
 }
 
 int Local_Storage::store_data_settings(std::string file, const char *data, unsigned int length)
@@ -676,7 +1247,19 @@ int Local_Storage::get_data(std::string folder, std::string file, char *data, un
     }
 
     std::string full_path(save_directory + appid + folder + file);
-    return get_file_data(full_path, data, max_length, offset);
+    int count = 0;
+    bool pending = visit_pending_write(full_path, [&](Pending_Write &write) {
+        const std::string &pending_str = pending_data(write);
+        if (offset >= pending_str.size()) return;
+
+        count = static_cast<int>(std::min<size_t>(max_length, pending_str.size() - offset));
+        memcpy(data, pending_str.data() + offset, count);
+    });
+    if (pending) return count;
+
+    auto handle = open_file(full_path);
+    if (!handle) return -1;
+    return handle->read(data, max_length, offset);
 }
 
 unsigned int Local_Storage::data_settings_size(std::string file)
@@ -699,7 +1282,10 @@ int Local_Storage::count_files(std::string folder)
         folder.append(PATH_SEPARATOR);
     }
 
-    return get_filenames_recursive(save_directory + appid + folder).size();
+    // deferred files that were never written wouldn't be listed otherwise
+    flush_pending(save_directory + appid + folder, true);
+    std::lock_guard lock(index_mutex);
+    return static_cast<int>(get_folder_index(save_directory + appid + folder).files.size());
 }
 
 bool Local_Storage::file_exists(std::string folder, std::string file)
@@ -710,7 +1296,10 @@ bool Local_Storage::file_exists(std::string folder, std::string file)
     }
 
     std::string full_path(save_directory + appid + folder + file);
-    return file_exists_(full_path);
+    if (visit_pending_write(full_path, [](Pending_Write &) {})) return true;
+
+    Indexed_File indexed{};
+    return find_indexed_file(folder, file, indexed);
 }
 
 unsigned int Local_Storage::file_size(std::string folder, std::string file)
@@ -721,7 +1310,12 @@ unsigned int Local_Storage::file_size(std::string folder, std::string file)
     }
 
     std::string full_path(save_directory + appid + folder + file);
-    return file_size_(full_path);
+    unsigned int size = 0;
+    if (visit_pending_write(full_path, [&](Pending_Write &write) { size = static_cast<unsigned int>(pending_data(write).size()); })) return size;
+
+    Indexed_File indexed{};
+    if (!find_indexed_file(folder, file, indexed)) return 0;
+    return static_cast<unsigned int>(indexed.size);
 }
 
 bool Local_Storage::file_delete(std::string folder, std::string file)
@@ -732,11 +1326,16 @@ bool Local_Storage::file_delete(std::string folder, std::string file)
     }
 
     std::string full_path(save_directory + appid + folder + file);
+    std::lock_guard flush_lock(flush_mutex);
+    bool was_pending = drop_pending_write(full_path);
+    drop_file_handle(full_path);
 #if defined(STEAM_WIN32)
-    return _wremove(utf8_decode(full_path).c_str()) == 0;
+    bool removed = _wremove(utf8_decode(full_path).c_str()) == 0;
 #else
-    return remove(full_path.c_str()) == 0;
+    bool removed = remove(full_path.c_str()) == 0;
 #endif
+    file_changed(full_path);
+    return removed || was_pending;
 }
 
 uint64_t Local_Storage::file_timestamp(std::string folder, std::string file)
@@ -747,15 +1346,12 @@ uint64_t Local_Storage::file_timestamp(std::string folder, std::string file)
     }
 
     std::string full_path(save_directory + appid + folder + file);
+    uint64_t modified = 0;
+    if (visit_pending_write(full_path, [&](Pending_Write &write) { modified = write.modified; })) return modified;
 
-#if defined(STEAM_WIN32)
-    struct _stat buffer = {};
-    if (_wstat(utf8_decode(full_path).c_str(), &buffer) != 0) return 0;
-#else
-    struct stat buffer = {};
-    if (stat (full_path.c_str(), &buffer) != 0) return 0;
-#endif
-    return buffer.st_mtime;
+    Indexed_File indexed{};
+    if (!find_indexed_file(folder, file, indexed)) return 0;
+    return indexed.timestamp;
 }
 
 bool Local_Storage::iterate_file(std::string folder, int index, char *output_filename, int32 *output_size)
@@ -764,11 +1360,23 @@ bool Local_Storage::iterate_file(std::string folder, int index, char *output_fil
         folder.append(PATH_SEPARATOR);
     }
 
-    std::vector<struct File_Data> files = get_filenames_recursive(save_directory + appid + folder);
-    if (index < 0 || static_cast<size_t>(index) >= files.size()) return false;
+    flush_pending(save_directory + appid + folder, true);
+    std::lock_guard lock(index_mutex);
+    Folder_Index &folder_index = get_folder_index(save_directory + appid + folder);
+    if (!folder_index.listing_valid) {
+        folder_index.listing.clear();
+        folder_index.listing.reserve(folder_index.files.size());
+        for (auto it = folder_index.files.cbegin(); it != folder_index.files.cend(); ++it) {
+            folder_index.listing.push_back(it);
+        }
+        folder_index.listing_valid = true;
+    }
+
+    if (index < 0 || static_cast<size_t>(index) >= folder_index.listing.size()) return false;
 
-    std::string name(desanitize_file_name(files[index].name));
-    if (output_size) *output_size = file_size(folder, name);
+    auto file = folder_index.listing[index];
+    std::string name(desanitize_file_name(file->first));
+    if (output_size) *output_size = static_cast<int32>(file->second.size);
 #if defined(STEAM_WIN32)
     name = replace_with(name, PATH_SEPARATOR, "/");
 #endif
@@ -798,11 +1406,24 @@ bool Local_Storage::update_save_filenames(std::string folder)
         }
     }
 
+    std::lock_guard lock(index_mutex);
+    drop_folder_indexes(save_directory + appid + folder);
     return true;
 }
 
 bool Local_Storage::load_json(const std::string &full_path, nlohmann::json& json)
 {
+    bool parsed = false;
+    bool pending = visit_pending_write(full_path, [&](Pending_Write &write) {
+        try {
+            json = write.is_json ? write.json : nlohmann::json::parse(write.data);
+            parsed = true;
+        } catch (const std::exception& e) {
+            PRINT_DEBUG("Error while parsing pending '%s' json error: %s", full_path.c_str(), e.what());
+        }
+    });
+    if (pending) return parsed;
+
     std::ifstream inventory_file(std::filesystem::u8path(full_path), std::ios::in | std::ios::binary);
     // If there is a file and we opened it
     if (inventory_file) {
@@ -842,9 +1463,12 @@ bool Local_Storage::write_json_file(std::string folder, std::string const&file,
 
     create_directory(inv_path);
 
-    std::ofstream inventory_file(std::filesystem::u8path(full_path), std::ios::trunc | std::ios::out | std::ios::binary);
-    if (inventory_file) {
-        inventory_file << std::setw(2) << json;
+    std::string data(json.dump(2));
+    std::lock_guard flush_lock(flush_mutex);
+    drop_pending_write(full_path);
+    drop_file_handle(full_path);
+    if (write_file_atomic(full_path, data.data(), static_cast<unsigned int>(data.size())) >= 0) {
+        file_changed(full_path);
         return true;
     }
     
@@ -854,6 +1478,19 @@ bool Local_Storage::write_json_file(std::string folder, std::string const&file,
     return false;
 }
 
+bool Local_Storage::write_json_file_deferred(std::string folder, std::string const&file, nlohmann::json const& json)
+{
+    if (!folder.empty() && folder.back() != *PATH_SEPARATOR) {
+        folder.append(PATH_SEPARATOR);
+    }
+
+    Pending_Write write{};
+    write.json = json;
+    write.is_json = true;
+    add_pending_write(save_directory + appid + folder + file, std::move(write));
+    return true;
+}
+
 std::vector<image_pixel_t> Local_Storage::load_image(std::string const& image_path)
 {
     std::vector<image_pixel_t> res{};
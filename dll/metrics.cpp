@@ -0,0 +1,460 @@
+/* Copyright (C) 2019 Mr Goldberg
+   This file is part of the Goldberg Emulator
+
+   The Goldberg Emulator is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   The Goldberg Emulator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the Goldberg Emulator; if not, see
+   <http://www.gnu.org/licenses/>.  */
+
+#include "dll/metrics.h"
+#include "dll/network.h"
+
+#if defined(__LINUX__)
+#include <signal.h>
+#endif
+
+// histograms are log-linear like HdrHistogram: each power of 2 is split in 2^METRICS_SUB_BUCKET_BITS buckets,
+// so any recorded value is off by at most 1/8 (12.5%) in a snapshot
+#define METRICS_SUB_BUCKET_BITS 3
+#define METRICS_SUB_BUCKETS (1u << METRICS_SUB_BUCKET_BITS)
+#define METRICS_HISTOGRAM_BUCKETS (METRICS_SUB_BUCKETS * (64 - METRICS_SUB_BUCKET_BITS + 1))
+
+static const char *counter_names[] = {
+    "runcallbacks",
+    "call_results_dispatched",
+    "global_mutex_contended",
+};
+static_assert(sizeof(counter_names) / sizeof(counter_names[0]) == METRIC_COUNTERS_MAX, "a counter has no name");
+
+static const struct {
+    const char *name;
+    const char *unit;
+} histogram_names[] = {
+    { "runcallbacks_total", "ns" },
+    { "runcallbacks_network", "ns" },
+    { "runcallbacks_matchmaking_servers", "ns" },
+    { "runcallbacks_run_every_runcb", "ns" },
+    { "runcallbacks_gameserver", "ns" },
+    { "runcallbacks_call_results_client", "ns" },
+    { "runcallbacks_call_results_server", "ns" },
+    { "runcallbacks_callbacks", "ns" },
+    { "global_mutex_wait", "ns" },
+    { "call_result_age", "ns" },
+    { "call_results_pending", "results" },
+    { "call_results_ready", "results" },
+    { "callbacks_queued", "callbacks" },
+};
+static_assert(sizeof(histogram_names) / sizeof(histogram_names[0]) == METRIC_HISTOGRAMS_MAX, "a histogram has no name");
+
+// same order as Callback_Ids
+static const char *channel_names[] = {
+    "user_status",
+    "lobby",
+    "networking",
+    "gameserver",
+    "friend",
+    "auth_ticket",
+    "friend_messages",
+    "networking_sockets",
+    "steam_messages",
+    "networking_messages",
+    "gameserver_stats",
+    "leaderboards_stats",
+};
+static_assert(sizeof(channel_names) / sizeof(channel_names[0]) == CALLBACK_IDS_MAX, "a network channel has no name");
+static_assert(CALLBACK_IDS_MAX <= METRICS_NETWORK_CHANNELS, "METRICS_NETWORK_CHANNELS is too small");
+
+struct Metrics_Histogram {
+    std::atomic<uint64> count{};
+    std::atomic<uint64> sum{};
+    std::atomic<uint64> max{};
+    std::atomic<uint64> buckets[METRICS_HISTOGRAM_BUCKETS]{};
+};
+
+// only written by its own thread, read by whoever writes a snapshot
+struct Metrics_Thread {
+    std::atomic<uint64> counters[METRIC_COUNTERS_MAX]{};
+    std::atomic<uint64> packets[2][METRICS_NETWORK_CHANNELS]{};
+    std::atomic<uint64> bytes[2][METRICS_NETWORK_CHANNELS]{};
+    struct Metrics_Histogram histograms[METRIC_HISTOGRAMS_MAX]{};
+};
+
+struct Metrics_Registry {
+    std::mutex mutex{};
+    // threads that are still running
+    std::vector<struct Metrics_Thread *> threads{};
+    // the numbers of the threads that exited, their blocks go to 'free_threads' for the next new thread
+    struct Metrics_Thread retired{};
+    size_t retired_threads{};
+    std::vector<struct Metrics_Thread *> free_threads{};
+    std::string path{};
+    double interval{};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+std::atomic<bool> metrics_detail::enabled{};
+static std::atomic<bool> dump_requested{};
+static thread_local struct Metrics_Thread *thread_metrics = nullptr;
+static thread_local bool thread_metrics_retired = false;
+
+static Metrics_Registry *get_registry()
+{
+    // never freed, metrics may still be recorded while the static destructors run
+    static Metrics_Registry *registry = new Metrics_Registry();
+    return registry;
+}
+
+// single writer, so there is no need for an atomic read-modify-write
+static inline void bump(std::atomic<uint64> &value, uint64 by)
+{
+    value.store(value.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+static void fold_thread(struct Metrics_Thread &to, const struct Metrics_Thread &from)
+{
+    for (unsigned i = 0; i < METRIC_COUNTERS_MAX; ++i) {
+        bump(to.counters[i], from.counters[i].load(std::memory_order_relaxed));
+    }
+
+    for (unsigned d = 0; d < 2; ++d) {
+        for (unsigned c = 0; c < METRICS_NETWORK_CHANNELS; ++c) {
+            bump(to.packets[d][c], from.packets[d][c].load(std::memory_order_relaxed));
+            bump(to.bytes[d][c], from.bytes[d][c].load(std::memory_order_relaxed));
+        }
+    }
+
+    for (unsigned i = 0; i < METRIC_HISTOGRAMS_MAX; ++i) {
+        auto &from_h = from.histograms[i];
+        auto &to_h = to.histograms[i];
+        bump(to_h.count, from_h.count.load(std::memory_order_relaxed));
+        bump(to_h.sum, from_h.sum.load(std::memory_order_relaxed));
+        to_h.max.store(std::max(to_h.max.load(std::memory_order_relaxed), from_h.max.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        for (unsigned b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b) {
+            bump(to_h.buckets[b], from_h.buckets[b].load(std::memory_order_relaxed));
+        }
+    }
+}
+
+// folds the block of an exiting thread into the retired totals and keeps it for the next thread
+struct Metrics_Thread_Owner {
+    ~Metrics_Thread_Owner()
+    {
+        thread_metrics_retired = true;
+        if (!thread_metrics) return;
+
+        auto registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        fold_thread(registry->retired, *thread_metrics);
+        ++registry->retired_threads;
+        auto it = std::find(registry->threads.begin(), registry->threads.end(), thread_metrics);
+        if (it != registry->threads.end()) registry->threads.erase(it);
+
+        thread_metrics->~Metrics_Thread();
+        new (thread_metrics) Metrics_Thread();
+        registry->free_threads.push_back(thread_metrics);
+        thread_metrics = nullptr;
+    }
+};
+
+static thread_local Metrics_Thread_Owner thread_metrics_owner{};
+
+static struct Metrics_Thread *get_thread_metrics()
+{
+    if (!thread_metrics) {
+        // recorded by a thread_local destructor that ran after ours, there is no block to hand out anymore
+        if (thread_metrics_retired) {
+            static struct Metrics_Thread *dropped = new Metrics_Thread();
+            return dropped;
+        }
+
+        auto registry = get_registry();
+        {
+            std::lock_guard<std::mutex> lock(registry->mutex);
+            if (registry->free_threads.size()) {
+                thread_metrics = registry->free_threads.back();
+                registry->free_threads.pop_back();
+            } else {
+                thread_metrics = new Metrics_Thread();
+            }
+
+            registry->threads.push_back(thread_metrics);
+        }
+
+        // constructs the owner, so its destructor runs when this thread exits
+        (void)&thread_metrics_owner;
+    }
+
+    return thread_metrics;
+}
+
+static unsigned highest_bit(uint64 value)
+{
+    unsigned bit = 0;
+    if (value >> 32) { value >>= 32; bit += 32; }
+    if (value >> 16) { value >>= 16; bit += 16; }
+    if (value >> 8) { value >>= 8; bit += 8; }
+    if (value >> 4) { value >>= 4; bit += 4; }
+    if (value >> 2) { value >>= 2; bit += 2; }
+    if (value >> 1) { bit += 1; }
+    return bit;
+}
+
+static unsigned bucket_index(uint64 value)
+{
+    if (value < METRICS_SUB_BUCKETS) return (unsigned)value;
+
+    unsigned shift = highest_bit(value) - METRICS_SUB_BUCKET_BITS;
+    return (shift + 1) * METRICS_SUB_BUCKETS + (unsigned)((value >> shift) & (METRICS_SUB_BUCKETS - 1));
+}
+
+// smallest value that lands in 'index'
+static uint64 bucket_lowest(unsigned index)
+{
+    if (index < METRICS_SUB_BUCKETS) return index;
+
+    unsigned shift = index / METRICS_SUB_BUCKETS - 1;
+    return (uint64)(METRICS_SUB_BUCKETS + index % METRICS_SUB_BUCKETS) << shift;
+}
+
+// largest value that lands in 'index'
+static uint64 bucket_highest(unsigned index)
+{
+    if (index + 1 >= METRICS_HISTOGRAM_BUCKETS) return std::numeric_limits<uint64>::max();
+    return bucket_lowest(index + 1) - 1;
+}
+
+void metrics_detail::add(Metric_Counters counter, uint64 value)
+{
+    bump(get_thread_metrics()->counters[counter], value);
+}
+
+void metrics_detail::record(Metric_Histograms histogram, uint64 value)
+{
+    auto &h = get_thread_metrics()->histograms[histogram];
+    bump(h.count, 1);
+    bump(h.sum, value);
+    bump(h.buckets[bucket_index(value)], 1);
+    if (value > h.max.load(std::memory_order_relaxed)) h.max.store(value, std::memory_order_relaxed);
+}
+
+void metrics_detail::network(Metric_Direction direction, unsigned channel, uint64 bytes)
+{
+    if (channel >= METRICS_NETWORK_CHANNELS) return;
+
+    auto t = get_thread_metrics();
+    bump(t->packets[direction][channel], 1);
+    bump(t->bytes[direction][channel], bytes);
+}
+
+Metrics_Timer::Metrics_Timer(Metric_Histograms histogram)
+{
+    if (!metrics_enabled()) return;
+
+    this->histogram = histogram;
+    start = std::chrono::high_resolution_clock::now();
+    active = true;
+}
+
+Metrics_Timer::~Metrics_Timer()
+{
+    stop();
+}
+
+void Metrics_Timer::next(Metric_Histograms histogram)
+{
+    if (!active) return;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    metrics_record(this->histogram, now - start);
+    this->histogram = histogram;
+    start = now;
+}
+
+void Metrics_Timer::stop()
+{
+    if (!active) return;
+
+    metrics_record(histogram, std::chrono::high_resolution_clock::now() - start);
+    active = false;
+}
+
+#if defined(__LINUX__)
+static void dump_signal_handler(int sig)
+{
+    metrics_request_dump();
+}
+
+// SIGUSR1 writes a snapshot, unless the game already handles that signal itself
+static void install_dump_signal()
+{
+    struct sigaction old_action{};
+    if (sigaction(SIGUSR1, nullptr, &old_action) != 0) return;
+    if (old_action.sa_handler != SIG_DFL || (old_action.sa_flags & SA_SIGINFO)) {
+        PRINT_DEBUG("SIGUSR1 is already handled by the game, metrics snapshots won't be written on signal");
+        return;
+    }
+
+    struct sigaction action{};
+    action.sa_handler = &dump_signal_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR1, &action, nullptr) == 0) {
+        PRINT_DEBUG("send SIGUSR1 to write a metrics snapshot");
+    }
+}
+#endif
+
+void metrics_configure(const std::string &path, double interval)
+{
+    auto registry = get_registry();
+    {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        registry->path = path;
+        registry->interval = path.empty() ? 0 : std::max(0.0, interval);
+    }
+
+    metrics_detail::enabled = !path.empty();
+#if defined(__LINUX__)
+    if (path.size()) install_dump_signal();
+#endif
+}
+
+double metrics_dump_interval()
+{
+    auto registry = get_registry();
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    return registry->interval;
+}
+
+static nlohmann::json histogram_json(const struct Metrics_Histogram &h, const char *unit)
+{
+    nlohmann::json json{};
+    uint64 count = h.count.load(std::memory_order_relaxed);
+    uint64 sum = h.sum.load(std::memory_order_relaxed);
+    json["unit"] = unit;
+    json["count"] = count;
+    json["sum"] = sum;
+    json["max"] = h.max.load(std::memory_order_relaxed);
+    json["mean"] = count ? (double)sum / (double)count : 0.0;
+
+    static const struct {
+        const char *name;
+        double quantile;
+    } percentiles[] = {
+        { "p50", 0.50 },
+        { "p90", 0.90 },
+        { "p99", 0.99 },
+        { "p999", 0.999 },
+    };
+
+    // highest value of the bucket holding the quantile, never past the real max
+    for (const auto &p : percentiles) {
+        uint64 target = (uint64)std::ceil(p.quantile * (double)count);
+        uint64 seen = 0;
+        uint64 value = 0;
+        for (unsigned i = 0; i < METRICS_HISTOGRAM_BUCKETS && count; ++i) {
+            seen += h.buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                value = std::min(bucket_highest(i), h.max.load(std::memory_order_relaxed));
+                break;
+            }
+        }
+
+        json[p.name] = value;
+    }
+
+    // only the used buckets, as [lowest value, count]
+    nlohmann::json buckets = nlohmann::json::array();
+    for (unsigned i = 0; i < METRICS_HISTOGRAM_BUCKETS; ++i) {
+        uint64 n = h.buckets[i].load(std::memory_order_relaxed);
+        if (n) buckets.push_back({ bucket_lowest(i), n });
+    }
+
+    json["buckets"] = buckets;
+    return json;
+}
+
+void metrics_dump()
+{
+    if (!metrics_enabled()) return;
+
+    auto registry = get_registry();
+    std::string path{};
+    // too big for some game threads' stacks
+    auto total = std::make_unique<Metrics_Thread>();
+    size_t threads = 0;
+    double uptime = 0;
+    {
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        path = registry->path;
+        threads = registry->threads.size() + registry->retired_threads;
+        uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - registry->start).count();
+        fold_thread(*total, registry->retired);
+        for (auto t : registry->threads) {
+            fold_thread(*total, *t);
+        }
+    }
+
+    if (path.empty()) return;
+
+    nlohmann::json json{};
+    json["uptime"] = uptime;
+    json["threads"] = threads;
+
+    for (unsigned i = 0; i < METRIC_COUNTERS_MAX; ++i) {
+        json["counters"][counter_names[i]] = total->counters[i].load(std::memory_order_relaxed);
+    }
+
+    for (unsigned c = 0; c < CALLBACK_IDS_MAX; ++c) {
+        auto &channel = json["network"][channel_names[c]];
+        channel["packets_in"] = total->packets[METRIC_NETWORK_IN][c].load(std::memory_order_relaxed);
+        channel["bytes_in"] = total->bytes[METRIC_NETWORK_IN][c].load(std::memory_order_relaxed);
+        channel["packets_out"] = total->packets[METRIC_NETWORK_OUT][c].load(std::memory_order_relaxed);
+        channel["bytes_out"] = total->bytes[METRIC_NETWORK_OUT][c].load(std::memory_order_relaxed);
+    }
+
+    for (unsigned i = 0; i < METRIC_HISTOGRAMS_MAX; ++i) {
+        json["histograms"][histogram_names[i].name] = histogram_json(total->histograms[i], histogram_names[i].unit);
+    }
+
+    // write next to it first, so whatever reads the snapshot never sees half of one
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(std::filesystem::u8path(temp_path), std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            PRINT_DEBUG("failed to open '%s'", temp_path.c_str());
+            return;
+        }
+
+        file << std::setw(2) << json << std::endl;
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(std::filesystem::u8path(temp_path), std::filesystem::u8path(path), ec);
+    if (ec) {
+        PRINT_DEBUG("failed to write '%s': %s", path.c_str(), ec.message().c_str());
+    } else {
+        PRINT_DEBUG("wrote metrics snapshot '%s'", path.c_str());
+    }
+}
+
+void metrics_request_dump()
+{
+    dump_requested.store(true, std::memory_order_relaxed);
+}
+
+void metrics_dump_pending()
+{
+    if (dump_requested.load(std::memory_order_relaxed) && dump_requested.exchange(false)) {
+        metrics_dump();
+    }
+}
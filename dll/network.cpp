@@ -17,6 +17,7 @@
 
 #include "dll/network.h"
 #include "dll/dll.h"
+#include "dll/metrics.h"
 
 #define MAX_BROADCASTS 16
 static int number_broadcasts = -1;
@@ -30,6 +31,31 @@ static uint32_t upper_range_ips[MAX_BROADCASTS];
 
 #define MAX_UDP_SIZE 16384
 
+// unreliable messages of MAX_UDP_SIZE or more are sent as fragments of this size
+#define UDP_FRAGMENT_SIZE 1200
+// messages needing more fragments than this are still sent over TCP
+#define UDP_FRAGMENT_MAX_COUNT 1024
+// total memory held by incomplete messages, the oldest ones are dropped past this
+// an incomplete message is charged for its slot of every fragment up front, then for each fragment's buffer
+#define UDP_REASSEMBLY_MAX_SIZE (4 * 1024 * 1024)
+// incomplete messages older than this are dropped, in seconds
+#define UDP_REASSEMBLY_TIMEOUT 2.0
+
+// max datagrams moved by a single recvmmsg()/sendmmsg() call
+#define UDP_BATCH_SIZE 32
+
+struct UDP_Batch {
+    char data[UDP_BATCH_SIZE][MAX_UDP_SIZE];
+    IP_PORT ip_port[UDP_BATCH_SIZE];
+    int length[UDP_BATCH_SIZE];
+};
+
+// max events fetched by a single epoll_wait() call
+#define MAX_EPOLL_EVENTS 64
+
+// max time the network I/O thread sleeps while no socket is ready
+#define IO_THREAD_WAIT_MS 4
+
 #if defined(STEAM_WIN32)
 
 //windows xp support
@@ -322,14 +348,93 @@ static int receive_packet(sock_t sock, IP_PORT *ip_port, char *data, unsigned lo
     return -1;
 }
 
-static bool send_broadcasts(sock_t sock, uint16 port, char *data, unsigned long length, std::vector<IP_PORT> *custom_broadcasts)
+// receive up to UDP_BATCH_SIZE datagrams, returns how many were received
+// a return value less than UDP_BATCH_SIZE means the socket has no more pending datagrams
+static int receive_packets(sock_t sock, struct UDP_Batch *batch)
+{
+#if defined(__LINUX__)
+    struct mmsghdr msgs[UDP_BATCH_SIZE]{};
+    struct iovec iovecs[UDP_BATCH_SIZE];
+    struct sockaddr_storage addrs[UDP_BATCH_SIZE];
+    for (int i = 0; i < UDP_BATCH_SIZE; ++i) {
+        iovecs[i].iov_base = batch->data[i];
+        iovecs[i].iov_len = MAX_UDP_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    }
+
+    int count = recvmmsg(sock, msgs, UDP_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (count <= 0) return 0;
+
+    for (int i = 0; i < count; ++i) {
+        struct sockaddr_in *addr_in = (struct sockaddr_in *)&addrs[i];
+        batch->ip_port[i].ip = addr_in->sin_addr.s_addr;
+        batch->ip_port[i].port = addr_in->sin_port;
+        batch->length[i] = static_cast<int>(msgs[i].msg_len);
+    }
+
+    return count;
+#else
+    int count = 0;
+    while (count < UDP_BATCH_SIZE) {
+        int len = receive_packet(sock, &batch->ip_port[count], batch->data[count], MAX_UDP_SIZE);
+        if (len < 0) break;
+
+        batch->length[count] = len;
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+// send 'count' datagrams, datagram i is sent to ip_ports[i]
+static void send_packets_to(sock_t sock, const IP_PORT *ip_ports, char *const *datas, const unsigned long *lengths, unsigned count)
+{
+#if defined(__LINUX__)
+    while (count) {
+        unsigned batch_count = count < UDP_BATCH_SIZE ? count : UDP_BATCH_SIZE;
+        struct mmsghdr msgs[UDP_BATCH_SIZE]{};
+        struct iovec iovecs[UDP_BATCH_SIZE];
+        struct sockaddr_in addrs[UDP_BATCH_SIZE]{};
+        for (unsigned i = 0; i < batch_count; ++i) {
+            PRINT_DEBUG("send: %lu %hhu.%hhu.%hhu.%hhu:%hu", lengths[i], ((unsigned char *)&ip_ports[i].ip)[0], ((unsigned char *)&ip_ports[i].ip)[1], ((unsigned char *)&ip_ports[i].ip)[2], ((unsigned char *)&ip_ports[i].ip)[3], htons(ip_ports[i].port));
+            addrs[i].sin_family = AF_INET;
+            addrs[i].sin_addr.s_addr = ip_ports[i].ip;
+            addrs[i].sin_port = ip_ports[i].port;
+            iovecs[i].iov_base = datas[i];
+            iovecs[i].iov_len = lengths[i];
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        }
+
+        int sent = sendmmsg(sock, msgs, batch_count, MSG_DONTWAIT | MSG_NOSIGNAL);
+        // an error only concerns the first datagram, skip it like a failed sendto() would
+        unsigned done = sent > 0 ? static_cast<unsigned>(sent) : 1;
+        ip_ports += done;
+        datas += done;
+        lengths += done;
+        count -= done;
+    }
+#else
+    for (unsigned i = 0; i < count; ++i) {
+        send_packet_to(sock, ip_ports[i], datas[i], lengths[i]);
+    }
+#endif
+}
+
+bool Networking::send_broadcasts(uint16 port, char *data, unsigned long length)
 {
     static std::chrono::high_resolution_clock::time_point last_get_broadcast_info;
     if (number_broadcasts < 0 || check_timedout(last_get_broadcast_info, 60.0)) {
         PRINT_DEBUG("get_broadcast_info");
         get_broadcast_info(port);
         std::vector<uint32_t> lower_range(lower_range_ips, lower_range_ips + number_broadcasts), upper_range(upper_range_ips, upper_range_ips + number_broadcasts);
-        for(auto &addr : *custom_broadcasts) {
+        for(auto &addr : custom_broadcasts) {
             lower_range.push_back(addr.ip);
             upper_range.push_back(addr.ip);
         }
@@ -341,29 +446,34 @@ static bool send_broadcasts(sock_t sock, uint16 port, char *data, unsigned long
     IP_PORT main_broadcast;
     main_broadcast.ip = INADDR_BROADCAST;
     main_broadcast.port = port;
-    int ret = send_packet_to(sock, main_broadcast, data, length);
 
-    if (!number_broadcasts)
-        return false;
+    auto &destinations = broadcast_destinations;
+    destinations.clear();
+    destinations.push_back(main_broadcast);
 
-    for (int i = 0; i < number_broadcasts; i++) {
-        ret = send_packet_to(sock, broadcasts[i], data, length);
-        IP_PORT ip_port = broadcasts[i];
-    }
+    if (number_broadcasts) {
+        for (int i = 0; i < number_broadcasts; i++) {
+            destinations.push_back(broadcasts[i]);
+        }
 
-    /** 
-     * Custom targeted clients server broadcaster
-     * 
-     * Sends to custom IPs the broadcast packet
-     * This is useful in cases of undetected network interfaces
-     */
-    PRINT_DEBUG("start custom broadcasts");
-    for(auto &addr : *custom_broadcasts) {
-        send_packet_to(sock, addr, data, length);
+        /** 
+         * Custom targeted clients server broadcaster
+         * 
+         * Sends to custom IPs the broadcast packet
+         * This is useful in cases of undetected network interfaces
+         */
+        PRINT_DEBUG("adding %zu custom broadcasts", custom_broadcasts.size());
+        for(auto &addr : custom_broadcasts) {
+            destinations.push_back(addr);
+        }
     }
-    PRINT_DEBUG("end custom broadcasts");
 
-    return true;
+    // same payload for every destination
+    broadcast_datas.assign(destinations.size(), data);
+    broadcast_lengths.assign(destinations.size(), length);
+    send_packets_to(udp_socket, destinations.data(), broadcast_datas.data(), broadcast_lengths.data(), static_cast<unsigned>(destinations.size()));
+
+    return number_broadcasts != 0;
 }
 
 static void buffers_set(sock_t sock)
@@ -430,18 +540,19 @@ static void send_tcp_pending(struct TCP_Socket &socket)
     size_t buf_size = socket.send_buffer.size();
     if (buf_size == 0) return;
 
-    int len = send(socket.sock, &(socket.send_buffer[0]), static_cast<int>(buf_size), MSG_NOSIGNAL);
+    // all queued frames are contiguous, a single send() pushes as many of them as the kernel accepts
+    int len = send(socket.sock, socket.send_buffer.data(), static_cast<int>(buf_size), MSG_NOSIGNAL);
     if (len <= 0) return;
 
-    socket.send_buffer.erase(socket.send_buffer.begin(), socket.send_buffer.begin() + len);
+    socket.send_buffer.consume(len);
 }
 
 static void send_buffer_tcp(struct TCP_Socket &socket, Common_Message *msg)
 {
-    uint32 size = static_cast<uint32>(msg->ByteSizeLong()), old_size = static_cast<uint32>(socket.send_buffer.size());
-    socket.send_buffer.resize(old_size + sizeof(uint32) + size);
-    memcpy(&(socket.send_buffer[old_size]), &size, sizeof(size));
-    msg->SerializeToArray(&(socket.send_buffer[old_size + sizeof(uint32)]), size);
+    uint32 size = static_cast<uint32>(msg->ByteSizeLong());
+    char *frame = socket.send_buffer.extend(sizeof(uint32) + size);
+    memcpy(frame, &size, sizeof(size));
+    msg->SerializeToArray(frame + sizeof(uint32), size);
 
     send_tcp_pending(socket);
 }
@@ -451,7 +562,7 @@ static unsigned long peek_buffer_tcp(struct TCP_Socket &socket)
     uint32 length;
     if (socket.recv_buffer.size() < sizeof(length)) return 0;
 
-    memcpy(&length, &(socket.recv_buffer[0]), sizeof(length));
+    memcpy(&length, socket.recv_buffer.data(), sizeof(length));
     if (sizeof(length) + length > socket.recv_buffer.size()) return 0;
 
     return length;
@@ -464,25 +575,30 @@ static bool unbuffer_tcp(struct TCP_Socket &socket, Common_Message *msg)
         return false;
     }
 
-    if (msg->ParseFromArray(&(socket.recv_buffer[sizeof(uint32)]), l)) {
-        socket.recv_buffer.erase(socket.recv_buffer.begin(), socket.recv_buffer.begin() + sizeof(l) + l);
+    // parse in place, the frame is contiguous in the buffer
+    if (msg->ParseFromArray(socket.recv_buffer.data() + sizeof(uint32), l)) {
+        socket.recv_buffer.consume(sizeof(l) + l);
         return true;
     } else {
-        PRINT_DEBUG("BAD TCP DATA %u %zu %zu %hhu", l, socket.recv_buffer.size(), sizeof(uint32), *((char *)&(socket.recv_buffer[sizeof(uint32)])));
+        PRINT_DEBUG("BAD TCP DATA %u %zu %zu %hhu", l, socket.recv_buffer.size(), sizeof(uint32), *(socket.recv_buffer.data() + sizeof(uint32)));
         kill_tcp_socket(socket);
     }
 
     return false;
 }
 
-static bool recv_tcp(struct TCP_Socket &socket)
+// 'drained' is set to false when the kernel buffer might still hold some data after this call
+static bool recv_tcp(struct TCP_Socket &socket, bool *drained = nullptr)
 {
+    if (drained) *drained = true;
     if (is_socket_valid(socket.sock)) {
-        unsigned int size = receive_buffer_amount(socket.sock), old_size = static_cast<uint32>(socket.recv_buffer.size());
+        unsigned int size = receive_buffer_amount(socket.sock);
         int len;
-        socket.recv_buffer.resize(old_size + size);
         if (size > 0) {
-            len = recv(socket.sock, &(socket.recv_buffer[old_size]), size, MSG_NOSIGNAL);
+            char *dest = socket.recv_buffer.extend(size);
+            len = recv(socket.sock, dest, size, MSG_NOSIGNAL);
+            socket.recv_buffer.unextend(size - (len > 0 ? len : 0));
+            if (drained && len > 0 && (unsigned int)len < size) *drained = false;
             socket.received_data = true;
             return true;
         }
@@ -491,9 +607,9 @@ static bool recv_tcp(struct TCP_Socket &socket)
     return false;
 }
 
-static void socket_timeouts(struct TCP_Socket &socket, double extra_time)
+static void socket_timeouts(struct TCP_Socket &socket, double extra_time, std::chrono::high_resolution_clock::time_point now)
 {
-    if (check_timedout(socket.last_heartbeat_sent, HEARTBEAT_TIMEOUT / 2.0)) {
+    if (check_timedout(socket.last_heartbeat_sent, HEARTBEAT_TIMEOUT / 2.0, now)) {
         Common_Message msg;
         msg.set_allocated_low_level(new Low_Level());
         msg.mutable_low_level()->set_type(Low_Level::HEARTBEAT);
@@ -501,7 +617,7 @@ static void socket_timeouts(struct TCP_Socket &socket, double extra_time)
         socket.last_heartbeat_sent = std::chrono::high_resolution_clock::now();
     }
 
-    if (check_timedout(socket.last_heartbeat_received, HEARTBEAT_TIMEOUT + extra_time)) {
+    if (check_timedout(socket.last_heartbeat_received, HEARTBEAT_TIMEOUT + extra_time, now)) {
         kill_tcp_socket(socket);
         PRINT_DEBUG("TCP SOCKET HEARTBEAT TIMEOUT");
     }
@@ -604,6 +720,220 @@ void Networking::do_callbacks_message(Common_Message *msg)
     
 }
 
+#if defined(__LINUX__)
+void Networking::mark_ready(sock_t sock)
+{
+    if ((size_t)sock >= in_ready.size()) in_ready.resize((size_t)sock + 1, READY_NONE);
+    if (in_ready[sock] == READY_NONE) ready_socks.push_back(sock);
+
+    in_ready[sock] = READY_PENDING;
+}
+#endif
+
+void Networking::watch_socket(sock_t sock)
+{
+#if defined(__LINUX__)
+    if (epoll_fd < 0 || !is_socket_valid(sock)) return;
+
+    // the fd may belong to a closed socket which was still flagged
+    if ((size_t)sock < in_ready.size() && in_ready[sock] == READY_PENDING) in_ready[sock] = READY_SERVICED;
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = sock;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &ev) != 0) {
+        PRINT_DEBUG("epoll_ctl failed for socket %i, errno %i", sock, errno);
+        // we will never get an event for this one, keep servicing it every tick
+        mark_ready(sock);
+    }
+#endif
+}
+
+// 'timeout_ms' is how long to block waiting for the first event, this must be called without holding 'mutex' when blocking
+void Networking::poll_sockets(int timeout_ms)
+{
+#if defined(__LINUX__)
+    if (epoll_fd >= 0) {
+        struct epoll_event events[MAX_EPOLL_EVENTS];
+        int count = epoll_wait(epoll_fd, events, MAX_EPOLL_EVENTS, timeout_ms);
+
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        ready_socks.erase(std::remove_if(ready_socks.begin(), ready_socks.end(), [this](sock_t sock) {
+            if (in_ready[sock] != READY_SERVICED) return false;
+            in_ready[sock] = READY_NONE;
+            return true;
+        }), ready_socks.end());
+
+        while (count > 0) {
+            for (int i = 0; i < count; ++i) {
+                mark_ready(events[i].data.fd);
+            }
+
+            if (count < MAX_EPOLL_EVENTS) break;
+            count = epoll_wait(epoll_fd, events, MAX_EPOLL_EVENTS, 0);
+        }
+
+        PRINT_DEBUG("EPOLL %zu ready", ready_socks.size());
+        return;
+    }
+#endif
+
+    if (timeout_ms > 0) {
+        common_helpers::thisThreadYieldFor(std::chrono::milliseconds(timeout_ms));
+    }
+}
+
+// returns true if Run() has to service this socket, sockets are reported once per readiness change
+// so the caller must read everything available, platforms without epoll always service all sockets
+bool Networking::take_ready_socket(sock_t sock)
+{
+#if defined(__LINUX__)
+    if (epoll_fd < 0) return true;
+
+    if ((size_t)sock >= in_ready.size() || in_ready[sock] != READY_PENDING) return false;
+
+    in_ready[sock] = READY_SERVICED;
+#endif
+    return true;
+}
+
+void Networking::recv_tcp_ready(struct TCP_Socket &socket)
+{
+    if (!is_tcp_socket_valid(socket) || !take_ready_socket(socket.sock)) return;
+
+    bool drained = true;
+    recv_tcp(socket, &drained);
+#if defined(__LINUX__)
+    // edge-triggered, no new event will come for the leftover data
+    if (!drained) mark_ready(socket.sock);
+#endif
+}
+
+void Networking::io_thread_proc()
+{
+    // block until a socket is ready, the timeout bounds how long pending sends and heartbeats have to wait
+    poll_sockets(flush_wait_ms(IO_THREAD_WAIT_MS));
+    // the flush callbacks take subsystem locks, so this must happen before taking 'mutex'
+    run_flushes();
+
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    flush_io_backlog();
+    run_sockets();
+}
+
+// how long the network thread may sleep without missing the next flush deadline
+int Networking::flush_wait_ms(int max_ms)
+{
+    int64_t deadline = flush_deadline.load(std::memory_order_acquire);
+    if (deadline == INT64_MAX) return max_ms;
+
+    auto left = std::chrono::steady_clock::duration(deadline) - std::chrono::steady_clock::now().time_since_epoch();
+    auto left_ms = std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+    if (left_ms <= 0) return 0;
+    return left_ms < max_ms ? static_cast<int>(left_ms) : max_ms;
+}
+
+void Networking::run_flushes()
+{
+    int64_t deadline = flush_deadline.load(std::memory_order_acquire);
+    while (true) {
+        if (deadline == INT64_MAX || std::chrono::steady_clock::now().time_since_epoch().count() < deadline) return;
+        // a failure means an earlier deadline was scheduled meanwhile, which is due as well
+        if (flush_deadline.compare_exchange_weak(deadline, INT64_MAX, std::memory_order_acq_rel)) break;
+    }
+
+    std::lock_guard<std::mutex> lock(flush_mutex);
+    for (auto &cb : flush_callbacks) {
+        cb.flush(cb.object);
+    }
+}
+
+// must be called while holding 'mutex'
+Network_Queued_Message *Networking::new_queued_message()
+{
+    Network_Queued_Message *queued = nullptr;
+    if (io_free.pop(queued)) return queued;
+    return new Network_Queued_Message();
+}
+
+// must be called while holding 'mutex'
+void Networking::queue_message(Network_Queued_Message *queued)
+{
+    // never let a message overtake the ones still waiting in the backlog
+    if (io_backlog.size() || !io_queue.push(queued)) {
+        PRINT_DEBUG("I/O queue full, %zu messages in backlog", io_backlog.size() + 1);
+        io_backlog.push_back(queued);
+    }
+}
+
+// must be called while holding 'mutex'
+void Networking::flush_io_backlog()
+{
+    while (io_backlog.size()) {
+        if (!io_queue.push(io_backlog.front())) break;
+        io_backlog.pop_front();
+    }
+}
+
+// the Callback_Ids channel a message is dispatched to, used to break down the traffic in the metrics
+static unsigned message_channel(const Common_Message *msg)
+{
+    switch (msg->messages_case()) {
+    case Common_Message::kLobby:
+    case Common_Message::kLobbyMessages: return CALLBACK_ID_LOBBY;
+    case Common_Message::kNetwork:
+    case Common_Message::kNetworkOld: return CALLBACK_ID_NETWORKING;
+    case Common_Message::kGameserver: return CALLBACK_ID_GAMESERVER;
+    case Common_Message::kFriend: return CALLBACK_ID_FRIEND;
+    case Common_Message::kAuthTicket: return CALLBACK_ID_AUTH_TICKET;
+    case Common_Message::kFriendMessages: return CALLBACK_ID_FRIEND_MESSAGES;
+    case Common_Message::kNetworkingSockets: return CALLBACK_ID_NETWORKING_SOCKETS;
+    case Common_Message::kSteamMessages: return CALLBACK_ID_STEAM_MESSAGES;
+    case Common_Message::kNetworkingMessages: return CALLBACK_ID_NETWORKING_MESSAGES;
+    case Common_Message::kGameserverStatsMessages: return CALLBACK_ID_GAMESERVER_STATS;
+    case Common_Message::kLeaderboardsMessages: return CALLBACK_ID_LEADERBOARDS_STATS;
+    // announces and low level messages keep track of the other users
+    default: return CALLBACK_ID_USER_STATUS;
+    }
+}
+
+void Networking::dispatch_message(Network_Queued_Message &queued)
+{
+    if (metrics_enabled()) {
+        metrics_network(METRIC_NETWORK_IN, queued.user_status ? static_cast<unsigned>(CALLBACK_ID_USER_STATUS) : message_channel(&queued.msg), queued.msg.ByteSizeLong());
+    }
+
+    if (queued.user_status) {
+        run_callbacks(CALLBACK_ID_USER_STATUS, &queued.msg);
+    } else {
+        do_callbacks_message(&queued.msg);
+    }
+}
+
+void Networking::dispatch_io_messages()
+{
+    Network_Queued_Message *queued = nullptr;
+    while (io_queue.pop(queued)) {
+        dispatch_message(*queued);
+        queued->msg.Clear();
+        queued->user_status = false;
+        if (!io_free.push(queued)) delete queued;
+    }
+}
+
+// queue a received message for the callbacks, they are never called with 'mutex' held (see the lock order in base.h)
+void Networking::deliver_message(Common_Message *msg)
+{
+    if (io_thread) {
+        auto queued = new_queued_message();
+        queued->msg.Swap(msg);
+        queue_message(queued);
+        return;
+    }
+
+    received.emplace_back().msg.Swap(msg);
+}
+
 bool Networking::handle_tcp(Common_Message *msg, struct TCP_Socket &socket)
 {
     socket.last_heartbeat_received = std::chrono::high_resolution_clock::now();
@@ -618,26 +948,59 @@ bool Networking::handle_tcp(Common_Message *msg, struct TCP_Socket &socket)
         }
     }
 
-    do_callbacks_message(msg);
+    deliver_message(msg);
     return true;
 }
 
 struct Connection *Networking::find_connection(CSteamID search_id, uint32 appid)
 {
-    auto conn = std::find_if(connections.begin(), connections.end(), [&search_id, appid](struct Connection const& conn) { 
-        if (appid && (conn.appid != appid)) return false;
+    auto it = connection_index.find(search_id.ConvertToUint64());
+    if (connection_index.end() == it)
+        return nullptr;
 
-        for (const auto &id: conn.ids) {
-            if (search_id == id) return true;
-        }
+    struct Connection *found = nullptr;
+    for (auto conn : it->second) {
+        if (appid && (conn->appid != appid)) continue;
+        if (!found || conn->serial < found->serial) found = conn;
+    }
 
-        return false;
-    });
+    return found;
+}
 
-    if (connections.end() != conn)
-        return &(*conn);
+void Networking::index_connection_id(struct Connection *conn, CSteamID steam_id)
+{
+    connection_index[steam_id.ConvertToUint64()].push_back(conn);
+    fanout_dirty = true;
+}
+
+void Networking::unindex_connection_id(struct Connection *conn, CSteamID steam_id)
+{
+    fanout_dirty = true;
+    auto it = connection_index.find(steam_id.ConvertToUint64());
+    if (connection_index.end() == it) return;
 
-    return nullptr;
+    auto &conns = it->second;
+    conns.erase(std::remove(conns.begin(), conns.end(), conn), conns.end());
+    if (conns.empty()) connection_index.erase(it);
+}
+
+void Networking::rebuild_fanout()
+{
+    if (!fanout_dirty) return;
+
+    fanout_all.clear();
+    fanout_individuals.clear();
+    fanout_gameservers.clear();
+    for (auto &conn: connections) {
+        for (auto &steam_id : conn.ids) {
+            struct Fanout_Target target{ &conn, steam_id };
+            fanout_all.push_back(target);
+            if (steam_id.BIndividualAccount()) fanout_individuals.push_back(target);
+            if (steam_id.BGameServerAccount()) fanout_gameservers.push_back(target);
+        }
+    }
+
+    fanout_dirty = false;
 }
 
 bool Networking::add_id_connection(struct Connection *connection, CSteamID steam_id)
@@ -650,6 +1013,7 @@ bool Networking::add_id_connection(struct Connection *connection, CSteamID steam
 
     PRINT_DEBUG("ADDED ID %llu", (uint64)steam_id.ConvertToUint64());
     connection->ids.push_back(steam_id);
+    index_connection_id(connection, steam_id);
     if (connection->connected) {
         run_callback_user(steam_id, true, connection->appid);
     }
@@ -662,14 +1026,15 @@ struct Connection *Networking::new_connection(CSteamID search_id, uint32 appid)
     Connection *conn = find_connection(search_id, appid);
     if (conn && conn->appid == appid) return NULL;
 
-    struct Connection connection;
+    struct Connection &connection = connections.emplace_back();
     connection.ids.push_back(search_id);
     connection.appid = appid;
     connection.last_received = std::chrono::high_resolution_clock::now();
+    connection.serial = next_connection_serial++;
+    index_connection_id(&connection, search_id);
 
     PRINT_DEBUG("ADDED ID %llu", (uint64)search_id.ConvertToUint64());
-    connections.push_back(connection);
-    return &(connections[connections.size() - 1]);
+    return &connection;
 }
 
 bool Networking::handle_announce(Common_Message *msg, IP_PORT ip_port)
@@ -761,7 +1126,7 @@ bool Networking::handle_low_level_udp(Common_Message *msg, IP_PORT ip_port)
 
 #define NUM_TCP_WAITING 128
 
-Networking::Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT> *custom_broadcasts, bool disable_sockets)
+Networking::Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT> *custom_broadcasts, bool disable_sockets, bool use_io_thread)
 {
     tcp_port = udp_port = port;
     own_ip = 0x7F000001;
@@ -784,6 +1149,14 @@ Networking::Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT>
     }
 
     run_at_startup();
+    udp_batch = new UDP_Batch();
+#if defined(__LINUX__)
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        PRINT_DEBUG("epoll_create1 failed %i, falling back to polling every socket", errno);
+    }
+#endif
+
     sock_t sock = static_cast<sock_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
     PRINT_DEBUG("UDP socket: %u", sock);
     if (is_socket_valid(sock) && set_socket_nonblocking(sock)) {
@@ -854,17 +1227,47 @@ Networking::Networking(CSteamID id, uint32 appid, uint16 port, std::set<IP_PORT>
  
     if (is_socket_valid(udp_socket) && is_socket_valid(tcp_socket)) {
         PRINT_DEBUG("Networking initialized successfully on udp: %u tcp: %u", udp_port, tcp_port);
+        watch_socket(udp_socket);
+        watch_socket(tcp_socket);
         enabled = true;
     }
 
     PRINT_DEBUG("ADDED ID %llu", (uint64)id.ConvertToUint64());
     ids.push_back(id);
 
+    if (enabled && use_io_thread) {
+        io_thread = new common_helpers::KillableWorker(
+            [this](void *){ io_thread_proc(); return false; },
+            std::chrono::milliseconds(0),
+            std::chrono::milliseconds(1)
+        );
+        io_thread->start();
+        PRINT_DEBUG("started network I/O thread");
+    }
+
     reset_last_error();
 }
 
 Networking::~Networking()
 {
+    if (flush_thread) {
+        flush_thread->kill();
+        delete flush_thread;
+        flush_thread = nullptr;
+    }
+
+    if (io_thread) {
+        io_thread->kill();
+        delete io_thread;
+        io_thread = nullptr;
+
+        Network_Queued_Message *queued = nullptr;
+        while (io_queue.pop(queued)) delete queued;
+        while (io_free.pop(queued)) delete queued;
+        for (auto q : io_backlog) delete q;
+        io_backlog.clear();
+    }
+
     for (auto &c : connections) {
         kill_tcp_socket(c.tcp_socket_incoming);
         kill_tcp_socket(c.tcp_socket_outgoing);
@@ -877,6 +1280,16 @@ Networking::~Networking()
     kill_socket(udp_socket);
     kill_socket(tcp_socket);
 
+#if defined(__LINUX__)
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+#endif
+
+    delete udp_batch;
+    udp_batch = nullptr;
+
     curl_global_cleanup();
 }
 
@@ -914,11 +1327,11 @@ void Networking::send_announce_broadcasts()
     Common_Message msg = create_announce(true);
 
     size_t size = msg.ByteSizeLong(); 
-    std::vector<char> buffer(size);
-    msg.SerializeToArray(&buffer[0], static_cast<int>(size));
-    send_broadcasts(udp_socket, htons(DEFAULT_PORT), &buffer[0], static_cast<unsigned long>(size), &this->custom_broadcasts);
+    announce_buffer.resize(size);
+    msg.SerializeToArray(&announce_buffer[0], static_cast<int>(size));
+    send_broadcasts(htons(DEFAULT_PORT), &announce_buffer[0], static_cast<unsigned long>(size));
     if (udp_port != DEFAULT_PORT) {
-        send_broadcasts(udp_socket, htons(udp_port), &buffer[0], static_cast<unsigned long>(size), &this->custom_broadcasts);
+        send_broadcasts(htons(udp_port), &announce_buffer[0], static_cast<unsigned long>(size));
     }
 
     last_broadcast = std::chrono::high_resolution_clock::now();
@@ -927,25 +1340,44 @@ void Networking::send_announce_broadcasts()
 
 void Networking::Run()
 {
-    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-    double time_extra = std::chrono::duration_cast<std::chrono::duration<double>>(now - last_run).count();
-    last_run = now;
+    if (io_thread) {
+        {
+            // the source query is answered by the gameserver, keep it on the caller's thread
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            run_query();
+        }
 
-    if (!enabled || ids.size() == 0) {
+        dispatch_io_messages();
         return;
     }
 
-    //PRINT_DEBUG("%lf", time_extra);
-    // PRINT_DEBUG_ENTRY();
-    if (check_timedout(last_broadcast, BROADCAST_INTERVAL)) {
-        send_announce_broadcasts();
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
+        poll_sockets();
+        run_query();
+        run_sockets();
+        dispatching.swap(received);
+    }
+
+    // the callbacks may take subsystem locks whose holders send through us, so 'mutex' must be released by now
+    for (auto &queued : dispatching) {
+        dispatch_message(queued);
+    }
+
+    dispatching.clear();
+}
+
+void Networking::run_query()
+{
+    if (!enabled || ids.size() == 0) {
+        return;
     }
 
     IP_PORT ip_port;
     char data[MAX_UDP_SIZE];
     int len;
 
-    if (query_alive && is_socket_valid(query_socket)) {
+    if (query_alive && is_socket_valid(query_socket) && take_ready_socket(query_socket)) {
         PRINT_DEBUG("RECV Source Query");
         Steam_Client* client = get_steam_client();
         sockaddr_in addr;
@@ -962,27 +1394,54 @@ void Networking::Run()
             sendto(query_socket, data, len, 0, (sockaddr*)&addr, sizeof(addr));
         }
     }
+}
 
-    PRINT_DEBUG("RECV UDP");
-    while((len = receive_packet(udp_socket, &ip_port, data, sizeof(data))) >= 0) {
-        PRINT_DEBUG("recv %i %hhu.%hhu.%hhu.%hhu:%hu", len,
-            ((unsigned char *)&ip_port.ip)[0], ((unsigned char *)&ip_port.ip)[1], ((unsigned char *)&ip_port.ip)[2], ((unsigned char *)&ip_port.ip)[3], htons(ip_port.port));
-        Common_Message msg;
-        if (msg.ParseFromArray(data, len)) {
-            if (msg.source_id()) {
-                if (msg.has_announce()) {
-                    handle_announce(&msg, ip_port);
-                } else if (msg.has_low_level()) {
-                    handle_low_level_udp(&msg, ip_port);
-                } else {
-                    msg.set_source_ip(ntohl(ip_port.ip));
-                    msg.set_source_port(ntohs(ip_port.port));
-                    do_callbacks_message(&msg);
+void Networking::run_sockets()
+{
+    // one clock reading for every heartbeat and user timeout below, these deadlines move with each packet received
+    // and the loops visit every connection to poll its sockets anyway
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+    double time_extra = std::chrono::duration_cast<std::chrono::duration<double>>(now - last_run).count();
+    last_run = now;
+
+    if (!enabled || ids.size() == 0) {
+        return;
+    }
+
+    //PRINT_DEBUG("%lf", time_extra);
+    // PRINT_DEBUG_ENTRY();
+    if (check_timedout(last_broadcast, BROADCAST_INTERVAL, now)) {
+        send_announce_broadcasts();
+    }
+
+    IP_PORT ip_port;
+
+    PRINT_DEBUG_TRACE("RECV UDP");
+    bool udp_ready = take_ready_socket(udp_socket);
+    while (udp_ready) {
+        int count = receive_packets(udp_socket, udp_batch);
+        for (int i = 0; i < count; ++i) {
+            ip_port = udp_batch->ip_port[i];
+            PRINT_DEBUG("recv %i %hhu.%hhu.%hhu.%hhu:%hu", udp_batch->length[i],
+                ((unsigned char *)&ip_port.ip)[0], ((unsigned char *)&ip_port.ip)[1], ((unsigned char *)&ip_port.ip)[2], ((unsigned char *)&ip_port.ip)[3], htons(ip_port.port));
+            Common_Message msg;
+            if (msg.ParseFromArray(udp_batch->data[i], udp_batch->length[i])) {
+                if (msg.source_id()) {
+                    if (msg.has_fragment()) {
+                        handle_fragment(&msg, ip_port);
+                    } else {
+                        handle_udp(&msg, ip_port);
+                    }
                 }
             }
         }
+
+        // a partial batch means the socket is drained
+        if (count < UDP_BATCH_SIZE) break;
     }
 
+    expire_fragments();
+
     PRINT_DEBUG("RECV LOCAL %zu", local_send.size());
     std::vector<Common_Message> local_send_copy = local_send;
     local_send.clear();
@@ -990,7 +1449,7 @@ void Networking::Run()
     for (auto & m: local_send_copy) {
         m.set_source_ip(ntohl(own_ip));
         m.set_source_port(ntohs(udp_port));
-        do_callbacks_message(&m);
+        deliver_message(&m);
     }
 
     struct sockaddr_storage addr;
@@ -1001,7 +1460,8 @@ void Networking::Run()
 #endif
     sock_t sock;
     PRINT_DEBUG("ACCEPTING");
-    while (is_socket_valid(sock = static_cast<sock_t>(accept(tcp_socket, (struct sockaddr *)&addr, &addrlen)))) {
+    bool accept_ready = take_ready_socket(tcp_socket);
+    while (accept_ready && is_socket_valid(sock = static_cast<sock_t>(accept(tcp_socket, (struct sockaddr *)&addr, &addrlen)))) {
         PRINT_DEBUG("ACCEPT SOCKET %u", sock);
         struct sockaddr_storage addr;
     #if defined(STEAM_WIN32)
@@ -1019,16 +1479,17 @@ void Networking::Run()
             socket.sock = sock;
             socket.received_data = true;
             socket.last_heartbeat_received = std::chrono::high_resolution_clock::now();
+            watch_socket(sock);
             accepted.push_back(socket);
             PRINT_DEBUG("TCP ACCEPTED %u", sock);
         }
     }
 
-    PRINT_DEBUG("ACCEPTED %zu", accepted.size());
+    PRINT_DEBUG_TRACE("ACCEPTED %zu", accepted.size());
     auto conn = std::begin(accepted);
     while (conn != std::end(accepted)) {
         bool deleted = false;
-        recv_tcp(*conn);
+        recv_tcp_ready(*conn);
         Common_Message msg;
         if (unbuffer_tcp(*conn, &msg)) {
             if (msg.source_id()) {
@@ -1051,7 +1512,7 @@ void Networking::Run()
             }
         }
 
-        if (!deleted && check_timedout(conn->last_heartbeat_received, HEARTBEAT_TIMEOUT + time_extra)) {
+        if (!deleted && check_timedout(conn->last_heartbeat_received, HEARTBEAT_TIMEOUT + time_extra, now)) {
             kill_tcp_socket(*conn);
             conn = accepted.erase(conn);
             deleted = true;
@@ -1070,6 +1531,7 @@ void Networking::Run()
             if (is_socket_valid(sock) && set_socket_nonblocking(sock)) {
                 PRINT_DEBUG("NEW SOCKET %u %u", sock, conn.tcp_socket_outgoing.sock);
                 disable_nagle(sock);
+                watch_socket(sock);
                 connect_socket(sock, conn.tcp_ip_port);
                 conn.tcp_socket_outgoing.sock = sock;
                 conn.tcp_socket_outgoing.last_heartbeat_received = std::chrono::high_resolution_clock::now();
@@ -1079,9 +1541,9 @@ void Networking::Run()
             }
         }
 
-        PRINT_DEBUG("RUN SOCKET1 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
-        recv_tcp(conn.tcp_socket_outgoing);
-        recv_tcp(conn.tcp_socket_incoming);
+        PRINT_DEBUG_TRACE("RUN SOCKET1 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
+        recv_tcp_ready(conn.tcp_socket_outgoing);
+        recv_tcp_ready(conn.tcp_socket_incoming);
 
         if (conn.tcp_socket_incoming.received_data || conn.tcp_socket_outgoing.received_data) {
             if (!conn.connected) {
@@ -1094,6 +1556,7 @@ void Networking::Run()
                             auto i = std::find(c.ids.begin(), c.ids.end(), steam_id);
                             if (i != c.ids.end()) {
                                 c.ids.erase(i);
+                                unindex_connection_id(&c, steam_id);
                                 run_callback_user(steam_id, false, c.appid);
                                 PRINT_DEBUG("REMOVE OLD CONNECTION ID");
                             }
@@ -1107,11 +1570,11 @@ void Networking::Run()
             }
         }
 
-        PRINT_DEBUG("RUN SOCKET2 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
+        PRINT_DEBUG_TRACE("RUN SOCKET2 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
         send_tcp_pending(conn.tcp_socket_outgoing);
         send_tcp_pending(conn.tcp_socket_incoming);
 
-        PRINT_DEBUG("RUN SOCKET3 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
+        PRINT_DEBUG_TRACE("RUN SOCKET3 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
         Common_Message msg;
         while (unbuffer_tcp(conn.tcp_socket_outgoing, &msg)) {
             PRINT_DEBUG("UNBUFFER SOCKET");
@@ -1127,19 +1590,20 @@ void Networking::Run()
             conn.last_received = std::chrono::high_resolution_clock::now();
         }
 
-        PRINT_DEBUG("RUN SOCKET4 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
-        socket_timeouts(conn.tcp_socket_outgoing, time_extra);
-        socket_timeouts(conn.tcp_socket_incoming, time_extra);
+        PRINT_DEBUG_TRACE("RUN SOCKET4 %u %u", conn.tcp_socket_outgoing.sock, conn.tcp_socket_incoming.sock);
+        socket_timeouts(conn.tcp_socket_outgoing, time_extra, now);
+        socket_timeouts(conn.tcp_socket_incoming, time_extra, now);
 
     }
 
     {
         auto conn = std::begin(connections);
         while (conn != std::end(connections)) {
-            if (check_timedout(conn->last_received, USER_TIMEOUT + time_extra)) {
+            if (check_timedout(conn->last_received, USER_TIMEOUT + time_extra, now)) {
                 if (conn->connected) for (auto &steam_id : conn->ids) run_callback_user(steam_id, false, conn->appid);
                 kill_tcp_socket(conn->tcp_socket_outgoing);
                 kill_tcp_socket(conn->tcp_socket_incoming);
+                for (auto &steam_id : conn->ids) unindex_connection_id(&(*conn), steam_id);
                 conn = connections.erase(conn);
                 PRINT_DEBUG("USER TIMEOUT");
             } else {
@@ -1160,6 +1624,7 @@ void Networking::Run()
 
 void Networking::addListenId(CSteamID id)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if (!enabled) return;
     auto i = std::find(ids.begin(), ids.end(), id);
     if (i != ids.end()) {
@@ -1174,11 +1639,14 @@ void Networking::addListenId(CSteamID id)
 
 void Networking::setAppID(uint32 appid)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     this->appid = appid;
 }
 
 bool Networking::sendToIPPort(Common_Message *msg, uint32 ip, uint16 port, bool reliable)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    batch_udp_sends = true;
     bool is_local_ip = ((ip >> 24) == 0x7F);
     uint32_t local_ip = getIP(ids.front());
     PRINT_DEBUG("%X %u %X", ip, is_local_ip, local_ip);
@@ -1192,11 +1660,13 @@ bool Networking::sendToIPPort(Common_Message *msg, uint32 ip, uint16 port, bool
         }
     }
 
+    flush_udp_sends();
     return true;
 }
 
 uint32 Networking::getIP(CSteamID id)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     Connection *conn = find_connection(id, this->appid);
     if (conn) {
         return ntohl(conn->tcp_ip_port.ip);
@@ -1207,10 +1677,11 @@ uint32 Networking::getIP(CSteamID id)
 
 bool Networking::sendTo(Common_Message *msg, bool reliable, Connection *conn)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if (!enabled) return false;
 
     size_t size = msg->ByteSizeLong();
-    if (size >= MAX_UDP_SIZE) reliable = true; //too big for UDP
+    if (size > UDP_FRAGMENT_SIZE * UDP_FRAGMENT_MAX_COUNT) reliable = true; //too big for UDP, even in fragments
 
     bool ret = false;
     CSteamID dest_id((uint64)msg->dest_id());
@@ -1228,6 +1699,7 @@ bool Networking::sendTo(Common_Message *msg, bool reliable, Connection *conn)
     }
 
     if (!ret && conn) {
+        metrics_network(METRIC_NETWORK_OUT, message_channel(msg), size);
         if (reliable || !conn->udp_pinged) {
             if (conn->tcp_socket_incoming.received_data) {
                 send_buffer_tcp(conn->tcp_socket_incoming, msg);
@@ -1236,10 +1708,17 @@ bool Networking::sendTo(Common_Message *msg, bool reliable, Connection *conn)
                 send_buffer_tcp(conn->tcp_socket_outgoing, msg);
                 ret = true;
             }
+        } else if (size >= MAX_UDP_SIZE) {
+            send_fragmented(conn->udp_ip_port, msg, size);
+            ret = true;
         } else {
-            std::vector<char> buffer(size, 0);
-            msg->SerializeToArray(&buffer[0], static_cast<int>(size));
-            send_packet_to(udp_socket, conn->udp_ip_port, &buffer[0], static_cast<unsigned long>(size));
+            if (batch_udp_sends) {
+                queue_udp_packet(conn->udp_ip_port, msg, size);
+            } else {
+                udp_buffer.resize(size);
+                msg->SerializeToArray(&udp_buffer[0], static_cast<int>(size));
+                send_packet_to(udp_socket, conn->udp_ip_port, &udp_buffer[0], static_cast<unsigned long>(size));
+            }
             ret = true;
         }
     }
@@ -1250,44 +1729,195 @@ bool Networking::sendTo(Common_Message *msg, bool reliable, Connection *conn)
 
 bool Networking::sendToAllIndividuals(Common_Message *msg, bool reliable)
 {
-    for (auto &conn: connections) {
-        for (auto &steam_id : conn.ids) {
-            if (steam_id.BIndividualAccount()) {
-                msg->set_dest_id(steam_id.ConvertToUint64());
-                sendTo(msg, reliable, &conn);
-            }
-        }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    rebuild_fanout();
+    batch_udp_sends = true;
+    for (auto &target : fanout_individuals) {
+        msg->set_dest_id(target.steam_id.ConvertToUint64());
+        sendTo(msg, reliable, target.conn);
     }
 
+    flush_udp_sends();
     return true;
 }
 
 bool Networking::sendToAllGameservers(Common_Message *msg, bool reliable)
 {
-    for (auto &conn: connections) {
-        for (auto &steam_id : conn.ids) {
-            if (steam_id.BGameServerAccount()) {
-                msg->set_dest_id(steam_id.ConvertToUint64());
-                sendTo(msg, reliable, &conn);
-            }
-        }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    rebuild_fanout();
+    batch_udp_sends = true;
+    for (auto &target : fanout_gameservers) {
+        msg->set_dest_id(target.steam_id.ConvertToUint64());
+        sendTo(msg, reliable, target.conn);
     }
 
+    flush_udp_sends();
     return true;
 }
 
 bool Networking::sendToAll(Common_Message *msg, bool reliable)
 {
-    for (auto &conn: connections) {
-        for (auto &steam_id : conn.ids) {
-            msg->set_dest_id(steam_id.ConvertToUint64());
-            sendTo(msg, reliable, &conn);
-        }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    rebuild_fanout();
+    batch_udp_sends = true;
+    for (auto &target : fanout_all) {
+        msg->set_dest_id(target.steam_id.ConvertToUint64());
+        sendTo(msg, reliable, target.conn);
+    }
+
+    flush_udp_sends();
+    return true;
+}
+
+void Networking::queue_udp_packet(IP_PORT ip_port, Common_Message *msg, size_t size)
+{
+    if (udp_send_count == udp_send_queue.size()) {
+        udp_send_queue.emplace_back();
+    }
+
+    auto &packet = udp_send_queue[udp_send_count++];
+    packet.ip_port = ip_port;
+    packet.data.resize(size);
+    msg->SerializeToArray(packet.data.data(), static_cast<int>(size));
+}
+
+void Networking::send_fragmented(IP_PORT ip_port, Common_Message *msg, size_t size)
+{
+    std::string serialized = msg->SerializeAsString();
+    uint32 count = static_cast<uint32>((size + UDP_FRAGMENT_SIZE - 1) / UDP_FRAGMENT_SIZE);
+    PRINT_DEBUG("sending %zu bytes as %u fragments", size, count);
+
+    Common_Message fragment_msg;
+    fragment_msg.set_source_id(msg->source_id());
+    fragment_msg.set_dest_id(msg->dest_id());
+    Fragment *fragment = fragment_msg.mutable_fragment();
+    fragment->set_message_id(++next_fragment_id);
+    fragment->set_count(count);
+
+    // the fragments always go out together, if the caller isn't batching already this is the only batch
+    bool flush = !batch_udp_sends;
+    batch_udp_sends = true;
+    for (uint32 i = 0; i < count; ++i) {
+        size_t offset = static_cast<size_t>(i) * UDP_FRAGMENT_SIZE;
+        fragment->set_index(i);
+        fragment->set_data(serialized.data() + offset, std::min<size_t>(UDP_FRAGMENT_SIZE, serialized.size() - offset));
+        queue_udp_packet(ip_port, &fragment_msg, fragment_msg.ByteSizeLong());
+    }
+
+    if (flush) flush_udp_sends();
+}
+
+void Networking::handle_udp(Common_Message *msg, IP_PORT ip_port)
+{
+    if (msg->has_announce()) {
+        handle_announce(msg, ip_port);
+    } else if (msg->has_low_level()) {
+        handle_low_level_udp(msg, ip_port);
+    } else {
+        msg->set_source_ip(ntohl(ip_port.ip));
+        msg->set_source_port(ntohs(ip_port.port));
+        deliver_message(msg);
+    }
+}
+
+bool Networking::handle_fragment(Common_Message *msg, IP_PORT ip_port)
+{
+    const Fragment &fragment = msg->fragment();
+    uint32 count = fragment.count();
+    uint32 index = fragment.index();
+    if (!count || count > UDP_FRAGMENT_MAX_COUNT || index >= count) return false;
+    if (fragment.data().empty() || fragment.data().size() > UDP_FRAGMENT_SIZE) return false;
+
+    auto key = std::make_pair((uint64)msg->source_id(), (uint64)fragment.message_id());
+    auto pending = reassembly.find(key);
+    if (pending == reassembly.end()) {
+        pending = reassembly.emplace(key, Fragment_Reassembly()).first;
+        pending->second.parts.resize(count);
+        pending->second.started = std::chrono::high_resolution_clock::now();
+        // a sender announcing many fragments and sending few of them still has to pay for the empty slots
+        pending->second.size = sizeof(*pending) + pending->second.parts.capacity() * sizeof(std::string);
+        reassembly_size += pending->second.size;
+    }
+
+    auto &parts = pending->second.parts;
+    if (parts.size() != count || parts[index].size()) return false; // mismatched or duplicate fragment
+
+    parts[index] = fragment.data();
+    pending->second.received += 1;
+    pending->second.data_size += parts[index].size();
+    pending->second.size += parts[index].capacity();
+    reassembly_size += parts[index].capacity();
+
+    while (reassembly_size > UDP_REASSEMBLY_MAX_SIZE) {
+        auto oldest = std::min_element(reassembly.begin(), reassembly.end(), [](const auto &a, const auto &b) { return a.second.started < b.second.started; });
+        PRINT_DEBUG("reassembly buffer full, dropping incomplete message %llu from %llu", oldest->first.second, oldest->first.first);
+        bool dropped_current = oldest == pending;
+        drop_reassembly(oldest);
+        if (dropped_current) return false;
+    }
+
+    if (pending->second.received < count) return true;
+
+    std::string serialized;
+    serialized.reserve(pending->second.data_size);
+    for (auto &part : parts) {
+        serialized += part;
     }
 
+    drop_reassembly(pending);
+
+    Common_Message full_msg;
+    if (!full_msg.ParseFromString(serialized) || !full_msg.source_id() || full_msg.has_fragment()) return false;
+
+    PRINT_DEBUG("reassembled %zu bytes from %u fragments", serialized.size(), count);
+    handle_udp(&full_msg, ip_port);
     return true;
 }
 
+void Networking::drop_reassembly(std::map<std::pair<uint64, uint64>, struct Fragment_Reassembly>::iterator pending)
+{
+    reassembly_size -= pending->second.size;
+    reassembly.erase(pending);
+}
+
+void Networking::expire_fragments()
+{
+    auto pending = reassembly.begin();
+    while (pending != reassembly.end()) {
+        if (check_timedout(pending->second.started, UDP_REASSEMBLY_TIMEOUT)) {
+            PRINT_DEBUG("dropping incomplete message %llu from %llu, got %u/%zu fragments", pending->first.second, pending->first.first, pending->second.received, pending->second.parts.size());
+            reassembly_size -= pending->second.size;
+            pending = reassembly.erase(pending);
+        } else {
+            ++pending;
+        }
+    }
+}
+
+void Networking::flush_udp_sends()
+{
+    batch_udp_sends = false;
+    if (!udp_send_count) return;
+
+    PRINT_DEBUG("sending %zu batched datagrams", udp_send_count);
+    IP_PORT ip_ports[UDP_BATCH_SIZE];
+    char *datas[UDP_BATCH_SIZE];
+    unsigned long lengths[UDP_BATCH_SIZE];
+    for (size_t start = 0; start < udp_send_count; start += UDP_BATCH_SIZE) {
+        unsigned count = 0;
+        for (size_t i = start; i < udp_send_count && count < UDP_BATCH_SIZE; ++i, ++count) {
+            ip_ports[count] = udp_send_queue[i].ip_port;
+            datas[count] = udp_send_queue[i].data.data();
+            lengths[count] = static_cast<unsigned long>(udp_send_queue[i].data.size());
+        }
+
+        send_packets_to(udp_socket, ip_ports, datas, lengths, count);
+    }
+
+    udp_send_count = 0;
+    reset_last_error();
+}
+
 void Networking::run_callbacks(Callback_Ids id, Common_Message *msg)
 {
     for (auto &cb : callbacks[id].callbacks) {
@@ -1315,7 +1945,17 @@ void Networking::run_callback_user(CSteamID steam_id, bool online, uint32 appid)
         msg.mutable_low_level()->set_type(Low_Level::DISCONNECT);
     }
 
-    run_callbacks(CALLBACK_ID_USER_STATUS, &msg);
+    if (io_thread) {
+        auto queued = new_queued_message();
+        queued->msg.Swap(&msg);
+        queued->user_status = true;
+        queue_message(queued);
+        return;
+    }
+
+    auto &queued = received.emplace_back();
+    queued.msg.Swap(&msg);
+    queued.user_status = true;
 }
 
 bool Networking::setCallback(Callback_Ids id, CSteamID steam_id, void (*message_callback)(void *object, Common_Message *msg), void *object)
@@ -1349,13 +1989,50 @@ void Networking::rmCallback(Callback_Ids id, CSteamID steam_id, void (*message_c
     target_cb.erase(itrm, target_cb.end());
 }
 
+void Networking::addFlushCallback(void (*flush)(void *object), void *object)
+{
+    std::lock_guard<std::mutex> lock(flush_mutex);
+    flush_callbacks.push_back({flush, object});
+
+    // without the I/O thread, a small thread of its own waits for the deadlines
+    // it's only started when a subsystem actually holds messages back, i.e. the Nagle timer is on
+    if (enabled && !io_thread && !flush_thread) {
+        flush_thread = new common_helpers::KillableWorker(
+            [this](void *){ run_flushes(); return false; },
+            std::chrono::milliseconds(0),
+            std::chrono::milliseconds(1)
+        );
+        flush_thread->start();
+        PRINT_DEBUG("started network flush thread");
+    }
+}
+
+void Networking::rmFlushCallback(void (*flush)(void *object), void *object)
+{
+    std::lock_guard<std::mutex> lock(flush_mutex);
+    auto itrm = std::remove_if(flush_callbacks.begin(), flush_callbacks.end(), [=](const struct Network_Flush_Callback &item) {
+        return item.flush == flush && item.object == object;
+    });
+
+    flush_callbacks.erase(itrm, flush_callbacks.end());
+}
+
+void Networking::scheduleFlush(std::chrono::steady_clock::time_point deadline)
+{
+    int64_t ticks = deadline.time_since_epoch().count();
+    int64_t current = flush_deadline.load(std::memory_order_relaxed);
+    while (ticks < current && !flush_deadline.compare_exchange_weak(current, ticks, std::memory_order_acq_rel)) {}
+}
+
 uint32 Networking::getOwnIP()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     return own_ip;
 }
 
 void Networking::startQuery(IP_PORT ip_port)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     if (ip_port.port <= 1024)
         return;
 
@@ -1394,6 +2071,7 @@ void Networking::startQuery(IP_PORT ip_port)
             if (res == 0)
             {
                 set_socket_nonblocking(query_socket);
+                watch_socket(query_socket);
                 break;
             }
 
@@ -1416,11 +2094,13 @@ void Networking::startQuery(IP_PORT ip_port)
 
 void Networking::shutDownQuery()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     query_alive = false;
     kill_socket(query_socket);
 }
 
 bool Networking::isQueryAlive()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     return query_alive;
 }
@@ -267,6 +267,12 @@ void Settings::addDLC(AppId_t appID, std::string name, bool available)
     new_entry.name = name;
     new_entry.available = available;
     DLCs.push_back(new_entry);
+    ++dlcs_version;
+}
+
+uint32 Settings::getDLCsVersion() const
+{
+    return dlcs_version;
 }
 
 unsigned int Settings::DLCCount() const
@@ -353,6 +359,7 @@ std::map<std::string, Stat_config>::const_iterator Settings::setStatDefiniton(co
 
 int Settings::add_image(const std::string &data, uint32 width, uint32 height)
 {
+    std::unique_lock lock(images_mutex);
     int last = static_cast<int>(images.size()) + 1;
     struct Image_Data dt;
     dt.width = width;
@@ -362,6 +369,36 @@ int Settings::add_image(const std::string &data, uint32 width, uint32 height)
     return last;
 }
 
+bool Settings::get_image_size(int image, uint32 *width, uint32 *height) const
+{
+    std::shared_lock lock(images_mutex);
+    auto it = images.find(image);
+    if (images.end() == it) return false;
+
+    *width = it->second.width;
+    *height = it->second.height;
+    return true;
+}
+
+bool Settings::copy_image_data(int image, void *dest, size_t size) const
+{
+    std::shared_lock lock(images_mutex);
+    auto it = images.find(image);
+    if (images.end() == it) return false;
+
+    it->second.data.copy((char *)dest, size);
+    return true;
+}
+
+std::string Settings::get_image_data(int image) const
+{
+    std::shared_lock lock(images_mutex);
+    auto it = images.find(image);
+    if (images.end() == it) return std::string();
+
+    return it->second.data;
+}
+
 
 void Settings::acceptAnyOverlayInvites(bool value)
 {
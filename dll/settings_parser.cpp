@@ -16,6 +16,7 @@
    <http://www.gnu.org/licenses/>.  */
 
 #include "dll/settings_parser.h"
+#include "dll/metrics.h"
 
 #define SI_CONVERT_GENERIC
 #define SI_SUPPORT_IOSTREAMS
@@ -1141,6 +1142,15 @@ static void parse_mods_folder(class Settings *settings_client, Settings *setting
 
 
 
+#ifndef EMU_RELEASE_BUILD
+static void flush_debug_log_on_crash()
+{
+    dbg_logger.flush_on_crash();
+}
+#endif
+
+static bool crash_printer_installed = false;
+
 // main::general::crash_printer_location
 static void parse_crash_printer_location()
 {
@@ -1149,6 +1159,7 @@ static void parse_crash_printer_location()
         auto crash_path = common_helpers::to_absolute(line, get_full_program_path());
         if (crash_path.size()) {
             if (crash_printer::init(crash_path)) {
+                crash_printer_installed = true;
                 PRINT_DEBUG("Unhandled crashes will be saved to '%s'", crash_path.c_str());
             } else {
                 PRINT_DEBUG("Failed to setup unhandled crash printer with path: '%s'", crash_path.c_str());
@@ -1157,6 +1168,63 @@ static void parse_crash_printer_location()
     }
 }
 
+// main::misc::debug_log_level
+// main::misc::debug_log_filter
+static void parse_debug_log()
+{
+#ifndef EMU_RELEASE_BUILD
+    static const std::map<std::string, dbg_log::level> levels {
+        { "error", dbg_log::level::error },
+        { "warn", dbg_log::level::warn },
+        { "info", dbg_log::level::info },
+        { "debug", dbg_log::level::debug },
+        { "trace", dbg_log::level::trace },
+    };
+
+    std::string level(common_helpers::to_lower(common_helpers::string_strip(ini.GetValue("main::misc", "debug_log_level", "trace"))));
+    auto it = levels.find(level);
+    if (it != levels.end()) {
+        dbg_logger.set_level(it->second);
+    } else {
+        PRINT_DEBUG("unknown debug_log_level '%s'", level.c_str());
+    }
+
+    std::string filter(common_helpers::string_strip(ini.GetValue("main::misc", "debug_log_filter", "")));
+    dbg_logger.set_filter(filter);
+    if (filter.size()) PRINT_DEBUG("debug log filter '%s'", filter.c_str());
+
+    // we're past the module loading here, the writer thread can start
+    dbg_logger.start_writer();
+
+    // the buffered lines die with the process, a crash writes them out even when no crash log was asked for
+    if (!crash_printer_installed) crash_printer_installed = crash_printer::init(std::string());
+    if (crash_printer_installed) crash_printer::set_on_crash(&flush_debug_log_on_crash);
+#endif
+}
+
+// main::misc::lock_contention_profile
+static void parse_lock_contention_profile()
+{
+    bool enable = ini.GetBoolValue("main::misc", "lock_contention_profile", false);
+    set_lock_contention_profiling(enable);
+    PRINT_DEBUG("lock contention profiling %i", (int)enable);
+}
+
+// main::misc::metrics_file
+// main::misc::metrics_dump_interval
+static void parse_metrics()
+{
+    std::string line(common_helpers::string_strip(ini.GetValue("main::misc", "metrics_file", "")));
+    if (line.empty()) return;
+
+    auto metrics_path = common_helpers::to_absolute(line, get_full_program_path());
+    if (metrics_path.empty()) return;
+
+    double interval = ini.GetDoubleValue("main::misc", "metrics_dump_interval", 0);
+    metrics_configure(metrics_path, interval);
+    PRINT_DEBUG("metrics will be written to '%s' every %f seconds", metrics_path.c_str(), interval);
+}
+
 // auto_accept_invite.txt
 static void parse_auto_accept_invite(class Settings *settings_client, class Settings *settings_server)
 {
@@ -1387,6 +1455,18 @@ static void parse_simple_features(class Settings *settings_client, class Setting
     settings_client->disable_networking = ini.GetBoolValue("main::connectivity", "disable_networking", settings_client->disable_networking);
     settings_server->disable_networking = ini.GetBoolValue("main::connectivity", "disable_networking", settings_server->disable_networking);
 
+    settings_client->network_io_thread = ini.GetBoolValue("main::connectivity", "network_io_thread", settings_client->network_io_thread);
+    settings_server->network_io_thread = ini.GetBoolValue("main::connectivity", "network_io_thread", settings_server->network_io_thread);
+
+    {
+        auto val = ini.GetLongValue("main::connectivity", "nagle_time_us", -1);
+        if (val >= 0) {
+            settings_client->nagle_time_us = val;
+            settings_server->nagle_time_us = val;
+            PRINT_DEBUG("Setting Nagle time to %i us", (int)val);
+        }
+    }
+
     settings_client->disable_sharing_stats_with_gameserver = ini.GetBoolValue("main::connectivity", "disable_sharing_stats_with_gameserver", settings_client->disable_sharing_stats_with_gameserver);
     settings_server->disable_sharing_stats_with_gameserver = ini.GetBoolValue("main::connectivity", "disable_sharing_stats_with_gameserver", settings_server->disable_sharing_stats_with_gameserver);
     
@@ -1620,6 +1700,9 @@ uint32 create_localstorage_settings(Settings **settings_client_out, Settings **s
 #endif
 
     parse_crash_printer_location();
+    parse_debug_log();
+    parse_lock_contention_profile();
+    parse_metrics();
 
     const std::string program_path(Local_Storage::get_program_path());
     const std::string steam_settings_path(Local_Storage::get_game_settings_path());
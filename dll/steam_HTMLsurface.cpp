@@ -30,14 +30,14 @@ Steam_HTMLsurface::Steam_HTMLsurface(class Settings *settings, class Networking
 bool Steam_HTMLsurface::Init()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
 bool Steam_HTMLsurface::Shutdown()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -59,7 +59,7 @@ STEAM_CALL_RESULT( HTML_BrowserReady_t )
 SteamAPICall_t Steam_HTMLsurface::CreateBrowser( const char *pchUserAgent, const char *pchUserCSS )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     HTML_BrowserReady_t data;
     data.unBrowserHandle = 1234869;
     
@@ -73,7 +73,7 @@ SteamAPICall_t Steam_HTMLsurface::CreateBrowser( const char *pchUserAgent, const
 void Steam_HTMLsurface::RemoveBrowser( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -81,7 +81,7 @@ void Steam_HTMLsurface::RemoveBrowser( HHTMLBrowser unBrowserHandle )
 void Steam_HTMLsurface::LoadURL( HHTMLBrowser unBrowserHandle, const char *pchURL, const char *pchPostData )
 {
     PRINT_DEBUG("TODO %s %s", pchURL, pchPostData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     static char url[256];
     strncpy(url, pchURL, sizeof(url));
     static char target[] = "_self";
@@ -112,7 +112,7 @@ void Steam_HTMLsurface::LoadURL( HHTMLBrowser unBrowserHandle, const char *pchUR
 void Steam_HTMLsurface::SetSize( HHTMLBrowser unBrowserHandle, uint32 unWidth, uint32 unHeight )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -120,28 +120,28 @@ void Steam_HTMLsurface::SetSize( HHTMLBrowser unBrowserHandle, uint32 unWidth, u
 void Steam_HTMLsurface::StopLoad( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Reload (most likely from local cache) the current page
 void Steam_HTMLsurface::Reload( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // navigate back in the page history
 void Steam_HTMLsurface::GoBack( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // navigate forward in the page history
 void Steam_HTMLsurface::GoForward( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -149,60 +149,60 @@ void Steam_HTMLsurface::GoForward( HHTMLBrowser unBrowserHandle )
 void Steam_HTMLsurface::AddHeader( HHTMLBrowser unBrowserHandle, const char *pchKey, const char *pchValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // run this javascript script in the currently loaded page
 void Steam_HTMLsurface::ExecuteJavascript( HHTMLBrowser unBrowserHandle, const char *pchScript )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Mouse click and mouse movement commands
 void Steam_HTMLsurface::MouseUp( HHTMLBrowser unBrowserHandle, EHTMLMouseButton eMouseButton )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_HTMLsurface::MouseDown( HHTMLBrowser unBrowserHandle, EHTMLMouseButton eMouseButton )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_HTMLsurface::MouseDoubleClick( HHTMLBrowser unBrowserHandle, EHTMLMouseButton eMouseButton )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // x and y are relative to the HTML bounds
 void Steam_HTMLsurface::MouseMove( HHTMLBrowser unBrowserHandle, int x, int y )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // nDelta is pixels of scroll
 void Steam_HTMLsurface::MouseWheel( HHTMLBrowser unBrowserHandle, int32 nDelta )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // keyboard interactions, native keycode is the key code value from your OS
 void Steam_HTMLsurface::KeyDown( HHTMLBrowser unBrowserHandle, uint32 nNativeKeyCode, EHTMLKeyModifiers eHTMLKeyModifiers, bool bIsSystemKey )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_HTMLsurface::KeyDown( HHTMLBrowser unBrowserHandle, uint32 nNativeKeyCode, EHTMLKeyModifiers eHTMLKeyModifiers)
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     KeyDown(unBrowserHandle, nNativeKeyCode, eHTMLKeyModifiers, false);
 }
 
@@ -210,14 +210,14 @@ void Steam_HTMLsurface::KeyDown( HHTMLBrowser unBrowserHandle, uint32 nNativeKey
 void Steam_HTMLsurface::KeyUp( HHTMLBrowser unBrowserHandle, uint32 nNativeKeyCode, EHTMLKeyModifiers eHTMLKeyModifiers )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // cUnicodeChar is the unicode character point for this keypress (and potentially multiple chars per press)
 void Steam_HTMLsurface::KeyChar( HHTMLBrowser unBrowserHandle, uint32 cUnicodeChar, EHTMLKeyModifiers eHTMLKeyModifiers )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -225,13 +225,13 @@ void Steam_HTMLsurface::KeyChar( HHTMLBrowser unBrowserHandle, uint32 cUnicodeCh
 void Steam_HTMLsurface::SetHorizontalScroll( HHTMLBrowser unBrowserHandle, uint32 nAbsolutePixelScroll )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_HTMLsurface::SetVerticalScroll( HHTMLBrowser unBrowserHandle, uint32 nAbsolutePixelScroll )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -239,7 +239,7 @@ void Steam_HTMLsurface::SetVerticalScroll( HHTMLBrowser unBrowserHandle, uint32
 void Steam_HTMLsurface::SetKeyFocus( HHTMLBrowser unBrowserHandle, bool bHasKeyFocus )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -247,21 +247,21 @@ void Steam_HTMLsurface::SetKeyFocus( HHTMLBrowser unBrowserHandle, bool bHasKeyF
 void Steam_HTMLsurface::ViewSource( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // copy the currently selected text on the html page to the local clipboard
 void Steam_HTMLsurface::CopyToClipboard( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // paste from the local clipboard to the current html page
 void Steam_HTMLsurface::PasteFromClipboard( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -269,14 +269,14 @@ void Steam_HTMLsurface::PasteFromClipboard( HHTMLBrowser unBrowserHandle )
 void Steam_HTMLsurface::Find( HHTMLBrowser unBrowserHandle, const char *pchSearchStr, bool bCurrentlyInFind, bool bReverse )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // cancel a currently running find
 void Steam_HTMLsurface::StopFind( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -284,7 +284,7 @@ void Steam_HTMLsurface::StopFind( HHTMLBrowser unBrowserHandle )
 void Steam_HTMLsurface::GetLinkAtPosition(  HHTMLBrowser unBrowserHandle, int x, int y )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -292,7 +292,7 @@ void Steam_HTMLsurface::GetLinkAtPosition(  HHTMLBrowser unBrowserHandle, int x,
 void Steam_HTMLsurface::SetCookie( const char *pchHostname, const char *pchKey, const char *pchValue, const char *pchPath, RTime32 nExpires, bool bSecure, bool bHTTPOnly )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -300,7 +300,7 @@ void Steam_HTMLsurface::SetCookie( const char *pchHostname, const char *pchKey,
 void Steam_HTMLsurface::SetPageScaleFactor( HHTMLBrowser unBrowserHandle, float flZoom, int nPointX, int nPointY )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -311,7 +311,7 @@ void Steam_HTMLsurface::SetPageScaleFactor( HHTMLBrowser unBrowserHandle, float
 void Steam_HTMLsurface::SetBackgroundMode( HHTMLBrowser unBrowserHandle, bool bBackgroundMode )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -320,13 +320,13 @@ void Steam_HTMLsurface::SetBackgroundMode( HHTMLBrowser unBrowserHandle, bool bB
 void Steam_HTMLsurface::SetDPIScalingFactor( HHTMLBrowser unBrowserHandle, float flDPIScaling )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_HTMLsurface::OpenDeveloperTools( HHTMLBrowser unBrowserHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // CALLBACKS
@@ -341,7 +341,7 @@ void Steam_HTMLsurface::OpenDeveloperTools( HHTMLBrowser unBrowserHandle )
 void Steam_HTMLsurface::AllowStartRequest( HHTMLBrowser unBrowserHandle, bool bAllowed )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -350,7 +350,7 @@ void Steam_HTMLsurface::AllowStartRequest( HHTMLBrowser unBrowserHandle, bool bA
 void Steam_HTMLsurface::JSDialogResponse( HHTMLBrowser unBrowserHandle, bool bResult )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -359,5 +359,5 @@ STEAM_IGNOREATTR()
 void Steam_HTMLsurface::FileLoadDialogResponse( HHTMLBrowser unBrowserHandle, const char **pchSelectedFiles )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
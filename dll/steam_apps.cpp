@@ -63,7 +63,7 @@ bool Steam_Apps::BIsVACBanned()
 const char *Steam_Apps::GetCurrentGameLanguage()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->get_language();
 }
 
@@ -72,7 +72,7 @@ const char *Steam_Apps::GetCurrentGameLanguage()
 const char *Steam_Apps::GetAvailableGameLanguages()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->get_supported_languages().c_str();
 }
 
@@ -81,7 +81,7 @@ const char *Steam_Apps::GetAvailableGameLanguages()
 bool Steam_Apps::BIsSubscribedApp( AppId_t appID )
 {
     PRINT_DEBUG("%u", appID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (appID == 0) return false; // steam returns false
     if (appID == UINT32_MAX) return true; // steam returns true
     if (appID == settings->get_local_game_id().AppID()) return true; // steam returns true
@@ -93,7 +93,7 @@ bool Steam_Apps::BIsSubscribedApp( AppId_t appID )
 bool Steam_Apps::BIsDlcInstalled( AppId_t appID )
 {
     PRINT_DEBUG("%u", appID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (appID == 0) return false; // steam returns false (also appid 1958220 expects false otherwise it hangs in loading screen)
     if (appID == UINT32_MAX) return false; // steam returns false
     
@@ -109,7 +109,7 @@ bool Steam_Apps::BIsDlcInstalled( AppId_t appID )
 uint32 Steam_Apps::GetEarliestPurchaseUnixTime( AppId_t nAppID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (nAppID == 0) return 0; // steam returns 0
     if (nAppID == UINT32_MAX) return 0; // steam returns 0
     if (nAppID == settings->get_local_game_id().AppID() || settings->hasDLC(nAppID)) {
@@ -140,7 +140,7 @@ bool Steam_Apps::BIsSubscribedFromFreeWeekend()
 int Steam_Apps::GetDLCCount()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->DLCCount();
 }
 
@@ -149,7 +149,7 @@ int Steam_Apps::GetDLCCount()
 bool Steam_Apps::BGetDLCDataByIndex( int iDLC, AppId_t *pAppID, bool *pbAvailable, char *pchName, int cchNameBufferSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     AppId_t appid = k_uAppIdInvalid;
     bool available = false;
     std::string name{};
@@ -171,7 +171,7 @@ void Steam_Apps::InstallDLC( AppId_t nAppID )
 {
     PRINT_DEBUG_TODO();
     // we lock here because the API is supposed to modify the DLC list
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (settings->hasDLC(nAppID)) {
         DlcInstalled_t data{};
@@ -184,7 +184,7 @@ void Steam_Apps::UninstallDLC( AppId_t nAppID )
 {
     PRINT_DEBUG_ENTRY();
     // we lock here because the API is supposed to modify the DLC list
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -218,7 +218,7 @@ static void FillProofOfPurchaseKey( AppProofOfPurchaseKeyResponse_t& data, AppId
 void Steam_Apps::RequestAppProofOfPurchaseKey( AppId_t nAppID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     AppProofOfPurchaseKeyResponse_t data{};
     data.m_nAppID = nAppID;
@@ -242,7 +242,7 @@ void Steam_Apps::RequestAppProofOfPurchaseKey( AppId_t nAppID )
 bool Steam_Apps::GetCurrentBetaName( char *pchName, int cchNameBufferSize )
 {
     PRINT_DEBUG("%p [%i]", pchName, cchNameBufferSize);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     const auto &current_branch_name = settings->branches[settings->selected_branch_idx].name;
     if (pchName && cchNameBufferSize > 0 && static_cast<size_t>(cchNameBufferSize) > current_branch_name.size()) {
@@ -258,7 +258,7 @@ bool Steam_Apps::GetCurrentBetaName( char *pchName, int cchNameBufferSize )
 bool Steam_Apps::MarkContentCorrupt( bool bMissingFilesOnly )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO: warn user
     return true;
 }
@@ -268,7 +268,7 @@ uint32 Steam_Apps::GetInstalledDepots( AppId_t appID, DepotId_t *pvecDepots, uin
 {
     PRINT_DEBUG("%u, %u", appID, cMaxDepots);
     //TODO not sure about the behavior of this function, I didn't actually test this.
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     unsigned int count = (unsigned int)settings->depots.size();
     if (!pvecDepots || !cMaxDepots || !count) return 0;
 
@@ -287,7 +287,7 @@ uint32 Steam_Apps::GetInstalledDepots( DepotId_t *pvecDepots, uint32 cMaxDepots
 uint32 Steam_Apps::GetAppInstallDir( AppId_t appID, char *pchFolder, uint32 cchFolderBufferSize )
 {
     PRINT_DEBUG("%u %p %u", appID, pchFolder, cchFolderBufferSize);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO return real path instead of dll path
     std::string installed_path = settings->getAppInstallPath(appID);
 
@@ -319,7 +319,7 @@ uint32 Steam_Apps::GetAppInstallDir( AppId_t appID, char *pchFolder, uint32 cchF
 bool Steam_Apps::BIsAppInstalled( AppId_t appID )
 {
     PRINT_DEBUG("%u", appID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (appID == 0) return false; // steam returns false
     // game LEGO 2K Drive (app id 1451810) checks for a proper steam behavior by sending uint32_max and expects false in return
@@ -337,7 +337,7 @@ bool Steam_Apps::BIsAppInstalled( AppId_t appID )
 CSteamID Steam_Apps::GetAppOwner()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->get_local_steam_id();
 }
 
@@ -348,7 +348,7 @@ CSteamID Steam_Apps::GetAppOwner()
 const char *Steam_Apps::GetLaunchQueryParam( const char *pchKey )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return "";
 }
 
@@ -357,7 +357,7 @@ const char *Steam_Apps::GetLaunchQueryParam( const char *pchKey )
 bool Steam_Apps::GetDlcDownloadProgress( AppId_t nAppID, uint64 *punBytesDownloaded, uint64 *punBytesTotal )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
  
@@ -366,7 +366,7 @@ bool Steam_Apps::GetDlcDownloadProgress( AppId_t nAppID, uint64 *punBytesDownloa
 int Steam_Apps::GetAppBuildId()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return static_cast<int>(this->settings->branches[settings->selected_branch_idx].build_id);
 }
 
@@ -378,7 +378,7 @@ int Steam_Apps::GetAppBuildId()
 void Steam_Apps::RequestAllProofOfPurchaseKeys()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     // current app
     {
         AppProofOfPurchaseKeyResponse_t data{};
@@ -413,7 +413,7 @@ STEAM_CALL_RESULT( FileDetailsResult_t )
 SteamAPICall_t Steam_Apps::GetFileDetails( const char* pszFileName )
 {
     PRINT_DEBUG("%s", pszFileName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     FileDetailsResult_t data = {};
     //TODO? this function should only return found if file is actually part of the steam depots
     if (file_exists_(pszFileName)) {
@@ -444,7 +444,7 @@ SteamAPICall_t Steam_Apps::GetFileDetails( const char* pszFileName )
 int Steam_Apps::GetLaunchCommandLine( char *pszCommandLine, int cubCommandLine )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -452,7 +452,7 @@ int Steam_Apps::GetLaunchCommandLine( char *pszCommandLine, int cubCommandLine )
 bool Steam_Apps::BIsSubscribedFromFamilySharing()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -460,7 +460,7 @@ bool Steam_Apps::BIsSubscribedFromFamilySharing()
 bool Steam_Apps::BIsTimedTrial( uint32* punSecondsAllowed, uint32* punSecondsPlayed )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -469,7 +469,7 @@ bool Steam_Apps::BIsTimedTrial( uint32* punSecondsAllowed, uint32* punSecondsPla
 bool Steam_Apps::SetDlcContext( AppId_t nAppID )
 {
     PRINT_DEBUG("%u // TODO", nAppID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     // TODO this one is very odd, in all other functions of this interface they were returning false
     // tested by `universal963` on real steam
@@ -487,7 +487,7 @@ bool Steam_Apps::SetDlcContext( AppId_t nAppID )
 int Steam_Apps::GetNumBetas( int *pnAvailable, int *pnPrivate )
 {
     PRINT_DEBUG("%p, %p", pnAvailable, pnPrivate);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     // I assume 'available' means installed on the user's disk and could be used
     // in that case only 1 should be *available* since the user can only have 1 active and usable branch with the emu, unlike real steam
@@ -522,7 +522,7 @@ bool Steam_Apps::GetBetaInfo( int iBetaIndex, uint32 *punFlags, uint32 *punBuild
 {
     // I assume this API is like "Steam_User_Stats::GetNextMostAchievedAchievementInfo()", it returns 'ok' until index is out of range
     PRINT_DEBUG("[%i] %p %p --- %p %i --- %p %i", iBetaIndex, punFlags, punBuildID, pchBetaName, cchBetaName, pchDescription, cchDescription);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (iBetaIndex < 0) return false;
     if (static_cast<size_t>(iBetaIndex) >= settings->branches.size()) return false;
@@ -550,7 +550,7 @@ bool Steam_Apps::GetBetaInfo( int iBetaIndex, uint32 *punFlags, uint32 *punBuild
 bool Steam_Apps::SetActiveBeta( const char *pchBetaName )
 {
     PRINT_DEBUG("'%s'", pchBetaName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     // (sdk 1.60) apparently steam always returns true if the string is null or empty, tested by 'universal963' on appid 480
     if (!pchBetaName || !pchBetaName[0]) return true;
@@ -580,7 +580,7 @@ bool Steam_Apps::SetActiveBeta( const char *pchBetaName )
 	SteamAPICall_t Steam_Apps::RegisterActivationCode( const char *pchActivationCode )
     {
         PRINT_DEBUG("%s", pchActivationCode);
-        std::lock_guard<std::recursive_mutex> lock(global_mutex);
+        Emu_Lock_Guard lock(global_mutex);
 
         if (!pchActivationCode) return 
         RegisterActivationCodeResponse_t data{};
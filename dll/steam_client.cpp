@@ -17,6 +17,23 @@
 
 #include "dll/steam_client.h"
 #include "dll/settings_parser.h"
+#include "dll/metrics.h"
+
+// seconds between two lock contention reports in the debug log, when lock_contention_profile is enabled
+#define LOCK_CONTENTION_REPORT_INTERVAL 30.0
+
+static void lock_contention_report_timer(void *object, uint64 data)
+{
+    report_lock_contention();
+    ((Timer_Wheel *)object)->add(LOCK_CONTENTION_REPORT_INTERVAL, &lock_contention_report_timer, object);
+}
+
+// the timers run with global_mutex held, the snapshot is written by the next metrics_dump_pending() outside of it
+static void metrics_dump_timer(void *object, uint64 data)
+{
+    metrics_request_dump();
+    ((Timer_Wheel *)object)->add(metrics_dump_interval(), &metrics_dump_timer, object);
+}
 
 
 void Steam_Client::background_thread_proc()
@@ -26,9 +43,10 @@ void Steam_Client::background_thread_proc()
     // if our time exceeds last run time of callbacks and it wasn't processing already
     const auto runcallbacks_timeout_ms = last_cb_run + max_stall_ms.count();
     if (!cb_run_active && (now_ms >= runcallbacks_timeout_ms)) {
-        std::lock_guard lock(global_mutex);
+        metrics_dump_pending();
+        Emu_Lock_Guard lock(global_mutex);
 
-        PRINT_DEBUG("run @@@@@@@@@@@@@@@@@@@@@@@@@@@");
+        PRINT_DEBUG_TRACE("run @@@@@@@@@@@@@@@@@@@@@@@@@@@");
         last_cb_run = now_ms; // update the time counter just to avoid overlap
         network->Run(); // networking must run first since it receives messages used by each run_callback()
         run_every_runcb->run(); // call each run_callback()
@@ -46,9 +64,16 @@ Steam_Client::Steam_Client()
         std::chrono::duration_cast<std::chrono::milliseconds>(initial_delay),
         std::chrono::duration_cast<std::chrono::milliseconds>(max_stall_ms)
     );
-    network = new Networking(settings_server->get_local_steam_id(), appid, settings_server->get_port(), &(settings_server->custom_broadcasts), settings_server->disable_networking);
+    network = new Networking(settings_server->get_local_steam_id(), appid, settings_server->get_port(), &(settings_server->custom_broadcasts), settings_server->disable_networking, settings_server->network_io_thread);
 
     run_every_runcb = new RunEveryRunCB();
+    if (lock_contention_profiling()) {
+        run_every_runcb->get_timers()->add(LOCK_CONTENTION_REPORT_INTERVAL, &lock_contention_report_timer, run_every_runcb->get_timers());
+    }
+
+    if (metrics_dump_interval() > 0) {
+        run_every_runcb->get_timers()->add(metrics_dump_interval(), &metrics_dump_timer, run_every_runcb->get_timers());
+    }
 
     PRINT_DEBUG(
         "init: id: %llu server id: %llu, appid: %u, port: %u",
@@ -85,7 +110,7 @@ Steam_Client::Steam_Client()
 
     // client
     PRINT_DEBUG("init client");
-    callback_results_client = new SteamCallResults();
+    callback_results_client = new SteamCallResults(run_every_runcb->get_timers());
     callbacks_client = new SteamCallBacks(callback_results_client);
     steam_overlay = new Steam_Overlay(settings_client, local_storage, callback_results_client, callbacks_client, run_every_runcb, network);
 
@@ -127,10 +152,10 @@ Steam_Client::Steam_Client()
 
     // server
     PRINT_DEBUG("init gameserver");
-    callback_results_server = new SteamCallResults();
+    callback_results_server = new SteamCallResults(run_every_runcb->get_timers());
     callbacks_server = new SteamCallBacks(callback_results_server);
 
-    steam_gameserver = new Steam_GameServer(settings_server, network, callbacks_server);
+    steam_gameserver = new Steam_GameServer(settings_server, network, callbacks_server, run_every_runcb);
     steam_gameserver_utils = new Steam_Utils(settings_server, callback_results_server, callbacks_server, steam_overlay);
     steam_gameserverstats = new Steam_GameServerStats(settings_server, network, callback_results_server, callbacks_server, run_every_runcb);
     steam_gameserver_networking = new Steam_Networking(settings_server, network, callbacks_server, run_every_runcb);
@@ -160,6 +185,10 @@ Steam_Client::~Steam_Client()
     #define DEL_INST(_obj_ins) do if (_obj_ins) { delete _obj_ins; _obj_ins = nullptr; } while(0)
 
     DEL_INST(background_thread);
+    report_lock_contention();
+    metrics_dump();
+    if (steam_user_stats) steam_user_stats->flush_stats_store();
+    local_storage->flush();
 
     DEL_INST(steam_gameserver);
     DEL_INST(steam_gameserver_utils);
@@ -247,16 +276,19 @@ bool Steam_Client::IsUserLogIn()
 void Steam_Client::serverShutdown()
 {
     server_init = false;
+    local_storage->flush();
 }
 
 void Steam_Client::clientShutdown()
 {
     user_logged_in = false;
+    if (steam_user_stats) steam_user_stats->flush_stats_store();
+    local_storage->flush();
 }
 
 void Steam_Client::setAppID(uint32 appid)
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (appid && !settings_client->get_local_game_id().AppID()) {
         settings_client->set_game_id(CGameID(appid));
         settings_server->set_game_id(CGameID(appid));
@@ -437,7 +469,7 @@ void Steam_Client::DEPRECATED_Remove_SteamAPI_CPostAPIResultInProcess( void (*)(
 void Steam_Client::Set_SteamAPI_CCheckCallbackRegisteredInProcess( SteamAPI_CheckCallbackRegistered_t func )
 {
     PRINT_DEBUG("%p // TODO", func);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_Client::Set_SteamAPI_CPostAPIResultInProcess( SteamAPI_PostAPIResultInProcess_t func )
@@ -900,7 +932,7 @@ void Steam_Client::UnregisterCallback( class CCallbackBase *pCallback)
 void Steam_Client::RegisterCallResult( class CCallbackBase *pCallback, SteamAPICall_t hAPICall)
 {
     PRINT_DEBUG("%llu %i", hAPICall, pCallback->GetICallback());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     callback_results_client->addCallBack(hAPICall, pCallback);
     callback_results_server->addCallBack(hAPICall, pCallback);
     
@@ -909,48 +941,60 @@ void Steam_Client::RegisterCallResult( class CCallbackBase *pCallback, SteamAPIC
 void Steam_Client::UnregisterCallResult( class CCallbackBase *pCallback, SteamAPICall_t hAPICall)
 {
     PRINT_DEBUG("%llu %i", hAPICall, pCallback->GetICallback());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     callback_results_client->rmCallBack(hAPICall, pCallback);
     callback_results_server->rmCallBack(hAPICall, pCallback);
 }
 
 void Steam_Client::RunCallbacks(bool runClientCB, bool runGameserverCB)
 {
-    PRINT_DEBUG("begin ------------------------------------------------------");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    PRINT_DEBUG_TRACE("begin ------------------------------------------------------");
+    // serializing and writing the snapshot must not hold up the other threads
+    metrics_dump_pending();
+    Emu_Lock_Guard lock(global_mutex);
     cb_run_active = true;
+    metrics_add(METRIC_RUNCALLBACKS);
+    Metrics_Timer total(METRIC_RUNCALLBACKS_TOTAL);
+    Metrics_Timer phase(METRIC_RUNCALLBACKS_NETWORK);
 
     // PRINT_DEBUG("network *********");
     network->Run(); // networking must run first since it receives messages use by each run_callback()
 
     // PRINT_DEBUG("steam_matchmaking_servers *********");
+    phase.next(METRIC_RUNCALLBACKS_MATCHMAKING_SERVERS);
     steam_matchmaking_servers->RunCallbacks();
     
     // PRINT_DEBUG("run_every_runcb *********");
+    phase.next(METRIC_RUNCALLBACKS_RUN_EVERY_RUNCB);
     run_every_runcb->run();
 
     // PRINT_DEBUG("steam_gameserver *********");
+    phase.next(METRIC_RUNCALLBACKS_GAMESERVER);
     steam_gameserver->RunCallbacks();
 
     if (runClientCB) {
         // PRINT_DEBUG("callback_results_client *********");
+        phase.next(METRIC_RUNCALLBACKS_CALL_RESULTS_CLIENT);
         callback_results_client->runCallResults();
     }
 
     if (runGameserverCB) {
         // PRINT_DEBUG("callback_results_server *********");
+        phase.next(METRIC_RUNCALLBACKS_CALL_RESULTS_SERVER);
         callback_results_server->runCallResults();
     }
 
     // PRINT_DEBUG("callbacks_server *********");
+    phase.next(METRIC_RUNCALLBACKS_CALLBACKS);
     callbacks_server->runCallBacks();
 
     // PRINT_DEBUG("callbacks_client *********");
     callbacks_client->runCallBacks();
+    phase.stop();
 
     last_cb_run = (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     cb_run_active = false;
-    PRINT_DEBUG("done ******************************************************");
+    PRINT_DEBUG_TRACE("done ******************************************************");
 }
 
 void Steam_Client::DestroyAllInterfaces()
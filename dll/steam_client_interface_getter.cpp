@@ -931,7 +931,7 @@ ISteamAppTicket *Steam_Client::GetAppTicket( HSteamUser hSteamUser, HSteamPipe h
 void Steam_Client::report_missing_impl_and_exit(std::string_view itf, std::string_view caller)
 {
     PRINT_DEBUG("'%s' '%s'", itf.data(), caller.data());
-    std::lock_guard lck(global_mutex);
+    Emu_Lock_Guard lck(global_mutex);
     std::stringstream ss{};
 
     try {
@@ -238,7 +238,7 @@ Steam_Controller::~Steam_Controller()
 bool Steam_Controller::Init(bool bExplicitlyCallRunFrame)
 {
     PRINT_DEBUG("%u", bExplicitlyCallRunFrame);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (disabled || initialized) {
         return true;
     }
@@ -279,7 +279,7 @@ bool Steam_Controller::Init()
 bool Steam_Controller::Shutdown()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (disabled || !initialized) {
         return true;
     }
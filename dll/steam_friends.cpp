@@ -190,7 +190,7 @@ Steam_Friends::~Steam_Friends()
 const char* Steam_Friends::GetPersonaName()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const char *local_name = settings->get_local_name();
     
     return local_name;
@@ -207,7 +207,7 @@ STEAM_CALL_RESULT( SetPersonaNameResponse_t )
 SteamAPICall_t Steam_Friends::SetPersonaName( const char *pchPersonaName )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     SetPersonaNameResponse_t data{};
     data.m_bSuccess = true;
@@ -230,7 +230,7 @@ SteamAPICall_t Steam_Friends::SetPersonaName( const char *pchPersonaName )
 void Steam_Friends::SetPersonaName_old( const char *pchPersonaName )
 {
 	PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	SetPersonaName(pchPersonaName);
 }
 
@@ -238,7 +238,7 @@ void Steam_Friends::SetPersonaName_old( const char *pchPersonaName )
 EPersonaState Steam_Friends::GetPersonaState()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EPersonaStateOnline;
 }
 
@@ -249,7 +249,7 @@ EPersonaState Steam_Friends::GetPersonaState()
 int Steam_Friends::GetFriendCount( int iFriendFlags )
 {
     PRINT_DEBUG("%i", iFriendFlags);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int count = 0;
     if (ok_friend_flags(iFriendFlags)) count = static_cast<int>(friends.size());
     PRINT_DEBUG("count %i", count);
@@ -259,7 +259,7 @@ int Steam_Friends::GetFriendCount( int iFriendFlags )
 int Steam_Friends::GetFriendCount( EFriendFlags eFriendFlags )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	return GetFriendCount((int)eFriendFlags);
 }
 
@@ -270,7 +270,7 @@ int Steam_Friends::GetFriendCount( EFriendFlags eFriendFlags )
 CSteamID Steam_Friends::GetFriendByIndex( int iFriend, int iFriendFlags )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     CSteamID id = k_steamIDNil;
     if (ok_friend_flags(iFriendFlags)) {
         if (iFriend >= 0 && static_cast<size_t>(iFriend) < friends.size()) {
@@ -284,14 +284,14 @@ CSteamID Steam_Friends::GetFriendByIndex( int iFriend, int iFriendFlags )
 void Steam_Friends::GetFriendByIndex(CSteamID& res, int iFriend, int iFriendFlags )
 {
 	PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	res = GetFriendByIndex(iFriend, iFriendFlags );
 }
 
 CSteamID Steam_Friends::GetFriendByIndex( int iFriend, EFriendFlags eFriendFlags )
 {
 	PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	return GetFriendByIndex(iFriend, (int)eFriendFlags );
 }
 
@@ -299,7 +299,7 @@ CSteamID Steam_Friends::GetFriendByIndex( int iFriend, EFriendFlags eFriendFlags
 void Steam_Friends::GetFriendByIndex(CSteamID& result, int iFriend, EFriendFlags eFriendFlags)
 {
 	PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	result = GetFriendByIndex(iFriend, eFriendFlags );
 }
 
@@ -308,7 +308,7 @@ void Steam_Friends::GetFriendByIndex(CSteamID& result, int iFriend, EFriendFlags
 EFriendRelationship Steam_Friends::GetFriendRelationship( CSteamID steamIDFriend )
 {
     PRINT_DEBUG("%llu", steamIDFriend.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (steamIDFriend == settings->get_local_steam_id()) return k_EFriendRelationshipNone; //Real steam behavior
     if (find_friend(steamIDFriend)) return k_EFriendRelationshipFriend;
 
@@ -321,7 +321,7 @@ EFriendRelationship Steam_Friends::GetFriendRelationship( CSteamID steamIDFriend
 EPersonaState Steam_Friends::GetFriendPersonaState( CSteamID steamIDFriend )
 {
     PRINT_DEBUG("%llu", steamIDFriend.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     EPersonaState state = k_EPersonaStateOffline;
     if (steamIDFriend == settings->get_local_steam_id() || find_friend(steamIDFriend)) {
         state = k_EPersonaStateOnline;
@@ -339,7 +339,7 @@ EPersonaState Steam_Friends::GetFriendPersonaState( CSteamID steamIDFriend )
 const char* Steam_Friends::GetFriendPersonaName( CSteamID steamIDFriend )
 {
     PRINT_DEBUG("%llu", steamIDFriend.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const char *name = "Unknown User";
     if (steamIDFriend == settings->get_local_steam_id()) {
         name = settings->get_local_name();
@@ -357,7 +357,7 @@ const char* Steam_Friends::GetFriendPersonaName( CSteamID steamIDFriend )
 bool Steam_Friends::GetFriendGamePlayed( CSteamID steamIDFriend, STEAM_OUT_STRUCT() FriendGameInfo_t *pFriendGameInfo )
 {
     PRINT_DEBUG("%llu %p", steamIDFriend.ConvertToUint64(), pFriendGameInfo);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     bool ret = false;
 
     if (steamIDFriend == settings->get_local_steam_id()) {
@@ -393,7 +393,7 @@ bool Steam_Friends::GetFriendGamePlayed( CSteamID steamIDFriend, STEAM_OUT_STRUC
 bool Steam_Friends::GetFriendGamePlayed( CSteamID steamIDFriend, uint64 *pulGameID, uint32 *punGameIP, uint16 *pusGamePort, uint16 *pusQueryPort )
 {
 	PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	FriendGameInfo_t info;
 	bool ret = GetFriendGamePlayed(steamIDFriend, &info);
 	if (ret) {
@@ -410,7 +410,7 @@ bool Steam_Friends::GetFriendGamePlayed( CSteamID steamIDFriend, uint64 *pulGame
 const char* Steam_Friends::GetFriendPersonaNameHistory( CSteamID steamIDFriend, int iPersonaName )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const char *ret = "";
     if (iPersonaName == 0) ret = GetFriendPersonaName(steamIDFriend);
     else if (iPersonaName == 1) ret = "Some Old Name";
@@ -422,7 +422,7 @@ const char* Steam_Friends::GetFriendPersonaNameHistory( CSteamID steamIDFriend,
 int Steam_Friends::GetFriendSteamLevel( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 100;
 }
 
@@ -431,7 +431,7 @@ int Steam_Friends::GetFriendSteamLevel( CSteamID steamIDFriend )
 const char* Steam_Friends::GetPlayerNickname( CSteamID steamIDPlayer )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -441,7 +441,7 @@ const char* Steam_Friends::GetPlayerNickname( CSteamID steamIDPlayer )
 int Steam_Friends::GetFriendsGroupCount()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -449,7 +449,7 @@ int Steam_Friends::GetFriendsGroupCount()
 FriendsGroupID_t Steam_Friends::GetFriendsGroupIDByIndex( int iFG )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_FriendsGroupID_Invalid;
 }
 
@@ -457,7 +457,7 @@ FriendsGroupID_t Steam_Friends::GetFriendsGroupIDByIndex( int iFG )
 const char* Steam_Friends::GetFriendsGroupName( FriendsGroupID_t friendsGroupID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -465,7 +465,7 @@ const char* Steam_Friends::GetFriendsGroupName( FriendsGroupID_t friendsGroupID
 int Steam_Friends::GetFriendsGroupMembersCount( FriendsGroupID_t friendsGroupID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -473,7 +473,7 @@ int Steam_Friends::GetFriendsGroupMembersCount( FriendsGroupID_t friendsGroupID
 void Steam_Friends::GetFriendsGroupMembersList( FriendsGroupID_t friendsGroupID, STEAM_OUT_ARRAY_CALL(nMembersCount, GetFriendsGroupMembersCount, friendsGroupID ) CSteamID *pOutSteamIDMembers, int nMembersCount )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -482,7 +482,7 @@ void Steam_Friends::GetFriendsGroupMembersList( FriendsGroupID_t friendsGroupID,
 bool Steam_Friends::HasFriend( CSteamID steamIDFriend, int iFriendFlags )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     bool ret = false;
     if (ok_friend_flags(iFriendFlags)) if (find_friend(steamIDFriend)) ret = true;
     
@@ -492,7 +492,7 @@ bool Steam_Friends::HasFriend( CSteamID steamIDFriend, int iFriendFlags )
 bool Steam_Friends::HasFriend( CSteamID steamIDFriend, EFriendFlags eFriendFlags ) 
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	return HasFriend(steamIDFriend, (int)eFriendFlags );
 }
 
@@ -500,7 +500,7 @@ bool Steam_Friends::HasFriend( CSteamID steamIDFriend, EFriendFlags eFriendFlags
 int Steam_Friends::GetClanCount()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int counter = 0;
     for (auto &c : settings->subscribed_groups_clans) counter++;
     return counter;
@@ -509,7 +509,7 @@ int Steam_Friends::GetClanCount()
 CSteamID Steam_Friends::GetClanByIndex( int iClan )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int counter = 0;
     for (auto &c : settings->subscribed_groups_clans) {
         if (counter == iClan) return c.id;
@@ -521,14 +521,14 @@ CSteamID Steam_Friends::GetClanByIndex( int iClan )
 void Steam_Friends::GetClanByIndex( CSteamID& result, int iClan )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     result = GetClanByIndex(iClan);
 }
 
 const char* Steam_Friends::GetClanName( CSteamID steamIDClan )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     for (auto &c : settings->subscribed_groups_clans) {
         if (c.id.ConvertToUint64() == steamIDClan.ConvertToUint64()) return c.name.c_str();
     }
@@ -538,7 +538,7 @@ const char* Steam_Friends::GetClanName( CSteamID steamIDClan )
 const char* Steam_Friends::GetClanTag( CSteamID steamIDClan )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     for (auto &c : settings->subscribed_groups_clans) {
         if (c.id.ConvertToUint64() == steamIDClan.ConvertToUint64()) return c.tag.c_str();
     }
@@ -549,7 +549,7 @@ const char* Steam_Friends::GetClanTag( CSteamID steamIDClan )
 bool Steam_Friends::GetClanActivityCounts( CSteamID steamIDClan, int *pnOnline, int *pnInGame, int *pnChatting )
 {
     PRINT_DEBUG("TODO %llu", steamIDClan.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -557,7 +557,7 @@ bool Steam_Friends::GetClanActivityCounts( CSteamID steamIDClan, int *pnOnline,
 SteamAPICall_t Steam_Friends::DownloadClanActivityCounts( STEAM_ARRAY_COUNT(cClansToRequest) CSteamID *psteamIDClans, int cClansToRequest )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -569,7 +569,7 @@ SteamAPICall_t Steam_Friends::DownloadClanActivityCounts( STEAM_ARRAY_COUNT(cCla
 int Steam_Friends::GetFriendCountFromSource( CSteamID steamIDSource )
 {
     PRINT_DEBUG("TODO %llu", steamIDSource.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     return 0;
 }
@@ -577,14 +577,14 @@ int Steam_Friends::GetFriendCountFromSource( CSteamID steamIDSource )
 CSteamID Steam_Friends::GetFriendFromSourceByIndex( CSteamID steamIDSource, int iFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
 void Steam_Friends::GetFriendFromSourceByIndex( CSteamID& res, CSteamID steamIDSource, int iFriend )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetFriendFromSourceByIndex( steamIDSource, iFriend );
 }
 
@@ -593,7 +593,7 @@ void Steam_Friends::GetFriendFromSourceByIndex( CSteamID& res, CSteamID steamIDS
 bool Steam_Friends::IsUserInSource( CSteamID steamIDUser, CSteamID steamIDSource )
 {
     PRINT_DEBUG("%llu %llu", steamIDUser.ConvertToUint64(), steamIDSource.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (steamIDUser == settings->get_local_steam_id()) {
         if (settings->get_lobby() == steamIDSource) {
             return true;
@@ -616,7 +616,7 @@ bool Steam_Friends::IsUserInSource( CSteamID steamIDUser, CSteamID steamIDSource
 void Steam_Friends::SetInGameVoiceSpeaking( CSteamID steamIDUser, bool bSpeaking )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -625,7 +625,7 @@ void Steam_Friends::SetInGameVoiceSpeaking( CSteamID steamIDUser, bool bSpeaking
 void Steam_Friends::ActivateGameOverlay( const char *pchDialog )
 {
     PRINT_DEBUG("%s", pchDialog);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     overlay->OpenOverlay(pchDialog);
 }
 
@@ -644,7 +644,7 @@ void Steam_Friends::ActivateGameOverlay( const char *pchDialog )
 void Steam_Friends::ActivateGameOverlayToUser( const char *pchDialog, CSteamID steamID )
 {
     PRINT_DEBUG("TODO %s %llu", pchDialog, steamID.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -653,14 +653,14 @@ void Steam_Friends::ActivateGameOverlayToUser( const char *pchDialog, CSteamID s
 void Steam_Friends::ActivateGameOverlayToWebPage( const char *pchURL, EActivateGameOverlayToWebPageMode eMode )
 {
     PRINT_DEBUG("TODO %s %u", pchURL, eMode);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     overlay->OpenOverlayWebpage(pchURL);
 }
 
 void Steam_Friends::ActivateGameOverlayToWebPage( const char *pchURL )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     ActivateGameOverlayToWebPage( pchURL, k_EActivateGameOverlayToWebPageMode_Default );
 }
 
@@ -668,13 +668,13 @@ void Steam_Friends::ActivateGameOverlayToWebPage( const char *pchURL )
 void Steam_Friends::ActivateGameOverlayToStore( AppId_t nAppID, EOverlayToStoreFlag eFlag )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 void Steam_Friends::ActivateGameOverlayToStore( AppId_t nAppID)
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Mark a target user as 'played with'. This is a client-side only feature that requires that the calling user is 
@@ -682,7 +682,7 @@ void Steam_Friends::ActivateGameOverlayToStore( AppId_t nAppID)
 void Steam_Friends::SetPlayedWith( CSteamID steamIDUserPlayedWith )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -690,7 +690,7 @@ void Steam_Friends::SetPlayedWith( CSteamID steamIDUserPlayedWith )
 void Steam_Friends::ActivateGameOverlayInviteDialog( CSteamID steamIDLobby )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     overlay->OpenOverlayInvite(steamIDLobby);
 }
 
@@ -699,7 +699,7 @@ int Steam_Friends::GetSmallFriendAvatar( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_ENTRY();
     //IMPORTANT NOTE: don't change friend avatar numbers for the same friend or else some games endlessly allocate stuff.
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Avatar_Numbers numbers = add_friend_avatars(steamIDFriend);
     return numbers.smallest;
 }
@@ -709,7 +709,7 @@ int Steam_Friends::GetSmallFriendAvatar( CSteamID steamIDFriend )
 int Steam_Friends::GetMediumFriendAvatar( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Avatar_Numbers numbers = add_friend_avatars(steamIDFriend);
     return numbers.medium;
 }
@@ -720,7 +720,7 @@ int Steam_Friends::GetMediumFriendAvatar( CSteamID steamIDFriend )
 int Steam_Friends::GetLargeFriendAvatar( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Avatar_Numbers numbers = add_friend_avatars(steamIDFriend);
     return numbers.large;
 }
@@ -728,7 +728,7 @@ int Steam_Friends::GetLargeFriendAvatar( CSteamID steamIDFriend )
 int Steam_Friends::GetFriendAvatar( CSteamID steamIDFriend, int eAvatarSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	if (eAvatarSize == k_EAvatarSize32x32) {
 		return GetSmallFriendAvatar(steamIDFriend);
 	} else if (eAvatarSize == k_EAvatarSize64x64) {
@@ -743,7 +743,7 @@ int Steam_Friends::GetFriendAvatar( CSteamID steamIDFriend, int eAvatarSize )
 int Steam_Friends::GetFriendAvatar(CSteamID steamIDFriend)
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return GetFriendAvatar(steamIDFriend, k_EAvatarSize32x32);
 }
 
@@ -755,7 +755,7 @@ int Steam_Friends::GetFriendAvatar(CSteamID steamIDFriend)
 bool Steam_Friends::RequestUserInformation( CSteamID steamIDUser, bool bRequireNameOnly )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //persona_change(steamIDUser, k_EPersonaChangeName);
     //We already know everything
     return false;
@@ -772,7 +772,7 @@ STEAM_CALL_RESULT( ClanOfficerListResponse_t )
 SteamAPICall_t Steam_Friends::RequestClanOfficerList( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -783,14 +783,14 @@ SteamAPICall_t Steam_Friends::RequestClanOfficerList( CSteamID steamIDClan )
 CSteamID Steam_Friends::GetClanOwner( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
 void Steam_Friends::GetClanOwner(CSteamID& res, CSteamID steamIDClan )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetClanOwner( steamIDClan );
 }
 
@@ -798,7 +798,7 @@ void Steam_Friends::GetClanOwner(CSteamID& res, CSteamID steamIDClan )
 int Steam_Friends::GetClanOfficerCount( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -806,14 +806,14 @@ int Steam_Friends::GetClanOfficerCount( CSteamID steamIDClan )
 CSteamID Steam_Friends::GetClanOfficerByIndex( CSteamID steamIDClan, int iOfficer )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
 void Steam_Friends::GetClanOfficerByIndex(CSteamID& res, CSteamID steamIDClan, int iOfficer )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetClanOfficerByIndex( steamIDClan, iOfficer );
 }
 
@@ -823,14 +823,14 @@ void Steam_Friends::GetClanOfficerByIndex(CSteamID& res, CSteamID steamIDClan, i
 uint32 Steam_Friends::GetUserRestrictions()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_nUserRestrictionNone;
 }
 
 EUserRestriction Steam_Friends::GetUserRestrictions_old()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_nUserRestrictionNone;
 }
 
@@ -847,7 +847,7 @@ EUserRestriction Steam_Friends::GetUserRestrictions_old()
 bool Steam_Friends::SetRichPresence( const char *pchKey, const char *pchValue )
 {
     PRINT_DEBUG("%s %s", pchKey, pchValue ? pchValue : "NULL");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (pchValue) {
         auto prev_value = (*us.mutable_rich_presence()).find(pchKey);
         if (prev_value == (*us.mutable_rich_presence()).end() || prev_value->second != pchValue) {
@@ -868,7 +868,7 @@ bool Steam_Friends::SetRichPresence( const char *pchKey, const char *pchValue )
 void Steam_Friends::ClearRichPresence()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     us.mutable_rich_presence()->clear();
     resend_friend_data();
     
@@ -877,7 +877,7 @@ void Steam_Friends::ClearRichPresence()
 // the overlay will keep calling GetFriendRichPresence() and spam the debug log, hence this function
 const char* Steam_Friends::get_friend_rich_presence_silent( CSteamID steamIDFriend, const char *pchKey )
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const char *value = "";
 
     Friend *f = NULL;
@@ -898,7 +898,7 @@ const char* Steam_Friends::get_friend_rich_presence_silent( CSteamID steamIDFrie
 const char* Steam_Friends::GetFriendRichPresence( CSteamID steamIDFriend, const char *pchKey )
 {
     PRINT_DEBUG("%llu '%s'", steamIDFriend.ConvertToUint64(), pchKey);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     const char *value = get_friend_rich_presence_silent(steamIDFriend, pchKey);
 
@@ -909,7 +909,7 @@ const char* Steam_Friends::GetFriendRichPresence( CSteamID steamIDFriend, const
 int Steam_Friends::GetFriendRichPresenceKeyCount( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int num = 0;
 
     Friend *f = NULL;
@@ -927,7 +927,7 @@ int Steam_Friends::GetFriendRichPresenceKeyCount( CSteamID steamIDFriend )
 const char* Steam_Friends::GetFriendRichPresenceKeyByIndex( CSteamID steamIDFriend, int iKey )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const char *key = "";
 
     Friend *f = NULL;
@@ -951,7 +951,7 @@ const char* Steam_Friends::GetFriendRichPresenceKeyByIndex( CSteamID steamIDFrie
 void Steam_Friends::RequestFriendRichPresence( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Friend *f = find_friend(steamIDFriend);
     if (f) rich_presence_updated(steamIDFriend, settings->get_local_game_id().AppID());
     
@@ -965,7 +965,7 @@ void Steam_Friends::RequestFriendRichPresence( CSteamID steamIDFriend )
 bool Steam_Friends::InviteUserToGame( CSteamID steamIDFriend, const char *pchConnectString )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Friend *f = find_friend(steamIDFriend);
     if (!f) return false;
 
@@ -986,35 +986,35 @@ bool Steam_Friends::InviteUserToGame( CSteamID steamIDFriend, const char *pchCon
 int Steam_Friends::GetCoplayFriendCount()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 CSteamID Steam_Friends::GetCoplayFriend( int iCoplayFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
 void Steam_Friends::GetCoplayFriend( CSteamID& res, int iCoplayFriend )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetCoplayFriend( iCoplayFriend );
 }
 
 int Steam_Friends::GetFriendCoplayTime( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 AppId_t Steam_Friends::GetFriendCoplayGame( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1028,7 +1028,7 @@ SteamAPICall_t Steam_Friends::JoinClanChatRoom( CSteamID steamIDClan )
 {
     PRINT_DEBUG("TODO %llu", steamIDClan.ConvertToUint64());
     //TODO actually join a room
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     JoinClanChatRoomCompletionResult_t data;
     data.m_steamIDClanChat = steamIDClan;
     data.m_eChatRoomEnterResponse = k_EChatRoomEnterResponseSuccess;
@@ -1038,49 +1038,49 @@ SteamAPICall_t Steam_Friends::JoinClanChatRoom( CSteamID steamIDClan )
 bool Steam_Friends::LeaveClanChatRoom( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 int Steam_Friends::GetClanChatMemberCount( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 CSteamID Steam_Friends::GetChatMemberByIndex( CSteamID steamIDClan, int iUser )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
 void Steam_Friends::GetChatMemberByIndex(CSteamID& res, CSteamID steamIDClan, int iUser )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetChatMemberByIndex( steamIDClan, iUser );
 }
 
 bool Steam_Friends::SendClanChatMessage( CSteamID steamIDClanChat, const char *pchText )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 int Steam_Friends::GetClanChatMessage( CSteamID steamIDClanChat, int iMessage, void *prgchText, int cchTextMax, EChatEntryType *peChatEntryType, STEAM_OUT_STRUCT() CSteamID *psteamidChatter )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 bool Steam_Friends::IsClanChatAdmin( CSteamID steamIDClanChat, CSteamID steamIDUser )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1089,21 +1089,21 @@ bool Steam_Friends::IsClanChatAdmin( CSteamID steamIDClanChat, CSteamID steamIDU
 bool Steam_Friends::IsClanChatWindowOpenInSteam( CSteamID steamIDClanChat )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Friends::OpenClanChatWindowInSteam( CSteamID steamIDClanChat )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
 bool Steam_Friends::CloseClanChatWindowInSteam( CSteamID steamIDClanChat )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -1113,21 +1113,21 @@ bool Steam_Friends::CloseClanChatWindowInSteam( CSteamID steamIDClanChat )
 bool Steam_Friends::SetListenForFriendsMessages( bool bInterceptEnabled )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
 bool Steam_Friends::ReplyToFriendMessage( CSteamID steamIDFriend, const char *pchMsgToSend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 int Steam_Friends::GetFriendMessage( CSteamID steamIDFriend, int iMessageID, void *pvData, int cubData, EChatEntryType *peChatEntryType )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1137,7 +1137,7 @@ STEAM_CALL_RESULT( FriendsGetFollowerCount_t )
 SteamAPICall_t Steam_Friends::GetFollowerCount( CSteamID steamID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1145,7 +1145,7 @@ STEAM_CALL_RESULT( FriendsIsFollowing_t )
 SteamAPICall_t Steam_Friends::IsFollowing( CSteamID steamID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1153,7 +1153,7 @@ STEAM_CALL_RESULT( FriendsEnumerateFollowingList_t )
 SteamAPICall_t Steam_Friends::EnumerateFollowingList( uint32 unStartIndex )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1161,21 +1161,21 @@ SteamAPICall_t Steam_Friends::EnumerateFollowingList( uint32 unStartIndex )
 bool Steam_Friends::IsClanPublic( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Friends::IsClanOfficialGameGroup( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 int Steam_Friends::GetNumChatsWithUnreadPriorityMessages()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1190,7 +1190,7 @@ void Steam_Friends::ActivateGameOverlayRemotePlayTogetherInviteDialog( CSteamID
 bool Steam_Friends::RegisterProtocolInOverlayBrowser( const char *pchProtocol )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1198,7 +1198,7 @@ bool Steam_Friends::RegisterProtocolInOverlayBrowser( const char *pchProtocol )
 void Steam_Friends::ActivateGameOverlayInviteDialogConnectString( const char *pchConnectString )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Steam Community items equipped by a user on their profile
@@ -1207,28 +1207,28 @@ STEAM_CALL_RESULT( EquippedProfileItems_t )
 SteamAPICall_t Steam_Friends::RequestEquippedProfileItems( CSteamID steamID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 bool Steam_Friends::BHasEquippedProfileItem( CSteamID steamID, ECommunityProfileItemType itemType )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 const char* Steam_Friends::GetProfileItemPropertyString( CSteamID steamID, ECommunityProfileItemType itemType, ECommunityProfileItemProperty prop )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return "";
 }
 
 uint32 Steam_Friends::GetProfileItemPropertyUint( CSteamID steamID, ECommunityProfileItemType itemType, ECommunityProfileItemProperty prop )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1283,8 +1283,7 @@ void Steam_Friends::Callback(Common_Message *msg)
             f->set_appid(settings->get_local_game_id().AppID());
             f->set_lobby_id(settings->get_lobby().ConvertToUint64());
             int avatar_number = GetLargeFriendAvatar(settings->get_local_steam_id());
-            if (settings->images[avatar_number].data.length() > 0) f->set_avatar(settings->images[avatar_number].data);
-            else f->set_avatar("");
+            f->set_avatar(settings->get_image_data(avatar_number));
             msg_.set_allocated_friend_(f);
             network->sendTo(&msg_, true);
         }
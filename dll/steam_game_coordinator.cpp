@@ -66,7 +66,7 @@ Steam_Game_Coordinator::~Steam_Game_Coordinator()
 EGCResults Steam_Game_Coordinator::SendMessage_( uint32 unMsgType, const void *pubData, uint32 cubData )
 {
     PRINT_DEBUG("%X %u len %u", unMsgType, (~protobuf_mask) & unMsgType, cubData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (protobuf_mask & unMsgType) {
         uint32 message_type = (~protobuf_mask) & unMsgType;
         if (message_type == 4006) { //client hello
@@ -86,7 +86,7 @@ EGCResults Steam_Game_Coordinator::SendMessage_( uint32 unMsgType, const void *p
 bool Steam_Game_Coordinator::IsMessageAvailable( uint32 *pcubMsgSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (outgoing_messages.size()) {
         if (pcubMsgSize) *pcubMsgSize = static_cast<uint32>(outgoing_messages.front().size());
         return true;
@@ -102,7 +102,7 @@ bool Steam_Game_Coordinator::IsMessageAvailable( uint32 *pcubMsgSize )
 EGCResults Steam_Game_Coordinator::RetrieveMessage( uint32 *punMsgType, void *pubDest, uint32 cubDest, uint32 *pcubMsgSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (outgoing_messages.size()) {
         if (outgoing_messages.front().size() > cubDest) {
             return k_EGCResultBufferTooSmall;
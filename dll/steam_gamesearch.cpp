@@ -59,7 +59,7 @@ Steam_Game_Search::~Steam_Game_Search()
 EGameSearchErrorCode_t Steam_Game_Search::AddGameSearchParams( const char *pchKeyToFind, const char *pchValuesToFind )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -70,7 +70,7 @@ EGameSearchErrorCode_t Steam_Game_Search::AddGameSearchParams( const char *pchKe
 EGameSearchErrorCode_t Steam_Game_Search::SearchForGameWithLobby( CSteamID steamIDLobby, int nPlayerMin, int nPlayerMax )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -80,7 +80,7 @@ EGameSearchErrorCode_t Steam_Game_Search::SearchForGameWithLobby( CSteamID steam
 EGameSearchErrorCode_t Steam_Game_Search::SearchForGameSolo( int nPlayerMin, int nPlayerMax )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -90,14 +90,14 @@ EGameSearchErrorCode_t Steam_Game_Search::SearchForGameSolo( int nPlayerMin, int
 EGameSearchErrorCode_t Steam_Game_Search::AcceptGame()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
 EGameSearchErrorCode_t Steam_Game_Search::DeclineGame()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -106,7 +106,7 @@ EGameSearchErrorCode_t Steam_Game_Search::DeclineGame()
 EGameSearchErrorCode_t Steam_Game_Search::RetrieveConnectionDetails( CSteamID steamIDHost, char *pchConnectionDetails, int cubConnectionDetails )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -115,7 +115,7 @@ EGameSearchErrorCode_t Steam_Game_Search::RetrieveConnectionDetails( CSteamID st
 EGameSearchErrorCode_t Steam_Game_Search::EndGameSearch()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -127,7 +127,7 @@ EGameSearchErrorCode_t Steam_Game_Search::EndGameSearch()
 EGameSearchErrorCode_t Steam_Game_Search::SetGameHostParams( const char *pchKey, const char *pchValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -136,7 +136,7 @@ EGameSearchErrorCode_t Steam_Game_Search::SetGameHostParams( const char *pchKey,
 EGameSearchErrorCode_t Steam_Game_Search::SetConnectionDetails( const char *pchConnectionDetails, int cubConnectionDetails )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -149,7 +149,7 @@ EGameSearchErrorCode_t Steam_Game_Search::SetConnectionDetails( const char *pchC
 EGameSearchErrorCode_t Steam_Game_Search::RequestPlayersForGame( int nPlayerMin, int nPlayerMax, int nMaxTeamSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -160,7 +160,7 @@ EGameSearchErrorCode_t Steam_Game_Search::RequestPlayersForGame( int nPlayerMin,
 EGameSearchErrorCode_t Steam_Game_Search::HostConfirmGameStart( uint64 ullUniqueGameID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -170,7 +170,7 @@ EGameSearchErrorCode_t Steam_Game_Search::HostConfirmGameStart( uint64 ullUnique
 EGameSearchErrorCode_t Steam_Game_Search::CancelRequestPlayersForGame()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -179,7 +179,7 @@ EGameSearchErrorCode_t Steam_Game_Search::CancelRequestPlayersForGame()
 EGameSearchErrorCode_t Steam_Game_Search::SubmitPlayerResult( uint64 ullUniqueGameID, CSteamID steamIDPlayer, EPlayerResult_t EPlayerResult )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
@@ -189,7 +189,7 @@ EGameSearchErrorCode_t Steam_Game_Search::SubmitPlayerResult( uint64 ullUniqueGa
 EGameSearchErrorCode_t Steam_Game_Search::EndGame( uint64 ullUniqueGameID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EGameSearchErrorCode_Failed_Offline;
 }
 
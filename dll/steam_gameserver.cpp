@@ -21,11 +21,12 @@
 #define SEND_SERVER_RATE 5.0
 
 
-Steam_GameServer::Steam_GameServer(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks)
+Steam_GameServer::Steam_GameServer(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb)
 {
     this->network = network;
     this->settings = settings;
     this->callbacks = callbacks;
+    this->run_every_runcb = run_every_runcb;
     auth_manager = new Auth_Manager(settings, network, callbacks);
     
     server_data.set_id(settings->get_local_steam_id().ConvertToUint64());
@@ -33,11 +34,19 @@ Steam_GameServer::Steam_GameServer(class Settings *settings, class Networking *n
 
 Steam_GameServer::~Steam_GameServer()
 {
+    run_every_runcb->get_timers()->remove(this);
     delete auth_manager;
     auth_manager = nullptr;
 }
 
 
+void Steam_GameServer::send_server_info_timer(void *object, uint64 data)
+{
+    Steam_GameServer *obj = (Steam_GameServer *)object;
+    obj->send_server_info = true;
+}
+
+
 std::vector<std::pair<CSteamID, Gameserver_Player_Info_t>>* Steam_GameServer::get_players()
 {
     return &players;
@@ -52,7 +61,7 @@ std::vector<std::pair<CSteamID, Gameserver_Player_Info_t>>* Steam_GameServer::ge
 bool Steam_GameServer::InitGameServer( uint32 unIP, uint16 usGamePort, uint16 usQueryPort, uint32 unFlags, AppId_t nGameAppId, const char *pchVersionString )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (logged_in) return false; // may not be changed after logged in.
     if (!pchVersionString) pchVersionString = "";
@@ -95,7 +104,7 @@ bool Steam_GameServer::InitGameServer( uint32 unIP, uint16 usGamePort, uint16 us
 void Steam_GameServer::SetProduct( const char *pszProduct )
 {
     PRINT_DEBUG("%s", pszProduct);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     // pszGameDescription should be used instead of pszProduct for accurate information
     // Example: 'Counter-Strike: Source' instead of 'cstrike'
     server_data.set_product(pszProduct);
@@ -107,7 +116,7 @@ void Steam_GameServer::SetProduct( const char *pszProduct )
 void Steam_GameServer::SetGameDescription( const char *pszGameDescription )
 {
     PRINT_DEBUG("%s", pszGameDescription);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_game_description(pszGameDescription);
     //server_data.set_product(pszGameDescription);
 }
@@ -120,7 +129,7 @@ void Steam_GameServer::SetGameDescription( const char *pszGameDescription )
 void Steam_GameServer::SetModDir( const char *pszModDir )
 {
     PRINT_DEBUG("%s", pszModDir);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_mod_dir(pszModDir);
 }
 
@@ -129,7 +138,7 @@ void Steam_GameServer::SetModDir( const char *pszModDir )
 void Steam_GameServer::SetDedicatedServer( bool bDedicated )
 {
     PRINT_DEBUG("%i", bDedicated);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_dedicated_server(bDedicated);
 }
 
@@ -147,7 +156,7 @@ void Steam_GameServer::SetDedicatedServer( bool bDedicated )
 void Steam_GameServer::LogOn( const char *pszToken )
 {
     PRINT_DEBUG("%s", pszToken);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     call_servers_connected = true;
     logged_in = true;
 }
@@ -168,7 +177,7 @@ void Steam_GameServer::LogOn(
 void Steam_GameServer::LogOnAnonymous()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     call_servers_connected = true;
     logged_in = true;
 }
@@ -183,7 +192,7 @@ void Steam_GameServer::LogOn()
 void Steam_GameServer::LogOff()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (logged_in) {
         call_servers_disconnected = true;
     }
@@ -196,14 +205,14 @@ void Steam_GameServer::LogOff()
 bool Steam_GameServer::BLoggedOn()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return logged_in;
 }
 
 bool Steam_GameServer::BSecure()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!policy_response_called) {
       server_data.set_secure(0);
       return false;
@@ -216,7 +225,7 @@ bool Steam_GameServer::BSecure()
 CSteamID Steam_GameServer::GetSteamID()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!logged_in) return k_steamIDNil;
     return settings->get_local_steam_id();
 }
@@ -227,7 +236,7 @@ CSteamID Steam_GameServer::GetSteamID()
 bool Steam_GameServer::WasRestartRequested()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -240,7 +249,7 @@ bool Steam_GameServer::WasRestartRequested()
 void Steam_GameServer::SetMaxPlayerCount( int cPlayersMax )
 {
     PRINT_DEBUG("%i", cPlayersMax);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_max_player_count(cPlayersMax);
 }
 
@@ -249,7 +258,7 @@ void Steam_GameServer::SetMaxPlayerCount( int cPlayersMax )
 void Steam_GameServer::SetBotPlayerCount( int cBotplayers )
 {
     PRINT_DEBUG("%i", cBotplayers);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_bot_player_count(cBotplayers);
 }
 
@@ -260,7 +269,7 @@ void Steam_GameServer::SetBotPlayerCount( int cBotplayers )
 void Steam_GameServer::SetServerName( const char *pszServerName )
 {
     PRINT_DEBUG("%s", pszServerName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_server_name(pszServerName);
 }
 
@@ -271,7 +280,7 @@ void Steam_GameServer::SetServerName( const char *pszServerName )
 void Steam_GameServer::SetMapName( const char *pszMapName )
 {
     PRINT_DEBUG("%s", pszMapName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_map_name(pszMapName);
 }
 
@@ -280,7 +289,7 @@ void Steam_GameServer::SetMapName( const char *pszMapName )
 void Steam_GameServer::SetPasswordProtected( bool bPasswordProtected )
 {
     PRINT_DEBUG("%i", bPasswordProtected);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_password_protected(bPasswordProtected);
 }
 
@@ -290,7 +299,7 @@ void Steam_GameServer::SetPasswordProtected( bool bPasswordProtected )
 void Steam_GameServer::SetSpectatorPort( uint16 unSpectatorPort )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_spectator_port(unSpectatorPort);
 }
 
@@ -301,7 +310,7 @@ void Steam_GameServer::SetSpectatorPort( uint16 unSpectatorPort )
 void Steam_GameServer::SetSpectatorServerName( const char *pszSpectatorServerName )
 {
     PRINT_DEBUG("%s", pszSpectatorServerName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_spectator_server_name(pszSpectatorServerName);
 }
 
@@ -310,7 +319,7 @@ void Steam_GameServer::SetSpectatorServerName( const char *pszSpectatorServerNam
 void Steam_GameServer::ClearAllKeyValues()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.clear_values();
 }
 
@@ -319,7 +328,7 @@ void Steam_GameServer::ClearAllKeyValues()
 void Steam_GameServer::SetKeyValue( const char *pKey, const char *pValue )
 {
     PRINT_DEBUG("%s %s", pKey, pValue);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     (*server_data.mutable_values())[std::string(pKey)] = std::string(pValue);
 }
 
@@ -331,7 +340,7 @@ void Steam_GameServer::SetKeyValue( const char *pKey, const char *pValue )
 void Steam_GameServer::SetGameTags( const char *pchGameTags )
 {
     PRINT_DEBUG("%s", pchGameTags);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_tags(pchGameTags);
 }
 
@@ -345,7 +354,7 @@ void Steam_GameServer::SetGameTags( const char *pchGameTags )
 void Steam_GameServer::SetGameData( const char *pchGameData )
 {
     PRINT_DEBUG("%s", pchGameData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_gamedata(pchGameData);
 }
 
@@ -354,7 +363,7 @@ void Steam_GameServer::SetGameData( const char *pchGameData )
 void Steam_GameServer::SetRegion( const char *pszRegion )
 {
     PRINT_DEBUG("%s", pszRegion);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_region(pszRegion);
 }
 
@@ -375,7 +384,7 @@ void Steam_GameServer::SetRegion( const char *pszRegion )
 bool Steam_GameServer::SendUserConnectAndAuthenticate( uint32 unIPClient, const void *pvAuthBlob, uint32 cubAuthBlobSize, CSteamID *pSteamIDUser )
 {
     PRINT_DEBUG("%u %u", unIPClient, cubAuthBlobSize);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     bool res = auth_manager->SendUserConnectAndAuthenticate(unIPClient, pvAuthBlob, cubAuthBlobSize, pSteamIDUser);
 
@@ -404,7 +413,7 @@ void Steam_GameServer::SendUserConnectAndAuthenticate( CSteamID steamIDUser, uin
 CSteamID Steam_GameServer::CreateUnauthenticatedUserConnection()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     CSteamID bot_id = auth_manager->fakeUser();
     std::pair<CSteamID, Gameserver_Player_Info_t> infos;
@@ -424,7 +433,7 @@ CSteamID Steam_GameServer::CreateUnauthenticatedUserConnection()
 void Steam_GameServer::SendUserDisconnect( CSteamID steamIDUser )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto player_it = std::find_if(players.begin(), players.end(), [&steamIDUser](std::pair<CSteamID, Gameserver_Player_Info_t>& player)
     {
@@ -448,7 +457,7 @@ void Steam_GameServer::SendUserDisconnect( CSteamID steamIDUser )
 bool Steam_GameServer::BUpdateUserData( CSteamID steamIDUser, const char *pchPlayerName, uint32 uScore )
 {
     PRINT_DEBUG("%llu %s %u", steamIDUser.ConvertToUint64(), pchPlayerName, uScore);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto player_it = std::find_if(players.begin(), players.end(), [&steamIDUser](std::pair<CSteamID, Gameserver_Player_Info_t>& player)
     {
@@ -486,7 +495,7 @@ bool Steam_GameServer::BSetServerType( uint32 unServerFlags, uint32 unGameIP, ui
                             uint16 unSpectatorPort, uint16 usQueryPort, const char *pchGameDir, const char *pchVersion, bool bLANMode )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_ip(unGameIP);
     server_data.set_port(unGamePort);
     server_data.set_query_port(usQueryPort);
@@ -514,7 +523,7 @@ void Steam_GameServer::UpdateServerStatus( int cPlayers, int cPlayersMax, int cB
                                     const char *pchMapName )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     server_data.set_num_players(cPlayers);
     server_data.set_max_player_count(cPlayersMax);
     server_data.set_bot_player_count(cBotPlayers);
@@ -535,14 +544,14 @@ void Steam_GameServer::UpdateSpectatorPort( uint16 unSpectatorPort )
 void Steam_GameServer::SetGameType( const char *pchGameType )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Ask if a user has a specific achievement for this game, will get a callback on reply
 bool Steam_GameServer::BGetUserAchievementStatus( CSteamID steamID, const char *pchAchievementName )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -562,7 +571,7 @@ HAuthTicket Steam_GameServer::GetAuthSessionTicket( void *pTicket, int cbMaxTick
 HAuthTicket Steam_GameServer::GetAuthSessionTicket( void *pTicket, int cbMaxTicket, uint32 *pcbTicket, const SteamNetworkingIdentity *pSnid )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pTicket) return k_HAuthTicketInvalid;
     
@@ -575,7 +584,7 @@ HAuthTicket Steam_GameServer::GetAuthSessionTicket( void *pTicket, int cbMaxTick
 EBeginAuthSessionResult Steam_GameServer::BeginAuthSession( const void *pAuthTicket, int cbAuthTicket, CSteamID steamID )
 {
     PRINT_DEBUG("%i %llu", cbAuthTicket, steamID.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     std::pair<CSteamID, Gameserver_Player_Info_t> infos;
     infos.first = steamID;
@@ -592,7 +601,7 @@ EBeginAuthSessionResult Steam_GameServer::BeginAuthSession( const void *pAuthTic
 void Steam_GameServer::EndAuthSession( CSteamID steamID )
 {
     PRINT_DEBUG("%llu", steamID.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto player_it = std::find_if(players.begin(), players.end(), [&steamID](std::pair<CSteamID, Gameserver_Player_Info_t>& player)
     {
@@ -612,7 +621,7 @@ void Steam_GameServer::EndAuthSession( CSteamID steamID )
 void Steam_GameServer::CancelAuthTicket( HAuthTicket hAuthTicket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auth_manager->cancelTicket(hAuthTicket);
 }
@@ -623,7 +632,7 @@ void Steam_GameServer::CancelAuthTicket( HAuthTicket hAuthTicket )
 EUserHasLicenseForAppResult Steam_GameServer::UserHasLicenseForApp( CSteamID steamID, AppId_t appID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EUserHasLicenseResultHasLicense;
 }
 
@@ -633,7 +642,7 @@ EUserHasLicenseForAppResult Steam_GameServer::UserHasLicenseForApp( CSteamID ste
 bool Steam_GameServer::RequestUserGroupStatus( CSteamID steamIDUser, CSteamID steamIDGroup )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -644,14 +653,14 @@ bool Steam_GameServer::RequestUserGroupStatus( CSteamID steamIDUser, CSteamID st
 void Steam_GameServer::GetGameplayStats( )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 STEAM_CALL_RESULT( GSReputation_t )
 SteamAPICall_t Steam_GameServer::GetServerReputation()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -662,7 +671,7 @@ SteamAPICall_t Steam_GameServer::GetServerReputation()
 uint32 Steam_GameServer::GetPublicIP_old()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     uint32 ip = network->getOwnIP();
     PRINT_DEBUG("  %X", ip);
     return ip;
@@ -700,7 +709,7 @@ void Steam_GameServer::GetPublicIP_fix(SteamIPAddress_t *out)
 bool Steam_GameServer::HandleIncomingPacket( const void *pData, int cbData, uint32 srcIP, uint16 srcPort )
 {
     PRINT_DEBUG("%i %X %i", cbData, srcIP, srcPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_source_query) return true;
 
     Gameserver_Outgoing_Packet packet;
@@ -724,7 +733,7 @@ bool Steam_GameServer::HandleIncomingPacket( const void *pData, int cbData, uint
 int Steam_GameServer::GetNextOutgoingPacket( void *pOut, int cbMaxOut, uint32 *pNetAdr, uint16 *pPort )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_source_query) return 0;
     if (outgoing_packets.empty()) return 0;
 
@@ -797,7 +806,7 @@ STEAM_CALL_RESULT( AssociateWithClanResult_t )
 SteamAPICall_t Steam_GameServer::AssociateWithClan( CSteamID steamIDClan )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -807,7 +816,7 @@ STEAM_CALL_RESULT( ComputeNewPlayerCompatibilityResult_t )
 SteamAPICall_t Steam_GameServer::ComputeNewPlayerCompatibility( CSteamID steamIDNewPlayer )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -833,7 +842,7 @@ void Steam_GameServer::RunCallbacks()
         policy_response_called = true;
     }
 
-    if (logged_in && check_timedout(last_sent_server_info, SEND_SERVER_RATE)) {
+    if (logged_in && send_server_info) {
         PRINT_DEBUG("Sending Gameserver");
         Common_Message msg;
         msg.set_source_id(settings->get_local_steam_id().ConvertToUint64());
@@ -841,7 +850,8 @@ void Steam_GameServer::RunCallbacks()
         msg.set_allocated_gameserver(new Gameserver(server_data));
         msg.mutable_gameserver()->set_num_players(auth_manager->countInboundAuth());
         network->sendToAllIndividuals(&msg, true);
-        last_sent_server_info = std::chrono::high_resolution_clock::now();
+        send_server_info = false;
+        run_every_runcb->get_timers()->add(SEND_SERVER_RATE, &Steam_GameServer::send_server_info_timer, this);
     }
 
     if (temp_call_servers_disconnected) {
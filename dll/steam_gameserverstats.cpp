@@ -116,7 +116,7 @@ STEAM_CALL_RESULT( GSStatsReceived_t )
 SteamAPICall_t Steam_GameServerStats::RequestUserStats( CSteamID steamIDUser )
 {
     PRINT_DEBUG("%llu", (uint64)steamIDUser.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) {
         GSStatsReceived_t data_bad{};
         data_bad.m_eResult = EResult::k_EResultFail;
@@ -157,7 +157,7 @@ SteamAPICall_t Steam_GameServerStats::RequestUserStats( CSteamID steamIDUser )
 bool Steam_GameServerStats::GetUserStat( CSteamID steamIDUser, const char *pchName, int32 *pData )
 {
     PRINT_DEBUG("<int32> %llu '%s' %p", (uint64)steamIDUser.ConvertToUint64(), pchName, pData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -173,7 +173,7 @@ bool Steam_GameServerStats::GetUserStat( CSteamID steamIDUser, const char *pchNa
 bool Steam_GameServerStats::GetUserStat( CSteamID steamIDUser, const char *pchName, float *pData )
 {
     PRINT_DEBUG("<float> %llu '%s' %p", (uint64)steamIDUser.ConvertToUint64(), pchName, pData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -189,7 +189,7 @@ bool Steam_GameServerStats::GetUserStat( CSteamID steamIDUser, const char *pchNa
 bool Steam_GameServerStats::GetUserAchievement( CSteamID steamIDUser, const char *pchName, bool *pbAchieved )
 {
     PRINT_DEBUG("%llu '%s' %p", (uint64)steamIDUser.ConvertToUint64(), pchName, pbAchieved);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -209,7 +209,7 @@ bool Steam_GameServerStats::GetUserAchievement( CSteamID steamIDUser, const char
 bool Steam_GameServerStats::SetUserStat( CSteamID steamIDUser, const char *pchName, int32 nData )
 {
     PRINT_DEBUG("<int32> %llu '%s'=%i", (uint64)steamIDUser.ConvertToUint64(), pchName, nData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -230,7 +230,7 @@ bool Steam_GameServerStats::SetUserStat( CSteamID steamIDUser, const char *pchNa
 bool Steam_GameServerStats::SetUserStat( CSteamID steamIDUser, const char *pchName, float fData )
 {
     PRINT_DEBUG("<float> %llu '%s'=%f", (uint64)steamIDUser.ConvertToUint64(), pchName, fData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -251,7 +251,7 @@ bool Steam_GameServerStats::SetUserStat( CSteamID steamIDUser, const char *pchNa
 bool Steam_GameServerStats::UpdateUserAvgRateStat( CSteamID steamIDUser, const char *pchName, float flCountThisSession, double dSessionLength )
 {
     PRINT_DEBUG("%llu '%s'", (uint64)steamIDUser.ConvertToUint64(), pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -284,7 +284,7 @@ bool Steam_GameServerStats::UpdateUserAvgRateStat( CSteamID steamIDUser, const c
 bool Steam_GameServerStats::SetUserAchievement( CSteamID steamIDUser, const char *pchName )
 {
     PRINT_DEBUG("%llu '%s'", (uint64)steamIDUser.ConvertToUint64(), pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -304,7 +304,7 @@ bool Steam_GameServerStats::SetUserAchievement( CSteamID steamIDUser, const char
 bool Steam_GameServerStats::ClearUserAchievement( CSteamID steamIDUser, const char *pchName )
 {
     PRINT_DEBUG("%llu '%s'", (uint64)steamIDUser.ConvertToUint64(), pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) return false;
 
     if (!pchName) return false;
@@ -333,7 +333,7 @@ SteamAPICall_t Steam_GameServerStats::StoreUserStats( CSteamID steamIDUser )
 {
     // it's not necessary to send all data here, we already do that in run_callback() and on each API function call (immediate mode)
     PRINT_DEBUG("Steam_GameServerStats::StoreUserStats");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (settings->disable_sharing_stats_with_gameserver) {
         GSStatsStored_t data_bad{};
         data_bad.m_eResult = EResult::k_EResultFail;
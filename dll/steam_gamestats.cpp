@@ -160,7 +160,7 @@ Steam_GameStats::Attribute_t *Steam_GameStats::get_or_create_row_att(uint64 ulRo
 SteamAPICall_t Steam_GameStats::GetNewSession( int8 nAccountType, uint64 ulAccountID, int32 nAppID, RTime32 rtTimeStarted )
 {
     PRINT_DEBUG("%i, %llu, %i, %u", (int)nAccountType, ulAccountID, nAppID, rtTimeStarted);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if ((settings->get_local_steam_id().ConvertToUint64() != ulAccountID) ||
         (nAppID < 0) ||
@@ -198,7 +198,7 @@ SteamAPICall_t Steam_GameStats::GetNewSession( int8 nAccountType, uint64 ulAccou
 SteamAPICall_t Steam_GameStats::EndSession( uint64 ulSessionID, RTime32 rtTimeEnded, int nReasonCode )
 {
     PRINT_DEBUG("%llu, %u, %i", ulSessionID, rtTimeEnded, nReasonCode);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size()) {
         GameStatsSessionClosed_t data_invalid{};
@@ -240,7 +240,7 @@ SteamAPICall_t Steam_GameStats::EndSession( uint64 ulSessionID, RTime32 rtTimeEn
 EResult Steam_GameStats::AddSessionAttributeInt( uint64 ulSessionID, const char* pstrName, int32 nData )
 {
     PRINT_DEBUG("%llu, '%s', %i", ulSessionID, pstrName, nData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size() || !pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -257,7 +257,7 @@ EResult Steam_GameStats::AddSessionAttributeInt( uint64 ulSessionID, const char*
 EResult Steam_GameStats::AddSessionAttributeString( uint64 ulSessionID, const char* pstrName, const char *pstrData )
 {
     PRINT_DEBUG("%llu, '%s', '%s'", ulSessionID, pstrName, pstrData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size() || !pstrName || !pstrData) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -274,7 +274,7 @@ EResult Steam_GameStats::AddSessionAttributeString( uint64 ulSessionID, const ch
 EResult Steam_GameStats::AddSessionAttributeFloat( uint64 ulSessionID, const char* pstrName, float fData )
 {
     PRINT_DEBUG("%llu, '%s', %f", ulSessionID, pstrName, fData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size() || !pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -292,7 +292,7 @@ EResult Steam_GameStats::AddSessionAttributeFloat( uint64 ulSessionID, const cha
 EResult Steam_GameStats::AddNewRow( uint64 *pulRowID, uint64 ulSessionID, const char *pstrTableName )
 {
     PRINT_DEBUG("%p, %llu, '%s'", pulRowID, ulSessionID, pstrTableName);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size() || !pstrTableName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -308,7 +308,7 @@ EResult Steam_GameStats::AddNewRow( uint64 *pulRowID, uint64 ulSessionID, const
 EResult Steam_GameStats::CommitRow( uint64 ulRowID )
 {
     PRINT_DEBUG("%llu", ulRowID);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto active_session = std::find_if(sessions.rbegin(), sessions.rend(), [](const Session_t &item){ return !item.ended; });
     if (sessions.rend() == active_session) return EResult::k_EResultFail; // TODO is this correct?
@@ -327,7 +327,7 @@ EResult Steam_GameStats::CommitRow( uint64 ulRowID )
 EResult Steam_GameStats::CommitOutstandingRows( uint64 ulSessionID )
 {
     PRINT_DEBUG("%llu", ulSessionID);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (ulSessionID == 0 || ulSessionID > sessions.size()) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -345,7 +345,7 @@ EResult Steam_GameStats::CommitOutstandingRows( uint64 ulSessionID )
 EResult Steam_GameStats::AddRowAttributeInt( uint64 ulRowID, const char *pstrName, int32 nData )
 {
     PRINT_DEBUG("%llu, '%s', %i", ulRowID, pstrName, nData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -366,7 +366,7 @@ EResult Steam_GameStats::AddRowAttributeInt( uint64 ulRowID, const char *pstrNam
 EResult Steam_GameStats::AddRowAtributeString( uint64 ulRowID, const char *pstrName, const char *pstrData )
 {
     PRINT_DEBUG("%llu, '%s', '%s'", ulRowID, pstrName, pstrData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pstrName || !pstrData) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -386,7 +386,7 @@ EResult Steam_GameStats::AddRowAtributeString( uint64 ulRowID, const char *pstrN
 EResult Steam_GameStats::AddRowAttributeFloat( uint64 ulRowID, const char *pstrName, float fData )
 {
     PRINT_DEBUG("%llu, '%s', %f", ulRowID, pstrName, fData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -407,7 +407,7 @@ EResult Steam_GameStats::AddRowAttributeFloat( uint64 ulRowID, const char *pstrN
 EResult Steam_GameStats::AddSessionAttributeInt64( uint64 ulSessionID, const char *pstrName, int64 llData )
 {
     PRINT_DEBUG("%llu, '%s', %lli", ulSessionID, pstrName, llData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (ulSessionID == 0 || ulSessionID > sessions.size() || !pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -424,7 +424,7 @@ EResult Steam_GameStats::AddSessionAttributeInt64( uint64 ulSessionID, const cha
 EResult Steam_GameStats::AddRowAttributeInt64( uint64 ulRowID, const char *pstrName, int64 llData )
 {
     PRINT_DEBUG("%llu, '%s', %lli", ulRowID, pstrName, llData);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pstrName) return EResult::k_EResultInvalidParam; // TODO is this correct?
     
@@ -45,6 +45,7 @@ struct Steam_Inventory_Requests* Steam_Inventory::new_inventory_result(bool full
 
     request.time_created = std::chrono::system_clock::now();
     inventory_requests.push_back(request);
+    run_every_runcb->get_timers()->add(request.timeout, &Steam_Inventory::request_timer, this, request.inventory_result);
 
     return &(inventory_requests.back());
 }
@@ -86,6 +87,38 @@ void Steam_Inventory::run_every_runcb_cb(void *object)
     obj->RunCallbacks();
 }
 
+void Steam_Inventory::request_timer(void *object, uint64 inventory_result)
+{
+    Steam_Inventory *obj = (Steam_Inventory *)object;
+    struct Steam_Inventory_Requests *r = obj->get_inventory_result((SteamInventoryResult_t)inventory_result);
+    // destroyed by the game before it was done
+    if (!r || r->done) return;
+
+    // the timers run before RunCallbacks(), load what it would have loaded before posting the result
+    if (!obj->inventory_loaded) {
+        obj->read_inventory_db();
+        obj->inventory_loaded = true;
+    }
+
+    if (r->full_query) {
+        // SteamInventoryFullUpdate_t callbacks are triggered when GetAllItems
+        // successfully returns a result which is newer / fresher than the last
+        // known result.
+        struct SteamInventoryFullUpdate_t data;
+        data.m_handle = r->inventory_result;
+        obj->callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+    }
+
+    {
+        struct SteamInventoryResultReady_t data;
+        data.m_handle = r->inventory_result;
+        data.m_result = k_EResultOK;
+        obj->callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+    }
+
+    r->done = true;
+}
+
 
 Steam_Inventory::Steam_Inventory(class Settings *settings, class SteamCallResults *callback_results, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb, class Local_Storage *local_storage):
     settings(settings),
@@ -107,6 +140,7 @@ Steam_Inventory::Steam_Inventory(class Settings *settings, class SteamCallResult
 Steam_Inventory::~Steam_Inventory()
 {
     this->run_every_runcb->remove(&Steam_Inventory::run_every_runcb_cb, this);
+    this->run_every_runcb->get_timers()->remove(this);
 }
 
 
@@ -129,7 +163,7 @@ STEAM_METHOD_DESC(Find out the status of an asynchronous inventory result handle
 EResult Steam_Inventory::GetResultStatus( SteamInventoryResult_t resultHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests *request = get_inventory_result(resultHandle);
     if (!request) return k_EResultInvalidParam;
     if (!request->result_done()) return k_EResultPending;
@@ -145,7 +179,7 @@ bool Steam_Inventory::GetResultItems( SteamInventoryResult_t resultHandle,
                             uint32 *punOutItemsArraySize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests *request = get_inventory_result(resultHandle);
     if (!request) return false;
     if (!request->result_done()) return false;
@@ -230,7 +264,7 @@ bool Steam_Inventory::GetResultItemProperty( SteamInventoryResult_t resultHandle
                                     STEAM_OUT_STRING_COUNT( punValueBufferSizeOut ) char *pchValueBuffer, uint32 *punValueBufferSizeOut )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     return false;
 }
@@ -242,7 +276,7 @@ STEAM_METHOD_DESC(Returns Steam_Inventory::the server time at which the result w
 uint32 Steam_Inventory::GetResultTimestamp( SteamInventoryResult_t resultHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests *request = get_inventory_result(resultHandle);
     if (!request || !request->result_done()) return 0;
     return request->timestamp();
@@ -256,7 +290,7 @@ STEAM_METHOD_DESC(Returns true if the result belongs to the target steam ID or f
 bool Steam_Inventory::CheckResultSteamID( SteamInventoryResult_t resultHandle, CSteamID steamIDExpected )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     return true;
 }
@@ -267,7 +301,7 @@ STEAM_METHOD_DESC(Destroys a result handle and frees all associated memory.)
 void Steam_Inventory::DestroyResult( SteamInventoryResult_t resultHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto request = std::find_if(inventory_requests.begin(), inventory_requests.end(), [&resultHandle](struct Steam_Inventory_Requests const& item) { return item.inventory_result == resultHandle; });
     if (inventory_requests.end() == request)
         return;
@@ -291,7 +325,7 @@ STEAM_METHOD_DESC(Captures the entire state of the current users Steam inventory
 bool Steam_Inventory::GetAllItems( SteamInventoryResult_t *pResultHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests* request = new_inventory_result();
 
     if (pResultHandle != nullptr)
@@ -313,7 +347,7 @@ STEAM_METHOD_DESC(Captures the state of a subset of the current users Steam inve
 bool Steam_Inventory::GetItemsByID( SteamInventoryResult_t *pResultHandle, STEAM_ARRAY_COUNT( unCountInstanceIDs ) const SteamItemInstanceID_t *pInstanceIDs, uint32 unCountInstanceIDs )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (pResultHandle) {
         struct Steam_Inventory_Requests *request = new_inventory_result(false, pInstanceIDs, unCountInstanceIDs);
         *pResultHandle = request->inventory_result;
@@ -343,7 +377,7 @@ bool Steam_Inventory::GetItemsByID( SteamInventoryResult_t *pResultHandle, STEAM
 bool Steam_Inventory::SerializeResult( SteamInventoryResult_t resultHandle, STEAM_OUT_BUFFER_COUNT(punOutBufferSize) void *pOutBuffer, uint32 *punOutBufferSize )
 {
     PRINT_DEBUG("%i", resultHandle);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     struct Steam_Inventory_Requests *request = get_inventory_result(resultHandle);
     if (!request) return false;
@@ -389,7 +423,7 @@ bool Steam_Inventory::SerializeResult( SteamInventoryResult_t resultHandle, STEA
 bool Steam_Inventory::DeserializeResult( SteamInventoryResult_t *pOutResultHandle, STEAM_BUFFER_COUNT(punOutBufferSize) const void *pBuffer, uint32 unBufferSize, bool bRESERVED_MUST_BE_FALSE)
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     if (pOutResultHandle) {
         struct Steam_Inventory_Requests *request = new_inventory_result(false);
@@ -414,7 +448,7 @@ bool Steam_Inventory::DeserializeResult( SteamInventoryResult_t *pOutResultHandl
 bool Steam_Inventory::GenerateItems( SteamInventoryResult_t *pResultHandle, STEAM_ARRAY_COUNT(unArrayLength) const SteamItemDef_t *pArrayItemDefs, STEAM_ARRAY_COUNT(unArrayLength) const uint32 *punArrayQuantity, uint32 unArrayLength )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -427,7 +461,7 @@ STEAM_METHOD_DESC(GrantPromoItems() Steam_Inventory::checks the list of promotio
 bool Steam_Inventory::GrantPromoItems( SteamInventoryResult_t *pResultHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests* request = new_inventory_result(false);
 
     if (pResultHandle != nullptr)
@@ -444,7 +478,7 @@ bool Steam_Inventory::AddPromoItem( SteamInventoryResult_t *pResultHandle, Steam
 {
     PRINT_DEBUG_ENTRY();
     //TODO
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests* request = new_inventory_result(false);
 
     if (pResultHandle != nullptr)
@@ -456,7 +490,7 @@ bool Steam_Inventory::AddPromoItems( SteamInventoryResult_t *pResultHandle, STEA
 {
     PRINT_DEBUG_ENTRY();
     //TODO
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests* request = new_inventory_result(false);
 
     if (pResultHandle != nullptr)
@@ -472,7 +506,7 @@ STEAM_METHOD_DESC(ConsumeItem() removes items from the inventory permanently.)
 bool Steam_Inventory::ConsumeItem( SteamInventoryResult_t *pResultHandle, SteamItemInstanceID_t itemConsume, uint32 unQuantity )
 {
     PRINT_DEBUG("%llu %u", itemConsume, unQuantity);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto it = user_items.find(std::to_string(itemConsume));
     if (it != user_items.end()) {
@@ -516,7 +550,7 @@ bool Steam_Inventory::ExchangeItems( SteamInventoryResult_t *pResultHandle,
                             STEAM_ARRAY_COUNT(unArrayDestroyLength) const SteamItemInstanceID_t *pArrayDestroy, STEAM_ARRAY_COUNT(unArrayDestroyLength) const uint32 *punArrayDestroyQuantity, uint32 unArrayDestroyLength )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -529,7 +563,7 @@ bool Steam_Inventory::ExchangeItems( SteamInventoryResult_t *pResultHandle,
 bool Steam_Inventory::TransferItemQuantity( SteamInventoryResult_t *pResultHandle, SteamItemInstanceID_t itemIdSource, uint32 unQuantity, SteamItemInstanceID_t itemIdDest )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -543,7 +577,7 @@ STEAM_METHOD_DESC( Deprecated method. Playtime accounting is performed on the St
 void Steam_Inventory::SendItemDropHeartbeat()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -561,7 +595,7 @@ bool Steam_Inventory::TriggerItemDrop( SteamInventoryResult_t *pResultHandle, St
 {
     PRINT_DEBUG("%p %i", pResultHandle, dropListDefinition);
     //TODO: if gameserver return false
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Steam_Inventory_Requests* request = new_inventory_result(false);
 
     if (pResultHandle != nullptr)
@@ -577,7 +611,7 @@ bool Steam_Inventory::TradeItems( SteamInventoryResult_t *pResultHandle, CSteamI
                             STEAM_ARRAY_COUNT(nArrayGetLength) const SteamItemInstanceID_t *pArrayGet, STEAM_ARRAY_COUNT(nArrayGetLength) const uint32 *pArrayGetQuantity, uint32 nArrayGetLength )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -601,7 +635,7 @@ STEAM_METHOD_DESC(LoadItemDefinitions triggers the automatic load and refresh of
 bool Steam_Inventory::LoadItemDefinitions()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!item_definitions_loaded)  {
         call_definition_update = true;
@@ -623,7 +657,7 @@ bool Steam_Inventory::GetItemDefinitionIDs(
             STEAM_DESC(Size of array is passed in and actual size used is returned in this param) uint32 *punItemDefIDsArraySize )
 {
     PRINT_DEBUG("%p", pItemDefIDs);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!punItemDefIDsArraySize)
         return false;
 
@@ -661,7 +695,7 @@ bool Steam_Inventory::GetItemDefinitionProperty( SteamItemDef_t iDefinition, con
     STEAM_OUT_STRING_COUNT(punValueBufferSizeOut) char *pchValueBuffer, uint32 *punValueBufferSizeOut )
 {
     PRINT_DEBUG("%i %s", iDefinition, pchPropertyName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto item = defined_items.find(std::to_string(iDefinition));
     if (item != defined_items.end())
@@ -759,7 +793,7 @@ STEAM_CALL_RESULT( SteamInventoryEligiblePromoItemDefIDs_t )
 SteamAPICall_t Steam_Inventory::RequestEligiblePromoItemDefinitionsIDs( CSteamID steamID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -773,7 +807,7 @@ bool Steam_Inventory::GetEligiblePromoItemDefinitionIDs(
     STEAM_DESC(Size of array is passed in and actual size used is returned in this param) uint32 *punItemDefIDsArraySize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -787,7 +821,7 @@ STEAM_CALL_RESULT( SteamInventoryStartPurchaseResult_t )
 SteamAPICall_t Steam_Inventory::StartPurchase( STEAM_ARRAY_COUNT(unArrayLength) const SteamItemDef_t *pArrayItemDefs, STEAM_ARRAY_COUNT(unArrayLength) const uint32 *punArrayQuantity, uint32 unArrayLength )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -811,7 +845,7 @@ SteamAPICall_t Steam_Inventory::RequestPrices()
 uint32 Steam_Inventory::GetNumItemsWithPrices()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -821,7 +855,7 @@ bool Steam_Inventory::GetItemsWithPrices( STEAM_ARRAY_COUNT(unArrayLength) STEAM
 									 uint32 unArrayLength )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -832,14 +866,14 @@ bool Steam_Inventory::GetItemsWithPrices( STEAM_ARRAY_COUNT(unArrayLength) STEAM
                                     uint32 unArrayLength )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return GetItemsWithPrices(pArrayItemDefs, pPrices, NULL, unArrayLength);
 }
 
 bool Steam_Inventory::GetItemPrice( SteamItemDef_t iDefinition, uint64 *pCurrentPrice, uint64 *pBasePrice )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -848,7 +882,7 @@ bool Steam_Inventory::GetItemPrice( SteamItemDef_t iDefinition, uint64 *pCurrent
 bool Steam_Inventory::GetItemPrice( SteamItemDef_t iDefinition, uint64 *pPrice )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return GetItemPrice(iDefinition, pPrice, NULL);
 }
 
@@ -857,7 +891,7 @@ bool Steam_Inventory::GetItemPrice( SteamItemDef_t iDefinition, uint64 *pPrice )
 SteamInventoryUpdateHandle_t Steam_Inventory::StartUpdateProperties()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -865,7 +899,7 @@ SteamInventoryUpdateHandle_t Steam_Inventory::StartUpdateProperties()
 bool Steam_Inventory::RemoveProperty( SteamInventoryUpdateHandle_t handle, SteamItemInstanceID_t nItemID, const char *pchPropertyName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -873,28 +907,28 @@ bool Steam_Inventory::RemoveProperty( SteamInventoryUpdateHandle_t handle, Steam
 bool Steam_Inventory::SetProperty( SteamInventoryUpdateHandle_t handle, SteamItemInstanceID_t nItemID, const char *pchPropertyName, const char *pchPropertyValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Inventory::SetProperty( SteamInventoryUpdateHandle_t handle, SteamItemInstanceID_t nItemID, const char *pchPropertyName, bool bValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Inventory::SetProperty( SteamInventoryUpdateHandle_t handle, SteamItemInstanceID_t nItemID, const char *pchPropertyName, int64 nValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Inventory::SetProperty( SteamInventoryUpdateHandle_t handle, SteamItemInstanceID_t nItemID, const char *pchPropertyName, float flValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -902,14 +936,14 @@ bool Steam_Inventory::SetProperty( SteamInventoryUpdateHandle_t handle, SteamIte
 bool Steam_Inventory::SubmitUpdateProperties( SteamInventoryUpdateHandle_t handle, SteamInventoryResult_t * pResultHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Inventory::InspectItem( SteamInventoryResult_t *pResultHandle, const char *pchItemToken )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -934,30 +968,4 @@ void Steam_Inventory::RunCallbacks()
         read_inventory_db();
         inventory_loaded = true;
     }
-
-    if (inventory_loaded)
-    {
-        std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-        for (auto& r : inventory_requests) {
-            if (!r.done && std::chrono::duration_cast<std::chrono::duration<double>>(now - r.time_created).count() > r.timeout) {
-                if (r.full_query) {
-                    // SteamInventoryFullUpdate_t callbacks are triggered when GetAllItems
-                    // successfully returns a result which is newer / fresher than the last
-                    // known result.
-                    struct SteamInventoryFullUpdate_t data;
-                    data.m_handle = r.inventory_result;
-                    callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-                }
-
-                {
-                    struct SteamInventoryResultReady_t data;
-                    data.m_handle = r.inventory_result;
-                    data.m_result = k_EResultOK;
-                    callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-                }
-
-                r.done = true;
-            }
-        }
-    }
 }
@@ -59,7 +59,7 @@ Steam_Masterserver_Updater::~Steam_Masterserver_Updater()
 void Steam_Masterserver_Updater::SetActive( bool bActive )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -69,7 +69,7 @@ void Steam_Masterserver_Updater::SetActive( bool bActive )
 void Steam_Masterserver_Updater::SetHeartbeatInterval( int iHeartbeatInterval )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -92,7 +92,7 @@ void Steam_Masterserver_Updater::SetHeartbeatInterval( int iHeartbeatInterval )
 bool Steam_Masterserver_Updater::HandleIncomingPacket( const void *pData, int cbData, uint32 srcIP, uint16 srcPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -104,7 +104,7 @@ bool Steam_Masterserver_Updater::HandleIncomingPacket( const void *pData, int cb
 int Steam_Masterserver_Updater::GetNextOutgoingPacket( void *pOut, int cbMaxOut, uint32 *pNetAdr, uint16 *pPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -123,7 +123,7 @@ void Steam_Masterserver_Updater::SetBasicServerData(
     const char *pGameDescription )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -131,7 +131,7 @@ void Steam_Masterserver_Updater::SetBasicServerData(
 void Steam_Masterserver_Updater::ClearAllKeyValues()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -139,7 +139,7 @@ void Steam_Masterserver_Updater::ClearAllKeyValues()
 void Steam_Masterserver_Updater::SetKeyValue( const char *pKey, const char *pValue )
 {
     PRINT_DEBUG("TODO '%s'='%s'", pKey, pValue);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -149,7 +149,7 @@ void Steam_Masterserver_Updater::SetKeyValue( const char *pKey, const char *pVal
 void Steam_Masterserver_Updater::NotifyShutdown()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -158,7 +158,7 @@ void Steam_Masterserver_Updater::NotifyShutdown()
 bool Steam_Masterserver_Updater::WasRestartRequested()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -167,7 +167,7 @@ bool Steam_Masterserver_Updater::WasRestartRequested()
 void Steam_Masterserver_Updater::ForceHeartbeat()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -176,14 +176,14 @@ void Steam_Masterserver_Updater::ForceHeartbeat()
 bool Steam_Masterserver_Updater::AddMasterServer( const char *pServerAddress )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
 bool Steam_Masterserver_Updater::RemoveMasterServer( const char *pServerAddress )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -191,7 +191,7 @@ bool Steam_Masterserver_Updater::RemoveMasterServer( const char *pServerAddress
 int Steam_Masterserver_Updater::GetNumMasterServers()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -200,7 +200,7 @@ int Steam_Masterserver_Updater::GetNumMasterServers()
 int Steam_Masterserver_Updater::GetMasterServerAddress( int iServer, char *pOut, int outBufferSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -224,6 +224,77 @@ void Steam_Matchmaking::steam_matchmaking_run_every_runcb(void *object)
     steam_matchmaking->RunCallbacks();
 }
 
+void Steam_Matchmaking::send_lobbies_timer(void *object, uint64 data)
+{
+    Steam_Matchmaking *steam_matchmaking = (Steam_Matchmaking *)object;
+    steam_matchmaking->send_lobby_data();
+    steam_matchmaking->run_every_runcb->get_timers()->add(SEND_LOBBY_RATE, &Steam_Matchmaking::send_lobbies_timer, object);
+}
+
+void Steam_Matchmaking::lobby_create_timer(void *object, uint64 api_id)
+{
+    Steam_Matchmaking *steam_matchmaking = (Steam_Matchmaking *)object;
+    steam_matchmaking->create_pending_lobby(api_id);
+}
+
+void Steam_Matchmaking::lobby_search_timer(void *object, uint64 api_id)
+{
+    Steam_Matchmaking *steam_matchmaking = (Steam_Matchmaking *)object;
+    // a newer RequestLobbyList() replaced this search, it has its own timer
+    if (!steam_matchmaking->searching || steam_matchmaking->search_call_api_id != api_id) return;
+
+    // look at the lobbies received this frame first, like the timeout check at the end of RunCallbacks() used to
+    steam_matchmaking->search_lobbies();
+    if (!steam_matchmaking->searching) return;
+
+    PRINT_DEBUG("LOBBY_SEARCH_TIMEOUT %zu", steam_matchmaking->filtered_lobbies.size());
+    LobbyMatchList_t data{};
+    data.m_nLobbiesMatching = static_cast<uint32>(steam_matchmaking->filtered_lobbies.size());
+    steam_matchmaking->callback_results->addCallResult(steam_matchmaking->search_call_api_id, data.k_iCallback, &data, sizeof(data));
+    steam_matchmaking->callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+    steam_matchmaking->searching = false;
+    steam_matchmaking->search_call_api_id = 0;
+}
+
+void Steam_Matchmaking::pending_join_timer(void *object, uint64 api_id)
+{
+    Steam_Matchmaking *steam_matchmaking = (Steam_Matchmaking *)object;
+    auto &pending_joins = steam_matchmaking->pending_joins;
+    auto g = std::find_if(pending_joins.begin(), pending_joins.end(), [api_id](Pending_Joins const& item) { return item.api_id == api_id; });
+    // already answered
+    if (g == pending_joins.end()) return;
+
+    Lobby *lobby = steam_matchmaking->get_lobby(g->lobby_id);
+    if (get_lobby_member(lobby, steam_matchmaking->settings->get_local_steam_id()) && !lobby->deleted()) {
+        // joined during this frame, RunCallbacks() would have seen it before timing out
+        PRINT_DEBUG("lobby joined %llu", g->lobby_id.ConvertToUint64());
+        steam_matchmaking->send_lobby_enter_result(g->api_id, g->lobby_id, k_EChatRoomEnterResponseSuccess);
+        pending_joins.erase(g);
+        steam_matchmaking->trigger_lobby_dataupdate((uint64)lobby->room_id(), (uint64)lobby->room_id(), true);
+        return;
+    }
+
+    PRINT_DEBUG("pending join timeout %llu", g->lobby_id.ConvertToUint64());
+    steam_matchmaking->send_lobby_enter_result(g->api_id, g->lobby_id, k_EChatRoomEnterResponseDoesntExist);
+    pending_joins.erase(g);
+}
+
+void Steam_Matchmaking::lobby_data_timer(void *object, uint64 lobby_id)
+{
+    Steam_Matchmaking *steam_matchmaking = (Steam_Matchmaking *)object;
+    auto &data_requested = steam_matchmaking->data_requested;
+    Timer_Wheel *timers = steam_matchmaking->run_every_runcb->get_timers();
+    // the same lobby can be requested again before the first request times out, only drop the expired one
+    auto dr = std::find_if(data_requested.begin(), data_requested.end(), [lobby_id, timers](Data_Requested const& item) {
+        return item.lobby_id.ConvertToUint64() == lobby_id && timers->passed(item.requested, REQUEST_LOBBY_DATA_TIMEOUT);
+    });
+    if (dr == data_requested.end()) return;
+
+    bool success = !!steam_matchmaking->get_lobby(dr->lobby_id);
+    data_requested.erase(dr);
+    steam_matchmaking->trigger_lobby_dataupdate((uint64)lobby_id, (uint64)lobby_id, success);
+}
+
 bool Steam_Matchmaking::add_member_to_lobby(Lobby *lobby, CSteamID id)
 {
     if (get_lobby_member(lobby, id)) return false; // player already exists
@@ -273,6 +344,8 @@ Steam_Matchmaking::Steam_Matchmaking(class Settings *settings, class Local_Stora
     this->network->setCallback(CALLBACK_ID_LOBBY, settings->get_local_steam_id(), &Steam_Matchmaking::steam_matchmaking_callback, this);
     this->network->setCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Matchmaking::steam_matchmaking_callback, this);
     this->run_every_runcb->add(&Steam_Matchmaking::steam_matchmaking_run_every_runcb, this);
+    // the first broadcast goes out on the next frame
+    this->run_every_runcb->get_timers()->add(0.0, &Steam_Matchmaking::send_lobbies_timer, this);
 }
 
 Steam_Matchmaking::~Steam_Matchmaking()
@@ -280,6 +353,7 @@ Steam_Matchmaking::~Steam_Matchmaking()
     this->network->rmCallback(CALLBACK_ID_LOBBY, settings->get_local_steam_id(), &Steam_Matchmaking::steam_matchmaking_callback, this);
     this->network->rmCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Matchmaking::steam_matchmaking_callback, this);
     this->run_every_runcb->remove(&Steam_Matchmaking::steam_matchmaking_run_every_runcb, this);
+    this->run_every_runcb->get_timers()->remove(this);
 }
 
 
@@ -471,7 +545,7 @@ STEAM_CALL_RESULT( LobbyMatchList_t )
 SteamAPICall_t Steam_Matchmaking::RequestLobbyList()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     filtered_lobbies.clear();
     lobby_last_search = std::chrono::high_resolution_clock::now();
@@ -482,6 +556,7 @@ SteamAPICall_t Steam_Matchmaking::RequestLobbyList()
     searching = true;
     if (search_call_api_id) callback_results->rmCallBack(search_call_api_id, NULL);
     search_call_api_id = callback_results->reserveCallResult();
+    run_every_runcb->get_timers()->add(lobby_last_search, LOBBY_SEARCH_TIMEOUT, &Steam_Matchmaking::lobby_search_timer, this, search_call_api_id);
     
     return search_call_api_id;
 }
@@ -499,7 +574,7 @@ void Steam_Matchmaking::AddRequestLobbyListStringFilter( const char *pchKeyToMat
     PRINT_DEBUG("'%s'=='%s' %i", pchKeyToMatch, pchValueToMatch, eComparisonType);
     if (!pchValueToMatch) return;
 
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Filter_Values fv;
     fv.key = std::string(pchKeyToMatch);
     fv.value_string = std::string(pchValueToMatch);
@@ -513,7 +588,7 @@ void Steam_Matchmaking::AddRequestLobbyListStringFilter( const char *pchKeyToMat
 void Steam_Matchmaking::AddRequestLobbyListNumericalFilter( const char *pchKeyToMatch, int nValueToMatch, ELobbyComparison eComparisonType )
 {
     PRINT_DEBUG("'%s'==%i %i", pchKeyToMatch, nValueToMatch, eComparisonType);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Filter_Values fv;
     fv.key = std::string(pchKeyToMatch);
     fv.value_int = nValueToMatch;
@@ -527,7 +602,7 @@ void Steam_Matchmaking::AddRequestLobbyListNumericalFilter( const char *pchKeyTo
 void Steam_Matchmaking::AddRequestLobbyListNearValueFilter( const char *pchKeyToMatch, int nValueToBeCloseTo )
 {
     PRINT_DEBUG("'%s'==%u", pchKeyToMatch, nValueToBeCloseTo);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     
 }
@@ -536,7 +611,7 @@ void Steam_Matchmaking::AddRequestLobbyListNearValueFilter( const char *pchKeyTo
 void Steam_Matchmaking::AddRequestLobbyListFilterSlotsAvailable( int nSlotsAvailable )
 {
     PRINT_DEBUG("%i", nSlotsAvailable);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     
 }
@@ -545,7 +620,7 @@ void Steam_Matchmaking::AddRequestLobbyListFilterSlotsAvailable( int nSlotsAvail
 void Steam_Matchmaking::AddRequestLobbyListDistanceFilter( ELobbyDistanceFilter eLobbyDistanceFilter )
 {
     PRINT_DEBUG("%i", eLobbyDistanceFilter);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     
 }
@@ -554,7 +629,7 @@ void Steam_Matchmaking::AddRequestLobbyListDistanceFilter( ELobbyDistanceFilter
 void Steam_Matchmaking::AddRequestLobbyListResultCountFilter( int cMaxResults )
 {
     PRINT_DEBUG("%i", cMaxResults);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     filter_max_results = cMaxResults;
     
 }
@@ -563,7 +638,7 @@ void Steam_Matchmaking::AddRequestLobbyListResultCountFilter( int cMaxResults )
 void Steam_Matchmaking::AddRequestLobbyListCompatibleMembersFilter( CSteamID steamIDLobby )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     
 }
@@ -581,7 +656,7 @@ void Steam_Matchmaking::AddRequestLobbyListNumericalFilter( const char *pchKeyTo
 void Steam_Matchmaking::AddRequestLobbyListSlotsAvailableFilter()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
 }
 
@@ -592,7 +667,7 @@ void Steam_Matchmaking::AddRequestLobbyListSlotsAvailableFilter()
 CSteamID Steam_Matchmaking::GetLobbyByIndex( int iLobby )
 {
     PRINT_DEBUG("%i", iLobby);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     CSteamID id = k_steamIDNil;
     if (iLobby >= 0 && static_cast<size_t>(iLobby) < filtered_lobbies.size()) {
         id = filtered_lobbies[iLobby];
@@ -604,7 +679,7 @@ CSteamID Steam_Matchmaking::GetLobbyByIndex( int iLobby )
 void Steam_Matchmaking::GetLobbyByIndex(CSteamID& res, int iLobby )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetLobbyByIndex(iLobby );
 }
 
@@ -618,13 +693,14 @@ STEAM_CALL_RESULT( LobbyCreated_t )
 SteamAPICall_t Steam_Matchmaking::CreateLobby( ELobbyType eLobbyType, int cMaxMembers )
 {
     PRINT_DEBUG("type: %i max_members: %i", eLobbyType, cMaxMembers);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct Pending_Creates p_c{};
     p_c.api_id = callback_results->reserveCallResult();
     p_c.eLobbyType = eLobbyType;
     p_c.cMaxMembers = cMaxMembers;
     p_c.created = std::chrono::high_resolution_clock::now();
     pending_creates.push_back(p_c);
+    run_every_runcb->get_timers()->add(p_c.created, LOBBY_CREATE_DELAY, &Steam_Matchmaking::lobby_create_timer, this, p_c.api_id);
     return p_c.api_id;
 }
 
@@ -652,7 +728,7 @@ STEAM_CALL_RESULT( LobbyEnter_t )
 SteamAPICall_t Steam_Matchmaking::JoinLobby( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto pj = std::find_if(pending_joins.begin(), pending_joins.end(), [&steamIDLobby](Pending_Joins const& item) {return item.lobby_id == steamIDLobby;});
     if (pj != pending_joins.end()) {
@@ -665,6 +741,7 @@ SteamAPICall_t Steam_Matchmaking::JoinLobby( CSteamID steamIDLobby )
     pending_join.lobby_id = steamIDLobby;
     pending_join.joined = std::chrono::high_resolution_clock::now();
     pending_joins.push_back(pending_join);
+    run_every_runcb->get_timers()->add(pending_join.joined, PENDING_JOIN_TIMEOUT, &Steam_Matchmaking::pending_join_timer, this, pending_join.api_id);
 
     Lobby_Messages *message = new Lobby_Messages();
     message->set_type(Lobby_Messages::JOIN);
@@ -684,7 +761,7 @@ void Steam_Matchmaking::JoinLobby_OLD( CSteamID steamIDLobby )
 void Steam_Matchmaking::LeaveLobby( CSteamID steamIDLobby )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     PRINT_DEBUG("pass mutex");
     Lobby *lobby = get_lobby(steamIDLobby);
     if (lobby) {
@@ -729,7 +806,7 @@ void Steam_Matchmaking::LeaveLobby( CSteamID steamIDLobby )
 bool Steam_Matchmaking::InviteUserToLobby( CSteamID steamIDLobby, CSteamID steamIDInvitee )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby) return false;
 
@@ -753,7 +830,7 @@ bool Steam_Matchmaking::InviteUserToLobby( CSteamID steamIDLobby, CSteamID steam
 int Steam_Matchmaking::GetNumLobbyMembers( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     int ret = 0;
     if (lobby) ret = lobby->members().size();
@@ -768,7 +845,7 @@ int Steam_Matchmaking::GetNumLobbyMembers( CSteamID steamIDLobby )
 CSteamID Steam_Matchmaking::GetLobbyMemberByIndex( CSteamID steamIDLobby, int iMember )
 {
     PRINT_DEBUG("%llu %i", steamIDLobby.ConvertToUint64(), iMember);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     CSteamID id = k_steamIDNil;
     if (lobby && !lobby->deleted() && lobby->members().size() > iMember && iMember >= 0) id = (uint64)lobby->members(iMember).id();
@@ -779,7 +856,7 @@ CSteamID Steam_Matchmaking::GetLobbyMemberByIndex( CSteamID steamIDLobby, int iM
 void Steam_Matchmaking::GetLobbyMemberByIndex(CSteamID&res, CSteamID steamIDLobby, int iMember )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetLobbyMemberByIndex( steamIDLobby, iMember );
 }
 
@@ -790,7 +867,7 @@ void Steam_Matchmaking::GetLobbyMemberByIndex(CSteamID&res, CSteamID steamIDLobb
 const char* Steam_Matchmaking::GetLobbyData( CSteamID steamIDLobby, const char *pchKey )
 {
     PRINT_DEBUG("%llu '%s'", steamIDLobby.ConvertToUint64(), pchKey);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchKey) return "";
     
     Lobby *lobby = get_lobby(steamIDLobby);
@@ -812,7 +889,7 @@ const char* Steam_Matchmaking::GetLobbyData( CSteamID steamIDLobby, const char *
 bool Steam_Matchmaking::SetLobbyData( CSteamID steamIDLobby, const char *pchKey, const char *pchValue )
 {
     PRINT_DEBUG("[%llu] '%s'='%s'", steamIDLobby.ConvertToUint64(), pchKey, pchValue);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchKey) return false;
     if (!pchValue) pchValue = "";
 
@@ -844,7 +921,7 @@ bool Steam_Matchmaking::SetLobbyData( CSteamID steamIDLobby, const char *pchKey,
 int Steam_Matchmaking::GetLobbyDataCount( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     Lobby *lobby = get_lobby(steamIDLobby);
     int size = 0;
@@ -859,7 +936,7 @@ int Steam_Matchmaking::GetLobbyDataCount( CSteamID steamIDLobby )
 bool Steam_Matchmaking::GetLobbyDataByIndex( CSteamID steamIDLobby, int iLobbyData, char *pchKey, int cchKeyBufferSize, char *pchValue, int cchValueBufferSize )
 {
     PRINT_DEBUG("%llu [%i] key size=%i, value size=%i", steamIDLobby.ConvertToUint64(), iLobbyData, cchKeyBufferSize, cchValueBufferSize);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     Lobby *lobby = get_lobby(steamIDLobby);
     bool ret = false;
@@ -890,7 +967,7 @@ bool Steam_Matchmaking::GetLobbyDataByIndex( CSteamID steamIDLobby, int iLobbyDa
 bool Steam_Matchmaking::DeleteLobbyData( CSteamID steamIDLobby, const char *pchKey )
 {
     PRINT_DEBUG("'%s'", pchKey);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->owner() != settings->get_local_steam_id().ConvertToUint64() || lobby->deleted()) {
         return false;
@@ -907,7 +984,7 @@ bool Steam_Matchmaking::DeleteLobbyData( CSteamID steamIDLobby, const char *pchK
 const char* Steam_Matchmaking::GetLobbyMemberData( CSteamID steamIDLobby, CSteamID steamIDUser, const char *pchKey )
 {
     PRINT_DEBUG("'%s' %llu %llu", pchKey, steamIDLobby.ConvertToUint64(), steamIDUser.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchKey) return "";
 
     Lobby_Member *member = get_lobby_member(get_lobby(steamIDLobby), steamIDUser);
@@ -940,7 +1017,7 @@ void Steam_Matchmaking::SetLobbyMemberData( CSteamID steamIDLobby, const char *p
     char empty_string[] = "";
     if (!pchValue) pchValue = empty_string;
 
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->deleted()) return;
 
@@ -986,7 +1063,7 @@ void Steam_Matchmaking::SetLobbyMemberData( CSteamID steamIDLobby, const char *p
 bool Steam_Matchmaking::SendLobbyChatMsg( CSteamID steamIDLobby, const void *pvMsgBody, int cubMsgBody )
 {
     PRINT_DEBUG("%llu %i", steamIDLobby.ConvertToUint64(), cubMsgBody);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->deleted()) return false;
 
@@ -1004,7 +1081,7 @@ bool Steam_Matchmaking::SendLobbyChatMsg( CSteamID steamIDLobby, const void *pvM
 int Steam_Matchmaking::GetLobbyChatEntry( CSteamID steamIDLobby, int iChatID, STEAM_OUT_STRUCT() CSteamID *pSteamIDUser, void *pvData, int cubData, EChatEntryType *peChatEntryType )
 {
     PRINT_DEBUG("%llu %i %p %p %i %p", steamIDLobby.ConvertToUint64(), iChatID, pSteamIDUser, pvData, cubData, peChatEntryType);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (iChatID < 0 || cubData < 0 || static_cast<size_t>(iChatID) >= chat_entries.size()) return 0;
     if (chat_entries[iChatID].lobby_id != steamIDLobby) return 0;
     if (pSteamIDUser) *pSteamIDUser = chat_entries[iChatID].user_id;
@@ -1032,12 +1109,13 @@ int Steam_Matchmaking::GetLobbyChatEntry( CSteamID steamIDLobby, int iChatID, ST
 bool Steam_Matchmaking::RequestLobbyData( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     struct Data_Requested requested{};
     requested.lobby_id = steamIDLobby;
     requested.requested = std::chrono::high_resolution_clock::now();
     data_requested.push_back(requested);
+    run_every_runcb->get_timers()->add(requested.requested, REQUEST_LOBBY_DATA_TIMEOUT, &Steam_Matchmaking::lobby_data_timer, this, steamIDLobby.ConvertToUint64());
     return true;
 }
 
@@ -1049,7 +1127,7 @@ void Steam_Matchmaking::SetLobbyGameServer( CSteamID steamIDLobby, uint32 unGame
     PRINT_DEBUG("%llu %llu %hhu.%hhu.%hhu.%hhu:%hu",
         steamIDLobby.ConvertToUint64(), steamIDGameServer.ConvertToUint64(), ((unsigned char *)&unGameServerIP)[3], ((unsigned char *)&unGameServerIP)[2], ((unsigned char *)&unGameServerIP)[1], ((unsigned char *)&unGameServerIP)[0], unGameServerPort
     );
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (lobby) {
         if (lobby->deleted()) return;
@@ -1070,7 +1148,7 @@ void Steam_Matchmaking::SetLobbyGameServer( CSteamID steamIDLobby, uint32 unGame
 bool Steam_Matchmaking::GetLobbyGameServer( CSteamID steamIDLobby, uint32 *punGameServerIP, uint16 *punGameServerPort, STEAM_OUT_STRUCT() CSteamID *psteamIDGameServer )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby) {
         
@@ -1095,7 +1173,7 @@ bool Steam_Matchmaking::GetLobbyGameServer( CSteamID steamIDLobby, uint32 *punGa
 bool Steam_Matchmaking::SetLobbyMemberLimit( CSteamID steamIDLobby, int cMaxMembers )
 {
     PRINT_DEBUG("%llu %i", steamIDLobby.ConvertToUint64(), cMaxMembers);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->owner() != settings->get_local_steam_id().ConvertToUint64() || lobby->deleted()) {
         
@@ -1112,7 +1190,7 @@ bool Steam_Matchmaking::SetLobbyMemberLimit( CSteamID steamIDLobby, int cMaxMemb
 int Steam_Matchmaking::GetLobbyMemberLimit( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     int limit = 0;
     if (lobby) limit = lobby->member_limit();
@@ -1131,7 +1209,7 @@ void Steam_Matchmaking::SetLobbyVoiceEnabled( CSteamID steamIDLobby, bool bVoice
 bool Steam_Matchmaking::SetLobbyType( CSteamID steamIDLobby, ELobbyType eLobbyType )
 {
     PRINT_DEBUG("%i", eLobbyType);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->owner() != settings->get_local_steam_id().ConvertToUint64() || lobby->deleted()) {
         return false;
@@ -1155,7 +1233,7 @@ bool Steam_Matchmaking::SetLobbyType( CSteamID steamIDLobby, ELobbyType eLobbyTy
 bool Steam_Matchmaking::SetLobbyJoinable( CSteamID steamIDLobby, bool bLobbyJoinable )
 {
     PRINT_DEBUG("%u", bLobbyJoinable);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->owner() != settings->get_local_steam_id().ConvertToUint64() || lobby->deleted()) {
         return false;
@@ -1177,7 +1255,7 @@ bool Steam_Matchmaking::SetLobbyJoinable( CSteamID steamIDLobby, bool bLobbyJoin
 CSteamID Steam_Matchmaking::GetLobbyOwner( CSteamID steamIDLobby )
 {
     PRINT_DEBUG("%llu", steamIDLobby.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->deleted()) return k_steamIDNil;
 
@@ -1188,7 +1266,7 @@ CSteamID Steam_Matchmaking::GetLobbyOwner( CSteamID steamIDLobby )
 void Steam_Matchmaking::GetLobbyOwner(CSteamID& res, CSteamID steamIDLobby )
 {
     PRINT_DEBUG_GNU_WIN();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     res = GetLobbyOwner( steamIDLobby );
 }
 
@@ -1216,7 +1294,7 @@ float Steam_Matchmaking::GetLobbyDistance( CSteamID steamIDLobby )
 bool Steam_Matchmaking::SetLobbyOwner( CSteamID steamIDLobby, CSteamID steamIDNewOwner )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Lobby *lobby = get_lobby(steamIDLobby);
     if (!lobby || lobby->owner() != settings->get_local_steam_id().ConvertToUint64() || lobby->deleted()) return false;
     Lobby_Member *member = get_lobby_member(lobby, steamIDNewOwner);
@@ -1257,154 +1335,144 @@ void Steam_Matchmaking::remove_lobbies()
     }
 }
 
-void Steam_Matchmaking::create_pending_lobbies()
-{
-    auto p_c = std::begin(pending_creates);
-    while (p_c != std::end(pending_creates)) {
-        if (check_timedout(p_c->created, LOBBY_CREATE_DELAY)) {
-            Lobby lobby{};
-            CSteamID lobby_id = generate_steam_id_lobby();
-            lobby.set_room_id(lobby_id.ConvertToUint64());
-            lobby.set_joinable(true);
-            lobby.set_member_limit(p_c->cMaxMembers);
-            lobby.set_type(p_c->eLobbyType);
-            lobby.set_owner(settings->get_local_steam_id().ConvertToUint64());
-            lobby.set_appid(settings->get_local_game_id().AppID());
-            add_member_to_lobby(&lobby, settings->get_local_steam_id());
-            lobbies.push_back(lobby);
-
-            if (settings->disable_lobby_creation) {
-                LobbyCreated_t data;
-                data.m_eResult = k_EResultFail;
-                data.m_ulSteamIDLobby = 0;
-                callback_results->addCallResult(p_c->api_id, data.k_iCallback, &data, sizeof(data));
-                callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-            } else {
-                LobbyCreated_t data;
-                data.m_eResult = k_EResultOK;
-                data.m_ulSteamIDLobby = lobby.room_id();
-                callback_results->addCallResult(p_c->api_id, data.k_iCallback, &data, sizeof(data));
-                callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-                
-                {
-                    LobbyEnter_t data2{};
-                    data2.m_ulSteamIDLobby = lobby.room_id();
-                    data2.m_rgfChatPermissions = 0; //Unused - Always 0
-                    if (p_c->eLobbyType == k_ELobbyTypePrivate)
-                        data2.m_bLocked = true;
-                    else
-                        data2.m_bLocked = false;
-                    data2.m_EChatRoomEnterResponse = k_EChatRoomEnterResponseSuccess;
-                    callbacks->addCBResult(data2.k_iCallback, &data2, sizeof(data2));
-                }
+void Steam_Matchmaking::create_pending_lobby(SteamAPICall_t api_id)
+{
+    auto p_c = std::find_if(pending_creates.begin(), pending_creates.end(), [api_id](Pending_Creates const& item) { return item.api_id == api_id; });
+    if (p_c == pending_creates.end()) return;
 
-                on_self_enter_leave_lobby(lobby_id, p_c->eLobbyType, false);
-                trigger_lobby_dataupdate(lobby_id, lobby_id, true);
-            }
+    Lobby lobby{};
+    CSteamID lobby_id = generate_steam_id_lobby();
+    lobby.set_room_id(lobby_id.ConvertToUint64());
+    lobby.set_joinable(true);
+    lobby.set_member_limit(p_c->cMaxMembers);
+    lobby.set_type(p_c->eLobbyType);
+    lobby.set_owner(settings->get_local_steam_id().ConvertToUint64());
+    lobby.set_appid(settings->get_local_game_id().AppID());
+    add_member_to_lobby(&lobby, settings->get_local_steam_id());
+    lobbies.push_back(lobby);
 
-            p_c = pending_creates.erase(p_c);
-        } else {
-            ++p_c;
+    if (settings->disable_lobby_creation) {
+        LobbyCreated_t data;
+        data.m_eResult = k_EResultFail;
+        data.m_ulSteamIDLobby = 0;
+        callback_results->addCallResult(p_c->api_id, data.k_iCallback, &data, sizeof(data));
+        callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+    } else {
+        LobbyCreated_t data;
+        data.m_eResult = k_EResultOK;
+        data.m_ulSteamIDLobby = lobby.room_id();
+        callback_results->addCallResult(p_c->api_id, data.k_iCallback, &data, sizeof(data));
+        callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+        
+        {
+            LobbyEnter_t data2{};
+            data2.m_ulSteamIDLobby = lobby.room_id();
+            data2.m_rgfChatPermissions = 0; //Unused - Always 0
+            if (p_c->eLobbyType == k_ELobbyTypePrivate)
+                data2.m_bLocked = true;
+            else
+                data2.m_bLocked = false;
+            data2.m_EChatRoomEnterResponse = k_EChatRoomEnterResponseSuccess;
+            callbacks->addCBResult(data2.k_iCallback, &data2, sizeof(data2));
         }
-    }
-}
-
-void Steam_Matchmaking::run_background()
-{
-    remove_lobbies();
-    create_pending_lobbies();
 
-    if (check_timedout(last_sent_lobbies, SEND_LOBBY_RATE)) {
-        send_lobby_data();
-        last_sent_lobbies = std::chrono::high_resolution_clock::now();
+        on_self_enter_leave_lobby(lobby_id, p_c->eLobbyType, false);
+        trigger_lobby_dataupdate(lobby_id, lobby_id, true);
     }
+
+    pending_creates.erase(p_c);
 }
 
-void Steam_Matchmaking::RunCallbacks()
+void Steam_Matchmaking::search_lobbies()
 {
-    run_background();
-
-    if (searching) {
-        PRINT_DEBUG("for lobbies %zu", lobbies.size());
-        for(auto & l: lobbies) {
-            bool use = l.joinable() && (l.type() == k_ELobbyTypePublic || l.type() == k_ELobbyTypeInvisible || l.type() == k_ELobbyTypeFriendsOnly) && !l.deleted();
-            PRINT_DEBUG("use lobby: %u, filters: %zu, joinable: %u, type: %u, deleted: %u", use, filter_values_copy.size(), l.joinable(), l.type(), l.deleted());
-            for (auto & f : filter_values_copy) {
-                PRINT_DEBUG("'%s':'%s'/%i %u %i", f.key.c_str(), f.value_string.c_str(), f.value_int, f.is_int, f.eComparisonType);
-                auto value = caseinsensitive_find(l.values(), f.key);
-                if (value != l.values().end()) {
-                    //TODO: eComparisonType
-                    if (!f.is_int) {
-                        PRINT_DEBUG("Compare Values %s %s", value->second.c_str(), f.value_string.c_str());
+    PRINT_DEBUG("for lobbies %zu", lobbies.size());
+    for(auto & l: lobbies) {
+        bool use = l.joinable() && (l.type() == k_ELobbyTypePublic || l.type() == k_ELobbyTypeInvisible || l.type() == k_ELobbyTypeFriendsOnly) && !l.deleted();
+        PRINT_DEBUG("use lobby: %u, filters: %zu, joinable: %u, type: %u, deleted: %u", use, filter_values_copy.size(), l.joinable(), l.type(), l.deleted());
+        for (auto & f : filter_values_copy) {
+            PRINT_DEBUG("'%s':'%s'/%i %u %i", f.key.c_str(), f.value_string.c_str(), f.value_int, f.is_int, f.eComparisonType);
+            auto value = caseinsensitive_find(l.values(), f.key);
+            if (value != l.values().end()) {
+                //TODO: eComparisonType
+                if (!f.is_int) {
+                    PRINT_DEBUG("Compare Values %s %s", value->second.c_str(), f.value_string.c_str());
+                    if (f.eComparisonType == k_ELobbyComparisonEqual) {
+                        if (value->second == f.value_string) {
+                            PRINT_DEBUG("Equal (non-int)");
+                            //use = use;
+                        } else {
+                            PRINT_DEBUG("Not Equal (non-int)");
+                            use = false;
+                        }
+                    } else {
+                        PRINT_DEBUG("TODO UNSUPPORTED compare type (non-int) %i", (int)f.eComparisonType);
+                    }
+                } else {
+                    try {
+                        PRINT_DEBUG("%s", value->second.c_str());
+                        int compare_to = 0;
+                        //TODO: check if this is how real steam behaves
+                        if (value->second.size()) {
+                            compare_to = static_cast<int>(std::stoll(value->second, 0, 0));
+                        }
+                        PRINT_DEBUG("Compare Values %i %i", compare_to, f.value_int);
                         if (f.eComparisonType == k_ELobbyComparisonEqual) {
-                            if (value->second == f.value_string) {
-                                PRINT_DEBUG("Equal (non-int)");
+                            if (compare_to == f.value_int) {
+                                PRINT_DEBUG("Equal (int)");
                                 //use = use;
                             } else {
-                                PRINT_DEBUG("Not Equal (non-int)");
+                                PRINT_DEBUG("Not Equal (int)");
                                 use = false;
                             }
                         } else {
-                            PRINT_DEBUG("TODO UNSUPPORTED compare type (non-int) %i", (int)f.eComparisonType);
+                            PRINT_DEBUG("TODO UNSUPPORTED compare type (int) %i", (int)f.eComparisonType);
                         }
-                    } else {
-                        try {
-                            PRINT_DEBUG("%s", value->second.c_str());
-                            int compare_to = 0;
-                            //TODO: check if this is how real steam behaves
-                            if (value->second.size()) {
-                                compare_to = static_cast<int>(std::stoll(value->second, 0, 0));
-                            }
-                            PRINT_DEBUG("Compare Values %i %i", compare_to, f.value_int);
-                            if (f.eComparisonType == k_ELobbyComparisonEqual) {
-                                if (compare_to == f.value_int) {
-                                    PRINT_DEBUG("Equal (int)");
-                                    //use = use;
-                                } else {
-                                    PRINT_DEBUG("Not Equal (int)");
-                                    use = false;
-                                }
-                            } else {
-                                PRINT_DEBUG("TODO UNSUPPORTED compare type (int) %i", (int)f.eComparisonType);
-                            }
-                        } catch (...) {
-                            //Same case as if the key is not in the lobby?
-                            use = false;
-                        }
-                        //TODO: add more comparisons
-                    }
-                } else {
-                    PRINT_DEBUG("Compare Key not in lobby");
-                    if (f.eComparisonType == k_ELobbyComparisonEqual) {
-                        //If the key is not in the lobby do we take it into account?
+                    } catch (...) {
+                        //Same case as if the key is not in the lobby?
                         use = false;
                     }
+                    //TODO: add more comparisons
+                }
+            } else {
+                PRINT_DEBUG("Compare Key not in lobby");
+                if (f.eComparisonType == k_ELobbyComparisonEqual) {
+                    //If the key is not in the lobby do we take it into account?
+                    use = false;
                 }
             }
+        }
 
-            PRINT_DEBUG("Lobby " "%" PRIu64 " use %u", l.room_id(), use);
-            if (use) PUSH_BACK_IF_NOT_IN(filtered_lobbies, (uint64)l.room_id());
-            if (filtered_lobbies.size() >= filter_max_results_copy) {
-                PRINT_DEBUG("returning lobby search results, count=%zu", filtered_lobbies.size());
-                searching = false;
-                LobbyMatchList_t data{};
-                data.m_nLobbiesMatching = static_cast<uint32>(filtered_lobbies.size());
-                callback_results->addCallResult(search_call_api_id, data.k_iCallback, &data, sizeof(data));
-                callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-                search_call_api_id = 0;
-            }
+        PRINT_DEBUG("Lobby " "%" PRIu64 " use %u", l.room_id(), use);
+        if (use) PUSH_BACK_IF_NOT_IN(filtered_lobbies, (uint64)l.room_id());
+        if (filtered_lobbies.size() >= filter_max_results_copy) {
+            PRINT_DEBUG("returning lobby search results, count=%zu", filtered_lobbies.size());
+            searching = false;
+            LobbyMatchList_t data{};
+            data.m_nLobbiesMatching = static_cast<uint32>(filtered_lobbies.size());
+            callback_results->addCallResult(search_call_api_id, data.k_iCallback, &data, sizeof(data));
+            callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+            search_call_api_id = 0;
         }
     }
+}
 
-    if (searching && check_timedout(lobby_last_search, LOBBY_SEARCH_TIMEOUT)) {
-        PRINT_DEBUG("LOBBY_SEARCH_TIMEOUT %zu", filtered_lobbies.size());
-        LobbyMatchList_t data{};
-        data.m_nLobbiesMatching = static_cast<uint32>(filtered_lobbies.size());
-        callback_results->addCallResult(search_call_api_id, data.k_iCallback, &data, sizeof(data));
-        callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-        searching = false;
-        search_call_api_id = 0;
-    }
+void Steam_Matchmaking::send_lobby_enter_result(SteamAPICall_t api_id, CSteamID lobby_id, EChatRoomEnterResponse response)
+{
+    LobbyEnter_t data{};
+    data.m_ulSteamIDLobby = lobby_id.ConvertToUint64();
+    data.m_rgfChatPermissions = 0; //Unused - Always 0
+    data.m_bLocked = false;
+    data.m_EChatRoomEnterResponse = response;
+    callback_results->addCallResult(api_id, data.k_iCallback, &data, sizeof(data));
+    callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+}
+
+void Steam_Matchmaking::RunCallbacks()
+{
+    // the create delay, the lobby broadcast and the timeouts are handled by the timers above
+    remove_lobbies();
+
+    if (searching) search_lobbies();
 
     auto g = std::begin(pending_joins);
     while (g != std::end(pending_joins)) {
@@ -1418,35 +1486,13 @@ void Steam_Matchmaking::RunCallbacks()
         Lobby *lobby = get_lobby(g->lobby_id);
         if (lobby && lobby->deleted()) {
             PRINT_DEBUG("lobby deleted %llu", g->lobby_id.ConvertToUint64());
-            LobbyEnter_t data{};
-            data.m_ulSteamIDLobby = lobby->room_id();
-            data.m_rgfChatPermissions = 0; //Unused - Always 0
-            data.m_bLocked = false;
-            data.m_EChatRoomEnterResponse = k_EChatRoomEnterResponseDoesntExist;
-            callback_results->addCallResult(g->api_id, data.k_iCallback, &data, sizeof(data));
-            callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+            send_lobby_enter_result(g->api_id, (uint64)lobby->room_id(), k_EChatRoomEnterResponseDoesntExist);
             g = pending_joins.erase(g);
         } else if (get_lobby_member(lobby, settings->get_local_steam_id())) {
             PRINT_DEBUG("lobby joined %llu", g->lobby_id.ConvertToUint64());
-            LobbyEnter_t data{};
-            data.m_ulSteamIDLobby = lobby->room_id();
-            data.m_rgfChatPermissions = 0; //Unused - Always 0
-            data.m_bLocked = false;
-            data.m_EChatRoomEnterResponse = k_EChatRoomEnterResponseSuccess;
-            callback_results->addCallResult(g->api_id, data.k_iCallback, &data, sizeof(data));
-            callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+            send_lobby_enter_result(g->api_id, (uint64)lobby->room_id(), k_EChatRoomEnterResponseSuccess);
             g = pending_joins.erase(g);
             trigger_lobby_dataupdate((uint64)lobby->room_id(), (uint64)lobby->room_id(), true);
-        } else if (check_timedout(g->joined, PENDING_JOIN_TIMEOUT)) {
-            PRINT_DEBUG("pending join timeout %llu", g->lobby_id.ConvertToUint64());
-            LobbyEnter_t data{};
-            data.m_ulSteamIDLobby = g->lobby_id.ConvertToUint64();
-            data.m_rgfChatPermissions = 0; //Unused - Always 0
-            data.m_bLocked = false;
-            data.m_EChatRoomEnterResponse = k_EChatRoomEnterResponseDoesntExist;
-            callback_results->addCallResult(g->api_id, data.k_iCallback, &data, sizeof(data));
-            callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-            g = pending_joins.erase(g);
         } else {
             ++g;
         }
@@ -1461,12 +1507,6 @@ void Steam_Matchmaking::RunCallbacks()
             continue;
         }
 
-        if (check_timedout(dr->requested, REQUEST_LOBBY_DATA_TIMEOUT)) {
-            trigger_lobby_dataupdate(dr->lobby_id, dr->lobby_id, false);
-            dr = data_requested.erase(dr);
-            continue;
-        }
-
         ++dr;
     }
 }
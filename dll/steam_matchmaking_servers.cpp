@@ -23,7 +23,7 @@
 
 static HServerQuery new_server_query()
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     static unsigned int a = 0;
     ++a;
     if (!a) ++a;
@@ -58,7 +58,7 @@ Steam_Matchmaking_Servers::~Steam_Matchmaking_Servers()
 HServerListRequest Steam_Matchmaking_Servers::RequestServerList(AppId_t iApp, ISteamMatchmakingServerListResponse *pRequestServersResponse, EMatchMakingType type)
 {
     PRINT_DEBUG("%u %p, %i", iApp, pRequestServersResponse, (int)type);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     static unsigned server_list_request = 0;
 
@@ -212,7 +212,7 @@ HServerListRequest Steam_Matchmaking_Servers::RequestSpectatorServerList( AppId_
 void Steam_Matchmaking_Servers::RequestOldServerList(AppId_t iApp, ISteamMatchmakingServerListResponse001 *pRequestServersResponse, EMatchMakingType type)
 {
     PRINT_DEBUG("%u", iApp);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto g = std::begin(requests);
     while (g != std::end(requests)) {
         if (g->id == (void *)type) {
@@ -375,7 +375,7 @@ void Steam_Matchmaking_Servers::ReleaseRequest( HServerListRequest hServerListRe
 gameserveritem_t *Steam_Matchmaking_Servers::GetServerDetails( HServerListRequest hRequest, int iServer )
 {
     PRINT_DEBUG("%p %i", hRequest, iServer);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     std::vector <struct Steam_Matchmaking_Servers_Gameserver> gameservers_filtered;
     auto g = std::begin(requests);
@@ -446,7 +446,7 @@ bool Steam_Matchmaking_Servers::IsRefreshing( HServerListRequest hRequest )
 int Steam_Matchmaking_Servers::GetServerCount( HServerListRequest hRequest )
 {
     PRINT_DEBUG("%p", hRequest);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int size = 0;
     auto g = std::begin(requests);
     while (g != std::end(requests)) {
@@ -527,7 +527,7 @@ void Steam_Matchmaking_Servers::RefreshServer( EMatchMakingType eType, int iServ
 HServerQuery Steam_Matchmaking_Servers::PingServer( uint32 unIP, uint16 usPort, ISteamMatchmakingPingResponse *pRequestServersResponse )
 {
     PRINT_DEBUG("%hhu.%hhu.%hhu.%hhu:%hu", ((unsigned char *)&unIP)[3], ((unsigned char *)&unIP)[2], ((unsigned char *)&unIP)[1], ((unsigned char *)&unIP)[0], usPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_Matchmaking_Servers_Direct_IP_Request r;
     r.id = new_server_query();
     r.ip = unIP;
@@ -542,7 +542,7 @@ HServerQuery Steam_Matchmaking_Servers::PingServer( uint32 unIP, uint16 usPort,
 HServerQuery Steam_Matchmaking_Servers::PlayerDetails( uint32 unIP, uint16 usPort, ISteamMatchmakingPlayersResponse *pRequestServersResponse )
 {
     PRINT_DEBUG("%hhu.%hhu.%hhu.%hhu:%hu", ((unsigned char *)&unIP)[3], ((unsigned char *)&unIP)[2], ((unsigned char *)&unIP)[1], ((unsigned char *)&unIP)[0], usPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_Matchmaking_Servers_Direct_IP_Request r;
     r.id = new_server_query();
     r.ip = unIP;
@@ -558,7 +558,7 @@ HServerQuery Steam_Matchmaking_Servers::PlayerDetails( uint32 unIP, uint16 usPor
 HServerQuery Steam_Matchmaking_Servers::ServerRules( uint32 unIP, uint16 usPort, ISteamMatchmakingRulesResponse *pRequestServersResponse )
 {
     PRINT_DEBUG("%hhu.%hhu.%hhu.%hhu:%hu", ((unsigned char *)&unIP)[3], ((unsigned char *)&unIP)[2], ((unsigned char *)&unIP)[1], ((unsigned char *)&unIP)[0], usPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_Matchmaking_Servers_Direct_IP_Request r;
     r.id = new_server_query();
     r.ip = unIP;
@@ -576,7 +576,7 @@ HServerQuery Steam_Matchmaking_Servers::ServerRules( uint32 unIP, uint16 usPort,
 void Steam_Matchmaking_Servers::CancelServerQuery( HServerQuery hServerQuery )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto r = std::find_if(direct_ip_requests.begin(), direct_ip_requests.end(), [&hServerQuery](Steam_Matchmaking_Servers_Direct_IP_Request const& item) { return item.id == hServerQuery; });
     if (direct_ip_requests.end() == r) return;
     direct_ip_requests.erase(r);
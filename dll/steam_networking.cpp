@@ -30,13 +30,13 @@
 
 bool Steam_Networking::connection_exists(CSteamID id)
 {
-    std::lock_guard<std::recursive_mutex> lock(connections_edit_mutex);
+    Emu_Lock_Guard lock(connections_edit_mutex);
     return std::find_if(connections.begin(), connections.end(), [&id](struct Steam_Networking_Connection const& conn) { return conn.remote == id;}) != connections.end();
 }
 
 struct Steam_Networking_Connection* Steam_Networking::get_or_create_connection(CSteamID id)
 {
-    std::lock_guard<std::recursive_mutex> lock(connections_edit_mutex);
+    Emu_Lock_Guard lock(connections_edit_mutex);
     auto conn = std::find_if(connections.begin(), connections.end(), [&id](struct Steam_Networking_Connection const& conn) { return conn.remote == id;});
 
     if (connections.end() == conn) {
@@ -52,11 +52,11 @@ struct Steam_Networking_Connection* Steam_Networking::get_or_create_connection(C
 void Steam_Networking::remove_connection(CSteamID id)
 {
     {
-        std::lock_guard<std::recursive_mutex> lock(connections_edit_mutex);
+        Emu_Lock_Guard lock(connections_edit_mutex);
         auto conn = std::begin(connections);
         while (conn != std::end(connections)) {
             if (conn->remote == id) {
-
+                flush_send_queue(&(*conn));
                 conn = connections.erase(conn);
             } else {
                 ++conn;
@@ -89,6 +89,32 @@ void Steam_Networking::remove_connection(CSteamID id)
     }
 }
 
+bool Steam_Networking::flush_send_queue(struct Steam_Networking_Connection *conn)
+{
+    if (conn->send_queue.empty()) return true;
+
+    Common_Message msg;
+    msg.set_source_id(settings->get_local_steam_id().ConvertToUint64());
+    msg.set_dest_id(conn->remote.ConvertToUint64());
+    if (conn->send_queue.size() == 1) {
+        // a lone packet goes out in the plain format
+        msg.set_allocated_network(new Network_pb(std::move(conn->send_queue[0])));
+    } else {
+        msg.set_allocated_network(new Network_pb);
+        msg.mutable_network()->set_type(Network_pb::DATA_BATCH);
+        for (auto &entry : conn->send_queue) {
+            msg.mutable_network()->add_batch()->Swap(&entry);
+        }
+    }
+
+    PRINT_DEBUG("flushing %zu packets (%zu bytes) to %llu", conn->send_queue.size(), conn->send_queue_size, conn->remote.ConvertToUint64());
+    bool reliable = conn->send_queue_reliable;
+    conn->send_queue.clear();
+    conn->send_queue_size = 0;
+    conn->send_queue_reliable = false;
+    return network->sendTo(&msg, reliable);
+}
+
 SNetSocket_t Steam_Networking::create_connection_socket(CSteamID target, int nVirtualPort, uint32 nIP, uint16 nPort, SNetListenSocket_t id, enum steam_socket_connection_status status, SNetSocket_t other_id)
 {
     static SNetSocket_t socket_number = 0;
@@ -181,6 +207,24 @@ void Steam_Networking::steam_networking_run_every_runcp(void *object)
     steam_networking->RunCallbacks();
 }
 
+// called by the network thread once a Nagle deadline passed
+void Steam_Networking::steam_networking_flush(void *object)
+{
+    Steam_Networking *steam_networking = (Steam_Networking *)object;
+    Emu_Lock_Guard lock(steam_networking->connections_edit_mutex);
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto &conn : steam_networking->connections) {
+        if (conn.send_queue.empty()) continue;
+
+        if (now >= conn.send_queue_deadline) {
+            steam_networking->flush_send_queue(&conn);
+        } else {
+            steam_networking->network->scheduleFlush(conn.send_queue_deadline);
+        }
+    }
+}
+
 Steam_Networking::Steam_Networking(class Settings *settings, class Networking *network, class SteamCallBacks *callbacks, class RunEveryRunCB *run_every_runcb)
 {
     this->settings = settings;
@@ -191,6 +235,9 @@ Steam_Networking::Steam_Networking(class Settings *settings, class Networking *n
     this->network->setCallback(CALLBACK_ID_NETWORKING, settings->get_local_steam_id(), &Steam_Networking::steam_networking_callback, this);
     this->network->setCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Networking::steam_networking_callback, this);
     this->run_every_runcb->add(&Steam_Networking::steam_networking_run_every_runcp, this);
+    if (settings->nagle_time_us > 0) {
+        this->network->addFlushCallback(&Steam_Networking::steam_networking_flush, this);
+    }
 
     PRINT_DEBUG("user id %llu messages: %p", settings->get_local_steam_id().ConvertToUint64(), &messages);
 }
@@ -200,6 +247,8 @@ Steam_Networking::~Steam_Networking()
     this->network->rmCallback(CALLBACK_ID_NETWORKING, settings->get_local_steam_id(), &Steam_Networking::steam_networking_callback, this);
     this->network->rmCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Networking::steam_networking_callback, this);
     this->run_every_runcb->remove(&Steam_Networking::steam_networking_run_every_runcp, this);
+    this->run_every_runcb->get_timers()->remove(this);
+    this->network->rmFlushCallback(&Steam_Networking::steam_networking_flush, this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -218,7 +267,7 @@ Steam_Networking::~Steam_Networking()
 bool Steam_Networking::SendP2PPacket( CSteamID steamIDRemote, const void *pubData, uint32 cubData, EP2PSend eP2PSendType, int nChannel)
 {
     PRINT_DEBUG("len %u sendtype: %u channel: %u to: %llu", cubData, eP2PSendType, nChannel, steamIDRemote.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(connections_edit_mutex);
     bool reliable = false;
     if (eP2PSendType == k_EP2PSendReliable || eP2PSendType == k_EP2PSendReliableWithBuffering) reliable = true;
     Common_Message msg;
@@ -231,14 +280,38 @@ bool Steam_Networking::SendP2PPacket( CSteamID steamIDRemote, const void *pubDat
         network->sendTo(&msg, true);
     }
 
-    msg.mutable_network()->set_channel(nChannel);
-    msg.mutable_network()->set_data(pubData, cubData);
-    msg.mutable_network()->set_type(Network_pb::DATA);
-
     struct Steam_Networking_Connection *conn = get_or_create_connection(steamIDRemote);
     new_connection_times.erase(steamIDRemote);
 
     conn->open_channels.insert(nChannel);
+
+    // only k_EP2PSendReliableWithBuffering asks to be buffered, every other send type goes out right away
+    bool buffered = eP2PSendType == k_EP2PSendReliableWithBuffering && settings->nagle_time_us > 0 && cubData < NAGLE_BATCH_MTU;
+    // keep the order of what is already queued, either by sending it first or by sending it together with this packet
+    if (conn->send_queue.size() && (!buffered || conn->send_queue_size + cubData > NAGLE_BATCH_MTU)) {
+        flush_send_queue(conn);
+    }
+
+    if (buffered) {
+        if (conn->send_queue.empty()) {
+            conn->send_queue_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(settings->nagle_time_us);
+            network->scheduleFlush(conn->send_queue_deadline);
+        }
+
+        Network_pb &entry = conn->send_queue.emplace_back();
+        entry.set_channel(nChannel);
+        entry.set_data(pubData, cubData);
+        entry.set_type(Network_pb::DATA);
+        conn->send_queue_size += cubData;
+        conn->send_queue_reliable = conn->send_queue_reliable || reliable;
+        PRINT_DEBUG("Queued message with size: %u, %zu queued", cubData, conn->send_queue.size());
+        return true;
+    }
+
+    msg.mutable_network()->set_channel(nChannel);
+    msg.mutable_network()->set_data(pubData, cubData);
+    msg.mutable_network()->set_type(Network_pb::DATA);
+
     bool ret = network->sendTo(&msg, reliable);
     PRINT_DEBUG("Sent message with size: %zu %u", msg.network().data().size(), ret);
     return ret;
@@ -336,7 +409,8 @@ bool Steam_Networking::ReadP2PPacket( void *pubDest, uint32 cubDest, uint32 *pcu
 bool Steam_Networking::AcceptP2PSessionWithUser( CSteamID steamIDRemote )
 {
     PRINT_DEBUG("%llu", steamIDRemote.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard connections_lock(connections_edit_mutex);
     struct Steam_Networking_Connection *conn = get_or_create_connection(steamIDRemote);
     if (conn) new_connection_times.erase(steamIDRemote);
     return !!conn;
@@ -348,7 +422,7 @@ bool Steam_Networking::AcceptP2PSessionWithUser( CSteamID steamIDRemote )
 bool Steam_Networking::CloseP2PSessionWithUser( CSteamID steamIDRemote )
 {
     PRINT_DEBUG("%llu", steamIDRemote.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!connection_exists(steamIDRemote)) {
         
         return false;
@@ -366,7 +440,8 @@ bool Steam_Networking::CloseP2PSessionWithUser( CSteamID steamIDRemote )
 bool Steam_Networking::CloseP2PChannelWithUser( CSteamID steamIDRemote, int nChannel )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard connections_lock(connections_edit_mutex);
     if (!connection_exists(steamIDRemote)) {
         return false;
     }
@@ -388,7 +463,7 @@ bool Steam_Networking::CloseP2PChannelWithUser( CSteamID steamIDRemote, int nCha
 bool Steam_Networking::GetP2PSessionState( CSteamID steamIDRemote, P2PSessionState_t *pConnectionState )
 {
     PRINT_DEBUG("%llu", steamIDRemote.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!connection_exists(steamIDRemote) && (steamIDRemote != settings->get_local_steam_id())) {
         if (pConnectionState) {
             pConnectionState->m_bConnectionActive = false;
@@ -455,7 +530,7 @@ SNetListenSocket_t socket_number = 0;
 SNetListenSocket_t Steam_Networking::CreateListenSocket( int nVirtualP2PPort, uint32 nIP, uint16 nPort, bool bAllowUseOfPacketRelay )
 {
     PRINT_DEBUG("old %i %u %hu %u", nVirtualP2PPort, nIP, nPort, bAllowUseOfPacketRelay);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     for (auto & c : listen_sockets) {
         if (c.nVirtualP2PPort == nVirtualP2PPort || c.nPort == nPort)
             return 0;
@@ -493,7 +568,7 @@ SNetListenSocket_t Steam_Networking::CreateListenSocket( int nVirtualP2PPort, ui
 SNetSocket_t Steam_Networking::CreateP2PConnectionSocket( CSteamID steamIDTarget, int nVirtualPort, int nTimeoutSec, bool bAllowUseOfPacketRelay )
 {
     PRINT_DEBUG("%llu %i %i %u", steamIDTarget.ConvertToUint64(), nVirtualPort, nTimeoutSec, bAllowUseOfPacketRelay);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO: nTimeoutSec
     return create_connection_socket(steamIDTarget, nVirtualPort, 0, 0);
 }
@@ -507,7 +582,7 @@ SNetSocket_t Steam_Networking::CreateP2PConnectionSocket( CSteamID steamIDTarget
 SNetSocket_t Steam_Networking::CreateConnectionSocket( uint32 nIP, uint16 nPort, int nTimeoutSec )
 {
     PRINT_DEBUG("%u %hu %i", nIP, nPort, nTimeoutSec);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO: nTimeoutSec
     return create_connection_socket((uint64)0, 0, nIP, nPort);
 }
@@ -525,7 +600,7 @@ SNetSocket_t Steam_Networking::CreateConnectionSocket( SteamIPAddress_t nIP, uin
 bool Steam_Networking::DestroySocket( SNetSocket_t hSocket, bool bNotifyRemoteEnd )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket || socket->status == SOCKET_KILLED) return false;
     socket->status = SOCKET_KILLED;
@@ -536,7 +611,7 @@ bool Steam_Networking::DestroySocket( SNetSocket_t hSocket, bool bNotifyRemoteEn
 bool Steam_Networking::DestroyListenSocket( SNetListenSocket_t hSocket, bool bNotifyRemoteEnd )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto c = std::begin(listen_sockets);
     while (c != std::end(listen_sockets)) {
         if (c->id == hSocket) {
@@ -564,7 +639,7 @@ bool Steam_Networking::DestroyListenSocket( SNetListenSocket_t hSocket, bool bNo
 bool Steam_Networking::SendDataOnSocket( SNetSocket_t hSocket, void *pubData, uint32 cubData, bool bReliable )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket || socket->status != SOCKET_CONNECTED) return false;
 
@@ -585,7 +660,7 @@ bool Steam_Networking::SendDataOnSocket( SNetSocket_t hSocket, void *pubData, ui
 bool Steam_Networking::IsDataAvailableOnSocket( SNetSocket_t hSocket, uint32 *pcubMsgSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket) {
         if (pcubMsgSize) *pcubMsgSize = 0;
@@ -605,7 +680,7 @@ bool Steam_Networking::IsDataAvailableOnSocket( SNetSocket_t hSocket, uint32 *pc
 bool Steam_Networking::RetrieveDataFromSocket( SNetSocket_t hSocket, void *pubDest, uint32 cubDest, uint32 *pcubMsgSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket || socket->data_packets.size() == 0) return false;
 
@@ -630,7 +705,7 @@ bool Steam_Networking::RetrieveDataFromSocket( SNetSocket_t hSocket, void *pubDe
 bool Steam_Networking::IsDataAvailable( SNetListenSocket_t hListenSocket, uint32 *pcubMsgSize, SNetSocket_t *phSocket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!hListenSocket) return false;
 
     for (auto & socket : connection_sockets) {
@@ -654,7 +729,7 @@ bool Steam_Networking::IsDataAvailable( SNetListenSocket_t hListenSocket, uint32
 bool Steam_Networking::RetrieveData( SNetListenSocket_t hListenSocket, void *pubDest, uint32 cubDest, uint32 *pcubMsgSize, SNetSocket_t *phSocket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!hListenSocket) return false;
 
     for (auto & socket : connection_sockets) {
@@ -680,7 +755,7 @@ bool Steam_Networking::RetrieveData( SNetListenSocket_t hListenSocket, void *pub
 bool Steam_Networking::GetSocketInfo( SNetSocket_t hSocket, CSteamID *pSteamIDRemote, int *peSocketStatus, uint32 *punIPRemote, uint16 *punPortRemote )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket) return false;
     if (pSteamIDRemote) *pSteamIDRemote = socket->target;
@@ -726,7 +801,7 @@ bool Steam_Networking::GetSocketInfo( SNetSocket_t hSocket, CSteamID *pSteamIDRe
 bool Steam_Networking::GetListenSocketInfo( SNetListenSocket_t hListenSocket, uint32 *pnIP, uint16 *pnPort )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto conn = std::find_if(listen_sockets.begin(), listen_sockets.end(), [&hListenSocket](struct steam_listen_socket const& conn) { return conn.id == hListenSocket;});
     if (conn == listen_sockets.end()) return false;
     if (pnIP) *pnIP = conn->nIP;
@@ -755,7 +830,7 @@ bool Steam_Networking::GetListenSocketInfo( SNetListenSocket_t hListenSocket, St
 ESNetSocketConnectionType Steam_Networking::GetSocketConnectionType( SNetSocket_t hSocket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     struct steam_connection_socket *socket = get_connection_socket(hSocket);
     if (!socket || socket->status != SOCKET_CONNECTED) return k_ESNetSocketConnectionTypeNotConnected;
     else return k_ESNetSocketConnectionTypeUDP;
@@ -769,84 +844,105 @@ int Steam_Networking::GetMaxPacketSize( SNetSocket_t hSocket )
     return 1500;
 }
 
-void Steam_Networking::RunCallbacks()
+// seconds on the same clock as the timers, only ever compared with each other
+static uint64 seconds_since_epoch(std::chrono::high_resolution_clock::time_point time)
 {
-    uint64 current_time = std::chrono::duration_cast<std::chrono::duration<uint64>>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return std::chrono::duration_cast<std::chrono::duration<uint64>>(time.time_since_epoch()).count();
+}
 
-    {
-    std::lock_guard<std::recursive_mutex> lock(messages_mutex);
+void Steam_Networking::new_connection_timer(void *object, uint64 steam_id)
+{
+    Steam_Networking *obj = (Steam_Networking *)object;
+    Emu_Lock_Guard connections_lock(obj->connections_edit_mutex);
+    auto t = obj->new_connection_times.find((uint64)steam_id);
+    // accepted in the meantime, or timed out and seen again, in which case the newer timer posts it
+    if (t == obj->new_connection_times.end() || !obj->run_every_runcb->get_timers()->passed(t->second, NEW_CONNECTION_DELAY)) return;
+
+    P2PSessionRequest_t data;
+    memset(&data, 0, sizeof(data));
+    data.m_steamIDRemote = (uint64)steam_id;
+    obj->callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
+}
 
-    {
-        auto msg = std::begin(unprocessed_messages);
-        while (msg != std::end(unprocessed_messages)) {
-            CSteamID source_id((uint64)msg->source_id());
-            if (!connection_exists(source_id)) {
-                if (new_connection_times.find(source_id) == new_connection_times.end()) {
-                    new_connections_to_call_cb.push(source_id);
-                    new_connection_times[source_id] = std::chrono::high_resolution_clock::now();
-                }
-            } else {
-                struct Steam_Networking_Connection *conn = get_or_create_connection(source_id);
-                conn->open_channels.insert(msg->network().channel());
-            }
+void Steam_Networking::new_connection_timeout_timer(void *object, uint64 steam_id)
+{
+    Steam_Networking *obj = (Steam_Networking *)object;
+    Emu_Lock_Guard connections_lock(obj->connections_edit_mutex);
+    auto t = obj->new_connection_times.find((uint64)steam_id);
+    if (t == obj->new_connection_times.end() || !obj->run_every_runcb->get_timers()->passed(t->second, NEW_CONNECTION_TIMEOUT)) return;
 
-            msg->mutable_network()->set_processed(true);
-            msg->mutable_network()->set_time_processed(current_time);
-            messages.push_back(*msg);
-            msg = unprocessed_messages.erase(msg);
-        }
-    }
+    obj->new_connection_times.erase(t);
+    //TODO send packet to other side to tell them connection has "failed".
+}
 
-    auto msg = std::begin(messages);
-    while (msg != std::end(messages)) {
-        bool deleted = false;
-        if (msg->network().processed()) {
-            if (!connection_exists((uint64)msg->source_id())) {
-                if (msg->network().time_processed() + ORPHANED_PACKET_TIMEOUT < current_time) {
-                    deleted = true;
-                }
+void Steam_Networking::orphaned_packets_timer(void *object, uint64 data)
+{
+    Steam_Networking *obj = (Steam_Networking *)object;
+    uint64 current_time = seconds_since_epoch(obj->run_every_runcb->get_timers()->now());
+    uint64 oldest_left = UINT64_MAX;
+
+    std::lock_guard<std::recursive_mutex> lock(obj->messages_mutex);
+    obj->orphaned_packets_timer_pending = false;
+    auto msg = std::begin(obj->messages);
+    while (msg != std::end(obj->messages)) {
+        if (msg->network().processed() && !obj->connection_exists((uint64)msg->source_id())) {
+            if (msg->network().time_processed() + ORPHANED_PACKET_TIMEOUT < current_time) {
+                msg = obj->messages.erase(msg);
+                continue;
             }
-        }
 
-        if (deleted) {
-            msg = messages.erase(msg);
-        } else {
-            ++msg;
+            oldest_left = std::min(oldest_left, (uint64)msg->network().time_processed());
         }
+
+        ++msg;
     }
 
+    if (oldest_left != UINT64_MAX) {
+        obj->run_every_runcb->get_timers()->add((double)(oldest_left + ORPHANED_PACKET_TIMEOUT + 1 - current_time), &Steam_Networking::orphaned_packets_timer, object);
+        obj->orphaned_packets_timer_pending = true;
     }
+}
 
-    while (!new_connections_to_call_cb.empty()) {
-        CSteamID source_id = new_connections_to_call_cb.front();
-        auto t = new_connection_times.find(source_id);
-        if (t == new_connection_times.end()) {
-            new_connections_to_call_cb.pop();
-            continue;
-        }
+void Steam_Networking::RunCallbacks()
+{
+    Timer_Wheel *timers = run_every_runcb->get_timers();
+    auto frame_time = timers->now();
+    uint64 current_time = seconds_since_epoch(frame_time);
+
+    {
+    std::lock_guard<std::recursive_mutex> lock(messages_mutex);
 
-        if (!check_timedout(t->second, NEW_CONNECTION_DELAY)) {
-            break;
+    auto msg = std::begin(unprocessed_messages);
+    while (msg != std::end(unprocessed_messages)) {
+        CSteamID source_id((uint64)msg->source_id());
+        Emu_Lock_Guard connections_lock(connections_edit_mutex);
+        if (!connection_exists(source_id)) {
+            if (new_connection_times.find(source_id) == new_connection_times.end()) {
+                new_connection_times[source_id] = frame_time;
+                timers->add(frame_time, NEW_CONNECTION_DELAY, &Steam_Networking::new_connection_timer, this, source_id.ConvertToUint64());
+                timers->add(frame_time, NEW_CONNECTION_TIMEOUT, &Steam_Networking::new_connection_timeout_timer, this, source_id.ConvertToUint64());
+            }
+
+            // dropped by orphaned_packets_timer() if no connection shows up for them
+            if (!orphaned_packets_timer_pending) {
+                timers->add((double)(ORPHANED_PACKET_TIMEOUT + 1), &Steam_Networking::orphaned_packets_timer, this);
+                orphaned_packets_timer_pending = true;
+            }
+        } else {
+            struct Steam_Networking_Connection *conn = get_or_create_connection(source_id);
+            conn->open_channels.insert(msg->network().channel());
         }
 
-        P2PSessionRequest_t data;
-        memset(&data, 0, sizeof(data));
-        data.m_steamIDRemote = source_id;
-        callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
-        new_connections_to_call_cb.pop();
+        msg->mutable_network()->set_processed(true);
+        msg->mutable_network()->set_time_processed(current_time);
+        messages.push_back(*msg);
+        msg = unprocessed_messages.erase(msg);
+    }
+
     }
 
     //TODO: not sure if sockets should be wiped right away
     remove_killed_connection_sockets();
-
-    for(auto it = new_connection_times.begin(); it != new_connection_times.end(); ) {
-        if (std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - it->second).count() > NEW_CONNECTION_TIMEOUT) {
-            it = new_connection_times.erase(it);
-            //TODO send packet to other side to tell them connection has "failed".
-        } else {
-            ++it;
-        }
-    }
 }
 
 void Steam_Networking::Callback(Common_Message *msg)
@@ -862,6 +958,15 @@ void Steam_Networking::Callback(Common_Message *msg)
             unprocessed_messages.push_back(Common_Message(*msg));
         }
 
+        if (msg->network().type() == Network_pb::DATA_BATCH) {
+            for (auto &entry : msg->network().batch()) {
+                Common_Message &unpacked = unprocessed_messages.emplace_back();
+                unpacked.set_source_id(msg->source_id());
+                unpacked.set_dest_id(msg->dest_id());
+                unpacked.set_allocated_network(new Network_pb(entry));
+            }
+        }
+
         if (msg->network().type() == Network_pb::NEW_CONNECTION) {
             std::lock_guard<std::recursive_mutex> lock(messages_mutex);
             auto msg_temp = std::begin(messages);
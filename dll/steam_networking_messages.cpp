@@ -37,6 +37,17 @@ void Steam_Networking_Messages::steam_run_every_runcb(void *object)
     steam_networking_messages->RunCallbacks();
 }
 
+void Steam_Networking_Messages::connection_timeout_timer(void *object, uint64 steam_id)
+{
+    Steam_Networking_Messages *steam_networking_messages = (Steam_Networking_Messages *)object;
+    auto conn = steam_networking_messages->connections.find((uint64)steam_id);
+    // a connection that was restarted has a later timer of its own
+    if (conn == steam_networking_messages->connections.end() || conn->second.accepted) return;
+    if (!steam_networking_messages->run_every_runcb->get_timers()->passed(conn->second.created, NETWORKING_MESSAGES_TIMEOUT)) return;
+
+    steam_networking_messages->connections.erase(conn);
+}
+
 void Steam_Networking_Messages::free_steam_message_data(SteamNetworkingMessage_t *pMsg)
 {
     free(pMsg->m_pData);
@@ -66,6 +77,7 @@ std::map<CSteamID, Steam_Message_Connection>::iterator Steam_Networking_Messages
         con.remote_identity = identityRemote;
         con.id = id_counter;
         connections[identityRemote.GetSteamID()] = con;
+        run_every_runcb->get_timers()->add(con.created, NETWORKING_MESSAGES_TIMEOUT, &Steam_Networking_Messages::connection_timeout_timer, this, identityRemote.GetSteamID64());
 
         Common_Message msg;
         msg.set_source_id(settings->get_local_steam_id().ConvertToUint64());
@@ -117,6 +129,7 @@ Steam_Networking_Messages::~Steam_Networking_Messages()
     this->network->rmCallback(CALLBACK_ID_NETWORKING_MESSAGES, settings->get_local_steam_id(), &Steam_Networking_Messages::steam_callback, this);
     this->network->rmCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Networking_Messages::steam_callback, this);
     this->run_every_runcb->remove(&Steam_Networking_Messages::steam_run_every_runcb, this);
+    this->run_every_runcb->get_timers()->remove(this);
 }
 
 
@@ -165,7 +178,7 @@ Steam_Networking_Messages::~Steam_Networking_Messages()
 EResult Steam_Networking_Messages::SendMessageToUser( const SteamNetworkingIdentity &identityRemote, const void *pubData, uint32 cubData, int nSendFlags, int nRemoteChannel )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     const SteamNetworkingIPAddr *ip = identityRemote.GetIPAddr();
     bool reliable = false;
     if (nSendFlags & k_nSteamNetworkingSend_Reliable) {
@@ -213,7 +226,7 @@ EResult Steam_Networking_Messages::SendMessageToUser( const SteamNetworkingIdent
 int Steam_Networking_Messages::ReceiveMessagesOnChannel( int nLocalChannel, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     int message_counter = 0;
 
     for (auto & conn : connections) {
@@ -261,7 +274,7 @@ int Steam_Networking_Messages::ReceiveMessagesOnChannel( int nLocalChannel, Stea
 bool Steam_Networking_Messages::AcceptSessionWithUser( const SteamNetworkingIdentity &identityRemote )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto conn = connections.find(identityRemote.GetSteamID());
     if (conn == connections.end()) {
         return false;
@@ -279,7 +292,7 @@ bool Steam_Networking_Messages::AcceptSessionWithUser( const SteamNetworkingIden
 bool Steam_Networking_Messages::CloseSessionWithUser( const SteamNetworkingIdentity &identityRemote )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto conn = connections.find(identityRemote.GetSteamID());
     if (conn == connections.end()) {
         return false;
@@ -305,7 +318,7 @@ bool Steam_Networking_Messages::CloseSessionWithUser( const SteamNetworkingIdent
 bool Steam_Networking_Messages::CloseChannelWithUser( const SteamNetworkingIdentity &identityRemote, int nLocalChannel )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO
     return false;
 }
@@ -322,7 +335,7 @@ bool Steam_Networking_Messages::CloseChannelWithUser( const SteamNetworkingIdent
 ESteamNetworkingConnectionState Steam_Networking_Messages::GetSessionConnectionInfo( const SteamNetworkingIdentity &identityRemote, SteamNetConnectionInfo_t *pConnectionInfo, SteamNetConnectionRealTimeStatus_t *pQuickStatus )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto conn = connections.find(identityRemote.GetSteamID());
     if (conn == connections.end()) {
         return k_ESteamNetworkingConnectionState_None;
@@ -368,15 +381,6 @@ void Steam_Networking_Messages::RunCallbacks()
 
         msg = incoming_data.erase(msg);
     }
-
-    auto conn = std::begin(connections);
-    while (conn != std::end(connections)) {
-        if (!conn->second.accepted && check_timedout(conn->second.created, NETWORKING_MESSAGES_TIMEOUT)) {
-            conn = connections.erase(conn);
-        } else {
-            ++conn;
-        }
-    }
 }
 
 void Steam_Networking_Messages::Callback(Common_Message *msg)
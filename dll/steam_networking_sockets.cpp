@@ -34,41 +34,139 @@ void Steam_Networking_Sockets::steam_run_every_runcb(void *object)
     steam_networkingsockets->RunCallbacks();
 }
 
+// called by the network thread once a Nagle deadline passed
+void Steam_Networking_Sockets::steam_network_flush(void *object)
+{
+    Steam_Networking_Sockets *steam_networkingsockets = (Steam_Networking_Sockets *)object;
+    auto sbcs = steam_networkingsockets->sbcs;
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto socket_conn = sbcs->connect_sockets.begin(); socket_conn != sbcs->connect_sockets.end(); ++socket_conn) {
+        if (socket_conn->second.send_queue.empty()) continue;
+
+        if (now >= socket_conn->second.send_queue_deadline) {
+            steam_networkingsockets->flush_send_queue(socket_conn);
+        } else {
+            steam_networkingsockets->network->scheduleFlush(socket_conn->second.send_queue_deadline);
+        }
+    }
+}
+
+// free messages kept around for reuse, anything released past this goes back to the allocator
+#define MESSAGE_POOL_MAX_FREE 4096
+// payload buffers up to this size stay with their pooled message, so small messages are received without any allocation
+#define MESSAGE_POOL_MAX_KEPT_PAYLOAD NAGLE_BATCH_MTU
+
+// how far ahead of the next expected reliable message others are buffered
+#define RELIABLE_REORDER_WINDOW 256
+// a missing reliable message is given up on after this long, in seconds
+#define RELIABLE_GAP_TIMEOUT 5.0
+// a Nagle queue that could not be sent is tried again after this long, in milliseconds
+#define SEND_QUEUE_RETRY_MS 10
+// how much a Nagle queue that can't be sent may hold, the default k_ESteamNetworkingConfig_SendBufferSize
+#define SEND_QUEUE_MAX_SIZE (512 * 1024)
+
+struct Steam_Message_Pool {
+    std::mutex mutex{};
+    std::vector<Pooled_Steam_Message *> free_messages{};
+};
+
+static Steam_Message_Pool *get_message_pool()
+{
+    // never freed, games may still Release() messages from their own threads while the emu shuts down
+    static Steam_Message_Pool *pool = new Steam_Message_Pool();
+    return pool;
+}
+
+Pooled_Steam_Message* Steam_Networking_Sockets::alloc_pooled_message()
+{
+    Pooled_Steam_Message *pMsg = nullptr;
+    {
+        auto pool = get_message_pool();
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->free_messages.size()) {
+            pMsg = pool->free_messages.back();
+            pool->free_messages.pop_back();
+        }
+    }
+
+    if (!pMsg) pMsg = new Pooled_Steam_Message();
+
+    pMsg->m_pData = nullptr;
+    pMsg->m_cbSize = 0;
+    pMsg->m_conn = k_HSteamNetConnection_Invalid;
+    pMsg->m_identityPeer.Clear();
+    pMsg->m_nConnUserData = 0;
+    pMsg->m_usecTimeReceived = 0;
+    pMsg->m_nMessageNumber = 0;
+    pMsg->m_pfnFreeData = &free_pooled_message_data;
+    pMsg->m_pfnRelease = &release_pooled_message;
+    pMsg->m_nChannel = 0;
+    pMsg->m_nFlags = 0;
+    pMsg->m_nUserData = 0;
+    pMsg->m_idxLane = 0;
+    return pMsg;
+}
+
 SteamNetworkingMessage_t* Steam_Networking_Sockets::get_steam_message_connection(HSteamNetConnection hConn)
 {
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) return NULL;
     if (connect_socket->second.data.empty()) return NULL;
-    SteamNetworkingMessage_t *pMsg = new SteamNetworkingMessage_t();
-    unsigned long size = static_cast<unsigned long>(connect_socket->second.data.top().data().size());
-    pMsg->m_pData = malloc(size);
+    Pooled_Steam_Message *pMsg = alloc_pooled_message();
+    auto &front = connect_socket->second.data.front();
+    if (front.data().size() <= MESSAGE_POOL_MAX_KEPT_PAYLOAD) {
+        // fits in the buffer the pooled message kept, cheaper than a new one, sized once so it never grows again
+        if (pMsg->payload.capacity() < MESSAGE_POOL_MAX_KEPT_PAYLOAD) pMsg->payload.reserve(MESSAGE_POOL_MAX_KEPT_PAYLOAD);
+        pMsg->payload.assign(front.data());
+    } else {
+        pMsg->payload.swap(*front.mutable_data());
+    }
+    unsigned long size = static_cast<unsigned long>(pMsg->payload.size());
+    pMsg->m_pData = pMsg->payload.data();
     pMsg->m_cbSize = size;
-    memcpy(pMsg->m_pData, connect_socket->second.data.top().data().data(), size);
     pMsg->m_conn = hConn;
     pMsg->m_identityPeer = connect_socket->second.remote_identity;
     pMsg->m_nConnUserData = connect_socket->second.user_data;
     pMsg->m_usecTimeReceived = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - created).count();
     //TODO: check where messagenumber starts
-    pMsg->m_nMessageNumber = connect_socket->second.data.top().message_number();
+    pMsg->m_nMessageNumber = front.message_number();
+    if (front.reliable_number()) pMsg->m_nFlags = k_nSteamNetworkingSend_Reliable;
 
-    pMsg->m_pfnFreeData = &free_steam_message_data;
-    pMsg->m_pfnRelease = &delete_steam_message;
-    pMsg->m_nChannel = 0;
-    connect_socket->second.data.pop();
+    connect_socket->second.data.pop_front();
     PRINT_DEBUG("get_steam_message_connection %u %lu, %llu", hConn, size, pMsg->m_nMessageNumber);
     return pMsg;
 }
 
-void Steam_Networking_Sockets::free_steam_message_data(SteamNetworkingMessage_t *pMsg)
+void Steam_Networking_Sockets::free_pooled_message_data(SteamNetworkingMessage_t *pMsg)
 {
-    free(pMsg->m_pData);
+    // don't hoard the buffers of big messages in the pool
+    auto &payload = static_cast<Pooled_Steam_Message *>(pMsg)->payload;
+    if (payload.capacity() > MESSAGE_POOL_MAX_KEPT_PAYLOAD) {
+        std::string().swap(payload);
+    } else {
+        payload.clear();
+    }
     pMsg->m_pData = NULL;
 }
 
-void Steam_Networking_Sockets::delete_steam_message(SteamNetworkingMessage_t *pMsg)
+// may be called from any thread, only touches the pool
+void Steam_Networking_Sockets::release_pooled_message(SteamNetworkingMessage_t *pMsg)
 {
     if (pMsg->m_pfnFreeData) pMsg->m_pfnFreeData(pMsg);
-    delete pMsg;
+
+    Pooled_Steam_Message *pooled = static_cast<Pooled_Steam_Message *>(pMsg);
+    {
+        auto pool = get_message_pool();
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->free_messages.size() < MESSAGE_POOL_MAX_FREE) {
+            pool->free_messages.push_back(pooled);
+            return;
+        }
+    }
+
+    delete pooled;
 }
 
 unsigned long Steam_Networking_Sockets::get_socket_id()
@@ -93,6 +191,7 @@ HSteamNetConnection Steam_Networking_Sockets::new_connect_socket(SteamNetworking
     socket.connect_request_last_sent = std::chrono::steady_clock::now();
     socket.connect_requests_sent = 0;
     socket.packet_send_counter = 1;
+    socket.traffic_window_start = socket.connect_request_last_sent;
 
     HSteamNetConnection socket_id = get_socket_id();
     if (socket_id == k_HSteamNetConnection_Invalid) ++socket_id;
@@ -146,6 +245,191 @@ bool Steam_Networking_Sockets::send_packet_new_connection(HSteamNetConnection m_
     return false;
 }
 
+bool Steam_Networking_Sockets::flush_send_queue(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket)
+{
+    auto &conn = connect_socket->second;
+    if (conn.send_queue.empty()) return true;
+
+    Common_Message msg;
+    msg.set_source_id(conn.created_by.ConvertToUint64());
+    msg.set_dest_id(conn.remote_identity.GetSteamID64());
+    msg.set_allocated_networking_sockets(new Networking_Sockets);
+    msg.mutable_networking_sockets()->set_virtual_port(conn.virtual_port);
+    msg.mutable_networking_sockets()->set_real_port(conn.real_port);
+    msg.mutable_networking_sockets()->set_connection_id_from(connect_socket->first);
+    msg.mutable_networking_sockets()->set_connection_id(conn.remote_id);
+    if (conn.send_queue.size() == 1) {
+        // a lone message goes out in the plain format
+        msg.mutable_networking_sockets()->set_type(Networking_Sockets::DATA);
+        msg.mutable_networking_sockets()->set_data(std::move(*conn.send_queue[0].mutable_data()));
+        msg.mutable_networking_sockets()->set_message_number(conn.send_queue[0].message_number());
+        msg.mutable_networking_sockets()->set_reliable_number(conn.send_queue[0].reliable_number());
+    } else {
+        msg.mutable_networking_sockets()->set_type(Networking_Sockets::DATA_BATCH);
+        for (auto &entry : conn.send_queue) {
+            msg.mutable_networking_sockets()->add_batch()->Swap(&entry);
+        }
+    }
+
+    PRINT_DEBUG("flushing %zu messages (%zu bytes) on connection %u", conn.send_queue.size(), conn.send_queue_size, connect_socket->first);
+    if (!network->sendTo(&msg, conn.send_queue_reliable)) {
+        // the game was already told these were sent, they stay queued (with their reliable numbers) until they are
+        if (conn.send_queue.size() == 1) {
+            conn.send_queue[0].set_data(std::move(*msg.mutable_networking_sockets()->mutable_data()));
+        } else {
+            for (size_t i = 0; i < conn.send_queue.size(); ++i) {
+                conn.send_queue[i].Swap(msg.mutable_networking_sockets()->mutable_batch(static_cast<int>(i)));
+            }
+        }
+
+        PRINT_DEBUG("failed to flush connection %u, will retry", connect_socket->first);
+        conn.send_queue_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SEND_QUEUE_RETRY_MS);
+        network->scheduleFlush(conn.send_queue_deadline);
+        return false;
+    }
+
+    conn.sent.packets += 1;
+    conn.sent.bytes += static_cast<unsigned>(conn.send_queue_size);
+    conn.send_queue.clear();
+    conn.send_queue_size = 0;
+    conn.send_queue_reliable_size = 0;
+    conn.send_queue_reliable = false;
+    return true;
+}
+
+void Steam_Networking_Sockets::push_received_data(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket, Networking_Sockets &data)
+{
+    connect_socket->second.received.packets += 1;
+    if (data.type() == Networking_Sockets::DATA_BATCH) {
+        for (auto &entry : *data.mutable_batch()) {
+            receive_message(connect_socket->second, entry);
+        }
+    } else {
+        receive_message(connect_socket->second, data);
+    }
+
+    mark_ready(connect_socket);
+}
+
+// queue the connection in the ready lists so the receive functions don't have to look at idle connections
+void Steam_Networking_Sockets::mark_ready(std::map<HSteamNetConnection, Connect_Socket>::iterator connect_socket)
+{
+    auto &conn = connect_socket->second;
+    if (conn.data.empty()) return;
+
+    if (!conn.poll_ready && conn.poll_group != k_HSteamNetPollGroup_Invalid) {
+        auto group = sbcs->poll_groups.find(conn.poll_group);
+        if (group != sbcs->poll_groups.end()) {
+            group->second.ready.push_back(connect_socket->first);
+            conn.poll_ready = true;
+        }
+    }
+
+    if (!conn.listen_ready && conn.listen_socket_id != k_HSteamListenSocket_Invalid) {
+        struct Listen_Socket *listen_socket = get_connection_socket(conn.listen_socket_id);
+        if (listen_socket) {
+            listen_socket->ready.push_back(connect_socket->first);
+            conn.listen_ready = true;
+        }
+    }
+}
+
+// unreliable messages are ready right away, reliable ones are released strictly in order
+void Steam_Networking_Sockets::receive_message(Connect_Socket &connect_socket, Networking_Sockets &message)
+{
+    connect_socket.received.bytes += static_cast<unsigned>(message.data().size());
+
+    uint64 number = message.reliable_number();
+    if (!number) {
+        connect_socket.data.emplace_back().Swap(&message);
+        return;
+    }
+
+    if (number < connect_socket.next_reliable_number) {
+        PRINT_DEBUG("dropping duplicate reliable message %llu", (unsigned long long)number);
+        return;
+    }
+
+    while (number >= connect_socket.next_reliable_number + RELIABLE_REORDER_WINDOW) {
+        // too far ahead to be buffered, give up on whatever is missing before it
+        if (!connect_socket.reorder_count) {
+            connect_socket.next_reliable_number = number - RELIABLE_REORDER_WINDOW + 1;
+            break;
+        }
+
+        skip_reliable_gap(connect_socket);
+    }
+
+    if (number == connect_socket.next_reliable_number) {
+        connect_socket.data.emplace_back().Swap(&message);
+        connect_socket.next_reliable_number += 1;
+    } else {
+        if (connect_socket.reorder_ring.empty()) connect_socket.reorder_ring.resize(RELIABLE_REORDER_WINDOW);
+        auto &slot = connect_socket.reorder_ring[number % RELIABLE_REORDER_WINDOW];
+        if (slot.reliable_number()) {
+            PRINT_DEBUG("dropping duplicate reliable message %llu", (unsigned long long)number);
+            return;
+        }
+
+        PRINT_DEBUG("reliable message %llu arrived before %llu", (unsigned long long)number, (unsigned long long)connect_socket.next_reliable_number);
+        if (!connect_socket.reorder_count) connect_socket.gap_since = std::chrono::steady_clock::now();
+        slot.Swap(&message);
+        connect_socket.reorder_count += 1;
+        return;
+    }
+
+    // release whatever was waiting on this one
+    while (connect_socket.reorder_count) {
+        auto &slot = connect_socket.reorder_ring[connect_socket.next_reliable_number % RELIABLE_REORDER_WINDOW];
+        if (!slot.reliable_number()) {
+            connect_socket.gap_since = std::chrono::steady_clock::now();
+            break;
+        }
+
+        connect_socket.data.emplace_back().Swap(&slot);
+        slot.Clear();
+        connect_socket.reorder_count -= 1;
+        connect_socket.next_reliable_number += 1;
+    }
+}
+
+// move past the missing reliable message(s) up to the next buffered one and release everything in order from there
+void Steam_Networking_Sockets::skip_reliable_gap(Connect_Socket &connect_socket)
+{
+    if (!connect_socket.reorder_count) return;
+
+    while (!connect_socket.reorder_ring[connect_socket.next_reliable_number % RELIABLE_REORDER_WINDOW].reliable_number()) {
+        connect_socket.next_reliable_number += 1;
+    }
+
+    PRINT_DEBUG("skipped a gap in reliable messages, resuming at %llu", (unsigned long long)connect_socket.next_reliable_number);
+    while (connect_socket.reorder_count) {
+        auto &slot = connect_socket.reorder_ring[connect_socket.next_reliable_number % RELIABLE_REORDER_WINDOW];
+        if (!slot.reliable_number()) break;
+
+        connect_socket.data.emplace_back().Swap(&slot);
+        slot.Clear();
+        connect_socket.reorder_count -= 1;
+        connect_socket.next_reliable_number += 1;
+    }
+
+    connect_socket.gap_since = std::chrono::steady_clock::now();
+}
+
+void Steam_Networking_Sockets::update_traffic_rates(Connect_Socket &connect_socket, std::chrono::steady_clock::time_point now)
+{
+    double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - connect_socket.traffic_window_start).count();
+    if (elapsed < 1.0) return;
+
+    connect_socket.out_packets_per_sec = static_cast<float>(connect_socket.sent.packets / elapsed);
+    connect_socket.out_bytes_per_sec = static_cast<float>(connect_socket.sent.bytes / elapsed);
+    connect_socket.in_packets_per_sec = static_cast<float>(connect_socket.received.packets / elapsed);
+    connect_socket.in_bytes_per_sec = static_cast<float>(connect_socket.received.bytes / elapsed);
+    connect_socket.sent = {};
+    connect_socket.received = {};
+    connect_socket.traffic_window_start = now;
+}
+
 shared_between_client_server* Steam_Networking_Sockets::get_shared_between_client_server()
 {
     return sbcs;
@@ -235,7 +519,9 @@ Steam_Networking_Sockets::Steam_Networking_Sockets(class Settings *settings, cla
     this->network->setCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Networking_Sockets::steam_callback, this);
     this->network->setCallback(CALLBACK_ID_NETWORKING_SOCKETS, settings->get_local_steam_id(), &Steam_Networking_Sockets::steam_callback, this);
     this->run_every_runcb->add(&Steam_Networking_Sockets::steam_run_every_runcb, this);
-
+    if (settings->nagle_time_us > 0) {
+        this->network->addFlushCallback(&Steam_Networking_Sockets::steam_network_flush, this);
+    }
 }
 
 Steam_Networking_Sockets::~Steam_Networking_Sockets()
@@ -243,6 +529,7 @@ Steam_Networking_Sockets::~Steam_Networking_Sockets()
     this->network->rmCallback(CALLBACK_ID_USER_STATUS, settings->get_local_steam_id(), &Steam_Networking_Sockets::steam_callback, this);
     this->network->rmCallback(CALLBACK_ID_NETWORKING_SOCKETS, settings->get_local_steam_id(), &Steam_Networking_Sockets::steam_callback, this);
     this->run_every_runcb->remove(&Steam_Networking_Sockets::steam_run_every_runcb, this);
+    this->network->rmFlushCallback(&Steam_Networking_Sockets::steam_network_flush, this);
 
     if (this->sbcs) {
         if (this->sbcs->used) {
@@ -280,7 +567,8 @@ Steam_Networking_Sockets::~Steam_Networking_Sockets()
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocket( int nSteamConnectVirtualPort, uint32 nIP, uint16 nPort )
 {
     PRINT_DEBUG("%i %u %u", nSteamConnectVirtualPort, nIP, nPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(nSteamConnectVirtualPort, nPort);
 }
 
@@ -301,21 +589,24 @@ HSteamListenSocket Steam_Networking_Sockets::CreateListenSocket( int nSteamConne
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketIP( const SteamNetworkingIPAddr &localAddress )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(SNS_DISABLED_PORT, localAddress.m_port);
 }
 
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketIP( const SteamNetworkingIPAddr *localAddress )
 {
     PRINT_DEBUG("old1");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(SNS_DISABLED_PORT, localAddress->m_port);
 }
 
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketIP( const SteamNetworkingIPAddr &localAddress, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(SNS_DISABLED_PORT, localAddress.m_port);
 }
 
@@ -340,7 +631,8 @@ HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketIP( const SteamNe
 HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNetworkingIPAddr &address )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     SteamNetworkingIdentity ip_id;
     ip_id.SetIPAddr(address);
     HSteamNetConnection socket = new_connect_socket(ip_id, SNS_DISABLED_PORT, address.m_port);
@@ -351,7 +643,8 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNet
 HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNetworkingIPAddr *address )
 {
     PRINT_DEBUG("old1");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     SteamNetworkingIdentity ip_id;
     ip_id.SetIPAddr(*address);
     HSteamNetConnection socket = new_connect_socket(ip_id, SNS_DISABLED_PORT, address->m_port);
@@ -362,7 +655,8 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNet
 HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNetworkingIPAddr &address, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG("%X", address.GetIPv4());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     SteamNetworkingIdentity ip_id;
     ip_id.SetIPAddr(address);
     HSteamNetConnection socket = new_connect_socket(ip_id, SNS_DISABLED_PORT, address.m_port);
@@ -383,7 +677,8 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectByIPAddress( const SteamNet
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketP2P( int nVirtualPort )
 {
     PRINT_DEBUG("old %i", nVirtualPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(nVirtualPort, SNS_DISABLED_PORT);
 }
 
@@ -391,7 +686,8 @@ HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketP2P( int nVirtual
 {
     PRINT_DEBUG("%i", nVirtualPort);
     //TODO config options
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(nVirtualPort, SNS_DISABLED_PORT);
 }
 
@@ -409,7 +705,8 @@ HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketP2P( int nVirtual
 HSteamNetConnection Steam_Networking_Sockets::ConnectP2P( const SteamNetworkingIdentity &identityRemote, int nVirtualPort )
 {
     PRINT_DEBUG("old %i", nVirtualPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     const SteamNetworkingIPAddr *ip = identityRemote.GetIPAddr();
 
@@ -453,7 +750,7 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectP2P( const SteamNetworkingI
 HSteamNetConnection Steam_Networking_Sockets::ConnectBySteamID( CSteamID steamIDTarget, int nVirtualPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamNetConnection_Invalid;
 }
 
@@ -461,7 +758,7 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectBySteamID( CSteamID steamID
 HSteamNetConnection Steam_Networking_Sockets::ConnectByIPv4Address( uint32 nIP, uint16 nPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamNetConnection_Invalid;
 }
 
@@ -502,7 +799,8 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectByIPv4Address( uint32 nIP,
 EResult Steam_Networking_Sockets::AcceptConnection( HSteamNetConnection hConn )
 {
     PRINT_DEBUG("%u", hConn);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) return k_EResultInvalidParam;
@@ -539,12 +837,16 @@ EResult Steam_Networking_Sockets::AcceptConnection( HSteamNetConnection hConn )
 bool Steam_Networking_Sockets::CloseConnection( HSteamNetConnection hPeer, int nReason, const char *pszDebug, bool bEnableLinger )
 {
     PRINT_DEBUG("%u", hPeer);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     auto connect_socket = sbcs->connect_sockets.find(hPeer);
     if (connect_socket == sbcs->connect_sockets.end()) return false;
 
     if (connect_socket->second.status != CONNECT_SOCKET_CLOSED && connect_socket->second.status != CONNECT_SOCKET_TIMEDOUT) {
+        // whatever the Nagle timer is still holding was already accepted by SendMessageToConnection()
+        flush_send_queue(connect_socket);
+
         //TODO send/nReason and pszDebug
         Common_Message msg;
         msg.set_source_id(connect_socket->second.created_by.ConvertToUint64());
@@ -575,7 +877,7 @@ bool Steam_Networking_Sockets::CloseConnection( HSteamNetConnection hPeer, int n
 bool Steam_Networking_Sockets::CloseListenSocket( HSteamListenSocket hSocket, const char *pszNotifyRemoteReason )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -584,7 +886,8 @@ bool Steam_Networking_Sockets::CloseListenSocket( HSteamListenSocket hSocket, co
 bool Steam_Networking_Sockets::CloseListenSocket( HSteamListenSocket hSocket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     auto conn = std::find_if(sbcs->listen_sockets.begin(), sbcs->listen_sockets.end(), [&hSocket](struct Listen_Socket const& conn) { return conn.socket_id == hSocket;});
     if (conn == sbcs->listen_sockets.end()) return false;
@@ -613,7 +916,8 @@ bool Steam_Networking_Sockets::CloseListenSocket( HSteamListenSocket hSocket )
 bool Steam_Networking_Sockets::SetConnectionUserData( HSteamNetConnection hPeer, int64 nUserData )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto connect_socket = sbcs->connect_sockets.find(hPeer);
     if (connect_socket == sbcs->connect_sockets.end()) return false;
     connect_socket->second.user_data = nUserData;
@@ -626,7 +930,8 @@ bool Steam_Networking_Sockets::SetConnectionUserData( HSteamNetConnection hPeer,
 int64 Steam_Networking_Sockets::GetConnectionUserData( HSteamNetConnection hPeer )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto connect_socket = sbcs->connect_sockets.find(hPeer);
     if (connect_socket == sbcs->connect_sockets.end()) return -1;
     return connect_socket->second.user_data;
@@ -637,7 +942,7 @@ int64 Steam_Networking_Sockets::GetConnectionUserData( HSteamNetConnection hPeer
 void Steam_Networking_Sockets::SetConnectionName( HSteamNetConnection hPeer, const char *pszName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -645,7 +950,7 @@ void Steam_Networking_Sockets::SetConnectionName( HSteamNetConnection hPeer, con
 bool Steam_Networking_Sockets::GetConnectionName( HSteamNetConnection hPeer, char *pszName, int nMaxLen )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -677,7 +982,7 @@ bool Steam_Networking_Sockets::GetConnectionName( HSteamNetConnection hPeer, cha
 EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection hConn, const void *pData, uint32 cbData, ESteamNetworkingSendType eSendType )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EResultFail;
 }
 
@@ -721,7 +1026,8 @@ EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection h
 EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection hConn, const void *pData, uint32 cbData, int nSendFlags, int64 *pOutMessageNumber )
 {
     PRINT_DEBUG("%u, len %u, flags %i", hConn, cbData, nSendFlags);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    // no global_mutex, sending must not wait for the callbacks to finish
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) return k_EResultInvalidParam;
@@ -729,6 +1035,49 @@ EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection h
     if (connect_socket->second.status == CONNECT_SOCKET_TIMEDOUT) return k_EResultNoConnection;
     if (connect_socket->second.status != CONNECT_SOCKET_CONNECTED && connect_socket->second.status != CONNECT_SOCKET_CONNECTING) return k_EResultInvalidState;
 
+    uint64 message_number = connect_socket->second.packet_send_counter;
+    connect_socket->second.packet_send_counter += 1;
+
+    bool reliable = false;
+    if (nSendFlags & k_nSteamNetworkingSend_Reliable) reliable = true;
+
+    auto &conn = connect_socket->second;
+    uint64 reliable_number = 0;
+    if (reliable) {
+        conn.reliable_send_counter += 1;
+        reliable_number = conn.reliable_send_counter;
+    }
+
+    bool send_now = (nSendFlags & (k_nSteamNetworkingSend_NoNagle | k_nSteamNetworkingSend_NoDelay)) || settings->nagle_time_us <= 0 || cbData >= NAGLE_BATCH_MTU;
+    // keep the order of what is already queued, either by sending it first or by sending it together with this message
+    bool queue_stuck = false;
+    if (conn.send_queue.size() && (send_now || conn.send_queue_size + cbData > NAGLE_BATCH_MTU)) {
+        queue_stuck = !flush_send_queue(connect_socket);
+    }
+
+    if (queue_stuck && (send_now || conn.send_queue_size + cbData > SEND_QUEUE_MAX_SIZE)) {
+        // it can't go out ahead of the queue, and the queue can't go out yet
+        if (reliable) conn.reliable_send_counter -= 1;
+        return send_now ? k_EResultFail : k_EResultLimitExceeded;
+    }
+
+    if (!send_now) {
+        if (conn.send_queue.empty()) {
+            conn.send_queue_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(settings->nagle_time_us);
+            network->scheduleFlush(conn.send_queue_deadline);
+        }
+
+        Networking_Sockets &entry = conn.send_queue.emplace_back();
+        entry.set_data(pData, cbData);
+        entry.set_message_number(message_number);
+        entry.set_reliable_number(reliable_number);
+        conn.send_queue_size += cbData;
+        if (reliable) conn.send_queue_reliable_size += cbData;
+        conn.send_queue_reliable = conn.send_queue_reliable || reliable;
+        if (pOutMessageNumber) *pOutMessageNumber = message_number;
+        return k_EResultOK;
+    }
+
     Common_Message msg;
     msg.set_source_id(connect_socket->second.created_by.ConvertToUint64());
     msg.set_dest_id(connect_socket->second.remote_identity.GetSteamID64());
@@ -739,17 +1088,18 @@ EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection h
     msg.mutable_networking_sockets()->set_connection_id_from(connect_socket->first);
     msg.mutable_networking_sockets()->set_connection_id(connect_socket->second.remote_id);
     msg.mutable_networking_sockets()->set_data(pData, cbData);
-    uint64 message_number = connect_socket->second.packet_send_counter;
     msg.mutable_networking_sockets()->set_message_number(message_number);
-    connect_socket->second.packet_send_counter += 1;
+    msg.mutable_networking_sockets()->set_reliable_number(reliable_number);
 
-    bool reliable = false;
-    if (nSendFlags & k_nSteamNetworkingSend_Reliable) reliable = true;
     if (network->sendTo(&msg, reliable)) {
+        conn.sent.packets += 1;
+        conn.sent.bytes += cbData;
         if (pOutMessageNumber) *pOutMessageNumber = message_number;
         return k_EResultOK;
     }
 
+    // the peer never sees this number, handing it to the next message keeps its reorder ring from waiting for it
+    if (reliable) conn.reliable_send_counter -= 1;
     return k_EResultFail;
 }
 
@@ -794,7 +1144,7 @@ EResult Steam_Networking_Sockets::SendMessageToConnection( HSteamNetConnection h
 void Steam_Networking_Sockets::SendMessages( int nMessages, SteamNetworkingMessage_t *const *pMessages, int64 *pOutMessageNumberOrResult )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     for (int i = 0; i < nMessages; ++i) {
         int64 out_number = 0;
         int result = SendMessageToConnection(pMessages[i]->m_conn, pMessages[i]->m_pData, pMessages[i]->m_cbSize, pMessages[i]->m_nFlags, &out_number);
@@ -820,8 +1170,15 @@ void Steam_Networking_Sockets::SendMessages( int nMessages, SteamNetworkingMessa
 /// on the next transmission time (often that means right now).
 EResult Steam_Networking_Sockets::FlushMessagesOnConnection( HSteamNetConnection hConn )
 {
-    PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    PRINT_DEBUG("%u", hConn);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
+
+    auto connect_socket = sbcs->connect_sockets.find(hConn);
+    if (connect_socket == sbcs->connect_sockets.end()) return k_EResultInvalidParam;
+    if (connect_socket->second.status == CONNECT_SOCKET_CLOSED) return k_EResultNoConnection;
+    if (connect_socket->second.status == CONNECT_SOCKET_TIMEDOUT) return k_EResultNoConnection;
+
+    if (!flush_send_queue(connect_socket)) return k_EResultFail;
     return k_EResultOK;
 }
 
@@ -843,7 +1200,8 @@ EResult Steam_Networking_Sockets::FlushMessagesOnConnection( HSteamNetConnection
 int Steam_Networking_Sockets::ReceiveMessagesOnConnection( HSteamNetConnection hConn, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG("%u %i", hConn, nMaxMessages);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     if (!ppOutMessages || !nMaxMessages) return 0;
 
     SteamNetworkingMessage_t *msg = NULL;
@@ -868,22 +1226,30 @@ int Steam_Networking_Sockets::ReceiveMessagesOnConnection( HSteamNetConnection h
 int Steam_Networking_Sockets::ReceiveMessagesOnListenSocket( HSteamListenSocket hSocket, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG("%u %i", hSocket, nMaxMessages);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     if (!ppOutMessages || !nMaxMessages) return 0;
 
+    struct Listen_Socket *listen_socket = get_connection_socket(hSocket);
+    if (!listen_socket) return 0;
+
     SteamNetworkingMessage_t *msg = NULL;
     int messages = 0;
 
-    auto socket_conn = std::begin(sbcs->connect_sockets);
-    while (socket_conn != std::end(sbcs->connect_sockets) && messages < nMaxMessages) {
-        if (socket_conn->second.listen_socket_id == hSocket) {
-            while (messages < nMaxMessages && (msg = get_steam_message_connection(socket_conn->first))) {
-                ppOutMessages[messages] = msg;
-                ++messages;
-            }
+    // one message per ready connection per turn so a busy client can't starve the others
+    while (messages < nMaxMessages && listen_socket->ready.size()) {
+        HSteamNetConnection c = listen_socket->ready.front();
+        listen_socket->ready.pop_front();
+        auto connect_socket = sbcs->connect_sockets.find(c);
+        if (connect_socket == sbcs->connect_sockets.end() || connect_socket->second.listen_socket_id != hSocket) continue;
+
+        connect_socket->second.listen_ready = false;
+        if ((msg = get_steam_message_connection(c))) {
+            ppOutMessages[messages] = msg;
+            ++messages;
         }
 
-        ++socket_conn;
+        mark_ready(connect_socket);
     }
 
     return messages;
@@ -893,7 +1259,8 @@ int Steam_Networking_Sockets::ReceiveMessagesOnListenSocket( HSteamListenSocket
 bool Steam_Networking_Sockets::GetConnectionInfo( HSteamNetConnection hConn, SteamNetConnectionInfo_t *pInfo )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     if (!pInfo) return false;
 
     auto connect_socket = sbcs->connect_sockets.find(hConn);
@@ -924,7 +1291,8 @@ bool Steam_Networking_Sockets::GetConnectionInfo( HSteamNetConnection hConn, Ste
 EResult Steam_Networking_Sockets::GetConnectionRealTimeStatus( HSteamNetConnection hConn, SteamNetConnectionRealTimeStatus_t *pStatus, int nLanes, SteamNetConnectionRealTimeLaneStatus_t *pLanes )
 {
     PRINT_DEBUG("%s %u %p %i %p", __FUNCTION__, hConn, pStatus, nLanes, pLanes);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) return k_EResultNoConnection;
 
@@ -933,13 +1301,23 @@ EResult Steam_Networking_Sockets::GetConnectionRealTimeStatus( HSteamNetConnecti
         pStatus->m_nPing = 10; //TODO: calculate real numbers?
         pStatus->m_flConnectionQualityLocal = 1.0;
         pStatus->m_flConnectionQualityRemote = 1.0;
-        //TODO: rest
-        pStatus->m_flOutPacketsPerSec = 0.0;
-        pStatus->m_flOutBytesPerSec = 0.0;
-        pStatus->m_flInPacketsPerSec = 0.0;
-        pStatus->m_flInBytesPerSec = 0.0;
+        auto &conn = connect_socket->second;
+        pStatus->m_flOutPacketsPerSec = conn.out_packets_per_sec;
+        pStatus->m_flOutBytesPerSec = conn.out_bytes_per_sec;
+        pStatus->m_flInPacketsPerSec = conn.in_packets_per_sec;
+        pStatus->m_flInBytesPerSec = conn.in_bytes_per_sec;
+        //TODO: m_nSendRateBytesPerSecond
+        // only the Nagle queue holds data back, once it's handed to the network it's considered acked
+        pStatus->m_cbPendingReliable = static_cast<int>(conn.send_queue_reliable_size);
+        pStatus->m_cbPendingUnreliable = static_cast<int>(conn.send_queue_size - conn.send_queue_reliable_size);
         pStatus->m_cbSentUnackedReliable = 0;
         pStatus->m_usecQueueTime = 0;
+        if (conn.send_queue.size()) {
+            auto now = std::chrono::steady_clock::now();
+            if (conn.send_queue_deadline > now) {
+                pStatus->m_usecQueueTime = std::chrono::duration_cast<std::chrono::microseconds>(conn.send_queue_deadline - now).count();
+            }
+        }
 
         //Note some games (volcanoids) might not allocate a struct the whole size of SteamNetworkingQuickConnectionStatus
         //keep this in mind in future interface updates
@@ -969,7 +1347,7 @@ EResult Steam_Networking_Sockets::GetConnectionRealTimeStatus( HSteamNetConnecti
 int Steam_Networking_Sockets::ReceiveMessagesOnConnection( HSteamNetConnection hConn, SteamNetworkingMessage001_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
  
@@ -985,7 +1363,7 @@ int Steam_Networking_Sockets::ReceiveMessagesOnConnection( HSteamNetConnection h
 int Steam_Networking_Sockets::ReceiveMessagesOnListenSocket( HSteamListenSocket hSocket, SteamNetworkingMessage001_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
  
@@ -994,7 +1372,7 @@ int Steam_Networking_Sockets::ReceiveMessagesOnListenSocket( HSteamListenSocket
 bool Steam_Networking_Sockets::GetConnectionInfo( HSteamNetConnection hConn, SteamNetConnectionInfo001_t *pInfo )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1021,7 +1399,7 @@ bool Steam_Networking_Sockets::GetQuickConnectionStatus( HSteamNetConnection hCo
 int Steam_Networking_Sockets::GetDetailedConnectionStatus( HSteamNetConnection hConn, char *pszBuf, int cbBuf )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
 
@@ -1032,7 +1410,7 @@ int Steam_Networking_Sockets::GetDetailedConnectionStatus( HSteamNetConnection h
 bool Steam_Networking_Sockets::GetListenSocketAddress( HSteamListenSocket hSocket, SteamNetworkingIPAddr *address )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1046,7 +1424,8 @@ bool Steam_Networking_Sockets::GetListenSocketAddress( HSteamListenSocket hSocke
 bool Steam_Networking_Sockets::GetListenSocketInfo( HSteamListenSocket hSocket, uint32 *pnIP, uint16 *pnPort )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     struct Listen_Socket *socket = get_connection_socket(hSocket);
     if (!socket) return false;
     if (pnIP) *pnIP = 0;//socket->ip;
@@ -1101,7 +1480,8 @@ bool Steam_Networking_Sockets::CreateSocketPair( HSteamNetConnection *pOutConnec
 bool Steam_Networking_Sockets::CreateSocketPair( HSteamNetConnection *pOutConnection1, HSteamNetConnection *pOutConnection2, bool bUseNetworkLoopback, const SteamNetworkingIdentity *pIdentity1, const SteamNetworkingIdentity *pIdentity2 )
 {
     PRINT_DEBUG("%u %p %p", bUseNetworkLoopback, pIdentity1, pIdentity2);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     if (!pOutConnection1 || !pOutConnection1) return false;
 
     SteamNetworkingIdentity remote_identity;
@@ -1185,7 +1565,8 @@ bool Steam_Networking_Sockets::CreateSocketPair( HSteamNetConnection *pOutConnec
 EResult Steam_Networking_Sockets::ConfigureConnectionLanes( HSteamNetConnection hConn, int nNumLanes, const int *pLanePriorities, const uint16 *pLaneWeights )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) return k_EResultNoConnection;
     //TODO
@@ -1201,7 +1582,7 @@ EResult Steam_Networking_Sockets::ConfigureConnectionLanes( HSteamNetConnection
 bool Steam_Networking_Sockets::GetIdentity( SteamNetworkingIdentity *pIdentity )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pIdentity) return false;
     pIdentity->SetSteamID(settings->get_local_steam_id());
     return true;
@@ -1233,7 +1614,7 @@ bool Steam_Networking_Sockets::GetIdentity( SteamNetworkingIdentity *pIdentity )
 ESteamNetworkingAvailability Steam_Networking_Sockets::InitAuthentication()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingAvailability_Current;
 }
 
@@ -1247,7 +1628,7 @@ ESteamNetworkingAvailability Steam_Networking_Sockets::InitAuthentication()
 ESteamNetworkingAvailability Steam_Networking_Sockets::GetAuthenticationStatus( SteamNetAuthenticationStatus_t *pDetails )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingAvailability_Current;
 }
 
@@ -1257,12 +1638,13 @@ ESteamNetworkingAvailability Steam_Networking_Sockets::GetAuthenticationStatus(
 HSteamNetPollGroup Steam_Networking_Sockets::CreatePollGroup()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     static HSteamNetPollGroup poll_group_counter;
     ++poll_group_counter;
 
     HSteamNetPollGroup poll_group_number = poll_group_counter;
-    sbcs->poll_groups[poll_group_number] = std::list<HSteamNetConnection>();
+    sbcs->poll_groups[poll_group_number] = Poll_Group();
     return poll_group_number;
 }
 
@@ -1274,16 +1656,18 @@ HSteamNetPollGroup Steam_Networking_Sockets::CreatePollGroup()
 bool Steam_Networking_Sockets::DestroyPollGroup( HSteamNetPollGroup hPollGroup )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto group = sbcs->poll_groups.find(hPollGroup);
     if (group == sbcs->poll_groups.end()) {
         return false;
     }
 
-    for (auto c : group->second) {
+    for (auto c : group->second.connections) {
         auto connect_socket = sbcs->connect_sockets.find(c);
         if (connect_socket != sbcs->connect_sockets.end()) {
             connect_socket->second.poll_group = k_HSteamNetPollGroup_Invalid;
+            connect_socket->second.poll_ready = false;
         }
     }
 
@@ -1308,7 +1692,8 @@ bool Steam_Networking_Sockets::DestroyPollGroup( HSteamNetPollGroup hPollGroup )
 bool Steam_Networking_Sockets::SetConnectionPollGroup( HSteamNetConnection hConn, HSteamNetPollGroup hPollGroup )
 {
     PRINT_DEBUG("%u %u", hConn, hPollGroup);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto connect_socket = sbcs->connect_sockets.find(hConn);
     if (connect_socket == sbcs->connect_sockets.end()) {
         return false;
@@ -1321,18 +1706,25 @@ bool Steam_Networking_Sockets::SetConnectionPollGroup( HSteamNetConnection hConn
 
     HSteamNetPollGroup old_poll_group = connect_socket->second.poll_group;
     if (old_poll_group != k_HSteamNetPollGroup_Invalid) {
-        auto group = sbcs->poll_groups.find(hPollGroup);
-        if (group != sbcs->poll_groups.end()) {
-            group->second.remove(hConn);
+        auto old_group = sbcs->poll_groups.find(old_poll_group);
+        if (old_group != sbcs->poll_groups.end()) {
+            old_group->second.connections.remove(hConn);
+            // drop its ready entry too, otherwise moving it away and back would queue it twice in that group
+            if (connect_socket->second.poll_ready) {
+                auto &ready = old_group->second.ready;
+                ready.erase(std::remove(ready.begin(), ready.end(), hConn), ready.end());
+            }
         }
     }
 
     connect_socket->second.poll_group = hPollGroup;
+    connect_socket->second.poll_ready = false;
     if (hPollGroup == k_HSteamNetPollGroup_Invalid) {
         return true;
     }
 
-    group->second.push_back(hConn);
+    group->second.connections.push_back(hConn);
+    mark_ready(connect_socket);
     return true;
 }
 
@@ -1354,7 +1746,8 @@ bool Steam_Networking_Sockets::SetConnectionPollGroup( HSteamNetConnection hConn
 int Steam_Networking_Sockets::ReceiveMessagesOnPollGroup( HSteamNetPollGroup hPollGroup, SteamNetworkingMessage_t **ppOutMessages, int nMaxMessages )
 {
     PRINT_DEBUG("%u %i", hPollGroup, nMaxMessages);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     auto group = sbcs->poll_groups.find(hPollGroup);
     if (group == sbcs->poll_groups.end()) {
         return 0;
@@ -1363,11 +1756,21 @@ int Steam_Networking_Sockets::ReceiveMessagesOnPollGroup( HSteamNetPollGroup hPo
     SteamNetworkingMessage_t *msg = NULL;
     int messages = 0;
 
-    for (auto c : group->second) {
-        while (messages < nMaxMessages && (msg = get_steam_message_connection(c))) {
+    // one message per ready connection per turn so a busy client can't starve the others
+    auto &ready = group->second.ready;
+    while (messages < nMaxMessages && ready.size()) {
+        HSteamNetConnection c = ready.front();
+        ready.pop_front();
+        auto connect_socket = sbcs->connect_sockets.find(c);
+        if (connect_socket == sbcs->connect_sockets.end() || connect_socket->second.poll_group != hPollGroup) continue;
+
+        connect_socket->second.poll_ready = false;
+        if ((msg = get_steam_message_connection(c))) {
             ppOutMessages[messages] = msg;
             ++messages;
         }
+
+        mark_ready(connect_socket);
     }
 
     PRINT_DEBUG("out %i", messages);
@@ -1389,7 +1792,7 @@ int Steam_Networking_Sockets::ReceiveMessagesOnPollGroup( HSteamNetPollGroup hPo
 bool Steam_Networking_Sockets::ReceivedRelayAuthTicket( const void *pvTicket, int cbTicket, SteamDatagramRelayAuthTicket *pOutParsedTicket )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1421,7 +1824,7 @@ int Steam_Networking_Sockets::FindRelayAuthTicketForServer( const SteamNetworkin
 int Steam_Networking_Sockets::FindRelayAuthTicketForServer( const SteamNetworkingIdentity &identityGameServer, int nVirtualPort, SteamDatagramRelayAuthTicket *pOutParsedTicket )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1437,14 +1840,14 @@ int Steam_Networking_Sockets::FindRelayAuthTicketForServer( const SteamNetworkin
 HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( const SteamNetworkingIdentity &identityTarget, int nVirtualPort )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamListenSocket_Invalid;
 }
 
 HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( const SteamNetworkingIdentity *identityTarget, int nVirtualPort )
 {
     PRINT_DEBUG("old1");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamListenSocket_Invalid;
 }
 
@@ -1457,14 +1860,14 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( co
 HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( CSteamID steamIDTarget, int nVirtualPort )
 {
     PRINT_DEBUG("older");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamListenSocket_Invalid;
 }
 
 HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( const SteamNetworkingIdentity &identityTarget, int nVirtualPort, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamListenSocket_Invalid;
 }
 
@@ -1476,7 +1879,7 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectToHostedDedicatedServer( co
 uint16 Steam_Networking_Sockets::GetHostedDedicatedServerPort()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO?
     return 27054;
 }
@@ -1487,7 +1890,7 @@ uint16 Steam_Networking_Sockets::GetHostedDedicatedServerPort()
 SteamNetworkingPOPID Steam_Networking_Sockets::GetHostedDedicatedServerPOPID()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1545,7 +1948,7 @@ bool Steam_Networking_Sockets::GetHostedDedicatedServerAddress001( SteamDatagram
 EResult Steam_Networking_Sockets::GetHostedDedicatedServerAddress( SteamDatagramHostedAddress *pRouting )
 {
     PRINT_DEBUG("%p", pRouting);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     pRouting->SetDevAddress(network->getOwnIP(), 27054);
     return k_EResultOK;
 }
@@ -1558,7 +1961,8 @@ EResult Steam_Networking_Sockets::GetHostedDedicatedServerAddress( SteamDatagram
 HSteamListenSocket Steam_Networking_Sockets::CreateHostedDedicatedServerListenSocket( int nVirtualPort )
 {
     PRINT_DEBUG("old %i", nVirtualPort);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(nVirtualPort, SNS_DISABLED_PORT);
 }
 
@@ -1575,7 +1979,8 @@ HSteamListenSocket Steam_Networking_Sockets::CreateHostedDedicatedServerListenSo
 {
     PRINT_DEBUG("old %i", nVirtualPort);
     //TODO config options
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
     return new_listen_socket(nVirtualPort, SNS_DISABLED_PORT);
 }
 
@@ -1588,7 +1993,7 @@ HSteamListenSocket Steam_Networking_Sockets::CreateHostedDedicatedServerListenSo
 bool Steam_Networking_Sockets::GetConnectionDebugText( HSteamNetConnection hConn, char *pOut, int nOutCCH )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1600,7 +2005,7 @@ bool Steam_Networking_Sockets::GetConnectionDebugText( HSteamNetConnection hConn
 int32 Steam_Networking_Sockets::GetConfigurationValue( ESteamNetworkingConfigurationValue eConfigValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
 
@@ -1608,7 +2013,7 @@ int32 Steam_Networking_Sockets::GetConfigurationValue( ESteamNetworkingConfigura
 bool Steam_Networking_Sockets::SetConfigurationValue( ESteamNetworkingConfigurationValue eConfigValue, int32 nValue )
 {
     PRINT_DEBUG("%i: %i", eConfigValue, nValue);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -1617,7 +2022,7 @@ bool Steam_Networking_Sockets::SetConfigurationValue( ESteamNetworkingConfigurat
 const char* Steam_Networking_Sockets::GetConfigurationValueName( ESteamNetworkingConfigurationValue eConfigValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -1630,14 +2035,14 @@ const char* Steam_Networking_Sockets::GetConfigurationValueName( ESteamNetworkin
 int32 Steam_Networking_Sockets::GetConfigurationString( ESteamNetworkingConfigurationString eConfigString, char *pDest, int32 destSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
 
 bool Steam_Networking_Sockets::SetConfigurationString( ESteamNetworkingConfigurationString eConfigString, const char *pString )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1646,7 +2051,7 @@ bool Steam_Networking_Sockets::SetConfigurationString( ESteamNetworkingConfigura
 const char* Steam_Networking_Sockets::GetConfigurationStringName( ESteamNetworkingConfigurationString eConfigString )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -1658,7 +2063,7 @@ const char* Steam_Networking_Sockets::GetConfigurationStringName( ESteamNetworki
 int32 Steam_Networking_Sockets::GetConnectionConfigurationValue( HSteamNetConnection hConn, ESteamNetworkingConnectionConfigurationValue eConfigValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return -1;
 }
 
@@ -1666,7 +2071,7 @@ int32 Steam_Networking_Sockets::GetConnectionConfigurationValue( HSteamNetConnec
 bool Steam_Networking_Sockets::SetConnectionConfigurationValue( HSteamNetConnection hConn, ESteamNetworkingConnectionConfigurationValue eConfigValue, int32 nValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1703,7 +2108,7 @@ bool Steam_Networking_Sockets::SetConnectionConfigurationValue( HSteamNetConnect
 EResult Steam_Networking_Sockets::GetGameCoordinatorServerLogin( SteamDatagramGameCoordinatorServerLogin *pLoginInfo, int *pcbSignedBlob, void *pBlob )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EResultFail;
 }
 
@@ -1750,7 +2155,7 @@ EResult Steam_Networking_Sockets::GetGameCoordinatorServerLogin( SteamDatagramGa
 HSteamNetConnection Steam_Networking_Sockets::ConnectP2PCustomSignaling( ISteamNetworkingConnectionCustomSignaling *pSignaling, const SteamNetworkingIdentity *pPeerIdentity, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //return ConnectP2PCustomSignaling(pSignaling, pPeerIdentity, 0, nOptions, pOptions);
     return k_HSteamNetConnection_Invalid;
 }
@@ -1759,7 +2164,7 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectP2PCustomSignaling( ISteamN
 HSteamNetConnection Steam_Networking_Sockets::ConnectP2PCustomSignaling( ISteamNetworkingConnectionSignaling *pSignaling, const SteamNetworkingIdentity *pPeerIdentity, int nRemoteVirtualPort, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamNetConnection_Invalid;
 }
 
@@ -1795,14 +2200,14 @@ HSteamNetConnection Steam_Networking_Sockets::ConnectP2PCustomSignaling( ISteamN
 bool Steam_Networking_Sockets::ReceivedP2PCustomSignal( const void *pMsg, int cbMsg, ISteamNetworkingCustomSignalingRecvContext *pContext )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Networking_Sockets::ReceivedP2PCustomSignal( const void *pMsg, int cbMsg, ISteamNetworkingSignalingRecvContext *pContext )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1820,7 +2225,7 @@ bool Steam_Networking_Sockets::ReceivedP2PCustomSignal( const void *pMsg, int cb
 bool Steam_Networking_Sockets::GetCertificateRequest( int *pcbBlob, void *pBlob, SteamNetworkingErrMsg &errMsg )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1829,7 +2234,7 @@ bool Steam_Networking_Sockets::GetCertificateRequest( int *pcbBlob, void *pBlob,
 bool Steam_Networking_Sockets::SetCertificate( const void *pCertificate, int cbCertificate, SteamNetworkingErrMsg &errMsg )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1844,7 +2249,7 @@ bool Steam_Networking_Sockets::SetCertificate( const void *pCertificate, int cbC
 void Steam_Networking_Sockets::ResetIdentity( const SteamNetworkingIdentity *pIdentity )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 //
@@ -1910,7 +2315,7 @@ void Steam_Networking_Sockets::ResetIdentity( const SteamNetworkingIdentity *pId
 bool Steam_Networking_Sockets::BeginAsyncRequestFakeIP( int nNumPorts )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1920,7 +2325,7 @@ bool Steam_Networking_Sockets::BeginAsyncRequestFakeIP( int nNumPorts )
 void Steam_Networking_Sockets::GetFakeIP( int idxFirstPort, SteamNetworkingFakeIPResult_t *pInfo )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 /// Create a listen socket that will listen for P2P connections sent
@@ -1935,7 +2340,7 @@ void Steam_Networking_Sockets::GetFakeIP( int idxFirstPort, SteamNetworkingFakeI
 HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketP2PFakeIP( int idxFakePort, int nOptions, const SteamNetworkingConfigValue_t *pOptions )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_HSteamListenSocket_Invalid;
 }
 
@@ -1957,7 +2362,7 @@ HSteamListenSocket Steam_Networking_Sockets::CreateListenSocketP2PFakeIP( int id
 EResult Steam_Networking_Sockets::GetRemoteFakeIPForConnection( HSteamNetConnection hConn, SteamNetworkingIPAddr *pOutAddr )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EResultNone;
 }
 
@@ -1981,7 +2386,7 @@ EResult Steam_Networking_Sockets::GetRemoteFakeIPForConnection( HSteamNetConnect
 ISteamNetworkingFakeUDPPort* Steam_Networking_Sockets::CreateFakeUDPPort( int idxFakeServerPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -1998,6 +2403,7 @@ void Steam_Networking_Sockets::RunCallbacks( ISteamNetworkingSocketsCallbacks *p
 void Steam_Networking_Sockets::RunCallbacks()
 {
     // PRINT_DEBUG_ENTRY();
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     //TODO: timeout unaccepted connections after a few seconds or so
     auto current_time = std::chrono::steady_clock::now();
@@ -2009,6 +2415,14 @@ void Steam_Networking_Sockets::RunCallbacks()
             socket_conn->second.connect_requests_sent += 1;
         }
 
+        if (socket_conn->second.reorder_count && (std::chrono::duration_cast<std::chrono::duration<double>>(current_time - socket_conn->second.gap_since).count() > RELIABLE_GAP_TIMEOUT)) {
+            skip_reliable_gap(socket_conn->second);
+            // the released messages didn't come with a packet, so nothing else queues the connection for them
+            mark_ready(socket_conn);
+        }
+
+        update_traffic_rates(socket_conn->second, current_time);
+
         ++socket_conn;
     }
 }
@@ -2017,6 +2431,7 @@ void Steam_Networking_Sockets::RunCallbacks()
 void Steam_Networking_Sockets::Callback(Common_Message *msg)
 {
     // PRINT_DEBUG_ENTRY();
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
 
     if (msg->has_low_level()) {
         if (msg->low_level().type() == Low_Level::CONNECT) {
@@ -2070,18 +2485,18 @@ void Steam_Networking_Sockets::Callback(Common_Message *msg)
                     launch_callback(connect_socket->first, CONNECT_SOCKET_CONNECTING);
                 }
             }
-        } else if (msg->networking_sockets().type() == Networking_Sockets::DATA) {
+        } else if (msg->networking_sockets().type() == Networking_Sockets::DATA || msg->networking_sockets().type() == Networking_Sockets::DATA_BATCH) {
             auto connect_socket = sbcs->connect_sockets.find(static_cast<HSteamNetConnection>(msg->networking_sockets().connection_id()));
             if (connect_socket != sbcs->connect_sockets.end()) {
                 if (connect_socket->second.remote_identity.GetSteamID64() == msg->source_id() && (connect_socket->second.status == CONNECT_SOCKET_CONNECTED)) {
-                    PRINT_DEBUG("got data len %zu, num " "%" PRIu64 " on connection %u", msg->networking_sockets().data().size(), msg->networking_sockets().message_number(), connect_socket->first);
-                    connect_socket->second.data.push(msg->networking_sockets());
+                    PRINT_DEBUG("got data len %zu, num " "%" PRIu64 ", batched %i on connection %u", msg->networking_sockets().data().size(), msg->networking_sockets().message_number(), msg->networking_sockets().batch_size(), connect_socket->first);
+                    push_received_data(connect_socket, *msg->mutable_networking_sockets());
                 }
             } else {
                 connect_socket = std::find_if(sbcs->connect_sockets.begin(), sbcs->connect_sockets.end(), [msg](const auto &in) {return in.second.remote_identity.GetSteamID64() == msg->source_id() && (in.second.status == CONNECT_SOCKET_NOT_ACCEPTED || in.second.status == CONNECT_SOCKET_CONNECTED) && in.second.remote_id == msg->networking_sockets().connection_id_from();});
                 if (connect_socket != sbcs->connect_sockets.end()) {
-                    PRINT_DEBUG("got data len %zu, num " "%" PRIu64 " on not accepted connection %u", msg->networking_sockets().data().size(), msg->networking_sockets().message_number(), connect_socket->first);
-                    connect_socket->second.data.push(msg->networking_sockets());
+                    PRINT_DEBUG("got data len %zu, num " "%" PRIu64 ", batched %i on not accepted connection %u", msg->networking_sockets().data().size(), msg->networking_sockets().message_number(), msg->networking_sockets().batch_size(), connect_socket->first);
+                    push_received_data(connect_socket, *msg->mutable_networking_sockets());
                 }
             }
         } else if (msg->networking_sockets().type() == Networking_Sockets::CONNECTION_END) {
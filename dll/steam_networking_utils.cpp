@@ -85,7 +85,7 @@ void Steam_Networking_Utils::delete_steam_message(SteamNetworkingMessage_t *pMsg
 SteamNetworkingMessage_t* Steam_Networking_Utils::AllocateMessage( int cbAllocateBuffer )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     SteamNetworkingMessage_t *pMsg = new SteamNetworkingMessage_t();
     pMsg->m_pfnFreeData = &free_steam_message_data;
     pMsg->m_pfnRelease = &delete_steam_message;
@@ -103,7 +103,7 @@ SteamNetworkingMessage_t* Steam_Networking_Utils::AllocateMessage( int cbAllocat
 bool Steam_Networking_Utils::InitializeRelayAccess()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     init_relay = true;
     return relay_initialized;
 }
@@ -130,7 +130,7 @@ SteamRelayNetworkStatus_t Steam_Networking_Utils::get_network_status()
 ESteamNetworkingAvailability Steam_Networking_Utils::GetRelayNetworkStatus( SteamRelayNetworkStatus_t *pDetails )
 {
     PRINT_DEBUG("TODO %p", pDetails);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     //TODO: check if this is how real steam returns it
     SteamRelayNetworkStatus_t data = {};
@@ -148,7 +148,7 @@ ESteamNetworkingAvailability Steam_Networking_Utils::GetRelayNetworkStatus( Stea
 float Steam_Networking_Utils::GetLocalPingLocation( SteamNetworkPingLocation_t &result )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (relay_initialized) {
         result.m_data[2] = 123;
         result.m_data[8] = 67;
@@ -161,7 +161,7 @@ float Steam_Networking_Utils::GetLocalPingLocation( SteamNetworkPingLocation_t &
 int Steam_Networking_Utils::EstimatePingTimeBetweenTwoLocations( const SteamNetworkPingLocation_t &location1, const SteamNetworkPingLocation_t &location2 )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //return k_nSteamNetworkingPing_Unknown;
     return 2;
 }
@@ -170,7 +170,7 @@ int Steam_Networking_Utils::EstimatePingTimeBetweenTwoLocations( const SteamNetw
 int Steam_Networking_Utils::EstimatePingTimeFromLocalHost( const SteamNetworkPingLocation_t &remoteLocation )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 2;
 }
 
@@ -178,7 +178,7 @@ int Steam_Networking_Utils::EstimatePingTimeFromLocalHost( const SteamNetworkPin
 void Steam_Networking_Utils::ConvertPingLocationToString( const SteamNetworkPingLocation_t &location, char *pszBuf, int cchBufSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     strncpy(pszBuf, "fra=10+2", cchBufSize);
 }
 
@@ -186,7 +186,7 @@ void Steam_Networking_Utils::ConvertPingLocationToString( const SteamNetworkPing
 bool Steam_Networking_Utils::ParsePingLocationString( const char *pszString, SteamNetworkPingLocation_t &result )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -202,7 +202,7 @@ bool Steam_Networking_Utils::CheckPingDataUpToDate( float flMaxAgeSeconds )
 bool Steam_Networking_Utils::IsPingMeasurementInProgress()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -210,7 +210,7 @@ bool Steam_Networking_Utils::IsPingMeasurementInProgress()
 int Steam_Networking_Utils::GetPingToDataCenter( SteamNetworkingPOPID popID, SteamNetworkingPOPID *pViaRelayPoP )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -218,7 +218,7 @@ int Steam_Networking_Utils::GetPingToDataCenter( SteamNetworkingPOPID popID, Ste
 int Steam_Networking_Utils::GetDirectPingToPOP( SteamNetworkingPOPID popID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -226,7 +226,7 @@ int Steam_Networking_Utils::GetDirectPingToPOP( SteamNetworkingPOPID popID )
 int Steam_Networking_Utils::GetPOPCount()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -234,7 +234,7 @@ int Steam_Networking_Utils::GetPOPCount()
 int Steam_Networking_Utils::GetPOPList( SteamNetworkingPOPID *list, int nListSz )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -263,7 +263,7 @@ int Steam_Networking_Utils::GetPOPList( SteamNetworkingPOPID *list, int nListSz
 SteamNetworkingMicroseconds Steam_Networking_Utils::GetLocalTimestamp()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return static_cast<SteamNetworkingMicroseconds>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - initialized_time).count() + (SteamNetworkingMicroseconds)24*3600*30*1e6);
 }
 
@@ -289,7 +289,7 @@ SteamNetworkingMicroseconds Steam_Networking_Utils::GetLocalTimestamp()
 void Steam_Networking_Utils::SetDebugOutputFunction( ESteamNetworkingSocketsDebugOutputType eDetailLevel, FSteamNetworkingSocketsDebugOutput pfnFunc )
 {
     PRINT_DEBUG("%i", eDetailLevel);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (eDetailLevel != k_ESteamNetworkingSocketsDebugOutputType_None) {
         debug_function = pfnFunc;
     }
@@ -308,7 +308,7 @@ void Steam_Networking_Utils::SetDebugOutputFunction( ESteamNetworkingSocketsDebu
 ESteamNetworkingFakeIPType Steam_Networking_Utils::GetIPv4FakeIPType( uint32 nIPv4 )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingFakeIPType_NotFake;
 }
 
@@ -327,7 +327,7 @@ ESteamNetworkingFakeIPType Steam_Networking_Utils::GetIPv4FakeIPType( uint32 nIP
 EResult Steam_Networking_Utils::GetRealIdentityForFakeIP( const SteamNetworkingIPAddr &fakeIP, SteamNetworkingIdentity *pOutRealIdentity )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EResultNoMatch;
 }
 
@@ -359,7 +359,7 @@ bool Steam_Networking_Utils::SetConfigValue( ESteamNetworkingConfigValue eValue,
     ESteamNetworkingConfigDataType eDataType, const void *pArg )
 {
     PRINT_DEBUG("TODO %i %i " "%" PRIdPTR " %i %p", eValue, eScopeType, scopeObj, eDataType, pArg);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
@@ -375,7 +375,7 @@ ESteamNetworkingGetConfigValueResult Steam_Networking_Utils::GetConfigValue( ESt
     ESteamNetworkingConfigDataType *pOutDataType, void *pResult, size_t *cbResult )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingGetConfigValue_BadValue;
 }
 
@@ -387,7 +387,7 @@ ESteamNetworkingGetConfigValueResult Steam_Networking_Utils::GetConfigValue( ESt
 bool Steam_Networking_Utils::GetConfigValueInfo( ESteamNetworkingConfigValue eValue, const char **pOutName, ESteamNetworkingConfigDataType *pOutDataType, ESteamNetworkingConfigScope *pOutScope, ESteamNetworkingConfigValue *pOutNextValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO flat api
     return false;
 }
@@ -398,7 +398,7 @@ bool Steam_Networking_Utils::GetConfigValueInfo( ESteamNetworkingConfigValue eVa
 const char* Steam_Networking_Utils::GetConfigValueInfo( ESteamNetworkingConfigValue eValue, ESteamNetworkingConfigDataType *pOutDataType, ESteamNetworkingConfigScope *pOutScope )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO flat api
     return NULL;
 }
@@ -407,7 +407,7 @@ const char* Steam_Networking_Utils::GetConfigValueInfo( ESteamNetworkingConfigVa
 ESteamNetworkingConfigValue Steam_Networking_Utils::GetFirstConfigValue()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingConfig_Invalid;
 }
 
@@ -422,7 +422,7 @@ ESteamNetworkingConfigValue Steam_Networking_Utils::GetFirstConfigValue()
 ESteamNetworkingConfigValue Steam_Networking_Utils::IterateGenericEditableConfigValues( ESteamNetworkingConfigValue eCurrent, bool bEnumerateDevVars )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingConfig_Invalid;
 }
 
@@ -432,7 +432,7 @@ ESteamNetworkingConfigValue Steam_Networking_Utils::IterateGenericEditableConfig
 void Steam_Networking_Utils::SteamNetworkingIPAddr_ToString( const SteamNetworkingIPAddr &addr, char *buf, size_t cbBuf, bool bWithPort )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (buf == nullptr || cbBuf == 0) return;
 
     char buffer[64]{}; // enough for ipv4 & ipv6 + port
@@ -474,7 +474,7 @@ void Steam_Networking_Utils::SteamNetworkingIPAddr_ToString( const SteamNetworki
 bool Steam_Networking_Utils::SteamNetworkingIPAddr_ParseString( SteamNetworkingIPAddr *pAddr, const char *pszStr )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     bool valid = false;
 
@@ -563,7 +563,7 @@ bool Steam_Networking_Utils::SteamNetworkingIPAddr_ParseString( SteamNetworkingI
 ESteamNetworkingFakeIPType Steam_Networking_Utils::SteamNetworkingIPAddr_GetFakeIPType( const SteamNetworkingIPAddr &addr )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamNetworkingFakeIPType_NotFake;
 }
 
@@ -571,7 +571,7 @@ ESteamNetworkingFakeIPType Steam_Networking_Utils::SteamNetworkingIPAddr_GetFake
 void Steam_Networking_Utils::SteamNetworkingIdentity_ToString( const SteamNetworkingIdentity &identity, char *buf, size_t cbBuf )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (buf == nullptr)
         return;
 
@@ -636,7 +636,7 @@ void Steam_Networking_Utils::SteamNetworkingIdentity_ToString( const SteamNetwor
 bool Steam_Networking_Utils::SteamNetworkingIdentity_ParseString( SteamNetworkingIdentity *pIdentity, const char *pszStr )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     bool valid = false;
     if (pIdentity == nullptr)
     {
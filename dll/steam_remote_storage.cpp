@@ -64,7 +64,7 @@ Steam_Remote_Storage::Steam_Remote_Storage(class Settings *settings, class Ugc_R
 bool Steam_Remote_Storage::FileWrite( const char *pchFile, const void *pvData, int32 cubData )
 {
     PRINT_DEBUG("'%s' %p %u", pchFile, pvData, cubData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchFile || !pchFile[0] || cubData <= 0 || cubData > k_unMaxCloudFileChunkSize || !pvData) {
         return false;
@@ -78,7 +78,7 @@ bool Steam_Remote_Storage::FileWrite( const char *pchFile, const void *pvData, i
 int32 Steam_Remote_Storage::FileRead( const char *pchFile, void *pvData, int32 cubDataToRead )
 {
     PRINT_DEBUG("'%s' %p %i", pchFile, pvData, cubDataToRead);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchFile || !pchFile[0] || !pvData || !cubDataToRead) return 0;
     int read_data = local_storage->get_data(Local_Storage::remote_storage_folder, pchFile, (char* )pvData, cubDataToRead);
@@ -91,7 +91,7 @@ STEAM_CALL_RESULT( RemoteStorageFileWriteAsyncComplete_t )
 SteamAPICall_t Steam_Remote_Storage::FileWriteAsync( const char *pchFile, const void *pvData, uint32 cubData )
 {
     PRINT_DEBUG("'%s' %p %u", pchFile, pvData, cubData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchFile || !pchFile[0] || cubData > k_unMaxCloudFileChunkSize || cubData == 0 || !pvData) {
         return k_uAPICallInvalid;
@@ -109,7 +109,7 @@ STEAM_CALL_RESULT( RemoteStorageFileReadAsyncComplete_t )
 SteamAPICall_t Steam_Remote_Storage::FileReadAsync( const char *pchFile, uint32 nOffset, uint32 cubToRead )
 {
     PRINT_DEBUG("'%s' %u %u", pchFile, nOffset, cubToRead);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchFile || !pchFile[0]) return k_uAPICallInvalid;
     unsigned int size = local_storage->file_size(Local_Storage::remote_storage_folder, pchFile);
@@ -137,7 +137,7 @@ SteamAPICall_t Steam_Remote_Storage::FileReadAsync( const char *pchFile, uint32
 bool Steam_Remote_Storage::FileReadAsyncComplete( SteamAPICall_t hReadCall, void *pvBuffer, uint32 cubToRead )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pvBuffer) return false;
 
     auto a_read = std::find_if(async_reads.begin(), async_reads.end(), [&hReadCall](Async_Read const& item) { return item.api_call == hReadCall; });
@@ -147,13 +147,11 @@ bool Steam_Remote_Storage::FileReadAsyncComplete( SteamAPICall_t hReadCall, void
     if (cubToRead < a_read->to_read)
         return false;
 
-    std::vector<char> temp(a_read->size);
-    int read_data = local_storage->get_data(Local_Storage::remote_storage_folder, a_read->file_name, (char* )&temp[0], a_read->size);
-    if (read_data < 0 || (static_cast<uint32>(read_data) < (a_read->to_read + a_read->offset))) {
+    int read_data = local_storage->get_data(Local_Storage::remote_storage_folder, a_read->file_name, (char* )pvBuffer, a_read->to_read, a_read->offset);
+    if (read_data < 0 || (static_cast<uint32>(read_data) < a_read->to_read)) {
         return false;
     }
 
-    memcpy(pvBuffer, &temp[0] + a_read->offset, a_read->to_read);
     async_reads.erase(a_read);
     return true;
 }
@@ -162,7 +160,7 @@ bool Steam_Remote_Storage::FileReadAsyncComplete( SteamAPICall_t hReadCall, void
 bool Steam_Remote_Storage::FileForget( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return false;
 
     return true;
@@ -171,7 +169,7 @@ bool Steam_Remote_Storage::FileForget( const char *pchFile )
 bool Steam_Remote_Storage::FileDelete( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return false;
     
     return local_storage->file_delete(Local_Storage::remote_storage_folder, pchFile);
@@ -181,7 +179,7 @@ STEAM_CALL_RESULT( RemoteStorageFileShareResult_t )
 SteamAPICall_t Steam_Remote_Storage::FileShare( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return k_uAPICallInvalid;
 
     RemoteStorageFileShareResult_t data = {};
@@ -200,7 +198,7 @@ SteamAPICall_t Steam_Remote_Storage::FileShare( const char *pchFile )
 bool Steam_Remote_Storage::SetSyncPlatforms( const char *pchFile, ERemoteStoragePlatform eRemoteStoragePlatform )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return false;
     
     return true;
@@ -211,7 +209,7 @@ bool Steam_Remote_Storage::SetSyncPlatforms( const char *pchFile, ERemoteStorage
 UGCFileWriteStreamHandle_t Steam_Remote_Storage::FileWriteStreamOpen( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return k_UGCFileStreamHandleInvalid;
     
     static UGCFileWriteStreamHandle_t handle;
@@ -226,7 +224,7 @@ UGCFileWriteStreamHandle_t Steam_Remote_Storage::FileWriteStreamOpen( const char
 bool Steam_Remote_Storage::FileWriteStreamWriteChunk( UGCFileWriteStreamHandle_t writeHandle, const void *pvData, int32 cubData )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pvData || cubData < 0) return false;
 
     auto request = std::find_if(stream_writes.begin(), stream_writes.end(), [&writeHandle](struct Stream_Write const& item) { return item.write_stream_handle == writeHandle; });
@@ -240,7 +238,7 @@ bool Steam_Remote_Storage::FileWriteStreamWriteChunk( UGCFileWriteStreamHandle_t
 bool Steam_Remote_Storage::FileWriteStreamClose( UGCFileWriteStreamHandle_t writeHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto request = std::find_if(stream_writes.begin(), stream_writes.end(), [&writeHandle](struct Stream_Write const& item) { return item.write_stream_handle == writeHandle; });
     if (stream_writes.end() == request)
         return false;
@@ -253,7 +251,7 @@ bool Steam_Remote_Storage::FileWriteStreamClose( UGCFileWriteStreamHandle_t writ
 bool Steam_Remote_Storage::FileWriteStreamCancel( UGCFileWriteStreamHandle_t writeHandle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     auto request = std::find_if(stream_writes.begin(), stream_writes.end(), [&writeHandle](struct Stream_Write const& item) { return item.write_stream_handle == writeHandle; });
     if (stream_writes.end() == request)
         return false;
@@ -266,7 +264,7 @@ bool Steam_Remote_Storage::FileWriteStreamCancel( UGCFileWriteStreamHandle_t wri
 bool Steam_Remote_Storage::FileExists( const char *pchFile )
 {
     PRINT_DEBUG("'%s'", pchFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return false;
     
     return local_storage->file_exists(Local_Storage::remote_storage_folder, pchFile);
@@ -275,7 +273,7 @@ bool Steam_Remote_Storage::FileExists( const char *pchFile )
 bool Steam_Remote_Storage::FilePersisted( const char *pchFile )
 {
     PRINT_DEBUG("'%s'", pchFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return false;
     
     return local_storage->file_exists(Local_Storage::remote_storage_folder, pchFile);
@@ -284,7 +282,7 @@ bool Steam_Remote_Storage::FilePersisted( const char *pchFile )
 int32 Steam_Remote_Storage::GetFileSize( const char *pchFile )
 {
     PRINT_DEBUG("'%s'", pchFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return 0;
     
     return local_storage->file_size(Local_Storage::remote_storage_folder, pchFile);
@@ -293,7 +291,7 @@ int32 Steam_Remote_Storage::GetFileSize( const char *pchFile )
 int64 Steam_Remote_Storage::GetFileTimestamp( const char *pchFile )
 {
     PRINT_DEBUG("'%s'", pchFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchFile || !pchFile[0]) return 0;
     
     return local_storage->file_timestamp(Local_Storage::remote_storage_folder, pchFile);
@@ -302,7 +300,7 @@ int64 Steam_Remote_Storage::GetFileTimestamp( const char *pchFile )
 ERemoteStoragePlatform Steam_Remote_Storage::GetSyncPlatforms( const char *pchFile )
 {
     PRINT_DEBUG("'%s'", pchFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_ERemoteStoragePlatformAll;
 }
@@ -312,7 +310,7 @@ ERemoteStoragePlatform Steam_Remote_Storage::GetSyncPlatforms( const char *pchFi
 int32 Steam_Remote_Storage::GetFileCount()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     int32 num = local_storage->count_files(Local_Storage::remote_storage_folder);
     PRINT_DEBUG("count: %i", num);
@@ -322,7 +320,7 @@ int32 Steam_Remote_Storage::GetFileCount()
 const char* Steam_Remote_Storage::GetFileNameAndSize( int iFile, int32 *pnFileSizeInBytes )
 {
     PRINT_DEBUG("%i", iFile);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     static char output_filename[MAX_FILENAME_LENGTH];
     if (local_storage->iterate_file(Local_Storage::remote_storage_folder, iFile, output_filename, pnFileSizeInBytes)) {
@@ -338,7 +336,7 @@ const char* Steam_Remote_Storage::GetFileNameAndSize( int iFile, int32 *pnFileSi
 bool Steam_Remote_Storage::GetQuota( uint64 *pnTotalBytes, uint64 *puAvailableBytes )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     uint64 quota = 2 << 26;
     if (pnTotalBytes) *pnTotalBytes = quota;
@@ -349,7 +347,7 @@ bool Steam_Remote_Storage::GetQuota( uint64 *pnTotalBytes, uint64 *puAvailableBy
 bool Steam_Remote_Storage::GetQuota( int32 *pnTotalBytes, int32 *puAvailableBytes )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     int32 quota = 2 << 26;
     if (pnTotalBytes) *pnTotalBytes = quota;
@@ -360,7 +358,7 @@ bool Steam_Remote_Storage::GetQuota( int32 *pnTotalBytes, int32 *puAvailableByte
 bool Steam_Remote_Storage::IsCloudEnabledForAccount()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return true;
 }
@@ -368,7 +366,7 @@ bool Steam_Remote_Storage::IsCloudEnabledForAccount()
 bool Steam_Remote_Storage::IsCloudEnabledForApp()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return steam_cloud_enabled;
 }
@@ -376,7 +374,7 @@ bool Steam_Remote_Storage::IsCloudEnabledForApp()
 bool Steam_Remote_Storage::IsCloudEnabledThisApp()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return steam_cloud_enabled;
 }
@@ -384,7 +382,7 @@ bool Steam_Remote_Storage::IsCloudEnabledThisApp()
 void Steam_Remote_Storage::SetCloudEnabledForApp( bool bEnabled )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     steam_cloud_enabled = bEnabled;
 }
@@ -392,7 +390,7 @@ void Steam_Remote_Storage::SetCloudEnabledForApp( bool bEnabled )
 bool Steam_Remote_Storage::SetCloudEnabledThisApp( bool bEnabled )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     steam_cloud_enabled = bEnabled;
     return true;
@@ -407,7 +405,7 @@ STEAM_CALL_RESULT( RemoteStorageDownloadUGCResult_t )
 SteamAPICall_t Steam_Remote_Storage::UGCDownload( UGCHandle_t hContent, uint32 unPriority )
 {
     PRINT_DEBUG("%llu", hContent);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hContent == k_UGCHandleInvalid) return k_uAPICallInvalid;
 
     RemoteStorageDownloadUGCResult_t data{};
@@ -422,6 +420,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownload( UGCHandle_t hContent, uint32 u
         shared_files[hContent].copy(data.m_pchFileName, sizeof(data.m_pchFileName) - 1);
 
         downloaded_files[hContent].source = Downloaded_File::DownloadSource::AfterFileShare;
+        downloaded_files[hContent].handle = nullptr;
         downloaded_files[hContent].file = shared_files[hContent];
         downloaded_files[hContent].total_size = data.m_nSizeInBytes;
     } else if (auto query_res = ugc_bridge->get_ugc_query_result(hContent)) {
@@ -442,6 +441,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownload( UGCHandle_t hContent, uint32 u
         mod_name.copy(data.m_pchFileName, sizeof(data.m_pchFileName) - 1);
         
         downloaded_files[hContent].source = Downloaded_File::DownloadSource::AfterSendQueryUGCRequest;
+        downloaded_files[hContent].handle = nullptr;
         downloaded_files[hContent].file = mod_name;
         downloaded_files[hContent].total_size = mod_size;
         
@@ -467,7 +467,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownload( UGCHandle_t hContent )
 bool Steam_Remote_Storage::GetUGCDownloadProgress( UGCHandle_t hContent, int32 *pnBytesDownloaded, int32 *pnBytesExpected )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -475,7 +475,7 @@ bool Steam_Remote_Storage::GetUGCDownloadProgress( UGCHandle_t hContent, int32 *
 bool Steam_Remote_Storage::GetUGCDownloadProgress( UGCHandle_t hContent, uint32 *pnBytesDownloaded, uint32 *pnBytesExpected )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -485,7 +485,7 @@ bool Steam_Remote_Storage::GetUGCDownloadProgress( UGCHandle_t hContent, uint32
 bool Steam_Remote_Storage::GetUGCDetails( UGCHandle_t hContent, AppId_t *pnAppID, STEAM_OUT_STRING() char **ppchName, int32 *pnFileSizeInBytes, STEAM_OUT_STRUCT() CSteamID *pSteamIDOwner )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -500,7 +500,7 @@ bool Steam_Remote_Storage::GetUGCDetails( UGCHandle_t hContent, AppId_t *pnAppID
 int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 cubDataToRead, uint32 cOffset, EUGCReadAction eAction )
 {
     PRINT_DEBUG("%llu, %p, %i, %u, %i", hContent, pvData, cubDataToRead, cOffset, eAction);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto f_itr = downloaded_files.find(hContent);
     if (hContent == k_UGCHandleInvalid || (downloaded_files.end() == f_itr) || cubDataToRead < 0) {
@@ -540,7 +540,9 @@ int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 c
             mod_fullpath = dwf.download_to_location_fullpath;
         }
         
-        read_data = Local_Storage::get_file_data(mod_fullpath, (char *)pvData, cubDataToRead, cOffset);
+        // opened once and kept until the file is closed, instead of once per chunk
+        if (!dwf.handle) dwf.handle = local_storage->open_file(mod_fullpath);
+        read_data = dwf.handle ? dwf.handle->read((char *)pvData, cubDataToRead, cOffset) : -1;
         PRINT_DEBUG("  mod file '%s' [%i]", mod_fullpath.c_str(), read_data);
         total_size = dwf.total_size;
     }
@@ -566,7 +568,7 @@ int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 c
 int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 cubDataToRead )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return UGCRead( hContent, pvData, cubDataToRead, 0);
 }
@@ -574,7 +576,7 @@ int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 c
 int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 cubDataToRead, uint32 cOffset)
 {
     PRINT_DEBUG("old2");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return UGCRead(hContent, pvData, cubDataToRead, cOffset, k_EUGCRead_ContinueReadingUntilFinished);
 }
@@ -583,7 +585,7 @@ int32 Steam_Remote_Storage::UGCRead( UGCHandle_t hContent, void *pvData, int32 c
 int32 Steam_Remote_Storage::GetCachedUGCCount()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return 0;
 }
@@ -591,7 +593,7 @@ int32 Steam_Remote_Storage::GetCachedUGCCount()
 UGCHandle_t Steam_Remote_Storage::GetCachedUGCHandle( int32 iCachedContent )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_UGCHandleInvalid;
 }
@@ -605,7 +607,7 @@ UGCHandle_t Steam_Remote_Storage::GetCachedUGCHandle( int32 iCachedContent )
 void Steam_Remote_Storage::GetFileListFromServer()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
 }
 
@@ -613,7 +615,7 @@ void Steam_Remote_Storage::GetFileListFromServer()
 bool Steam_Remote_Storage::FileFetch( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return true;
 }
@@ -622,7 +624,7 @@ bool Steam_Remote_Storage::FileFetch( const char *pchFile )
 bool Steam_Remote_Storage::FilePersist( const char *pchFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return true;
 }
@@ -631,7 +633,7 @@ bool Steam_Remote_Storage::FilePersist( const char *pchFile )
 bool Steam_Remote_Storage::SynchronizeToClient()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
 }
 
@@ -639,7 +641,7 @@ bool Steam_Remote_Storage::SynchronizeToClient()
 bool Steam_Remote_Storage::SynchronizeToServer()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
 }
 
@@ -647,7 +649,7 @@ bool Steam_Remote_Storage::SynchronizeToServer()
 bool Steam_Remote_Storage::ResetFileRequestState()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
 }
 
@@ -658,7 +660,7 @@ STEAM_CALL_RESULT( RemoteStoragePublishFileProgress_t )
 SteamAPICall_t Steam_Remote_Storage::PublishWorkshopFile( const char *pchFile, const char *pchPreviewFile, AppId_t nConsumerAppId, const char *pchTitle, const char *pchDescription, ERemoteStoragePublishedFileVisibility eVisibility, SteamParamStringArray_t *pTags, EWorkshopFileType eWorkshopFileType )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return k_uAPICallInvalid;
 }
@@ -666,7 +668,7 @@ SteamAPICall_t Steam_Remote_Storage::PublishWorkshopFile( const char *pchFile, c
 PublishedFileUpdateHandle_t Steam_Remote_Storage::CreatePublishedFileUpdateRequest( PublishedFileId_t unPublishedFileId )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_PublishedFileUpdateHandleInvalid;
 }
@@ -674,7 +676,7 @@ PublishedFileUpdateHandle_t Steam_Remote_Storage::CreatePublishedFileUpdateReque
 bool Steam_Remote_Storage::UpdatePublishedFileFile( PublishedFileUpdateHandle_t updateHandle, const char *pchFile )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -682,7 +684,7 @@ bool Steam_Remote_Storage::UpdatePublishedFileFile( PublishedFileUpdateHandle_t
 SteamAPICall_t Steam_Remote_Storage::PublishFile( const char *pchFile, const char *pchPreviewFile, AppId_t nConsumerAppId, const char *pchTitle, const char *pchDescription, ERemoteStoragePublishedFileVisibility eVisibility, SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -690,7 +692,7 @@ SteamAPICall_t Steam_Remote_Storage::PublishFile( const char *pchFile, const cha
 SteamAPICall_t Steam_Remote_Storage::PublishWorkshopFile( const char *pchFile, const char *pchPreviewFile, AppId_t nConsumerAppId, const char *pchTitle, const char *pchDescription, SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -698,7 +700,7 @@ SteamAPICall_t Steam_Remote_Storage::PublishWorkshopFile( const char *pchFile, c
 SteamAPICall_t Steam_Remote_Storage::UpdatePublishedFile( RemoteStorageUpdatePublishedFileRequest_t updatePublishedFileRequest )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -706,7 +708,7 @@ SteamAPICall_t Steam_Remote_Storage::UpdatePublishedFile( RemoteStorageUpdatePub
 bool Steam_Remote_Storage::UpdatePublishedFilePreviewFile( PublishedFileUpdateHandle_t updateHandle, const char *pchPreviewFile )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -714,7 +716,7 @@ bool Steam_Remote_Storage::UpdatePublishedFilePreviewFile( PublishedFileUpdateHa
 bool Steam_Remote_Storage::UpdatePublishedFileTitle( PublishedFileUpdateHandle_t updateHandle, const char *pchTitle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -722,7 +724,7 @@ bool Steam_Remote_Storage::UpdatePublishedFileTitle( PublishedFileUpdateHandle_t
 bool Steam_Remote_Storage::UpdatePublishedFileDescription( PublishedFileUpdateHandle_t updateHandle, const char *pchDescription )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -730,7 +732,7 @@ bool Steam_Remote_Storage::UpdatePublishedFileDescription( PublishedFileUpdateHa
 bool Steam_Remote_Storage::UpdatePublishedFileVisibility( PublishedFileUpdateHandle_t updateHandle, ERemoteStoragePublishedFileVisibility eVisibility )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -738,7 +740,7 @@ bool Steam_Remote_Storage::UpdatePublishedFileVisibility( PublishedFileUpdateHan
 bool Steam_Remote_Storage::UpdatePublishedFileTags( PublishedFileUpdateHandle_t updateHandle, SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -747,7 +749,7 @@ STEAM_CALL_RESULT( RemoteStorageUpdatePublishedFileResult_t )
 SteamAPICall_t Steam_Remote_Storage::CommitPublishedFileUpdate( PublishedFileUpdateHandle_t updateHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -761,7 +763,7 @@ SteamAPICall_t Steam_Remote_Storage::GetPublishedFileDetails( PublishedFileId_t
     PRINT_DEBUG("TODO %llu %u", unPublishedFileId, unMaxSecondsOld);
     //TODO: check what this function really returns
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
     RemoteStorageGetPublishedFileDetailsResult_t data{};
@@ -799,7 +801,7 @@ SteamAPICall_t Steam_Remote_Storage::GetPublishedFileDetails( PublishedFileId_t
 
     // return 0;
 /*
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     RemoteStorageGetPublishedFileDetailsResult_t data = {};
     data.m_eResult = k_EResultFail;
     data.m_nPublishedFileId = unPublishedFileId;
@@ -818,7 +820,7 @@ STEAM_CALL_RESULT( RemoteStorageDeletePublishedFileResult_t )
 SteamAPICall_t Steam_Remote_Storage::DeletePublishedFile( PublishedFileId_t unPublishedFileId )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -829,7 +831,7 @@ SteamAPICall_t Steam_Remote_Storage::EnumerateUserPublishedFiles( uint32 unStart
 {
     PRINT_DEBUG("TODO %u", unStartIndex);
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     RemoteStorageEnumerateUserPublishedFilesResult_t data{};
 
     // collect all published mods by this user
@@ -868,7 +870,7 @@ STEAM_CALL_RESULT( RemoteStorageSubscribePublishedFileResult_t )
 SteamAPICall_t Steam_Remote_Storage::SubscribePublishedFile( PublishedFileId_t unPublishedFileId )
 {
     PRINT_DEBUG("TODO %llu", unPublishedFileId);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
 
     // TODO is this implementation correct?
@@ -890,7 +892,7 @@ SteamAPICall_t Steam_Remote_Storage::EnumerateUserSubscribedFiles( uint32 unStar
 {
     // https://partner.steamgames.com/doc/api/ISteamRemoteStorage
     PRINT_DEBUG("%u", unStartIndex);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     // Get ready for a working but bad implementation - Detanup01
     RemoteStorageEnumerateUserSubscribedFilesResult_t data{};
     uint32_t modCount = (uint32_t)ugc_bridge->subbed_mods_count();
@@ -921,7 +923,7 @@ STEAM_CALL_RESULT( RemoteStorageUnsubscribePublishedFileResult_t )
 SteamAPICall_t Steam_Remote_Storage::UnsubscribePublishedFile( PublishedFileId_t unPublishedFileId )
 {
     PRINT_DEBUG("TODO %llu", unPublishedFileId);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
 
     // TODO is this implementation correct?
@@ -941,7 +943,7 @@ SteamAPICall_t Steam_Remote_Storage::UnsubscribePublishedFile( PublishedFileId_t
 bool Steam_Remote_Storage::UpdatePublishedFileSetChangeDescription( PublishedFileUpdateHandle_t updateHandle, const char *pchChangeDescription )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return false;
 }
@@ -951,7 +953,7 @@ SteamAPICall_t Steam_Remote_Storage::GetPublishedItemVoteDetails( PublishedFileI
 {
     PRINT_DEBUG_TODO();
     // TODO s this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
 
     RemoteStorageGetPublishedItemVoteDetailsResult_t data{};
@@ -977,7 +979,7 @@ SteamAPICall_t Steam_Remote_Storage::UpdateUserPublishedItemVote( PublishedFileI
     // given that the mod owner is the current user
     PRINT_DEBUG_TODO();
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
 
     RemoteStorageUpdateUserPublishedItemVoteResult_t data{};
@@ -1002,7 +1004,7 @@ SteamAPICall_t Steam_Remote_Storage::GetUserPublishedItemVoteDetails( PublishedF
     PRINT_DEBUG_ENTRY();
     
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (unPublishedFileId == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
 
     RemoteStorageGetPublishedItemVoteDetailsResult_t data{};
@@ -1031,7 +1033,7 @@ STEAM_CALL_RESULT( RemoteStorageEnumerateUserPublishedFilesResult_t )
 SteamAPICall_t Steam_Remote_Storage::EnumerateUserSharedWorkshopFiles( CSteamID steamId, uint32 unStartIndex, SteamParamStringArray_t *pRequiredTags, SteamParamStringArray_t *pExcludedTags )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     RemoteStorageEnumerateUserPublishedFilesResult_t data{};
     data.m_eResult = k_EResultOK;
     data.m_nResultsReturned = 0;
@@ -1051,7 +1053,7 @@ STEAM_CALL_RESULT( RemoteStoragePublishFileProgress_t )
 SteamAPICall_t Steam_Remote_Storage::PublishVideo( EWorkshopVideoProvider eVideoProvider, const char *pchVideoAccount, const char *pchVideoIdentifier, const char *pchPreviewFile, AppId_t nConsumerAppId, const char *pchTitle, const char *pchDescription, ERemoteStoragePublishedFileVisibility eVisibility, SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_uAPICallInvalid;
 }
 
@@ -1059,7 +1061,7 @@ STEAM_CALL_RESULT( RemoteStoragePublishFileProgress_t )
 SteamAPICall_t Steam_Remote_Storage::PublishVideo(const char *pchFileName, const char *pchPreviewFile, AppId_t nConsumerAppId, const char *pchTitle, const char *pchDescription, ERemoteStoragePublishedFileVisibility eVisibility, SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_uAPICallInvalid;
 }
 
@@ -1067,7 +1069,7 @@ STEAM_CALL_RESULT( RemoteStorageSetUserPublishedFileActionResult_t )
 SteamAPICall_t Steam_Remote_Storage::SetUserPublishedFileAction( PublishedFileId_t unPublishedFileId, EWorkshopFileAction eAction )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_uAPICallInvalid;
 }
 
@@ -1075,7 +1077,7 @@ STEAM_CALL_RESULT( RemoteStorageEnumeratePublishedFilesByUserActionResult_t )
 SteamAPICall_t Steam_Remote_Storage::EnumeratePublishedFilesByUserAction( EWorkshopFileAction eAction, uint32 unStartIndex )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_uAPICallInvalid;
 }
 
@@ -1085,7 +1087,7 @@ SteamAPICall_t Steam_Remote_Storage::EnumeratePublishedWorkshopFiles( EWorkshopE
 {
     PRINT_DEBUG_TODO();
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     RemoteStorageEnumerateWorkshopFilesResult_t data{};
     data.m_eResult = EResult::k_EResultOK;
     data.m_nResultsReturned = 0;
@@ -1100,7 +1102,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownloadToLocation( UGCHandle_t hContent
 {
     PRINT_DEBUG("TODO %llu %s", hContent, pchLocation);
     // TODO is this implementation correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO: not sure if this is the right result
     if (hContent == k_UGCHandleInvalid || !pchLocation || !pchLocation[0]) return k_uAPICallInvalid;
 
@@ -1135,6 +1137,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownloadToLocation( UGCHandle_t hContent
 
         // TODO not sure about this though
         downloaded_files[hContent].source = Downloaded_File::DownloadSource::FromUGCDownloadToLocation;
+        downloaded_files[hContent].handle = nullptr;
         downloaded_files[hContent].file = mod_name;
         downloaded_files[hContent].total_size = mod_size;
         
@@ -1152,7 +1155,7 @@ SteamAPICall_t Steam_Remote_Storage::UGCDownloadToLocation( UGCHandle_t hContent
 int32 Steam_Remote_Storage::GetLocalFileChangeCount()
 {
     PRINT_DEBUG("GetLocalFileChangeCount");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return 0;
 }
@@ -1160,7 +1163,7 @@ int32 Steam_Remote_Storage::GetLocalFileChangeCount()
 const char* Steam_Remote_Storage::GetLocalFileChange( int iFile, ERemoteStorageLocalFileChange *pEChangeType, ERemoteStorageFilePathType *pEFilePathType )
 {
     PRINT_DEBUG("GetLocalFileChange");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return "";
 }
@@ -1170,7 +1173,7 @@ const char* Steam_Remote_Storage::GetLocalFileChange( int iFile, ERemoteStorageL
 bool Steam_Remote_Storage::BeginFileWriteBatch()
 {
     PRINT_DEBUG("BeginFileWriteBatch");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return true;
 }
@@ -1178,7 +1181,7 @@ bool Steam_Remote_Storage::BeginFileWriteBatch()
 bool Steam_Remote_Storage::EndFileWriteBatch()
 {
     PRINT_DEBUG("EndFileWriteBatch");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return true;
 }
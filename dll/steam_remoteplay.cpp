@@ -55,7 +55,7 @@ Steam_RemotePlay::~Steam_RemotePlay()
 uint32 Steam_RemotePlay::GetSessionCount()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -63,7 +63,7 @@ uint32 Steam_RemotePlay::GetSessionCount()
 uint32 Steam_RemotePlay::GetSessionID( int iSessionIndex )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -71,7 +71,7 @@ uint32 Steam_RemotePlay::GetSessionID( int iSessionIndex )
 CSteamID Steam_RemotePlay::GetSessionSteamID( uint32 unSessionID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_steamIDNil;
 }
 
@@ -80,7 +80,7 @@ CSteamID Steam_RemotePlay::GetSessionSteamID( uint32 unSessionID )
 const char* Steam_RemotePlay::GetSessionClientName( uint32 unSessionID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return NULL;
 }
 
@@ -88,7 +88,7 @@ const char* Steam_RemotePlay::GetSessionClientName( uint32 unSessionID )
 ESteamDeviceFormFactor Steam_RemotePlay::GetSessionClientFormFactor( uint32 unSessionID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamDeviceFormFactorUnknown;
 }
 
@@ -97,7 +97,7 @@ ESteamDeviceFormFactor Steam_RemotePlay::GetSessionClientFormFactor( uint32 unSe
 bool Steam_RemotePlay::BGetSessionClientResolution( uint32 unSessionID, int *pnResolutionX, int *pnResolutionY )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (pnResolutionX) *pnResolutionX = 0;
     if (pnResolutionY) *pnResolutionY = 0;
     return false;
@@ -106,7 +106,7 @@ bool Steam_RemotePlay::BGetSessionClientResolution( uint32 unSessionID, int *pnR
 bool Steam_RemotePlay::BStartRemotePlayTogether( bool bShowOverlay )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -115,7 +115,7 @@ bool Steam_RemotePlay::BStartRemotePlayTogether( bool bShowOverlay )
 bool Steam_RemotePlay::BSendRemotePlayTogetherInvite( CSteamID steamIDFriend )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -26,7 +26,7 @@ Steam_Screenshots::Steam_Screenshots(class Local_Storage* local_storage, class S
 
 ScreenshotHandle Steam_Screenshots::create_screenshot_handle()
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     static ScreenshotHandle handle = 100;
 
     ++handle;
@@ -39,7 +39,7 @@ ScreenshotHandle Steam_Screenshots::create_screenshot_handle()
 ScreenshotHandle Steam_Screenshots::WriteScreenshot( void *pubRGB, uint32 cubRGB, int nWidth, int nHeight )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     char buff[128];
     auto now = std::chrono::system_clock::now();
@@ -67,7 +67,7 @@ ScreenshotHandle Steam_Screenshots::WriteScreenshot( void *pubRGB, uint32 cubRGB
 ScreenshotHandle Steam_Screenshots::AddScreenshotToLibrary( const char *pchFilename, const char *pchThumbnailFilename, int nWidth, int nHeight )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (pchFilename == nullptr)
         return INVALID_SCREENSHOT_HANDLE;
@@ -99,7 +99,7 @@ ScreenshotHandle Steam_Screenshots::AddScreenshotToLibrary( const char *pchFilen
 void Steam_Screenshots::TriggerScreenshot()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (hooked) {
         ScreenshotRequested_t data;
@@ -116,7 +116,7 @@ void Steam_Screenshots::TriggerScreenshot()
 void Steam_Screenshots::HookScreenshots( bool bHook )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     hooked = bHook;
 }
 
@@ -125,7 +125,7 @@ void Steam_Screenshots::HookScreenshots( bool bHook )
 bool Steam_Screenshots::SetLocation( ScreenshotHandle hScreenshot, const char *pchLocation )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto it = _screenshots.find(hScreenshot);
     if (it == _screenshots.end()) return false;
@@ -141,7 +141,7 @@ bool Steam_Screenshots::SetLocation( ScreenshotHandle hScreenshot, const char *p
 bool Steam_Screenshots::TagUser( ScreenshotHandle hScreenshot, CSteamID steamID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto it = _screenshots.find(hScreenshot);
     if (it == _screenshots.end()) return false;
@@ -157,7 +157,7 @@ bool Steam_Screenshots::TagUser( ScreenshotHandle hScreenshot, CSteamID steamID
 bool Steam_Screenshots::TagPublishedFile( ScreenshotHandle hScreenshot, PublishedFileId_t unPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto it = _screenshots.find(hScreenshot);
     if (it == _screenshots.end()) return false;
@@ -173,7 +173,7 @@ bool Steam_Screenshots::TagPublishedFile( ScreenshotHandle hScreenshot, Publishe
 bool Steam_Screenshots::IsScreenshotsHooked()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return hooked;
 }
@@ -187,7 +187,7 @@ bool Steam_Screenshots::IsScreenshotsHooked()
 ScreenshotHandle Steam_Screenshots::AddVRScreenshotToLibrary( EVRScreenshotType eType, const char *pchFilename, const char *pchVRFilename )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return INVALID_SCREENSHOT_HANDLE;
 }
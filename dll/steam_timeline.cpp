@@ -58,7 +58,7 @@ Steam_Timeline::~Steam_Timeline()
 void Steam_Timeline::SetTimelineStateDescription( const char *pchDescription, float flTimeDelta )
 {
     PRINT_DEBUG("'%s' %f", pchDescription, flTimeDelta);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     const auto target_timepoint = std::chrono::system_clock::now() + std::chrono::milliseconds(static_cast<long>(flTimeDelta * 1000));
 
@@ -82,7 +82,7 @@ void Steam_Timeline::SetTimelineStateDescription( const char *pchDescription, fl
 void Steam_Timeline::ClearTimelineStateDescription( float flTimeDelta )
 {
     PRINT_DEBUG("%f", flTimeDelta);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     const auto target_timepoint = std::chrono::system_clock::now() + std::chrono::milliseconds(static_cast<long>(flTimeDelta * 1000));
 
@@ -102,7 +102,7 @@ void Steam_Timeline::ClearTimelineStateDescription( float flTimeDelta )
 void Steam_Timeline::AddTimelineEvent( const char *pchIcon, const char *pchTitle, const char *pchDescription, uint32 unPriority, float flStartOffsetSeconds, float flDurationSeconds, ETimelineEventClipPriority ePossibleClip )
 {
     PRINT_DEBUG("'%s' | '%s' - '%s', %u, [%f, %f) %i", pchIcon, pchTitle, pchDescription, unPriority, flStartOffsetSeconds, flDurationSeconds, (int)ePossibleClip);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto &new_event = timeline_events.emplace_back(TimelineEvent_t{});
     new_event.pchIcon = pchIcon;
@@ -125,7 +125,7 @@ void Steam_Timeline::AddTimelineEvent( const char *pchIcon, const char *pchTitle
 void Steam_Timeline::SetTimelineGameMode( ETimelineGameMode eMode )
 {
     PRINT_DEBUG("%i", (int)eMode);
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (timeline_states.empty()) return;
 
@@ -19,7 +19,7 @@
 
 UGCQueryHandle_t Steam_UGC::new_ugc_query(bool return_all_subscribed, std::set<PublishedFileId_t> return_only)
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     ++handle;
     if ((handle == 0) || (handle == k_UGCQueryHandleInvalid)) handle = 50;
@@ -168,7 +168,7 @@ Steam_UGC::Steam_UGC(class Settings *settings, class Ugc_Remote_Storage_Bridge *
 UGCQueryHandle_t Steam_UGC::CreateQueryUserUGCRequest( AccountID_t unAccountID, EUserUGCList eListType, EUGCMatchingUGCType eMatchingUGCType, EUserUGCListSortOrder eSortOrder, AppId_t nCreatorAppID, AppId_t nConsumerAppID, uint32 unPage )
 {
     PRINT_DEBUG("%u %i %i %i %u %u %u", unAccountID, eListType, eMatchingUGCType, eSortOrder, nCreatorAppID, nConsumerAppID, unPage);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (nCreatorAppID != settings->get_local_game_id().AppID() || nConsumerAppID != settings->get_local_game_id().AppID()) return k_UGCQueryHandleInvalid;
     if (unPage < 1) return k_UGCQueryHandleInvalid;
@@ -184,7 +184,7 @@ UGCQueryHandle_t Steam_UGC::CreateQueryUserUGCRequest( AccountID_t unAccountID,
 UGCQueryHandle_t Steam_UGC::CreateQueryAllUGCRequest( EUGCQuery eQueryType, EUGCMatchingUGCType eMatchingeMatchingUGCTypeFileType, AppId_t nCreatorAppID, AppId_t nConsumerAppID, uint32 unPage )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nCreatorAppID != settings->get_local_game_id().AppID() || nConsumerAppID != settings->get_local_game_id().AppID()) return k_UGCQueryHandleInvalid;
     if (unPage < 1) return k_UGCQueryHandleInvalid;
@@ -198,7 +198,7 @@ UGCQueryHandle_t Steam_UGC::CreateQueryAllUGCRequest( EUGCQuery eQueryType, EUGC
 UGCQueryHandle_t Steam_UGC::CreateQueryAllUGCRequest( EUGCQuery eQueryType, EUGCMatchingUGCType eMatchingeMatchingUGCTypeFileType, AppId_t nCreatorAppID, AppId_t nConsumerAppID, const char *pchCursor )
 {
     PRINT_DEBUG("other");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nCreatorAppID != settings->get_local_game_id().AppID() || nConsumerAppID != settings->get_local_game_id().AppID()) return k_UGCQueryHandleInvalid;
     if (eQueryType < 0) return k_UGCQueryHandleInvalid;
@@ -211,7 +211,7 @@ UGCQueryHandle_t Steam_UGC::CreateQueryAllUGCRequest( EUGCQuery eQueryType, EUGC
 UGCQueryHandle_t Steam_UGC::CreateQueryUGCDetailsRequest( PublishedFileId_t *pvecPublishedFileID, uint32 unNumPublishedFileIDs )
 {
     PRINT_DEBUG("%p, max file IDs = [%u]", pvecPublishedFileID, unNumPublishedFileIDs);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pvecPublishedFileID) return k_UGCQueryHandleInvalid;
     if (unNumPublishedFileIDs < 1) return k_UGCQueryHandleInvalid;
@@ -234,7 +234,7 @@ STEAM_CALL_RESULT( SteamUGCQueryCompleted_t )
 SteamAPICall_t Steam_UGC::SendQueryUGCRequest( UGCQueryHandle_t handle )
 {
     PRINT_DEBUG("%llu", handle);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return k_uAPICallInvalid;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -278,7 +278,7 @@ SteamAPICall_t Steam_UGC::SendQueryUGCRequest( UGCQueryHandle_t handle )
 bool Steam_UGC::GetQueryUGCResult( UGCQueryHandle_t handle, uint32 index, SteamUGCDetails_t *pDetails )
 {
     PRINT_DEBUG("%llu %u %p", handle, index, pDetails);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -314,7 +314,7 @@ uint32 Steam_UGC::GetQueryUGCNumTags( UGCQueryHandle_t handle, uint32 index )
 {
     PRINT_DEBUG_TODO();
     // TODO is this correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return 0;
     
     auto res = get_query_ugc_tags(handle, index);
@@ -325,7 +325,7 @@ bool Steam_UGC::GetQueryUGCTag( UGCQueryHandle_t handle, uint32 index, uint32 in
 {
     PRINT_DEBUG_TODO();
     // TODO is this correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
     if (!pchValue || !cchValueSize) return false;
 
@@ -341,7 +341,7 @@ bool Steam_UGC::GetQueryUGCTagDisplayName( UGCQueryHandle_t handle, uint32 index
 {
     PRINT_DEBUG_TODO();
     // TODO is this correct?
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
     if (!pchValue || !cchValueSize) return false;
 
@@ -356,7 +356,7 @@ bool Steam_UGC::GetQueryUGCTagDisplayName( UGCQueryHandle_t handle, uint32 index
 bool Steam_UGC::GetQueryUGCPreviewURL( UGCQueryHandle_t handle, uint32 index, STEAM_OUT_STRING_COUNT(cchURLSize) char *pchURL, uint32 cchURLSize )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     //TODO: escape simulator tries downloading this url and unsubscribes if it fails
     if (handle == k_UGCQueryHandleInvalid) return false;
     if (!pchURL || !cchURLSize) return false;
@@ -375,7 +375,7 @@ bool Steam_UGC::GetQueryUGCPreviewURL( UGCQueryHandle_t handle, uint32 index, ST
 bool Steam_UGC::GetQueryUGCMetadata( UGCQueryHandle_t handle, uint32 index, STEAM_OUT_STRING_COUNT(cchMetadatasize) char *pchMetadata, uint32 cchMetadatasize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -388,7 +388,7 @@ bool Steam_UGC::GetQueryUGCMetadata( UGCQueryHandle_t handle, uint32 index, STEA
 bool Steam_UGC::GetQueryUGCChildren( UGCQueryHandle_t handle, uint32 index, PublishedFileId_t* pvecPublishedFileID, uint32 cMaxEntries )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -401,7 +401,7 @@ bool Steam_UGC::GetQueryUGCChildren( UGCQueryHandle_t handle, uint32 index, Publ
 bool Steam_UGC::GetQueryUGCStatistic( UGCQueryHandle_t handle, uint32 index, EItemStatistic eStatType, uint64 *pStatValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -413,7 +413,7 @@ bool Steam_UGC::GetQueryUGCStatistic( UGCQueryHandle_t handle, uint32 index, EIt
 bool Steam_UGC::GetQueryUGCStatistic( UGCQueryHandle_t handle, uint32 index, EItemStatistic eStatType, uint32 *pStatValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -425,7 +425,7 @@ bool Steam_UGC::GetQueryUGCStatistic( UGCQueryHandle_t handle, uint32 index, EIt
 uint32 Steam_UGC::GetQueryUGCNumAdditionalPreviews( UGCQueryHandle_t handle, uint32 index )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return 0;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -438,7 +438,7 @@ uint32 Steam_UGC::GetQueryUGCNumAdditionalPreviews( UGCQueryHandle_t handle, uin
 bool Steam_UGC::GetQueryUGCAdditionalPreview( UGCQueryHandle_t handle, uint32 index, uint32 previewIndex, STEAM_OUT_STRING_COUNT(cchURLSize) char *pchURLOrVideoID, uint32 cchURLSize, STEAM_OUT_STRING_COUNT(cchURLSize) char *pchOriginalFileName, uint32 cchOriginalFileNameSize, EItemPreviewType *pPreviewType )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -450,7 +450,7 @@ bool Steam_UGC::GetQueryUGCAdditionalPreview( UGCQueryHandle_t handle, uint32 in
 bool Steam_UGC::GetQueryUGCAdditionalPreview( UGCQueryHandle_t handle, uint32 index, uint32 previewIndex, char *pchURLOrVideoID, uint32 cchURLSize, bool *hz )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -462,7 +462,7 @@ bool Steam_UGC::GetQueryUGCAdditionalPreview( UGCQueryHandle_t handle, uint32 in
 uint32 Steam_UGC::GetQueryUGCNumKeyValueTags( UGCQueryHandle_t handle, uint32 index )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return 0;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -475,7 +475,7 @@ uint32 Steam_UGC::GetQueryUGCNumKeyValueTags( UGCQueryHandle_t handle, uint32 in
 bool Steam_UGC::GetQueryUGCKeyValueTag( UGCQueryHandle_t handle, uint32 index, uint32 keyValueTagIndex, STEAM_OUT_STRING_COUNT(cchKeySize) char *pchKey, uint32 cchKeySize, STEAM_OUT_STRING_COUNT(cchValueSize) char *pchValue, uint32 cchValueSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -487,7 +487,7 @@ bool Steam_UGC::GetQueryUGCKeyValueTag( UGCQueryHandle_t handle, uint32 index, u
 bool Steam_UGC::GetQueryUGCKeyValueTag( UGCQueryHandle_t handle, uint32 index, const char *pchKey, STEAM_OUT_STRING_COUNT(cchValueSize) char *pchValue, uint32 cchValueSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -501,7 +501,7 @@ bool Steam_UGC::GetQueryUGCKeyValueTag( UGCQueryHandle_t handle, uint32 index, c
 uint32 Steam_UGC::GetNumSupportedGameVersions( UGCQueryHandle_t handle, uint32 index )
 {
     PRINT_DEBUG("%llu %u // TODO", handle, index);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return 0;
 
     auto res = get_query_ugc(handle, index);
@@ -514,7 +514,7 @@ uint32 Steam_UGC::GetNumSupportedGameVersions( UGCQueryHandle_t handle, uint32 i
 bool Steam_UGC::GetSupportedGameVersionData( UGCQueryHandle_t handle, uint32 index, uint32 versionIndex, STEAM_OUT_STRING_COUNT( cchGameBranchSize ) char *pchGameBranchMin, STEAM_OUT_STRING_COUNT( cchGameBranchSize ) char *pchGameBranchMax, uint32 cchGameBranchSize )
 {
     PRINT_DEBUG("%llu %u %u // TODO", handle, index, versionIndex);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     if (versionIndex != 0) { // TODO I assume this is supposed to be an index in the range [ 0, GetNumSupportedGameVersions() )
@@ -542,7 +542,7 @@ bool Steam_UGC::GetSupportedGameVersionData( UGCQueryHandle_t handle, uint32 ind
 uint32 Steam_UGC::GetQueryUGCContentDescriptors( UGCQueryHandle_t handle, uint32 index, EUGCContentDescriptorID *pvecDescriptors, uint32 cMaxEntries )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return 0;
 
     auto res = get_query_ugc(handle, index);
@@ -555,7 +555,7 @@ uint32 Steam_UGC::GetQueryUGCContentDescriptors( UGCQueryHandle_t handle, uint32
 bool Steam_UGC::ReleaseQueryUGCRequest( UGCQueryHandle_t handle )
 {
     PRINT_DEBUG("%llu", handle);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -570,7 +570,7 @@ bool Steam_UGC::ReleaseQueryUGCRequest( UGCQueryHandle_t handle )
 bool Steam_UGC::AddRequiredTag( UGCQueryHandle_t handle, const char *pTagName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -582,7 +582,7 @@ bool Steam_UGC::AddRequiredTag( UGCQueryHandle_t handle, const char *pTagName )
 bool Steam_UGC::AddRequiredTagGroup( UGCQueryHandle_t handle, const SteamParamStringArray_t *pTagGroups )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -594,7 +594,7 @@ bool Steam_UGC::AddRequiredTagGroup( UGCQueryHandle_t handle, const SteamParamSt
 bool Steam_UGC::AddExcludedTag( UGCQueryHandle_t handle, const char *pTagName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -607,7 +607,7 @@ bool Steam_UGC::AddExcludedTag( UGCQueryHandle_t handle, const char *pTagName )
 bool Steam_UGC::SetReturnOnlyIDs( UGCQueryHandle_t handle, bool bReturnOnlyIDs )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -644,7 +644,7 @@ bool Steam_UGC::SetReturnLongDescription( UGCQueryHandle_t handle, bool bReturnL
 bool Steam_UGC::SetReturnMetadata( UGCQueryHandle_t handle, bool bReturnMetadata )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -657,7 +657,7 @@ bool Steam_UGC::SetReturnMetadata( UGCQueryHandle_t handle, bool bReturnMetadata
 bool Steam_UGC::SetReturnChildren( UGCQueryHandle_t handle, bool bReturnChildren )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -670,7 +670,7 @@ bool Steam_UGC::SetReturnChildren( UGCQueryHandle_t handle, bool bReturnChildren
 bool Steam_UGC::SetReturnAdditionalPreviews( UGCQueryHandle_t handle, bool bReturnAdditionalPreviews )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -683,7 +683,7 @@ bool Steam_UGC::SetReturnAdditionalPreviews( UGCQueryHandle_t handle, bool bRetu
 bool Steam_UGC::SetReturnTotalOnly( UGCQueryHandle_t handle, bool bReturnTotalOnly )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -696,7 +696,7 @@ bool Steam_UGC::SetReturnTotalOnly( UGCQueryHandle_t handle, bool bReturnTotalOn
 bool Steam_UGC::SetReturnPlaytimeStats( UGCQueryHandle_t handle, uint32 unDays )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -709,7 +709,7 @@ bool Steam_UGC::SetReturnPlaytimeStats( UGCQueryHandle_t handle, uint32 unDays )
 bool Steam_UGC::SetLanguage( UGCQueryHandle_t handle, const char *pchLanguage )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -722,7 +722,7 @@ bool Steam_UGC::SetLanguage( UGCQueryHandle_t handle, const char *pchLanguage )
 bool Steam_UGC::SetAllowCachedResponse( UGCQueryHandle_t handle, uint32 unMaxAgeSeconds )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -736,7 +736,7 @@ bool Steam_UGC::SetAllowCachedResponse( UGCQueryHandle_t handle, uint32 unMaxAge
 bool Steam_UGC::SetAdminQuery( UGCUpdateHandle_t handle, bool bAdminQuery )
 {
     PRINT_DEBUG("%llu %i // TODO", handle, (int)bAdminQuery);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -751,7 +751,7 @@ bool Steam_UGC::SetAdminQuery( UGCUpdateHandle_t handle, bool bAdminQuery )
 bool Steam_UGC::SetCloudFileNameFilter( UGCQueryHandle_t handle, const char *pMatchCloudFileName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -765,7 +765,7 @@ bool Steam_UGC::SetCloudFileNameFilter( UGCQueryHandle_t handle, const char *pMa
 bool Steam_UGC::SetMatchAnyTag( UGCQueryHandle_t handle, bool bMatchAnyTag )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -778,7 +778,7 @@ bool Steam_UGC::SetMatchAnyTag( UGCQueryHandle_t handle, bool bMatchAnyTag )
 bool Steam_UGC::SetSearchText( UGCQueryHandle_t handle, const char *pSearchText )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -791,7 +791,7 @@ bool Steam_UGC::SetSearchText( UGCQueryHandle_t handle, const char *pSearchText
 bool Steam_UGC::SetRankedByTrendDays( UGCQueryHandle_t handle, uint32 unDays )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -804,7 +804,7 @@ bool Steam_UGC::SetRankedByTrendDays( UGCQueryHandle_t handle, uint32 unDays )
 bool Steam_UGC::AddRequiredKeyValueTag( UGCQueryHandle_t handle, const char *pKey, const char *pValue )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -816,7 +816,7 @@ bool Steam_UGC::AddRequiredKeyValueTag( UGCQueryHandle_t handle, const char *pKe
 bool Steam_UGC::SetTimeCreatedDateRange( UGCQueryHandle_t handle, RTime32 rtStart, RTime32 rtEnd )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -828,7 +828,7 @@ bool Steam_UGC::SetTimeCreatedDateRange( UGCQueryHandle_t handle, RTime32 rtStar
 bool Steam_UGC::SetTimeUpdatedDateRange( UGCQueryHandle_t handle, RTime32 rtStart, RTime32 rtEnd )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (handle == k_UGCQueryHandleInvalid) return false;
 
     auto request = std::find_if(ugc_queries.begin(), ugc_queries.end(), [&handle](struct UGC_query const& item) { return item.handle == handle; });
@@ -841,7 +841,7 @@ bool Steam_UGC::SetTimeUpdatedDateRange( UGCQueryHandle_t handle, RTime32 rtStar
 SteamAPICall_t Steam_UGC::RequestUGCDetails( PublishedFileId_t nPublishedFileID, uint32 unMaxAgeSeconds )
 {
     PRINT_DEBUG("%llu", nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     SteamUGCRequestUGCDetailsResult_t data{};
     data.m_bCachedData = false;
@@ -863,7 +863,7 @@ STEAM_CALL_RESULT( CreateItemResult_t )
 SteamAPICall_t Steam_UGC::CreateItem( AppId_t nConsumerAppId, EWorkshopFileType eFileType )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -873,7 +873,7 @@ SteamAPICall_t Steam_UGC::CreateItem( AppId_t nConsumerAppId, EWorkshopFileType
 UGCUpdateHandle_t Steam_UGC::StartItemUpdate( AppId_t nConsumerAppId, PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_UGCUpdateHandleInvalid;
 }
@@ -883,7 +883,7 @@ UGCUpdateHandle_t Steam_UGC::StartItemUpdate( AppId_t nConsumerAppId, PublishedF
 bool Steam_UGC::SetItemTitle( UGCUpdateHandle_t handle, const char *pchTitle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -893,7 +893,7 @@ bool Steam_UGC::SetItemTitle( UGCUpdateHandle_t handle, const char *pchTitle )
 bool Steam_UGC::SetItemDescription( UGCUpdateHandle_t handle, const char *pchDescription )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -903,7 +903,7 @@ bool Steam_UGC::SetItemDescription( UGCUpdateHandle_t handle, const char *pchDes
 bool Steam_UGC::SetItemUpdateLanguage( UGCUpdateHandle_t handle, const char *pchLanguage )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -913,7 +913,7 @@ bool Steam_UGC::SetItemUpdateLanguage( UGCUpdateHandle_t handle, const char *pch
 bool Steam_UGC::SetItemMetadata( UGCUpdateHandle_t handle, const char *pchMetaData )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -923,7 +923,7 @@ bool Steam_UGC::SetItemMetadata( UGCUpdateHandle_t handle, const char *pchMetaDa
 bool Steam_UGC::SetItemVisibility( UGCUpdateHandle_t handle, ERemoteStoragePublishedFileVisibility eVisibility )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -933,7 +933,7 @@ bool Steam_UGC::SetItemVisibility( UGCUpdateHandle_t handle, ERemoteStoragePubli
 bool Steam_UGC::SetItemTags( UGCUpdateHandle_t updateHandle, const SteamParamStringArray_t *pTags )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -941,7 +941,7 @@ bool Steam_UGC::SetItemTags( UGCUpdateHandle_t updateHandle, const SteamParamStr
 bool Steam_UGC::SetItemTags( UGCUpdateHandle_t updateHandle, const SteamParamStringArray_t *pTags, bool bAllowAdminTags )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -950,7 +950,7 @@ bool Steam_UGC::SetItemTags( UGCUpdateHandle_t updateHandle, const SteamParamStr
 bool Steam_UGC::SetItemContent( UGCUpdateHandle_t handle, const char *pszContentFolder )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -960,7 +960,7 @@ bool Steam_UGC::SetItemContent( UGCUpdateHandle_t handle, const char *pszContent
 bool Steam_UGC::SetItemPreview( UGCUpdateHandle_t handle, const char *pszPreviewFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -969,7 +969,7 @@ bool Steam_UGC::SetItemPreview( UGCUpdateHandle_t handle, const char *pszPreview
 bool Steam_UGC::SetAllowLegacyUpload( UGCUpdateHandle_t handle, bool bAllowLegacyUpload )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -977,7 +977,7 @@ bool Steam_UGC::SetAllowLegacyUpload( UGCUpdateHandle_t handle, bool bAllowLegac
 bool Steam_UGC::RemoveAllItemKeyValueTags( UGCUpdateHandle_t handle )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -986,7 +986,7 @@ bool Steam_UGC::RemoveAllItemKeyValueTags( UGCUpdateHandle_t handle )
 bool Steam_UGC::RemoveItemKeyValueTags( UGCUpdateHandle_t handle, const char *pchKey )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -996,7 +996,7 @@ bool Steam_UGC::RemoveItemKeyValueTags( UGCUpdateHandle_t handle, const char *pc
 bool Steam_UGC::AddItemKeyValueTag( UGCUpdateHandle_t handle, const char *pchKey, const char *pchValue )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1006,7 +1006,7 @@ bool Steam_UGC::AddItemKeyValueTag( UGCUpdateHandle_t handle, const char *pchKey
 bool Steam_UGC::AddItemPreviewFile( UGCUpdateHandle_t handle, const char *pszPreviewFile, EItemPreviewType type )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1016,7 +1016,7 @@ bool Steam_UGC::AddItemPreviewFile( UGCUpdateHandle_t handle, const char *pszPre
 bool Steam_UGC::AddItemPreviewVideo( UGCUpdateHandle_t handle, const char *pszVideoID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1026,7 +1026,7 @@ bool Steam_UGC::AddItemPreviewVideo( UGCUpdateHandle_t handle, const char *pszVi
 bool Steam_UGC::UpdateItemPreviewFile( UGCUpdateHandle_t handle, uint32 index, const char *pszPreviewFile )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1036,7 +1036,7 @@ bool Steam_UGC::UpdateItemPreviewFile( UGCUpdateHandle_t handle, uint32 index, c
 bool Steam_UGC::UpdateItemPreviewVideo( UGCUpdateHandle_t handle, uint32 index, const char *pszVideoID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1046,7 +1046,7 @@ bool Steam_UGC::UpdateItemPreviewVideo( UGCUpdateHandle_t handle, uint32 index,
 bool Steam_UGC::RemoveItemPreview( UGCUpdateHandle_t handle, uint32 index )
 {
     PRINT_DEBUG("%llu %u", handle, index);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1055,7 +1055,7 @@ bool Steam_UGC::RemoveItemPreview( UGCUpdateHandle_t handle, uint32 index )
 bool Steam_UGC::AddContentDescriptor( UGCUpdateHandle_t handle, EUGCContentDescriptorID descid )
 {
     PRINT_DEBUG("%llu %u", handle, descid);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1063,7 +1063,7 @@ bool Steam_UGC::AddContentDescriptor( UGCUpdateHandle_t handle, EUGCContentDescr
 bool Steam_UGC::RemoveContentDescriptor( UGCUpdateHandle_t handle, EUGCContentDescriptorID descid )
 {
     PRINT_DEBUG("%llu %u", handle, descid);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1072,7 +1072,7 @@ bool Steam_UGC::RemoveContentDescriptor( UGCUpdateHandle_t handle, EUGCContentDe
 bool Steam_UGC::SetRequiredGameVersions( UGCUpdateHandle_t handle, const char *pszGameBranchMin, const char *pszGameBranchMax )
 {
     PRINT_DEBUG("%llu '%s' '%s' // TODO", handle, pszGameBranchMin, pszGameBranchMax);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (handle == k_UGCQueryHandleInvalid) return false;
 
@@ -1088,7 +1088,7 @@ STEAM_CALL_RESULT( SubmitItemUpdateResult_t )
 SteamAPICall_t Steam_UGC::SubmitItemUpdate( UGCUpdateHandle_t handle, const char *pchChangeNote )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -1098,7 +1098,7 @@ SteamAPICall_t Steam_UGC::SubmitItemUpdate( UGCUpdateHandle_t handle, const char
 EItemUpdateStatus Steam_UGC::GetItemUpdateProgress( UGCUpdateHandle_t handle, uint64 *punBytesProcessed, uint64* punBytesTotal )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_EItemUpdateStatusInvalid;
 }
@@ -1110,7 +1110,7 @@ STEAM_CALL_RESULT( SetUserItemVoteResult_t )
 SteamAPICall_t Steam_UGC::SetUserItemVote( PublishedFileId_t nPublishedFileID, bool bVoteUp )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!settings->isModInstalled(nPublishedFileID)) return k_uAPICallInvalid; // TODO is this correct
     
     auto mod  = settings->getMod(nPublishedFileID);
@@ -1131,7 +1131,7 @@ STEAM_CALL_RESULT( GetUserItemVoteResult_t )
 SteamAPICall_t Steam_UGC::GetUserItemVote( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (nPublishedFileID == k_PublishedFileIdInvalid || !settings->isModInstalled(nPublishedFileID)) return k_uAPICallInvalid; // TODO is this correct
 
     auto mod  = settings->getMod(nPublishedFileID);
@@ -1149,7 +1149,7 @@ STEAM_CALL_RESULT( UserFavoriteItemsListChanged_t )
 SteamAPICall_t Steam_UGC::AddItemToFavorites( AppId_t nAppId, PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG("%u %llu", nAppId, nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (nAppId == k_uAppIdInvalid || nAppId != settings->get_local_game_id().AppID()) return k_uAPICallInvalid; // TODO is this correct
     if (nPublishedFileID == k_PublishedFileIdInvalid || !settings->isModInstalled(nPublishedFileID)) return k_uAPICallInvalid; // TODO is this correct
 
@@ -1174,7 +1174,7 @@ STEAM_CALL_RESULT( UserFavoriteItemsListChanged_t )
 SteamAPICall_t Steam_UGC::RemoveItemFromFavorites( AppId_t nAppId, PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (nAppId == k_uAppIdInvalid || nAppId != settings->get_local_game_id().AppID()) return k_uAPICallInvalid; // TODO is this correct
     if (nPublishedFileID == k_PublishedFileIdInvalid || !settings->isModInstalled(nPublishedFileID)) return k_uAPICallInvalid; // TODO is this correct
 
@@ -1199,7 +1199,7 @@ STEAM_CALL_RESULT( RemoteStorageSubscribePublishedFileResult_t )
 SteamAPICall_t Steam_UGC::SubscribeItem( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG("%llu", nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     RemoteStorageSubscribePublishedFileResult_t data;
     data.m_nPublishedFileId = nPublishedFileID;
@@ -1217,7 +1217,7 @@ STEAM_CALL_RESULT( RemoteStorageUnsubscribePublishedFileResult_t )
 SteamAPICall_t Steam_UGC::UnsubscribeItem( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG("%llu", nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     RemoteStorageUnsubscribePublishedFileResult_t data;
     data.m_nPublishedFileId = nPublishedFileID;
@@ -1235,7 +1235,7 @@ SteamAPICall_t Steam_UGC::UnsubscribeItem( PublishedFileId_t nPublishedFileID )
 uint32 Steam_UGC::GetNumSubscribedItems()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     PRINT_DEBUG("  Steam_UGC::GetNumSubscribedItems = %zu", ugc_bridge->subbed_mods_count());
     return (uint32)ugc_bridge->subbed_mods_count();
@@ -1245,7 +1245,7 @@ uint32 Steam_UGC::GetNumSubscribedItems()
 uint32 Steam_UGC::GetSubscribedItems( PublishedFileId_t* pvecPublishedFileID, uint32 cMaxEntries )
 {
     PRINT_DEBUG("%p %u", pvecPublishedFileID, cMaxEntries);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if ((size_t)cMaxEntries > ugc_bridge->subbed_mods_count()) {
         cMaxEntries = (uint32)ugc_bridge->subbed_mods_count();
     }
@@ -1259,7 +1259,7 @@ uint32 Steam_UGC::GetSubscribedItems( PublishedFileId_t* pvecPublishedFileID, ui
 uint32 Steam_UGC::GetItemState( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG("%llu", nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (ugc_bridge->has_subbed_mod(nPublishedFileID)) {
         if (settings->isModInstalled(nPublishedFileID)) {
             PRINT_DEBUG("  mod is subscribed and installed");
@@ -1280,7 +1280,7 @@ uint32 Steam_UGC::GetItemState( PublishedFileId_t nPublishedFileID )
 bool Steam_UGC::GetItemInstallInfo( PublishedFileId_t nPublishedFileID, uint64 *punSizeOnDisk, STEAM_OUT_STRING_COUNT( cchFolderSize ) char *pchFolder, uint32 cchFolderSize, uint32 *punTimeStamp )
 {
     PRINT_DEBUG("%llu %p %p [%u] %p", nPublishedFileID, punSizeOnDisk, pchFolder, cchFolderSize, punTimeStamp);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!cchFolderSize) return false;
     if (!settings->isModInstalled(nPublishedFileID)) return false;
 
@@ -1309,7 +1309,7 @@ bool Steam_UGC::GetItemInstallInfo( PublishedFileId_t nPublishedFileID, uint64 *
 bool Steam_UGC::GetItemDownloadInfo( PublishedFileId_t nPublishedFileID, uint64 *punBytesDownloaded, uint64 *punBytesTotal )
 {
     PRINT_DEBUG("%llu", nPublishedFileID);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!settings->isModInstalled(nPublishedFileID)) return false;
 
     auto mod = settings->getMod(nPublishedFileID);
@@ -1327,7 +1327,7 @@ bool Steam_UGC::GetItemInstallInfo( PublishedFileId_t nPublishedFileID, uint64 *
 bool Steam_UGC::GetItemUpdateInfo( PublishedFileId_t nPublishedFileID, bool *pbNeedsUpdate, bool *pbIsDownloading, uint64 *punBytesDownloaded, uint64 *punBytesTotal )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     bool res = GetItemDownloadInfo(nPublishedFileID, punBytesDownloaded, punBytesTotal);
     if (res) {
         if (pbNeedsUpdate) *pbNeedsUpdate = false;
@@ -1349,7 +1349,7 @@ bool Steam_UGC::GetItemInstallInfo( PublishedFileId_t nPublishedFileID, uint64 *
 bool Steam_UGC::DownloadItem( PublishedFileId_t nPublishedFileID, bool bHighPriority )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return false;
 }
@@ -1360,7 +1360,7 @@ bool Steam_UGC::DownloadItem( PublishedFileId_t nPublishedFileID, bool bHighPrio
 bool Steam_UGC::BInitWorkshopForGameServer( DepotId_t unWorkshopDepotID, const char *pszFolder )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1370,7 +1370,7 @@ bool Steam_UGC::BInitWorkshopForGameServer( DepotId_t unWorkshopDepotID, const c
 void Steam_UGC::SuspendDownloads( bool bSuspend )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
 }
 
@@ -1380,7 +1380,7 @@ STEAM_CALL_RESULT( StartPlaytimeTrackingResult_t )
 SteamAPICall_t Steam_UGC::StartPlaytimeTracking( PublishedFileId_t *pvecPublishedFileID, uint32 unNumPublishedFileIDs )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     StopPlaytimeTrackingResult_t data;
     data.m_eResult = k_EResultOK;
     return callback_results->addCallResult(data.k_iCallback, &data, sizeof(data));
@@ -1390,7 +1390,7 @@ STEAM_CALL_RESULT( StopPlaytimeTrackingResult_t )
 SteamAPICall_t Steam_UGC::StopPlaytimeTracking( PublishedFileId_t *pvecPublishedFileID, uint32 unNumPublishedFileIDs )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     StopPlaytimeTrackingResult_t data;
     data.m_eResult = k_EResultOK;
     return callback_results->addCallResult(data.k_iCallback, &data, sizeof(data));
@@ -1400,7 +1400,7 @@ STEAM_CALL_RESULT( StopPlaytimeTrackingResult_t )
 SteamAPICall_t Steam_UGC::StopPlaytimeTrackingForAllItems()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     StopPlaytimeTrackingResult_t data;
     data.m_eResult = k_EResultOK;
     return callback_results->addCallResult(data.k_iCallback, &data, sizeof(data));
@@ -1412,7 +1412,7 @@ STEAM_CALL_RESULT( AddUGCDependencyResult_t )
 SteamAPICall_t Steam_UGC::AddDependency( PublishedFileId_t nParentPublishedFileID, PublishedFileId_t nChildPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nParentPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1423,7 +1423,7 @@ STEAM_CALL_RESULT( RemoveUGCDependencyResult_t )
 SteamAPICall_t Steam_UGC::RemoveDependency( PublishedFileId_t nParentPublishedFileID, PublishedFileId_t nChildPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nParentPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1436,7 +1436,7 @@ STEAM_CALL_RESULT( AddAppDependencyResult_t )
 SteamAPICall_t Steam_UGC::AddAppDependency( PublishedFileId_t nPublishedFileID, AppId_t nAppID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1447,7 +1447,7 @@ STEAM_CALL_RESULT( RemoveAppDependencyResult_t )
 SteamAPICall_t Steam_UGC::RemoveAppDependency( PublishedFileId_t nPublishedFileID, AppId_t nAppID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1460,7 +1460,7 @@ STEAM_CALL_RESULT( GetAppDependenciesResult_t )
 SteamAPICall_t Steam_UGC::GetAppDependencies( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1473,7 +1473,7 @@ STEAM_CALL_RESULT( DeleteItemResult_t )
 SteamAPICall_t Steam_UGC::DeleteItem( PublishedFileId_t nPublishedFileID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (nPublishedFileID == k_PublishedFileIdInvalid) return k_uAPICallInvalid;
     
@@ -1484,7 +1484,7 @@ SteamAPICall_t Steam_UGC::DeleteItem( PublishedFileId_t nPublishedFileID )
 bool Steam_UGC::ShowWorkshopEULA()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return false;
 }
@@ -1494,7 +1494,7 @@ STEAM_CALL_RESULT( WorkshopEULAStatus_t )
 SteamAPICall_t Steam_UGC::GetWorkshopEULAStatus()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return k_uAPICallInvalid;
 }
@@ -1503,7 +1503,7 @@ SteamAPICall_t Steam_UGC::GetWorkshopEULAStatus()
 uint32 Steam_UGC::GetUserContentDescriptorPreferences( EUGCContentDescriptorID *pvecDescriptors, uint32 cMaxEntries )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     return 0;
 }
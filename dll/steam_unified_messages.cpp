@@ -59,7 +59,7 @@ Steam_Unified_Messages::~Steam_Unified_Messages()
 ClientUnifiedMessageHandle Steam_Unified_Messages::SendMethod( const char *pchServiceMethod, const void *pRequestBuffer, uint32 unRequestBufferSize, uint64 unContext )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return ISteamUnifiedMessages::k_InvalidUnifiedMessageHandle;
 }
 
@@ -68,7 +68,7 @@ ClientUnifiedMessageHandle Steam_Unified_Messages::SendMethod( const char *pchSe
 bool Steam_Unified_Messages::GetMethodResponseInfo( ClientUnifiedMessageHandle hHandle, uint32 *punResponseSize, EResult *peResult )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -77,7 +77,7 @@ bool Steam_Unified_Messages::GetMethodResponseInfo( ClientUnifiedMessageHandle h
 bool Steam_Unified_Messages::GetMethodResponseData( ClientUnifiedMessageHandle hHandle, void *pResponseBuffer, uint32 unResponseBufferSize, bool bAutoRelease )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -86,7 +86,7 @@ bool Steam_Unified_Messages::GetMethodResponseData( ClientUnifiedMessageHandle h
 bool Steam_Unified_Messages::ReleaseMethod( ClientUnifiedMessageHandle hHandle )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -96,7 +96,7 @@ bool Steam_Unified_Messages::ReleaseMethod( ClientUnifiedMessageHandle hHandle )
 bool Steam_Unified_Messages::SendNotification( const char *pchServiceNotification, const void *pNotificationBuffer, uint32 unNotificationBufferSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
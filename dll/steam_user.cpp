@@ -85,7 +85,7 @@ CSteamID Steam_User::GetSteamID()
 int Steam_User::InitiateGameConnection( void *pAuthBlob, int cbMaxAuthBlob, CSteamID steamIDGameServer, uint32 unIPServer, uint16 usPortServer, bool bSecure )
 {
     PRINT_DEBUG("%i %llu %u %u %u %p", cbMaxAuthBlob, steamIDGameServer.ConvertToUint64(), unIPServer, usPortServer, bSecure, pAuthBlob);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (cbMaxAuthBlob < INITIATE_GAME_CONNECTION_TICKET_SIZE) return 0;
     if (!pAuthBlob) return 0;
     uint32 out_size = INITIATE_GAME_CONNECTION_TICKET_SIZE;
@@ -284,7 +284,7 @@ HAuthTicket Steam_User::GetAuthSessionTicket( void *pTicket, int cbMaxTicket, ui
 HAuthTicket Steam_User::GetAuthSessionTicket( void *pTicket, int cbMaxTicket, uint32 *pcbTicket, const SteamNetworkingIdentity *pSteamNetworkingIdentity )
 {
     PRINT_DEBUG("%p [%i] %p", pTicket, cbMaxTicket, pcbTicket);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pTicket) return k_HAuthTicketInvalid;
     
@@ -297,7 +297,7 @@ HAuthTicket Steam_User::GetAuthSessionTicket( void *pTicket, int cbMaxTicket, ui
 HAuthTicket Steam_User::GetAuthTicketForWebApi( const char *pchIdentity )
 {
     PRINT_DEBUG("%s", pchIdentity);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return auth_manager->getWebApiTicket(pchIdentity);
 }
@@ -307,7 +307,7 @@ HAuthTicket Steam_User::GetAuthTicketForWebApi( const char *pchIdentity )
 EBeginAuthSessionResult Steam_User::BeginAuthSession( const void *pAuthTicket, int cbAuthTicket, CSteamID steamID )
 {
     PRINT_DEBUG("%i %llu", cbAuthTicket, steamID.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return auth_manager->beginAuth(pAuthTicket, cbAuthTicket, steamID);
 }
@@ -316,7 +316,7 @@ EBeginAuthSessionResult Steam_User::BeginAuthSession( const void *pAuthTicket, i
 void Steam_User::EndAuthSession( CSteamID steamID )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auth_manager->endAuth(steamID);
 }
@@ -325,7 +325,7 @@ void Steam_User::EndAuthSession( CSteamID steamID )
 void Steam_User::CancelAuthTicket( HAuthTicket hAuthTicket )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auth_manager->cancelTicket(hAuthTicket);
 }
@@ -352,7 +352,7 @@ bool Steam_User::BIsBehindNAT()
 void Steam_User::AdvertiseGame( CSteamID steamIDGameServer, uint32 unIPServer, uint16 usPortServer )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Gameserver *server = new Gameserver();
     server->set_id(steamIDGameServer.ConvertToUint64());
     server->set_ip(unIPServer);
@@ -378,7 +378,7 @@ STEAM_CALL_RESULT( EncryptedAppTicketResponse_t )
 SteamAPICall_t Steam_User::RequestEncryptedAppTicket( void *pDataToInclude, int cbDataToInclude )
 {
     PRINT_DEBUG("%i", cbDataToInclude);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     EncryptedAppTicketResponse_t data;
 	data.m_eResult = k_EResultOK;
 
@@ -18,6 +18,17 @@
 #include "dll/steam_user_stats.h"
 #include <random>
 
+// layout of stats_store_file:
+// header: magic, u32 version, u32 count of stats, u32 FNV-1a checksum of everything after the header
+// stat:   u16 name size + name, u16 data size + data
+// the data of a stat is what its file in the old layout had: an int32 or a float,
+// or for STAT_TYPE_AVGRATE the float average + float count + double session length
+static constexpr const char stats_store_magic[8] = { 'E', 'M', 'U', 'S', 'T', 'A', 'T', 'S' };
+#define STATS_STORE_VERSION 1
+#define STATS_STORE_HEADER_SIZE (sizeof(stats_store_magic) + sizeof(uint32) * 3)
+// changed stats are serialized at most this often unless StoreStats() is called
+#define STATS_STORE_SAVE_DELAY_SECONDS 5
+
 
 // --- Steam_Leaderboard ---
 
@@ -110,10 +121,92 @@ bool achievement_trigger::should_indicate_progress(int32 stat) const
 
 
 
+// --- Achievement_Definitions ---
+
+size_t Achievement_Name_Hash::operator()(std::string_view name) const
+{
+    // FNV-1a of the upper case name
+    size_t hash = 2166136261u;
+    for (const char c : name) {
+        hash ^= (size_t)(unsigned char)std::toupper((unsigned char)c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool Achievement_Name_Equal::operator()(std::string_view lhs, std::string_view rhs) const
+{
+    return common_helpers::str_cmp_insensitive(lhs, rhs);
+}
+
+int Achievement_Definitions::find(std::string_view name) const
+{
+    auto it = index.find(name);
+    if (index.end() == it) return -1;
+    return (int)it->second;
+}
+
+size_t Achievement_Definitions::size() const
+{
+    return names.size();
+}
+
+// --- Achievement_Definitions ---
+
+
+
 void Steam_User_Stats::load_achievements_db()
 {
     std::string file_path = Local_Storage::get_game_settings_path() + achievements_user_file;
     local_storage->load_json(file_path, defined_achievements);
+
+    auto x = defined_achievements.begin();
+    while (x != defined_achievements.end()) {
+        if (!x->contains("name")) {
+            x = defined_achievements.erase(x);
+        } else {
+            ++x;
+        }
+    }
+
+    auto &defs = achievement_definitions;
+    defs.names.reserve(defined_achievements.size());
+    defs.display_names.reserve(defined_achievements.size());
+    defs.descriptions.reserve(defined_achievements.size());
+    defs.hidden.reserve(defined_achievements.size());
+    defs.icons.reserve(defined_achievements.size());
+    defs.icons_gray.reserve(defined_achievements.size());
+    for (auto &it : defined_achievements) {
+        try {
+            it["hidden"] = std::to_string(it["hidden"].get<int>());
+        } catch(...) {}
+
+        it["displayName"] = get_value_for_language(it, "displayName", settings->get_language());
+        it["description"] = get_value_for_language(it, "description", settings->get_language());
+
+        auto string_value = [&it](const char *key) {
+            auto value = it.find(key);
+            if (it.end() == value || !value->is_string()) return std::string();
+            return value->get<std::string>();
+        };
+        defs.names.push_back(string_value("name"));
+        defs.display_names.push_back(string_value("displayName"));
+        defs.descriptions.push_back(string_value("description"));
+        defs.hidden.push_back(string_value("hidden"));
+        defs.icons.push_back(string_value("icon"));
+        std::string icon_gray = string_value("icon_gray");
+        if (icon_gray.empty()) icon_gray = string_value("icongray"); // old format
+        defs.icons_gray.push_back(std::move(icon_gray));
+    }
+
+    // 'names' won't grow anymore, the index can point into it
+    defs.index.reserve(defs.names.size());
+    for (uint32 i = 0; i < (uint32)defs.names.size(); ++i) {
+        // the first one wins like it did when searching the json
+        if (defs.names[i].size()) defs.index.emplace(defs.names[i], i);
+    }
+
+    PRINT_DEBUG("indexed %zu achievements", defs.index.size());
 }
 
 void Steam_User_Stats::load_achievements()
@@ -123,19 +216,167 @@ void Steam_User_Stats::load_achievements()
 
 void Steam_User_Stats::save_achievements()
 {
-    local_storage->write_json_file("", achievements_user_file, user_achievements);
+    local_storage->write_json_file_deferred("", achievements_user_file, user_achievements);
 }
 
+static uint32 stats_store_checksum(const char *data, size_t size)
+{
+    uint32 hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-nlohmann::detail::iter_impl<nlohmann::json> Steam_User_Stats::defined_achievements_find(const std::string &key)
+void Steam_User_Stats::load_stats_store()
 {
-    return std::find_if(
-        defined_achievements.begin(), defined_achievements.end(),
-        [&key](const nlohmann::json& item) {
-            const std::string &name = static_cast<const std::string &>( item.value("name", std::string()) );
-            return common_helpers::str_cmp_insensitive(key, name);
+    if (local_storage->file_exists("", stats_store_file)) {
+        unsigned int size = local_storage->file_size("", stats_store_file);
+        std::string buffer(size, '\0');
+        bool read = !size || local_storage->get_data("", stats_store_file, &buffer[0], size) == (int)size;
+        std::map<std::string, std::string> stats{};
+        uint32 version = 0;
+        if (read && parse_stats_store(buffer, stats, version)) {
+            stored_stats = std::move(stats);
+            PRINT_DEBUG("loaded %zu stats", stored_stats.size());
+            return;
         }
-    );
+
+        if (read && version != 0 && version != STATS_STORE_VERSION) {
+            // written by another build, saving would replace it with an older layout and lose what it has
+            stats_store_read_only = true;
+            PRINT_DEBUG("'%s' has version %u, it won't be overwritten", stats_store_file, version);
+            return;
+        }
+
+        // the old stats files are older than this one, reading them would roll the stats back
+        // nothing from it is trusted, a copy of it is kept for recovery before a changed stat replaces it
+        std::string damaged_file(std::string(stats_store_file) + ".damaged");
+        if (size) local_storage->store_data("", damaged_file, &buffer[0], size);
+        PRINT_DEBUG("'%s' is damaged, copied to '%s'", stats_store_file, damaged_file.c_str());
+        return;
+    }
+
+    // the old layout, one file per stat, those files are left as they are so an older build still finds them
+    int count = local_storage->count_files(Local_Storage::stats_storage_folder);
+    for (int i = 0; i < count; ++i) {
+        char filename[MAX_FILENAME_LENGTH]{};
+        int32 file_size = 0;
+        if (!local_storage->iterate_file(Local_Storage::stats_storage_folder, i, filename, &file_size)) break;
+        if (file_size <= 0 || file_size > UINT16_MAX) continue;
+
+        std::string data((size_t)file_size, '\0');
+        if (local_storage->get_data(Local_Storage::stats_storage_folder, filename, &data[0], (unsigned int)file_size) != file_size) continue;
+        stored_stats[common_helpers::ascii_to_lowercase(filename)] = std::move(data);
+    }
+
+    if (stored_stats.size()) {
+        PRINT_DEBUG("moving %zu stats files to '%s'", stored_stats.size(), stats_store_file);
+        save_stats_store();
+    }
+}
+
+// 'version' is left at 0 when the file isn't a stats store at all
+bool Steam_User_Stats::parse_stats_store(const std::string &buffer, std::map<std::string, std::string> &stats, uint32 &version)
+{
+    if (buffer.size() < STATS_STORE_HEADER_SIZE) return false;
+    if (memcmp(buffer.data(), stats_store_magic, sizeof(stats_store_magic)) != 0) return false;
+
+    uint32 count = 0, checksum = 0;
+    memcpy(&version, buffer.data() + sizeof(stats_store_magic), sizeof(version));
+    memcpy(&count, buffer.data() + sizeof(stats_store_magic) + sizeof(uint32), sizeof(count));
+    memcpy(&checksum, buffer.data() + sizeof(stats_store_magic) + sizeof(uint32) * 2, sizeof(checksum));
+    if (version != STATS_STORE_VERSION) {
+        PRINT_DEBUG("unsupported version %u", version);
+        return false;
+    }
+
+    if (stats_store_checksum(buffer.data() + STATS_STORE_HEADER_SIZE, buffer.size() - STATS_STORE_HEADER_SIZE) != checksum) {
+        PRINT_DEBUG("bad checksum");
+        return false;
+    }
+
+    size_t pos = STATS_STORE_HEADER_SIZE;
+    auto read_string = [&buffer, &pos](std::string &str) {
+        uint16 size = 0;
+        if (buffer.size() - pos < sizeof(size)) return false;
+        memcpy(&size, buffer.data() + pos, sizeof(size));
+        pos += sizeof(size);
+
+        if (buffer.size() - pos < size) return false;
+        str.assign(buffer.data() + pos, size);
+        pos += size;
+        return true;
+    };
+
+    for (uint32 i = 0; i < count; ++i) {
+        std::string name{};
+        std::string data{};
+        if (!read_string(name) || !read_string(data)) return false;
+        stats[std::move(name)] = std::move(data);
+    }
+
+    return pos == buffer.size();
+}
+
+void Steam_User_Stats::mark_stats_store_dirty()
+{
+    if (stats_store_dirty) return;
+
+    stats_store_dirty = true;
+    stats_store_dirty_since = std::chrono::steady_clock::now();
+}
+
+void Steam_User_Stats::flush_stats_store()
+{
+    Emu_Lock_Guard lock(global_mutex);
+    if (stats_store_dirty) save_stats_store();
+}
+
+// the whole file is rewritten, but only in memory until the write-behind delay of local storage or StoreStats()
+bool Steam_User_Stats::save_stats_store()
+{
+    stats_store_dirty = false;
+    if (stats_store_read_only) {
+        PRINT_DEBUG("'%s' is from another version, not saving", stats_store_file);
+        return false;
+    }
+
+    std::string buffer(STATS_STORE_HEADER_SIZE, '\0');
+    auto write_string = [&buffer](const std::string &str) {
+        uint16 size = (uint16)str.size();
+        buffer.append((const char *)&size, sizeof(size));
+        buffer.append(str.data(), size);
+    };
+
+    uint32 count = 0;
+    for (const auto &stat : stored_stats) {
+        // sizes are stored in 16 bits, such an entry would make the whole file unreadable
+        if (stat.first.size() > UINT16_MAX || stat.second.size() > UINT16_MAX) {
+            PRINT_DEBUG("stat '%.64s' is too big to be saved (%zu + %zu bytes)", stat.first.c_str(), stat.first.size(), stat.second.size());
+            continue;
+        }
+
+        write_string(stat.first);
+        write_string(stat.second);
+        ++count;
+    }
+
+    uint32 version = STATS_STORE_VERSION;
+    uint32 checksum = stats_store_checksum(buffer.data() + STATS_STORE_HEADER_SIZE, buffer.size() - STATS_STORE_HEADER_SIZE);
+    memcpy(&buffer[0], stats_store_magic, sizeof(stats_store_magic));
+    memcpy(&buffer[sizeof(stats_store_magic)], &version, sizeof(version));
+    memcpy(&buffer[sizeof(stats_store_magic) + sizeof(uint32)], &count, sizeof(count));
+    memcpy(&buffer[sizeof(stats_store_magic) + sizeof(uint32) * 2], &checksum, sizeof(checksum));
+
+    return local_storage->store_data_deferred("", stats_store_file, buffer.data(), (unsigned int)buffer.size()) == (int)buffer.size();
+}
+
+
+int Steam_User_Stats::defined_achievements_find(std::string_view key) const
+{
+    return achievement_definitions.find(key);
 }
 
 std::string Steam_User_Stats::get_value_for_language(const nlohmann::json &json, std::string_view key, std::string_view language)
@@ -379,8 +620,9 @@ void Steam_User_Stats::request_user_leaderboard_entry(const Steam_Leaderboard &b
 bool Steam_User_Stats::clear_stats_internal()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     bool notify_server = false;
+    bool needs_disk_write = false;
     
     for (const auto &stat : settings->getStats()) {
         std::string stat_name(common_helpers::ascii_to_lowercase(stat.first));
@@ -390,16 +632,14 @@ bool Steam_User_Stats::clear_stats_internal()
         case GameServerStats_Messages::StatInfo::STAT_TYPE_INT: {
             auto data = stat.second.default_value_int;
 
-            bool needs_disk_write = false;
             auto it_res = stats_cache_int.find(stat_name);
             if (stats_cache_int.end() == it_res || it_res->second != data) {
+                stored_stats[stat_name].assign((const char *)&data, sizeof(data));
                 needs_disk_write = true;
                 notify_server = true;
             }
 
             stats_cache_int[stat_name] = data;
-            
-            if (needs_disk_write) local_storage->store_data(Local_Storage::stats_storage_folder, stat_name, (char *)&data, sizeof(data));
         }
         break;
 
@@ -407,16 +647,14 @@ bool Steam_User_Stats::clear_stats_internal()
         case GameServerStats_Messages::StatInfo::STAT_TYPE_AVGRATE: {
             auto data = stat.second.default_value_float;
 
-            bool needs_disk_write = false;
             auto it_res = stats_cache_float.find(stat_name);
             if (stats_cache_float.end() == it_res || it_res->second != data) {
+                stored_stats[stat_name].assign((const char *)&data, sizeof(data));
                 needs_disk_write = true;
                 notify_server = true;
             }
 
             stats_cache_float[stat_name] = data;
-            
-            if (needs_disk_write) local_storage->store_data(Local_Storage::stats_storage_folder, stat_name, (char *)&data, sizeof(data));
         }
         break;
         
@@ -424,13 +662,15 @@ bool Steam_User_Stats::clear_stats_internal()
         }
     }
 
+    if (needs_disk_write) mark_stats_store_dirty();
+
     return notify_server;
 }
 
 Steam_User_Stats::InternalSetResult<int32> Steam_User_Stats::set_stat_internal( const char *pchName, int32 nData )
 {
     PRINT_DEBUG("<int32> '%s' = %i", pchName, nData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_User_Stats::InternalSetResult<int32> result{};
 
     if (!pchName) return result;
@@ -490,20 +730,18 @@ Steam_User_Stats::InternalSetResult<int32> Steam_User_Stats::set_stat_internal(
         }
     }
 
-    if (local_storage->store_data(Local_Storage::stats_storage_folder, stat_name, (char* )&nData, sizeof(nData)) == sizeof(nData)) {
-        stats_cache_int[stat_name] = nData;
-        result.success = true;
-        result.notify_server = !settings->disable_sharing_stats_with_gameserver;
-        return result;
-    }
-
+    stored_stats[stat_name].assign((const char *)&nData, sizeof(nData));
+    mark_stats_store_dirty();
+    stats_cache_int[stat_name] = nData;
+    result.success = true;
+    result.notify_server = !settings->disable_sharing_stats_with_gameserver;
     return result;
 }
 
 Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo::Stat_Type, float>> Steam_User_Stats::set_stat_internal( const char *pchName, float fData )
 {
     PRINT_DEBUG("<float> '%s' = %f", pchName, fData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo::Stat_Type, float>> result{};
 
     if (!pchName) return result;
@@ -564,20 +802,18 @@ Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo
         }
     }
 
-    if (local_storage->store_data(Local_Storage::stats_storage_folder, stat_name, (char* )&fData, sizeof(fData)) == sizeof(fData)) {
-        stats_cache_float[stat_name] = fData;
-        result.success = true;
-        result.notify_server = !settings->disable_sharing_stats_with_gameserver;
-        return result;
-    }
-
+    stored_stats[stat_name].assign((const char *)&fData, sizeof(fData));
+    mark_stats_store_dirty();
+    stats_cache_float[stat_name] = fData;
+    result.success = true;
+    result.notify_server = !settings->disable_sharing_stats_with_gameserver;
     return result;
 }
 
 Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo::Stat_Type, float>> Steam_User_Stats::update_avg_rate_stat_internal( const char *pchName, float flCountThisSession, double dSessionLength )
 {
     PRINT_DEBUG("%s", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo::Stat_Type, float>> result{};
 
     if (!pchName) return result;
@@ -598,10 +834,11 @@ Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo
     result.internal_name = stat_name;
 
     char data[sizeof(float) + sizeof(float) + sizeof(double)];
-    int read_data = local_storage->get_data(Local_Storage::stats_storage_folder, stat_name, (char* )data, sizeof(*data));
     float oldcount = 0;
     double oldsessionlength = 0;
-    if (read_data == sizeof(data)) {
+    auto stored = stored_stats.find(stat_name);
+    if (stored_stats.end() != stored && stored->second.size() == sizeof(data)) {
+        memcpy(data, stored->second.data(), sizeof(data));
         memcpy(&oldcount, data + sizeof(float), sizeof(oldcount));
         memcpy(&oldsessionlength, data + sizeof(float) + sizeof(float), sizeof(oldsessionlength));
     }
@@ -617,20 +854,18 @@ Steam_User_Stats::InternalSetResult<std::pair<GameServerStats_Messages::StatInfo
     result.current_val.first = stats_data->second.type;
     result.current_val.second = average;
 
-    if (local_storage->store_data(Local_Storage::stats_storage_folder, stat_name, data, sizeof(data)) == sizeof(data)) {
-        stats_cache_float[stat_name] = average;
-        result.success = true;
-        result.notify_server = !settings->disable_sharing_stats_with_gameserver;
-        return result;
-    }
-
+    stored_stats[stat_name].assign(data, sizeof(data));
+    mark_stats_store_dirty();
+    stats_cache_float[stat_name] = average;
+    result.success = true;
+    result.notify_server = !settings->disable_sharing_stats_with_gameserver;
     return result;
 }
 
 Steam_User_Stats::InternalSetResult<bool> Steam_User_Stats::set_achievement_internal( const char *pchName )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_User_Stats::InternalSetResult<bool> result{};
 
     if (!pchName) return result;
@@ -650,18 +885,15 @@ Steam_User_Stats::InternalSetResult<bool> Steam_User_Stats::set_achievement_inte
         return result;
     }
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(org_name);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return result;
+    int ach_idx = defined_achievements_find(org_name);
+    if (ach_idx < 0) return result;
 
     result.current_val = true;
     result.internal_name = org_name;
     result.success = true;
 
     try {
-        std::string internal_name = it->value("name", std::string());
+        const std::string &internal_name = achievement_definitions.names[ach_idx];
 
         result.internal_name = internal_name;
 
@@ -694,25 +926,22 @@ Steam_User_Stats::InternalSetResult<bool> Steam_User_Stats::set_achievement_inte
 Steam_User_Stats::InternalSetResult<bool> Steam_User_Stats::clear_achievement_internal( const char *pchName )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_User_Stats::InternalSetResult<bool> result{};
 
     if (!pchName) return result;
 
     std::string org_name(pchName);
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(org_name);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return result;
+    int ach_idx = defined_achievements_find(org_name);
+    if (ach_idx < 0) return result;
 
     result.current_val = false;
     result.internal_name = org_name;
     result.success = true;
 
     try {
-        std::string internal_name = it->value("name", std::string());
+        const std::string &internal_name = achievement_definitions.names[ach_idx];
 
         result.internal_name = internal_name;
 
@@ -786,15 +1015,7 @@ Steam_User_Stats::Steam_User_Stats(Settings *settings, class Networking *network
 {
     load_achievements_db(); // achievements db
     load_achievements(); // achievements per user
-
-    auto x = defined_achievements.begin();
-    while (x != defined_achievements.end()) {
-        if (!x->contains("name")) {
-            x = defined_achievements.erase(x);
-        } else {
-            ++x;
-        }
-    }
+    load_stats_store(); // stats per user
 
     for (auto & it : defined_achievements) {
         try {
@@ -824,13 +1045,6 @@ Steam_User_Stats::Steam_User_Stats(Settings *settings, class Networking *network
                 user_ach.emplace("max_progress", progress_max);
             } catch(...) {}
         } catch(...) {}
-
-        try {
-            it["hidden"] = std::to_string(it["hidden"].get<int>());
-        } catch(...) {}
-
-        it["displayName"] = get_value_for_language(it, "displayName", settings->get_language());
-        it["description"] = get_value_for_language(it, "description", settings->get_language());
     }
 
     //TODO: not sure if the sort is actually case insensitive, ach names seem to be treated by steam as case insensitive so I assume they are.
@@ -867,7 +1081,7 @@ STEAM_CALL_BACK( UserStatsReceived_t )
 bool Steam_User_Stats::RequestCurrentStats()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     UserStatsReceived_t data{};
     data.m_nGameID = settings->get_local_game_id().ToUint64();
@@ -882,7 +1096,7 @@ bool Steam_User_Stats::RequestCurrentStats()
 bool Steam_User_Stats::GetStat( const char *pchName, int32 *pData )
 {
     PRINT_DEBUG("<int32> '%s' %p", pchName, pData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
     std::string stat_name = common_helpers::ascii_to_lowercase(pchName);
@@ -905,9 +1119,10 @@ bool Steam_User_Stats::GetStat( const char *pchName, int32 *pData )
         return true;
     }
 
-    int32 output = 0;
-    int read_data = local_storage->get_data(Local_Storage::stats_storage_folder, stat_name, (char* )&output, sizeof(output));
-    if (read_data == sizeof(int32)) {
+    auto stored = stored_stats.find(stat_name);
+    if (stored_stats.end() != stored && stored->second.size() >= sizeof(int32)) {
+        int32 output = 0;
+        memcpy(&output, stored->second.data(), sizeof(output));
         stats_cache_int[stat_name] = output;
         if (pData) *pData = output;
         return true;
@@ -921,7 +1136,7 @@ bool Steam_User_Stats::GetStat( const char *pchName, int32 *pData )
 bool Steam_User_Stats::GetStat( const char *pchName, float *pData )
 {
     PRINT_DEBUG("<float> '%s' %p", pchName, pData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
     std::string stat_name = common_helpers::ascii_to_lowercase(pchName);
@@ -944,9 +1159,11 @@ bool Steam_User_Stats::GetStat( const char *pchName, float *pData )
         return true;
     }
 
-    float output = 0.0;
-    int read_data = local_storage->get_data(Local_Storage::stats_storage_folder, stat_name, (char* )&output, sizeof(output));
-    if (read_data == sizeof(float)) {
+    // an average rate stat starts with its average
+    auto stored = stored_stats.find(stat_name);
+    if (stored_stats.end() != stored && stored->second.size() >= sizeof(float)) {
+        float output = 0.0;
+        memcpy(&output, stored->second.data(), sizeof(output));
         stats_cache_float[stat_name] = output;
         if (pData) *pData = output;
         return true;
@@ -962,7 +1179,7 @@ bool Steam_User_Stats::GetStat( const char *pchName, float *pData )
 bool Steam_User_Stats::SetStat( const char *pchName, int32 nData )
 {
     PRINT_DEBUG("<int32> '%s' = %i", pchName, nData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto ret = set_stat_internal(pchName, nData );
     if (ret.success && ret.notify_server ) {
@@ -979,7 +1196,7 @@ bool Steam_User_Stats::SetStat( const char *pchName, int32 nData )
 bool Steam_User_Stats::SetStat( const char *pchName, float fData )
 {
     PRINT_DEBUG("<float> '%s' = %f", pchName, fData);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto ret = set_stat_internal(pchName, fData);
     if (ret.success && ret.notify_server) {
@@ -996,7 +1213,7 @@ bool Steam_User_Stats::SetStat( const char *pchName, float fData )
 bool Steam_User_Stats::UpdateAvgRateStat( const char *pchName, float flCountThisSession, double dSessionLength )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto ret = update_avg_rate_stat_internal(pchName, flCountThisSession, dSessionLength);
     if (ret.success && ret.notify_server) {
@@ -1015,15 +1232,12 @@ bool Steam_User_Stats::UpdateAvgRateStat( const char *pchName, float flCountThis
 bool Steam_User_Stats::GetAchievement( const char *pchName, bool *pbAchieved )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(pchName);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return false;
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return false;
 
     // according to docs, the function returns true if the achievement was found,
     // regardless achieved or not 
@@ -1031,7 +1245,7 @@ bool Steam_User_Stats::GetAchievement( const char *pchName, bool *pbAchieved )
 
     *pbAchieved = false;
     try {
-        std::string pch_name = it->value("name", std::string());
+        const std::string &pch_name = achievement_definitions.names[ach_idx];
         auto ach = user_achievements.find(pch_name);
         if (user_achievements.end() != ach) {
             *pbAchieved = ach->value("earned", false);
@@ -1044,7 +1258,7 @@ bool Steam_User_Stats::GetAchievement( const char *pchName, bool *pbAchieved )
 bool Steam_User_Stats::SetAchievement( const char *pchName )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto ret = set_achievement_internal(pchName);
     if (ret.success && ret.notify_server) {
@@ -1060,7 +1274,7 @@ bool Steam_User_Stats::SetAchievement( const char *pchName )
 bool Steam_User_Stats::ClearAchievement( const char *pchName )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     auto ret = clear_achievement_internal(pchName);
     if (ret.success && ret.notify_server) {
@@ -1080,21 +1294,18 @@ bool Steam_User_Stats::ClearAchievement( const char *pchName )
 bool Steam_User_Stats::GetAchievementAndUnlockTime( const char *pchName, bool *pbAchieved, uint32 *punUnlockTime )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(pchName);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return false;
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return false;
 
     if (pbAchieved) *pbAchieved = false;
     if (punUnlockTime) *punUnlockTime = 0;
     
     try {
-        std::string pch_name = it->value("name", std::string());
+        const std::string &pch_name = achievement_definitions.names[ach_idx];
         auto ach = user_achievements.find(pch_name);
         if (user_achievements.end() != ach) {
             if (pbAchieved) *pbAchieved = ach->value("earned", false);
@@ -1117,7 +1328,7 @@ bool Steam_User_Stats::StoreStats()
 {
     // no need to exchange data with gameserver, we already do that in run_callback() and on each stat/ach update (immediate mode)
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     UserStatsStored_t data{};
     data.m_eResult = k_EResultOK;
@@ -1129,6 +1340,10 @@ bool Steam_User_Stats::StoreStats()
     }
     store_stats_trigger.clear();
 
+    // stats and achievements are only kept in memory until now, or until the write-behind delay of local storage
+    if (stats_store_dirty) save_stats_store();
+    local_storage->flush();
+
     return true;
 }
 
@@ -1142,7 +1357,7 @@ bool Steam_User_Stats::StoreStats()
 int Steam_User_Stats::GetAchievementIcon( const char *pchName )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchName) return 0;
 
     // callbacks->addCBResult(data.k_iCallback, &data, sizeof(data));
@@ -1151,24 +1366,14 @@ int Steam_User_Stats::GetAchievementIcon( const char *pchName )
 
 std::string Steam_User_Stats::get_achievement_icon_name( const char *pchName, bool pbAchieved )
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchName) return "";
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(pchName);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return "";
-
-    try {
-        if (pbAchieved) return it.value()["icon"].get<std::string>();
-        
-        std::string locked_icon = it.value().value("icon_gray", std::string());
-        if (locked_icon.size()) return locked_icon;
-        else return it.value().value("icongray", std::string()); // old format
-    } catch (...) {}
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return "";
 
-    return "";
+    if (pbAchieved) return achievement_definitions.icons[ach_idx];
+    return achievement_definitions.icons_gray[ach_idx];
 }
 
 
@@ -1178,28 +1383,19 @@ std::string Steam_User_Stats::get_achievement_icon_name( const char *pchName, bo
 const char * Steam_User_Stats::GetAchievementDisplayAttribute( const char *pchName, const char *pchKey )
 {
     PRINT_DEBUG("[%s] [%s]", pchName, pchKey);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName || !pchKey || !pchKey[0]) return "";
 
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(pchName);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return "";
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return "";
 
     if (strncmp(pchKey, "name", sizeof("name")) == 0) {
-        try {
-            return it.value()["displayName"].get_ptr<std::string*>()->c_str();
-        } catch (...) {}
+        return achievement_definitions.display_names[ach_idx].c_str();
     } else if (strncmp(pchKey, "desc", sizeof("desc")) == 0) {
-        try {
-            return it.value()["description"].get_ptr<std::string*>()->c_str();
-        } catch (...) {}
+        return achievement_definitions.descriptions[ach_idx].c_str();
     } else if (strncmp(pchKey, "hidden", sizeof("hidden")) == 0) {
-        try {
-            return it.value()["hidden"].get_ptr<std::string*>()->c_str();
-        } catch (...) {}
+        return achievement_definitions.hidden[ach_idx].c_str();
     }
 
     return "";
@@ -1211,7 +1407,7 @@ const char * Steam_User_Stats::GetAchievementDisplayAttribute( const char *pchNa
 bool Steam_User_Stats::IndicateAchievementProgress( const char *pchName, uint32 nCurProgress, uint32 nMaxProgress )
 {
     PRINT_DEBUG("'%s' %u %u", pchName, nCurProgress, nMaxProgress);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
     if (nCurProgress >= nMaxProgress) return false;
@@ -1219,17 +1415,11 @@ bool Steam_User_Stats::IndicateAchievementProgress( const char *pchName, uint32
     std::string ach_name(pchName);
 
     // find in achievements.json
-    nlohmann::detail::iter_impl<nlohmann::json> it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(ach_name);
-    } catch(...) { }
-    if (defined_achievements.end() == it) return false;
+    int ach_idx = defined_achievements_find(ach_name);
+    if (ach_idx < 0) return false;
 
     // get actual name from achievements.json
-    std::string actual_ach_name{};
-    try {
-        actual_ach_name = it->value("name", std::string());
-    } catch (...) { }
+    std::string actual_ach_name = achievement_definitions.names[ach_idx];
     if (actual_ach_name.empty()) { // fallback
         actual_ach_name = ach_name;
     }
@@ -1284,15 +1474,15 @@ bool Steam_User_Stats::IndicateAchievementProgress( const char *pchName, uint32
 uint32 Steam_User_Stats::GetNumAchievements()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
-    return (uint32)defined_achievements.size();
+    Emu_Lock_Guard lock(global_mutex);
+    return (uint32)achievement_definitions.size();
 }
 
 // Get achievement name iAchievement in [0,GetNumAchievements)
 const char * Steam_User_Stats::GetAchievementName( uint32 iAchievement )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (iAchievement >= sorted_achievement_names.size()) {
         return "";
     }
@@ -1311,7 +1501,7 @@ STEAM_CALL_RESULT( UserStatsReceived_t )
 SteamAPICall_t Steam_User_Stats::RequestUserStats( CSteamID steamIDUser )
 {
     PRINT_DEBUG("%llu", steamIDUser.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     // Enable this to allow hot reload achievements status
     //if (steamIDUser == settings->get_local_steam_id()) {
@@ -1335,7 +1525,7 @@ SteamAPICall_t Steam_User_Stats::RequestUserStats( CSteamID steamIDUser )
 bool Steam_User_Stats::GetUserStat( CSteamID steamIDUser, const char *pchName, int32 *pData )
 {
     PRINT_DEBUG("'%s' %llu", pchName, steamIDUser.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
@@ -1351,7 +1541,7 @@ bool Steam_User_Stats::GetUserStat( CSteamID steamIDUser, const char *pchName, i
 bool Steam_User_Stats::GetUserStat( CSteamID steamIDUser, const char *pchName, float *pData )
 {
     PRINT_DEBUG("%s %llu", pchName, steamIDUser.ConvertToUint64());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
@@ -1367,7 +1557,7 @@ bool Steam_User_Stats::GetUserStat( CSteamID steamIDUser, const char *pchName, f
 bool Steam_User_Stats::GetUserAchievement( CSteamID steamIDUser, const char *pchName, bool *pbAchieved )
 {
     PRINT_DEBUG("%s", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     if (!pchName) return false;
 
@@ -1382,7 +1572,7 @@ bool Steam_User_Stats::GetUserAchievement( CSteamID steamIDUser, const char *pch
 bool Steam_User_Stats::GetUserAchievementAndUnlockTime( CSteamID steamIDUser, const char *pchName, bool *pbAchieved, uint32 *punUnlockTime )
 {
     PRINT_DEBUG("%s", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
@@ -1397,7 +1587,7 @@ bool Steam_User_Stats::GetUserAchievementAndUnlockTime( CSteamID steamIDUser, co
 bool Steam_User_Stats::ResetAllStats( bool bAchievementsToo )
 {
     PRINT_DEBUG("bAchievementsToo = %i", (int)bAchievementsToo);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     clear_stats_internal(); // this will save stats to disk if necessary
     if (!settings->disable_sharing_stats_with_gameserver) {
@@ -1436,8 +1626,9 @@ bool Steam_User_Stats::ResetAllStats( bool bAchievementsToo )
                 item["earned_time"] = static_cast<uint32>(0);
 
                 try {
-                    auto defined_ach_it = defined_achievements_find(name);
-                    if (defined_achievements.end() != defined_ach_it) {
+                    int ach_idx = defined_achievements_find(name);
+                    if (ach_idx >= 0) {
+                        auto defined_ach_it = defined_achievements.begin() + ach_idx;
                         auto defined_progress_it = defined_ach_it->find("progress");
                         if (defined_ach_it->end() != defined_progress_it) { // if the schema had "progress"
                             uint32 val = 0;
@@ -1480,7 +1671,7 @@ STEAM_CALL_RESULT(LeaderboardFindResult_t)
 SteamAPICall_t Steam_User_Stats::FindOrCreateLeaderboard( const char *pchLeaderboardName, ELeaderboardSortMethod eLeaderboardSortMethod, ELeaderboardDisplayType eLeaderboardDisplayType )
 {
     PRINT_DEBUG("'%s'", pchLeaderboardName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchLeaderboardName) {
         LeaderboardFindResult_t data{};
         data.m_hSteamLeaderboard = 0;
@@ -1508,7 +1699,7 @@ STEAM_CALL_RESULT( LeaderboardFindResult_t )
 SteamAPICall_t Steam_User_Stats::FindLeaderboard( const char *pchLeaderboardName )
 {
     PRINT_DEBUG("'%s'", pchLeaderboardName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchLeaderboardName) {
         LeaderboardFindResult_t data{};
         data.m_hSteamLeaderboard = 0;
@@ -1544,7 +1735,7 @@ SteamAPICall_t Steam_User_Stats::FindLeaderboard( const char *pchLeaderboardName
 const char * Steam_User_Stats::GetLeaderboardName( SteamLeaderboard_t hSteamLeaderboard )
 {
     PRINT_DEBUG("%llu", hSteamLeaderboard);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return "";
 
     return cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)].name.c_str();
@@ -1555,7 +1746,7 @@ const char * Steam_User_Stats::GetLeaderboardName( SteamLeaderboard_t hSteamLead
 int Steam_User_Stats::GetLeaderboardEntryCount( SteamLeaderboard_t hSteamLeaderboard )
 {
     PRINT_DEBUG("%llu", hSteamLeaderboard);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return 0;
 
     return (int)cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)].entries.size();
@@ -1566,7 +1757,7 @@ int Steam_User_Stats::GetLeaderboardEntryCount( SteamLeaderboard_t hSteamLeaderb
 ELeaderboardSortMethod Steam_User_Stats::GetLeaderboardSortMethod( SteamLeaderboard_t hSteamLeaderboard )
 {
     PRINT_DEBUG("%llu", hSteamLeaderboard);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return k_ELeaderboardSortMethodNone;
 
     return cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)].sort_method;
@@ -1577,7 +1768,7 @@ ELeaderboardSortMethod Steam_User_Stats::GetLeaderboardSortMethod( SteamLeaderbo
 ELeaderboardDisplayType Steam_User_Stats::GetLeaderboardDisplayType( SteamLeaderboard_t hSteamLeaderboard )
 {
     PRINT_DEBUG("%llu", hSteamLeaderboard);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return k_ELeaderboardDisplayTypeNone;
 
     return cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)].display_type;
@@ -1596,7 +1787,7 @@ STEAM_CALL_RESULT( LeaderboardScoresDownloaded_t )
 SteamAPICall_t Steam_User_Stats::DownloadLeaderboardEntries( SteamLeaderboard_t hSteamLeaderboard, ELeaderboardDataRequest eLeaderboardDataRequest, int nRangeStart, int nRangeEnd )
 {
     PRINT_DEBUG("%llu %i [%i, %i]", hSteamLeaderboard, eLeaderboardDataRequest, nRangeStart, nRangeEnd);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return k_uAPICallInvalid; //might return callresult even if hSteamLeaderboard is invalid
 
     int entries_count = (int)cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)].entries.size();
@@ -1625,7 +1816,7 @@ SteamAPICall_t Steam_User_Stats::DownloadLeaderboardEntriesForUsers( SteamLeader
                                                             STEAM_ARRAY_COUNT_D(cUsers, Array of users to retrieve) CSteamID *prgUsers, int cUsers )
 {
     PRINT_DEBUG("%i %llu", cUsers, cUsers > 0 ? prgUsers[0].ConvertToUint64() : 0);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return k_uAPICallInvalid; //might return callresult even if hSteamLeaderboard is invalid
 
     auto& board = cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)];
@@ -1676,7 +1867,7 @@ SteamAPICall_t Steam_User_Stats::DownloadLeaderboardEntriesForUsers( SteamLeader
 bool Steam_User_Stats::GetDownloadedLeaderboardEntry( SteamLeaderboardEntries_t hSteamLeaderboardEntries, int index, LeaderboardEntry_t *pLeaderboardEntry, int32 *pDetails, int cDetailsMax )
 {
     PRINT_DEBUG("[%i] (%i) %llu %p %p", index, cDetailsMax, hSteamLeaderboardEntries, pLeaderboardEntry, pDetails);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboardEntries > cached_leaderboards.size() || hSteamLeaderboardEntries <= 0) return false;
     
     const auto &board = cached_leaderboards[static_cast<unsigned>(hSteamLeaderboardEntries - 1)];
@@ -1711,7 +1902,7 @@ STEAM_CALL_RESULT( LeaderboardScoreUploaded_t )
 SteamAPICall_t Steam_User_Stats::UploadLeaderboardScore( SteamLeaderboard_t hSteamLeaderboard, ELeaderboardUploadScoreMethod eLeaderboardUploadScoreMethod, int32 nScore, const int32 *pScoreDetails, int cScoreDetailsCount )
 {
     PRINT_DEBUG("%llu %i", hSteamLeaderboard, nScore);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) return k_uAPICallInvalid; //TODO: might return callresult even if hSteamLeaderboard is invalid
 
     auto &board = cached_leaderboards[static_cast<unsigned>(hSteamLeaderboard - 1)];
@@ -1791,7 +1982,7 @@ STEAM_CALL_RESULT( LeaderboardUGCSet_t )
 SteamAPICall_t Steam_User_Stats::AttachLeaderboardUGC( SteamLeaderboard_t hSteamLeaderboard, UGCHandle_t hUGC )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     LeaderboardUGCSet_t data{};
     if (hSteamLeaderboard > cached_leaderboards.size() || hSteamLeaderboard <= 0) {
         data.m_eResult = k_EResultFail;
@@ -1812,7 +2003,7 @@ STEAM_CALL_RESULT( NumberOfCurrentPlayers_t )
 SteamAPICall_t Steam_User_Stats::GetNumberOfCurrentPlayers()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     std::random_device rd{};
     std::mt19937 gen(rd());
@@ -1834,7 +2025,7 @@ STEAM_CALL_RESULT( GlobalAchievementPercentagesReady_t )
 SteamAPICall_t Steam_User_Stats::RequestGlobalAchievementPercentages()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     GlobalAchievementPercentagesReady_t data{};
     data.m_eResult = EResult::k_EResultOK;
@@ -1851,7 +2042,7 @@ SteamAPICall_t Steam_User_Stats::RequestGlobalAchievementPercentages()
 int Steam_User_Stats::GetMostAchievedAchievementInfo( char *pchName, uint32 unNameBufLen, float *pflPercent, bool *pbAchieved )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!pchName) return -1;
 
     std::string name(GetAchievementName(0));
@@ -1879,11 +2070,11 @@ int Steam_User_Stats::GetMostAchievedAchievementInfo( char *pchName, uint32 unNa
 int Steam_User_Stats::GetNextMostAchievedAchievementInfo( int iIteratorPrevious, char *pchName, uint32 unNameBufLen, float *pflPercent, bool *pbAchieved )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (iIteratorPrevious < 0) return -1;
     
     unsigned iIteratorCurrent = static_cast<unsigned>(iIteratorPrevious + 1);
-    if (iIteratorCurrent >= defined_achievements.size()) return -1;
+    if (iIteratorCurrent >= achievement_definitions.size()) return -1;
 
     std::string name(GetAchievementName(iIteratorCurrent));
     if (name.empty()) return -1;
@@ -1894,7 +2085,7 @@ int Steam_User_Stats::GetNextMostAchievedAchievementInfo( int iIteratorPrevious,
     }
 
     if (pflPercent) {
-        *pflPercent = (float)(90 * (defined_achievements.size() - iIteratorCurrent) / defined_achievements.size());
+        *pflPercent = (float)(90 * (achievement_definitions.size() - iIteratorCurrent) / achievement_definitions.size());
     }
     if (pbAchieved) {
         bool achieved = false;
@@ -1910,14 +2101,15 @@ int Steam_User_Stats::GetNextMostAchievedAchievementInfo( int iIteratorPrevious,
 bool Steam_User_Stats::GetAchievementAchievedPercent( const char *pchName, float *pflPercent )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
-    auto it = defined_achievements_find(pchName);
-    if (defined_achievements.end() == it) return false;
+    if (!pchName) return false;
+
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return false;
 
-    size_t idx = it - defined_achievements.begin();
     if (pflPercent) {
-        *pflPercent = (float)(90 * (defined_achievements.size() - idx) / defined_achievements.size());
+        *pflPercent = (float)(90 * (achievement_definitions.size() - ach_idx) / achievement_definitions.size());
     }
     
     return true;
@@ -1932,7 +2124,7 @@ STEAM_CALL_RESULT( GlobalStatsReceived_t )
 SteamAPICall_t Steam_User_Stats::RequestGlobalStats( int nHistoryDays )
 {
     PRINT_DEBUG("%i", nHistoryDays);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     GlobalStatsReceived_t data{};
     data.m_nGameID = settings->get_local_game_id().ToUint64();
     data.m_eResult = k_EResultOK;
@@ -1946,14 +2138,14 @@ SteamAPICall_t Steam_User_Stats::RequestGlobalStats( int nHistoryDays )
 bool Steam_User_Stats::GetGlobalStat( const char *pchStatName, int64 *pData )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_User_Stats::GetGlobalStat( const char *pchStatName, double *pData )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -1965,14 +2157,14 @@ bool Steam_User_Stats::GetGlobalStat( const char *pchStatName, double *pData )
 int32 Steam_User_Stats::GetGlobalStatHistory( const char *pchStatName, STEAM_ARRAY_COUNT(cubData) int64 *pData, uint32 cubData )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 int32 Steam_User_Stats::GetGlobalStatHistory( const char *pchStatName, STEAM_ARRAY_COUNT(cubData) double *pData, uint32 cubData )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
@@ -1982,7 +2174,7 @@ int32 Steam_User_Stats::GetGlobalStatHistory( const char *pchStatName, STEAM_ARR
 bool Steam_User_Stats::GetAchievementProgressLimits( const char *pchName, int32 *pnMinProgress, int32 *pnMaxProgress )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     float fMinProgress{};
     float fMaxProgress{};
@@ -1997,22 +2189,18 @@ bool Steam_User_Stats::GetAchievementProgressLimits( const char *pchName, int32
 bool Steam_User_Stats::GetAchievementProgressLimits( const char *pchName, float *pfMinProgress, float *pfMaxProgress )
 {
     PRINT_DEBUG("'%s'", pchName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     if (!pchName) return false;
 
-    auto it = defined_achievements.end();
-    try {
-        it = defined_achievements_find(pchName);
-    }
-    catch (...) {}
-    if (defined_achievements.end() == it) return false;
+    int ach_idx = defined_achievements_find(pchName);
+    if (ach_idx < 0) return false;
 
     if (pfMinProgress) *pfMinProgress = 0;
     if (pfMaxProgress) *pfMaxProgress = 0;
 
     try {
-        std::string pch_name = it->value("name", std::string());
+        const std::string &pch_name = achievement_definitions.names[ach_idx];
         auto ach = user_achievements.find(pch_name);
         if (user_achievements.end() != ach) {
             auto it_progress = ach->find("progress");
@@ -2084,6 +2272,10 @@ void Steam_User_Stats::send_updated_stats()
 void Steam_User_Stats::steam_run_callback()
 {
     send_updated_stats();
+
+    if (stats_store_dirty && std::chrono::steady_clock::now() - stats_store_dirty_since >= std::chrono::seconds(STATS_STORE_SAVE_DELAY_SECONDS)) {
+        save_stats_store();
+    }
 }
 
 
@@ -2134,8 +2326,7 @@ void Steam_User_Stats::network_stats_initial(Common_Message *msg)
 
     // get all achievements
     auto &achievements_map = *all_stats_msg->mutable_user_achievements();
-    for (const auto &ach : defined_achievements) {
-        const std::string &name = static_cast<const std::string &>( ach.value("name", std::string()) );
+    for (const auto &name : achievement_definitions.names) {
         auto &this_ach = achievements_map[name];
 
         // achieved or not
@@ -32,14 +32,14 @@ Steam_Utils::Steam_Utils(Settings *settings, class SteamCallResults *callback_re
 uint32 Steam_Utils::GetSecondsSinceAppActive()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return static_cast<uint32>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - startup_time).count());
 }
 
 uint32 Steam_Utils::GetSecondsSinceComputerActive()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return GetSecondsSinceAppActive() + 2000;
 }
 
@@ -48,7 +48,7 @@ uint32 Steam_Utils::GetSecondsSinceComputerActive()
 EUniverse Steam_Utils::GetConnectedUniverse()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_EUniversePublic;
 }
 
@@ -57,7 +57,7 @@ EUniverse Steam_Utils::GetConnectedUniverse()
 uint32 Steam_Utils::GetServerRealTime()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     uint32 server_time = std::chrono::duration_cast<std::chrono::duration<uint32>>(std::chrono::system_clock::now().time_since_epoch()).count();
     PRINT_DEBUG("  Time %u", server_time);
     return server_time;
@@ -69,7 +69,7 @@ uint32 Steam_Utils::GetServerRealTime()
 const char* Steam_Utils::GetIPCountry()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->ip_country.c_str();
 }
 
@@ -77,16 +77,11 @@ const char* Steam_Utils::GetIPCountry()
 bool Steam_Utils::GetImageSize( int iImage, uint32 *pnWidth, uint32 *pnHeight )
 {
     PRINT_DEBUG("%i", iImage);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    // images are under their own reader lock, no need to wait for global_mutex
 
     if (!iImage || !pnWidth || !pnHeight) return false;
 
-    auto image = settings->images.find(iImage);
-    if (settings->images.end() == image) return false;
-
-    *pnWidth = image->second.width;
-    *pnHeight = image->second.height;
-    return true;
+    return settings->get_image_size(iImage, pnWidth, pnHeight);
 }
 
 // returns true if the image exists, and the buffer was successfully filled out
@@ -95,22 +90,18 @@ bool Steam_Utils::GetImageSize( int iImage, uint32 *pnWidth, uint32 *pnHeight )
 bool Steam_Utils::GetImageRGBA( int iImage, uint8 *pubDest, int nDestBufferSize )
 {
     PRINT_DEBUG("%i %p %i", iImage, pubDest, nDestBufferSize);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    // images are under their own reader lock, no need to wait for global_mutex
 
     if (!iImage || !pubDest || nDestBufferSize <= 0) return false;
 
-    auto image = settings->images.find(iImage);
-    if (settings->images.end() == image) return false;
-
-    image->second.data.copy((char *)pubDest, nDestBufferSize);
-    return true;
+    return settings->copy_image_data(iImage, pubDest, static_cast<size_t>(nDestBufferSize));
 }
 
 // returns the IP of the reporting server for valve - currently only used in Source engine games
 bool Steam_Utils::GetCSERIPPort( uint32 *unIP, uint16 *usPort )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -119,7 +110,7 @@ bool Steam_Utils::GetCSERIPPort( uint32 *unIP, uint16 *usPort )
 uint8 Steam_Utils::GetCurrentBatteryPower()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 255; // AC
 }
 
@@ -128,7 +119,7 @@ uint8 Steam_Utils::GetCurrentBatteryPower()
 uint32 Steam_Utils::GetAppID()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->get_local_game_id().AppID();
 }
 
@@ -138,7 +129,7 @@ uint32 Steam_Utils::GetAppID()
 void Steam_Utils::SetOverlayNotificationPosition( ENotificationPosition eNotificationPosition )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     overlay->SetNotificationPosition(eNotificationPosition);
 }
 
@@ -148,7 +139,7 @@ void Steam_Utils::SetOverlayNotificationPosition( ENotificationPosition eNotific
 bool Steam_Utils::IsAPICallCompleted( SteamAPICall_t hSteamAPICall, bool *pbFailed )
 {
     PRINT_DEBUG("%llu", hSteamAPICall);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (pbFailed) *pbFailed = false;
 
     if (hSteamAPICall == 1) { //bug ? soul calibur 6 calls this function with the return value 1 of Steam_User_Stats::RequestCurrentStats and expects this function to return true
@@ -163,14 +154,14 @@ bool Steam_Utils::IsAPICallCompleted( SteamAPICall_t hSteamAPICall, bool *pbFail
 ESteamAPICallFailure Steam_Utils::GetAPICallFailureReason( SteamAPICall_t hSteamAPICall )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamAPICallFailureNone;
 }
 
 bool Steam_Utils::GetAPICallResult( SteamAPICall_t hSteamAPICall, void *pCallback, int cubCallback, int iCallbackExpected, bool *pbFailed )
 {
     PRINT_DEBUG("%llu %i %i %p", hSteamAPICall, cubCallback, iCallbackExpected, pbFailed);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (callback_results->callback_result(hSteamAPICall, pCallback, cubCallback)) {
         if (pbFailed) *pbFailed = false;
         PRINT_DEBUG("  Succeeded");
@@ -185,7 +176,7 @@ STEAM_PRIVATE_API(
 void Steam_Utils::RunFrame()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     // Steam_Client *client = get_steam_client();
     // client ->RunCallbacks(true, false, false);
 }
@@ -198,7 +189,7 @@ void Steam_Utils::RunFrame()
 uint32 Steam_Utils::GetIPCCallCount()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     static int i = 0;
     i += 123;
     return i; //TODO
@@ -220,7 +211,7 @@ void Steam_Utils::SetWarningMessageHook( SteamAPIWarningMessageHook_t pFunction
 bool Steam_Utils::IsOverlayEnabled()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return overlay->Ready();
 }
 
@@ -237,7 +228,7 @@ bool Steam_Utils::IsOverlayEnabled()
 bool Steam_Utils::BOverlayNeedsPresent()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return overlay->NeedPresent();
 }
 
@@ -254,7 +245,7 @@ STEAM_CALL_RESULT( CheckFileSignature_t )
 SteamAPICall_t Steam_Utils::CheckFileSignature( const char *szFileName )
 {
     PRINT_DEBUG("'%s'", szFileName);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     CheckFileSignature_t data;
     data.m_eCheckFileSignature = k_ECheckFileSignatureValidSignature;
     auto ret = callback_results->addCallResult(data.k_iCallback, &data, sizeof(data));
@@ -268,14 +259,14 @@ SteamAPICall_t Steam_Utils::CheckFileSignature( const char *szFileName )
 bool Steam_Utils::ShowGamepadTextInput( EGamepadTextInputMode eInputMode, EGamepadTextInputLineMode eLineInputMode, const char *pchDescription, uint32 unCharMax, const char *pchExistingText )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
 bool Steam_Utils::ShowGamepadTextInput( EGamepadTextInputMode eInputMode, EGamepadTextInputLineMode eLineInputMode, const char *pchDescription, uint32 unCharMax )
 {
 	PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 	return ShowGamepadTextInput(eInputMode, eLineInputMode, pchDescription, unCharMax, NULL);
 }
 
@@ -283,14 +274,14 @@ bool Steam_Utils::ShowGamepadTextInput( EGamepadTextInputMode eInputMode, EGamep
 uint32 Steam_Utils::GetEnteredGamepadTextLength()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return 0;
 }
 
 bool Steam_Utils::GetEnteredGamepadTextInput( char *pchText, uint32 cchText )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -299,7 +290,7 @@ bool Steam_Utils::GetEnteredGamepadTextInput( char *pchText, uint32 cchText )
 const char* Steam_Utils::GetSteamUILanguage()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->get_language();
 }
 
@@ -308,7 +299,7 @@ const char* Steam_Utils::GetSteamUILanguage()
 bool Steam_Utils::IsSteamRunningInVR()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -317,7 +308,7 @@ bool Steam_Utils::IsSteamRunningInVR()
 void Steam_Utils::SetOverlayNotificationInset( int nHorizontalInset, int nVerticalInset )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     overlay->SetNotificationInset(nHorizontalInset, nVerticalInset);
 }
 
@@ -328,7 +319,7 @@ void Steam_Utils::SetOverlayNotificationInset( int nHorizontalInset, int nVertic
 bool Steam_Utils::IsSteamInBigPictureMode()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -337,7 +328,7 @@ bool Steam_Utils::IsSteamInBigPictureMode()
 void Steam_Utils::StartVRDashboard()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -345,7 +336,7 @@ void Steam_Utils::StartVRDashboard()
 bool Steam_Utils::IsVRHeadsetStreamingEnabled()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -358,14 +349,14 @@ bool Steam_Utils::IsVRHeadsetStreamingEnabled()
 void Steam_Utils::SetVRHeadsetStreamingEnabled( bool bEnabled )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 // Returns whether this steam client is a Steam China specific client, vs the global client.
 bool Steam_Utils::IsSteamChinaLauncher()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -374,7 +365,7 @@ bool Steam_Utils::IsSteamChinaLauncher()
 bool Steam_Utils::InitFilterText()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -384,7 +375,7 @@ bool Steam_Utils::InitFilterText()
 bool Steam_Utils::InitFilterText( uint32 unFilterOptions )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -397,7 +388,7 @@ bool Steam_Utils::InitFilterText( uint32 unFilterOptions )
 int Steam_Utils::FilterText( char* pchOutFilteredText, uint32 nByteSizeOutFilteredText, const char * pchInputMessage, bool bLegalOnly )
 {
     PRINT_DEBUG("old");
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return FilterText(k_ETextFilteringContextUnknown, CSteamID(), pchInputMessage, pchOutFilteredText, nByteSizeOutFilteredText );
 }
 
@@ -411,7 +402,7 @@ int Steam_Utils::FilterText( char* pchOutFilteredText, uint32 nByteSizeOutFilter
 int Steam_Utils::FilterText( ETextFilteringContext eContext, CSteamID sourceSteamID, const char *pchInputMessage, char *pchOutFilteredText, uint32 nByteSizeOutFilteredText )
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     if (!nByteSizeOutFilteredText) return 0;
     unsigned len = static_cast<unsigned>(strlen(pchInputMessage));
     if (!len) return 0;
@@ -430,7 +421,7 @@ int Steam_Utils::FilterText( ETextFilteringContext eContext, CSteamID sourceStea
 ESteamIPv6ConnectivityState Steam_Utils::GetIPv6ConnectivityState( ESteamIPv6ConnectivityProtocol eProtocol )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return k_ESteamIPv6ConnectivityState_Unknown;
 }
 
@@ -438,7 +429,7 @@ ESteamIPv6ConnectivityState Steam_Utils::GetIPv6ConnectivityState( ESteamIPv6Con
 bool Steam_Utils::IsSteamRunningOnSteamDeck()
 {
     PRINT_DEBUG("%i", (int)settings->steam_deck);
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return settings->steam_deck;
 }
 
@@ -447,7 +438,7 @@ bool Steam_Utils::IsSteamRunningOnSteamDeck()
 bool Steam_Utils::ShowFloatingGamepadTextInput( EFloatingGamepadTextInputMode eKeyboardMode, int nTextFieldXPosition, int nTextFieldYPosition, int nTextFieldWidth, int nTextFieldHeight )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -455,19 +446,19 @@ bool Steam_Utils::ShowFloatingGamepadTextInput( EFloatingGamepadTextInputMode eK
 void Steam_Utils::SetGameLauncherMode( bool bLauncherMode )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 bool Steam_Utils::DismissFloatingGamepadTextInput()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
 
 bool Steam_Utils::DismissGamepadTextInput()
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return true;
 }
@@ -21,7 +21,7 @@
 void Steam_Video::GetVideoURL( AppId_t unVideoAppID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 
@@ -29,7 +29,7 @@ void Steam_Video::GetVideoURL( AppId_t unVideoAppID )
 bool Steam_Video::IsBroadcasting( int *pnNumViewers )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
 
@@ -39,12 +39,12 @@ STEAM_CALL_BACK( GetOPFSettingsResult_t )
 void Steam_Video::GetOPFSettings( AppId_t unVideoAppID )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 }
 
 bool Steam_Video::GetOPFStringForApp( AppId_t unVideoAppID, char *pchBuffer, int32 *pnBufferSize )
 {
     PRINT_DEBUG_TODO();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     return false;
 }
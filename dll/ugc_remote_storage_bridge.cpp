@@ -11,14 +11,14 @@ Ugc_Remote_Storage_Bridge::Ugc_Remote_Storage_Bridge(class Settings *settings)
 
 Ugc_Remote_Storage_Bridge::~Ugc_Remote_Storage_Bridge()
 {
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     steam_ugc_queries.clear();
 }
 
 void Ugc_Remote_Storage_Bridge::add_ugc_query_result(UGCHandle_t file_handle, PublishedFileId_t fileid, bool handle_of_primary_file)
 {
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     steam_ugc_queries[file_handle].mod_id = fileid;
     steam_ugc_queries[file_handle].is_primary_file = handle_of_primary_file;
@@ -26,14 +26,14 @@ void Ugc_Remote_Storage_Bridge::add_ugc_query_result(UGCHandle_t file_handle, Pu
 
 bool Ugc_Remote_Storage_Bridge::remove_ugc_query_result(UGCHandle_t file_handle)
 {
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     return !!steam_ugc_queries.erase(file_handle);
 }
 
 std::optional<Ugc_Remote_Storage_Bridge::QueryInfo> Ugc_Remote_Storage_Bridge::get_ugc_query_result(UGCHandle_t file_handle) const
 {
-    std::lock_guard lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     
     auto it = steam_ugc_queries.find(file_handle);
     if (steam_ugc_queries.end() == it) return std::nullopt;
@@ -5,78 +5,541 @@
 #include <iterator>
 #include <cwchar>
 #include <cstdarg>
+#include <cstring>
 #include <filesystem>
-#include <sstream>
 #include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <condition_variable>
 #include <stdio.h>
 
 #include "common_helpers/os_detector.h"
 
+#if defined(__WINDOWS__)
+	#define WIN32_LEAN_AND_MEAN
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// bytes buffered per thread, a thread that fills its ring writes it out itself
+#define DBG_LOG_RING_SIZE (64 * 1024)
+// how often the writer thread wakes up when no ring is getting full
+#define DBG_LOG_WRITE_INTERVAL_MS 50
+// lines shorter than this are formatted without any allocation
+#define DBG_LOG_LINE_STACK_SIZE 512
+
 
-void dbg_log::open()
-{
 #ifndef EMU_RELEASE_BUILD
-	if (!out_file && filepath.size()) {
+
+struct dbg_log_record {
+	// microseconds since the log was created
+	uint64_t stamp{};
+	uint32_t size{};
+	// dbg_log_trace::kind
+	uint32_t kind{};
+};
+
+// single producer (its thread) / single consumer (whoever holds drain_mtx)
+// owned by shared_state::rings, its thread only borrows it until it exits, the drain frees it once it is abandoned and empty
+struct dbg_log_ring {
+	// on their own cache lines, the producer and the consumer each write one of them
+	alignas(64) std::atomic<size_t> head{};
+	alignas(64) std::atomic<size_t> tail{};
+	// its thread exited, freed once it is empty
+	std::atomic<bool> abandoned{};
+	char data[DBG_LOG_RING_SIZE];
+};
+
+struct dbg_log_filter {
+	std::vector<std::string> include{};
+	std::vector<std::string> exclude{};
+};
+
+struct shared_state {
+	std::string filepath{};
+#if defined(__WINDOWS__)
+	// converted up front, flush_on_crash() can't allocate
+	std::wstring wide_filepath{};
+#endif
+	std::FILE *out_file{};
+	bool binary{};
+	// a binary log gets one header per run, even if it is closed and opened again
+	bool header_written{};
+	const std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+
+	// held by whoever empties the rings into the file
+	std::mutex drain_mtx{};
+	// set by start_writer() and cleared by close(), until then every line is written right away
+	std::atomic<bool> async{};
+
+	std::mutex rings_mtx{};
+	std::vector<dbg_log_ring *> rings{};
+
+	std::shared_ptr<const dbg_log_filter> filter{};
+
+	std::mutex sites_mtx{};
+	uint32_t last_site_id{};
+
+	std::thread writer{};
+	std::atomic<bool> stop{};
+	std::atomic<bool> wake{};
+	std::mutex wake_mtx{};
+	std::condition_variable wake_cv{};
+};
+
+struct dbg_log_thread_ring {
+	shared_state *state{};
+	dbg_log_ring *ring{};
+	// a thread_local destroyed after this one may still log, those lines are written right away
+	bool exited{};
+
+	~dbg_log_thread_ring()
+	{
+		// the ring may be freed as soon as it is marked, forget it first
+		dbg_log_ring *abandoned = ring;
+		ring = nullptr;
+		exited = true;
+		if (abandoned) abandoned->abandoned.store(true, std::memory_order_release);
+	}
+};
+
+static thread_local dbg_log_thread_ring thread_ring{};
+
+static uint64_t stamp_now(shared_state *state)
+{
+	auto elapsed = std::chrono::high_resolution_clock::now() - state->start_time;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+// must be called while holding drain_mtx
+static void open_file(shared_state *state)
+{
+	if (!state->out_file && state->filepath.size()) {
 
 		// https://en.cppreference.com/w/cpp/filesystem/path/u8path
-		const auto fsp = std::filesystem::u8path(filepath);
+		const auto fsp = std::filesystem::u8path(state->filepath);
 #if defined(__WINDOWS__)
-		out_file = _wfopen(fsp.c_str(), L"at");
+		state->out_file = _wfopen(fsp.c_str(), state->binary ? L"ab" : L"at");
 #else
-		out_file = std::fopen(fsp.c_str(), "a");
+		state->out_file = std::fopen(fsp.c_str(), state->binary ? "ab" : "a");
 #endif
 
+		if (state->out_file && state->binary && !state->header_written) {
+			std::fwrite(dbg_log_trace::magic, 1, sizeof(dbg_log_trace::magic), state->out_file);
+			std::fwrite(&dbg_log_trace::version, sizeof(dbg_log_trace::version), 1, state->out_file);
+			state->header_written = true;
+		}
+
+	}
+}
+
+// must be called while holding drain_mtx
+static void write_line(shared_state *state, uint8_t kind, uint64_t stamp, const char *str, size_t size)
+{
+	if (!state->out_file) return;
+
+	if (state->binary) {
+		uint32_t payload_size = (uint32_t)size;
+		std::fwrite(&kind, sizeof(kind), 1, state->out_file);
+		std::fwrite(&stamp, sizeof(stamp), 1, state->out_file);
+		std::fwrite(&payload_size, sizeof(payload_size), 1, state->out_file);
+		std::fwrite(str, 1, size, state->out_file);
+		return;
+	}
+
+	// a text log can't show trace records, nothing sends them there
+	if (kind != dbg_log_trace::KIND_TEXT) return;
+
+	std::fprintf(state->out_file, "[%llu ms, %llu us] ", (unsigned long long)(stamp / 1000), (unsigned long long)stamp);
+	std::fwrite(str, 1, size, state->out_file);
+	std::fputc('\n', state->out_file);
+}
+
+static void ring_copy_out(const dbg_log_ring *ring, size_t pos, void *to, size_t size)
+{
+	size_t start = pos % DBG_LOG_RING_SIZE;
+	size_t first = std::min(size, (size_t)DBG_LOG_RING_SIZE - start);
+	std::memcpy(to, ring->data + start, first);
+	std::memcpy((char *)to + first, ring->data, size - first);
+}
+
+static void ring_copy_in(dbg_log_ring *ring, size_t pos, const void *from, size_t size)
+{
+	size_t start = pos % DBG_LOG_RING_SIZE;
+	size_t first = std::min(size, (size_t)DBG_LOG_RING_SIZE - start);
+	std::memcpy(ring->data + start, from, first);
+	std::memcpy(ring->data, (const char *)from + first, size - first);
+}
+
+static size_t record_space(size_t size)
+{
+	return (sizeof(dbg_log_record) + size + 7) & ~(size_t)7;
+}
+
+// must be called while holding drain_mtx
+// the lines of all threads are merged by time, so the file reads like it did when every line was written right away
+static void drain_rings(shared_state *state)
+{
+	std::vector<dbg_log_ring *> rings{};
+	{
+		std::lock_guard lk(state->rings_mtx);
+		rings = state->rings;
+	}
+
+	struct line {
+		uint64_t stamp;
+		uint8_t kind;
+		std::string text;
+	};
+	std::vector<line> lines{};
+	std::vector<dbg_log_ring *> emptied{};
+	for (auto ring : rings) {
+		// read 'abandoned' first, its thread can't push anything after setting it
+		bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+		size_t head = ring->head.load(std::memory_order_acquire);
+		size_t tail = ring->tail.load(std::memory_order_relaxed);
+		while (tail != head) {
+			dbg_log_record record{};
+			ring_copy_out(ring, tail, &record, sizeof(record));
+			std::string text(record.size, '\0');
+			ring_copy_out(ring, tail + sizeof(record), text.data(), record.size);
+			lines.push_back({ record.stamp, (uint8_t)record.kind, std::move(text) });
+			tail += record_space(record.size);
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+		if (abandoned) emptied.push_back(ring);
+	}
+
+	if (emptied.size()) {
+		std::lock_guard lk(state->rings_mtx);
+		for (auto ring : emptied) {
+			state->rings.erase(std::remove(state->rings.begin(), state->rings.end(), ring), state->rings.end());
+			delete ring;
+		}
 	}
 
+	if (lines.empty()) return;
+
+	std::stable_sort(lines.begin(), lines.end(), [](const line &a, const line &b) { return a.stamp < b.stamp; });
+	open_file(state);
+	for (const auto &l : lines) {
+		write_line(state, l.kind, l.stamp, l.text.data(), l.text.size());
+	}
+
+	if (state->out_file) std::fflush(state->out_file);
+}
+
+#if defined(__WINDOWS__)
+typedef HANDLE crash_file;
+#else
+typedef int crash_file;
+#endif
+
+static void crash_write(crash_file file, const void *data, size_t size)
+{
+#if defined(__WINDOWS__)
+	DWORD written = 0;
+	WriteFile(file, data, (DWORD)size, &written, nullptr);
+#else
+	while (size) {
+		ssize_t written = ::write(file, data, size);
+		if (written <= 0) return;
+		data = (const char *)data + written;
+		size -= (size_t)written;
+	}
 #endif
+}
+
+// no snprintf() in a signal handler
+static size_t crash_format_number(char *to, uint64_t value)
+{
+	char digits[20];
+	size_t count = 0;
+	do {
+		digits[count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value);
+
+	for (size_t i = 0; i < count; ++i) to[i] = digits[count - 1 - i];
+	return count;
+}
+
+// must be called while holding drain_mtx, the records are written the way write_line() does but straight from the rings,
+// one ring after the other since sorting them would need memory
+static void crash_write_rings(shared_state *state, crash_file file)
+{
+	if (state->binary && !state->header_written) {
+		crash_write(file, dbg_log_trace::magic, sizeof(dbg_log_trace::magic));
+		crash_write(file, &dbg_log_trace::version, sizeof(dbg_log_trace::version));
+		state->header_written = true;
+	}
 
+	for (auto ring : state->rings) {
+		size_t head = ring->head.load(std::memory_order_acquire);
+		size_t tail = ring->tail.load(std::memory_order_relaxed);
+		while (tail != head) {
+			dbg_log_record record{};
+			ring_copy_out(ring, tail, &record, sizeof(record));
+			size_t start = (tail + sizeof(record)) % DBG_LOG_RING_SIZE;
+			size_t first = std::min((size_t)record.size, (size_t)DBG_LOG_RING_SIZE - start);
+			if (state->binary) {
+				uint8_t kind = (uint8_t)record.kind;
+				crash_write(file, &kind, sizeof(kind));
+				crash_write(file, &record.stamp, sizeof(record.stamp));
+				crash_write(file, &record.size, sizeof(record.size));
+			} else if (record.kind == dbg_log_trace::KIND_TEXT) {
+				char prefix[64];
+				size_t size = 0;
+				prefix[size++] = '[';
+				size += crash_format_number(prefix + size, record.stamp / 1000);
+				std::memcpy(prefix + size, " ms, ", 5);
+				size += 5;
+				size += crash_format_number(prefix + size, record.stamp);
+				std::memcpy(prefix + size, " us] ", 5);
+				size += 5;
+				crash_write(file, prefix, size);
+			}
+
+			if (state->binary || record.kind == dbg_log_trace::KIND_TEXT) {
+				crash_write(file, ring->data + start, first);
+				crash_write(file, ring->data, record.size - first);
+				if (!state->binary) crash_write(file, "\n", 1);
+			}
+
+			tail += record_space(record.size);
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+	}
+}
+
+static void writer_proc(shared_state *state)
+{
+	while (!state->stop.load(std::memory_order_relaxed)) {
+		{
+			std::unique_lock lk(state->wake_mtx);
+			state->wake_cv.wait_for(lk, std::chrono::milliseconds(DBG_LOG_WRITE_INTERVAL_MS), [state] {
+				return state->wake.load(std::memory_order_relaxed) || state->stop.load(std::memory_order_relaxed);
+			});
+			state->wake = false;
+		}
+
+		std::lock_guard lk(state->drain_mtx);
+		if (!state->async) break;
+		drain_rings(state);
+	}
 }
 
-void dbg_log::write_stamp()
+static dbg_log_ring *get_thread_ring(shared_state *state)
 {
-	auto elapsed = std::chrono::high_resolution_clock::now() - start_time;
-	auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-	auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	if (thread_ring.exited) return nullptr;
 
-	std::stringstream ss{};
-	ss << "[" << duration_ms << " ms, " << duration_us << " us] ";
-	auto ss_str = ss.str();
+	if (thread_ring.ring) {
+		// a second dbg_log in the same module, its lines are written right away
+		return thread_ring.state == state ? thread_ring.ring : nullptr;
+	}
+
+	auto ring = new dbg_log_ring();
+	{
+		std::lock_guard lk(state->rings_mtx);
+		state->rings.push_back(ring);
+	}
 
-	std::fprintf(out_file, "%s", ss_str.c_str());
+	thread_ring.state = state;
+	thread_ring.ring = ring;
+	return ring;
 }
 
-dbg_log::dbg_log(std::string_view path)
+#endif
+
+
+void dbg_log::push(uint8_t kind, const char *str, size_t size)
 {
-	
 #ifndef EMU_RELEASE_BUILD
-	filepath = path;
+	uint64_t stamp = stamp_now(state);
+	dbg_log_ring *ring = state->async ? get_thread_ring(state) : nullptr;
+	size_t space = record_space(size);
+	if (!ring || space > DBG_LOG_RING_SIZE / 2) {
+		// write what this thread buffered first, so its lines stay in order
+		std::lock_guard lk(state->drain_mtx);
+		drain_rings(state);
+		open_file(state);
+		write_line(state, kind, stamp, str, size);
+		if (state->out_file) std::fflush(state->out_file);
+		return;
+	}
+
+	size_t head = ring->head.load(std::memory_order_relaxed);
+	while (DBG_LOG_RING_SIZE - (head - ring->tail.load(std::memory_order_acquire)) < space) {
+		// the writer thread is behind, empty the rings here instead of waiting for it
+		std::lock_guard lk(state->drain_mtx);
+		drain_rings(state);
+	}
+
+	dbg_log_record record{};
+	record.stamp = stamp;
+	record.size = (uint32_t)size;
+	record.kind = kind;
+	ring_copy_in(ring, head, &record, sizeof(record));
+	ring_copy_in(ring, head + sizeof(record), str, size);
+	head += space;
+	ring->head.store(head, std::memory_order_release);
+
+	if (head - ring->tail.load(std::memory_order_relaxed) > DBG_LOG_RING_SIZE / 2 &&
+		!state->wake.load(std::memory_order_relaxed) && !state->wake.exchange(true)) {
+		state->wake_cv.notify_one();
+	}
+#endif
+}
+
+bool dbg_log::passes_filter(const char *function)
+{
+#ifndef EMU_RELEASE_BUILD
+	auto filter = std::atomic_load(&state->filter);
+	if (!filter || !function) return true;
+
+	// "Class" matches "Class::Func" and "Class::Func" matches "Class::Func(", both only at the start of a name
+	auto matches = [function](const std::string &entry) {
+		for (const char *found = std::strstr(function, entry.c_str()); found; found = std::strstr(found + 1, entry.c_str())) {
+			char before = found == function ? ' ' : found[-1];
+			char after = found[entry.size()];
+			if ((before == ' ' || before == '*' || before == '&' || before == ':') && (after == ':' || after == '(')) return true;
+		}
+
+		return false;
+	};
+
+	for (const auto &entry : filter->exclude) {
+		if (matches(entry)) return false;
+	}
+
+	if (filter->include.empty()) return true;
+	for (const auto &entry : filter->include) {
+		if (matches(entry)) return true;
+	}
+
+	return false;
+#else
+	return true;
+#endif
+}
+
+dbg_log::dbg_log(std::string_view path, bool binary)
+{
+
+#ifndef EMU_RELEASE_BUILD
+	// never freed, see close()
+	state = new shared_state();
+	state->filepath = path;
+#if defined(__WINDOWS__)
+	state->wide_filepath = std::filesystem::u8path(state->filepath).wstring();
+#endif
+	state->binary = binary;
+#endif
+
+}
+
+dbg_log::dbg_log(std::wstring_view path, bool binary)
+{
+
+#ifndef EMU_RELEASE_BUILD
+	state = new shared_state();
+	state->filepath = common_helpers::to_str(path);
+#if defined(__WINDOWS__)
+	state->wide_filepath = path;
+#endif
+	state->binary = binary;
 #endif
 
 }
 
-dbg_log::dbg_log(std::wstring_view path)
+uint32_t dbg_log::register_site(dbg_log_trace::site &site)
 {
-	
+
 #ifndef EMU_RELEASE_BUILD
-	filepath = common_helpers::to_str(path);
+	std::lock_guard lk(state->sites_mtx);
+	uint32_t id = site.id.load(std::memory_order_relaxed);
+	if (id) return id;
+
+	id = ++state->last_site_id;
+	size_t function_size = std::strlen(site.function);
+	dbg_log_trace::encoder format{};
+	format.put_value<uint32_t>(id);
+	format.put_value<uint32_t>((uint32_t)function_size);
+	format.put(site.function, function_size);
+	format.put(site.format, std::strlen(site.format));
+	// pushed before anyone can see the id, so the format always comes first in this thread's ring
+	push(dbg_log_trace::KIND_FORMAT, format.data(), format.size());
+
+	site.id.store(id, std::memory_order_release);
+	return id;
+#else
+	return 0;
 #endif
 
 }
 
+void dbg_log_trace::encoder::arg(const wchar_t *str)
+{
+	if (!str) str = L"(null)";
+	std::string utf8(common_helpers::to_str(std::wstring_view(str)));
+	put_string(utf8.c_str(), utf8.size());
+}
+
 dbg_log::~dbg_log()
 {
-	
+
 #ifndef EMU_RELEASE_BUILD
 	close();
 #endif
 
 }
 
+void dbg_log::set_level(level max_level)
+{
+	this->max_level = (int)max_level;
+}
+
+void dbg_log::set_filter(const std::string &filter)
+{
+
+#ifndef EMU_RELEASE_BUILD
+	auto rules = std::make_shared<dbg_log_filter>();
+	size_t start = 0;
+	while (start <= filter.size()) {
+		size_t end = filter.find(',', start);
+		if (end == std::string::npos) end = filter.size();
+
+		std::string entry(common_helpers::string_strip(filter.substr(start, end - start)));
+		if (entry.size() > 1 && entry[0] == '-') {
+			rules->exclude.push_back(std::string(common_helpers::string_strip(entry.substr(1))));
+		} else if (entry.size() && entry[0] != '-') {
+			rules->include.push_back(entry);
+		}
+
+		start = end + 1;
+	}
+
+	bool any = rules->include.size() || rules->exclude.size();
+	std::atomic_store(&state->filter, any ? std::shared_ptr<const dbg_log_filter>(rules) : std::shared_ptr<const dbg_log_filter>());
+	filtered = any;
+#endif
+
+}
+
 void dbg_log::write(const std::string &str)
 {
 
 #ifndef EMU_RELEASE_BUILD
-	write("%s", str.c_str());
+	push(dbg_log_trace::KIND_TEXT, str.c_str(), str.size());
 #endif
 
 }
@@ -85,7 +548,7 @@ void dbg_log::write(const std::wstring &str)
 {
 
 #ifndef EMU_RELEASE_BUILD
-	write("%s", str.c_str());
+	write(common_helpers::to_str(str));
 #endif
 
 }
@@ -94,40 +557,126 @@ void dbg_log::write(const char *fmt, ...)
 {
 
 #ifndef EMU_RELEASE_BUILD
-	std::lock_guard lk(f_mtx);
-	open();
-	if (out_file) {
-		write_stamp();
+	char line[DBG_LOG_LINE_STACK_SIZE];
+	std::va_list args;
+	va_start(args, fmt);
+	std::va_list args_copy;
+	va_copy(args_copy, args);
+	int size = std::vsnprintf(line, sizeof(line), fmt, args);
+	va_end(args);
+
+	if (size >= (int)sizeof(line)) {
+		std::string long_line((size_t)size + 1, '\0');
+		if (std::vsnprintf(long_line.data(), long_line.size(), fmt, args_copy) >= 0) {
+			push(dbg_log_trace::KIND_TEXT, long_line.c_str(), (size_t)size);
+		} else {
+			// what fit on the stack is still better than nothing
+			push(dbg_log_trace::KIND_TEXT, line, std::strlen(line));
+		}
+	} else if (size >= 0) {
+		push(dbg_log_trace::KIND_TEXT, line, (size_t)size);
+	} else {
+		// an encoding error, the line is kept so it's clear something was logged here
+		std::string placeholder(std::string("(unformattable log line) ") + fmt);
+		push(dbg_log_trace::KIND_TEXT, placeholder.c_str(), placeholder.size());
+	}
+
+	va_end(args_copy);
+#endif
+
+}
 
+void dbg_log::write(const wchar_t *fmt, ...)
+{
+
+#ifndef EMU_RELEASE_BUILD
+	// vswprintf() doesn't tell how long the output would be, grow until it fits
+	std::wstring line(DBG_LOG_LINE_STACK_SIZE, L'\0');
+	while (true) {
 		std::va_list args;
 		va_start(args, fmt);
-		std::vfprintf(out_file, fmt, args);
+		int size = std::vswprintf(line.data(), line.size(), fmt, args);
 		va_end(args);
 
-		std::fprintf(out_file, "\n");
-		std::fflush(out_file);
+		if (size >= 0) {
+			line.resize((size_t)size);
+			break;
+		}
+
+		if (line.size() >= 1024 * 1024) {
+			// an encoding error rather than a long line
+			line = std::wstring(L"(unformattable log line) ") + fmt;
+			break;
+		}
+
+		line.resize(line.size() * 2);
 	}
+
+	write(line);
 #endif
 
 }
 
-void dbg_log::write(const wchar_t *fmt, ...)
+void dbg_log::start_writer()
 {
 
 #ifndef EMU_RELEASE_BUILD
-	std::lock_guard lk(f_mtx);
-	open();
-	if (out_file) {
-		write_stamp();
+	std::lock_guard lk(state->drain_mtx);
+	if (state->async || state->writer.joinable()) return;
 
-		std::va_list args;
-		va_start(args, fmt);
-		std::vfwprintf(out_file, fmt, args);
-		va_end(args);
+	state->writer = std::thread(writer_proc, state);
+	state->async = true;
+#endif
+
+}
 
-		std::fprintf(out_file, "\n");
-		std::fflush(out_file);
+void dbg_log::flush()
+{
+
+#ifndef EMU_RELEASE_BUILD
+	std::lock_guard lk(state->drain_mtx);
+	drain_rings(state);
+#endif
+
+}
+
+void dbg_log::flush_on_crash()
+{
+
+#ifndef EMU_RELEASE_BUILD
+	// a crashing thread may have been interrupted while holding a lock, don't wait for it forever,
+	// without both locks the rings may be getting drained or freed right now and are left alone
+	bool locked = false;
+	for (int i = 0; i < 100 && !locked; ++i) {
+		locked = state->drain_mtx.try_lock();
+		if (!locked) std::this_thread::sleep_for(std::chrono::milliseconds(1));
 	}
+
+	if (!locked) return;
+	if (!state->rings_mtx.try_lock()) {
+		state->drain_mtx.unlock();
+		return;
+	}
+
+	// anything already written went through fflush(), the FILE has nothing buffered while drain_mtx is free
+	if (state->filepath.size()) {
+#if defined(__WINDOWS__)
+		HANDLE file = CreateFileW(state->wide_filepath.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file != INVALID_HANDLE_VALUE) {
+			crash_write_rings(state, file);
+			CloseHandle(file);
+		}
+#else
+		int file = ::open(state->filepath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+		if (file >= 0) {
+			crash_write_rings(state, file);
+			::close(file);
+		}
+#endif
+	}
+
+	state->rings_mtx.unlock();
+	state->drain_mtx.unlock();
 #endif
 
 }
@@ -136,12 +685,22 @@ void dbg_log::close()
 {
 
 #ifndef EMU_RELEASE_BUILD
-	std::lock_guard lk(f_mtx);
-	if (out_file) {
-		std::fprintf(out_file, "\nLog file closed\n\n");
-		std::fclose(out_file);
-		out_file = nullptr;
+	// the writer is stopped but never joined, this runs while the module is unloaded and on Windows
+	// a thread can't exit at that point, this is also why 'state' is never freed
+	state->stop = true;
+	state->wake_cv.notify_one();
+	{
+		std::lock_guard lk(state->drain_mtx);
+		state->async = false;
+		drain_rings(state);
+		if (state->out_file) {
+			if (!state->binary) std::fprintf(state->out_file, "\nLog file closed\n\n");
+			std::fclose(state->out_file);
+			state->out_file = nullptr;
+		}
 	}
+
+	if (state->writer.joinable()) state->writer.detach();
 #endif
 
 }
@@ -5,28 +5,79 @@
 #include <mutex>
 #include <cstdio>
 #include <chrono>
+#include <atomic>
 
+#include "dbg_log/dbg_log_trace.hpp"
+
+// once start_writer() is called, lines are formatted by the calling thread into its own ring buffer and written to disk
+// in batches by a background thread, so a log call never waits for the file or for another thread
+// call flush() before anything that may kill the process, a crash handler calls flush_on_crash() instead
 class dbg_log
 {
+public:
+    enum class level : int {
+        error,
+        warn,
+        info,
+        debug,
+        trace,
+    };
+
 private:
-    std::recursive_mutex f_mtx{};
-    std::string filepath{};
-    std::FILE *out_file{};
-    const std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    // shared with the writer thread, which may outlive this object when the module is unloaded
+    struct shared_state *state{};
+    std::atomic<int> max_level{ (int)level::trace };
+    // only look at the filter when one is set
+    std::atomic<bool> filtered{};
 
-    void open();
-    void write_stamp();
+    void push(uint8_t kind, const char *str, size_t size);
+    bool passes_filter(const char *function);
+    uint32_t register_site(dbg_log_trace::site &site);
 
 public:
-    dbg_log(std::string_view path);
-    dbg_log(std::wstring_view path);
+    // 'binary' writes a dbg_log_trace file instead of text, needed by trace()
+    dbg_log(std::string_view path, bool binary = false);
+    dbg_log(std::wstring_view path, bool binary = false);
     ~dbg_log();
 
+    // least important level still written, anything after it is dropped before it is formatted
+    void set_level(level max_level);
+    // comma separated list of subsystems ("Steam_Networking") or functions ("Networking::Run"),
+    // a '-' in front excludes one, without any included entry everything not excluded is written
+    void set_filter(const std::string &filter);
+
+    bool enabled(level lvl, const char *function)
+    {
+        return (int)lvl <= max_level.load(std::memory_order_relaxed) && (!filtered.load(std::memory_order_relaxed) || passes_filter(function));
+    }
+
     void write(const std::string &str);
     void write(const std::wstring &str);
 
     void write(const char* fmt, ...);
     void write(const wchar_t* fmt, ...);
 
+    // record a line without formatting it, only for binary logs
+    template<typename... Args>
+    void trace(dbg_log_trace::site &site, long long tid, Args... args)
+    {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (!id) id = register_site(site);
+
+        dbg_log_trace::encoder line{};
+        line.put_value<uint32_t>(id);
+        line.put_value<int64_t>(tid);
+        (line.arg(args), ...);
+        push(dbg_log_trace::KIND_LINE, line.data(), line.size());
+    }
+
+    // lines are written right away until this is called, it must not be called while the module is being loaded
+    // since the writer thread can't start at that point on Windows
+    void start_writer();
+    // write everything buffered so far
+    void flush();
+    // only for a crash handler, writes what the rings hold without allocating or sorting the lines,
+    // gives up if another thread is writing the log and doesn't let go of it
+    void flush_on_crash();
     void close();
 };
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <type_traits>
+
+// binary trace written instead of the text log when the emu is built with EMU_BINARY_TRACE (premake option --bintrace),
+// PRINT_DEBUG then only copies its arguments and tool_trace_decoder turns the file back into the usual text
+//
+// file:     magic, u32 version, then records until the next header (a new run appending to the same file)
+// record:   u8 kind, u64 microseconds since the log was created, u32 payload size, payload
+// KIND_TEXT:   the line as it is
+// KIND_FORMAT: u32 id, u32 size + function name, format string, sent once per PRINT_DEBUG call site
+// KIND_LINE:   u32 id of the format, i64 thread id, then one entry per argument:
+//              u8 type, then an i64/u64/double/u64 for ARG_INT/ARG_UINT/ARG_DOUBLE/ARG_POINTER
+//              or u32 size + utf-8 bytes for ARG_STRING
+// numbers are in the byte order of the machine that wrote the trace
+namespace dbg_log_trace
+{
+
+constexpr const char magic[8] = { 'E', 'M', 'U', 'T', 'R', 'A', 'C', 'E' };
+constexpr uint32_t version = 1;
+
+enum kind : uint8_t {
+    KIND_TEXT,
+    KIND_FORMAT,
+    KIND_LINE,
+};
+
+enum arg_type : uint8_t {
+    ARG_INT = 'i',
+    ARG_UINT = 'u',
+    ARG_DOUBLE = 'd',
+    ARG_STRING = 's',
+    ARG_POINTER = 'p',
+};
+
+// one per PRINT_DEBUG call site, 'id' is given on its first use
+struct site {
+    const char *format;
+    const char *function;
+    std::atomic<uint32_t> id{};
+};
+
+// builds a record payload, on the stack unless it gets big
+class encoder
+{
+private:
+    char stack[256];
+    std::string heap{};
+    char *buffer = stack;
+    size_t capacity = sizeof(stack);
+    size_t used = 0;
+
+    void grow(size_t needed)
+    {
+        heap.resize(needed > capacity * 2 ? needed : capacity * 2);
+        if (buffer == stack) std::memcpy(&heap[0], stack, used);
+        buffer = &heap[0];
+        capacity = heap.size();
+    }
+
+public:
+    encoder() = default;
+    encoder(const encoder &) = delete;
+    encoder &operator=(const encoder &) = delete;
+
+    void put(const void *data, size_t size)
+    {
+        if (used + size > capacity) grow(used + size);
+        std::memcpy(buffer + used, data, size);
+        used += size;
+    }
+
+    template<typename T>
+    void put_value(T value)
+    {
+        put(&value, sizeof(value));
+    }
+
+    void put_string(const char *str, size_t size)
+    {
+        put_value<uint8_t>(ARG_STRING);
+        put_value<uint32_t>((uint32_t)size);
+        put(str, size);
+    }
+
+    // converted to utf-8, defined in dbg_log.cpp
+    void arg(const wchar_t *str);
+    void arg(wchar_t *str) { arg((const wchar_t *)str); }
+
+    void arg(const char *str)
+    {
+        if (!str) str = "(null)";
+        put_string(str, std::strlen(str));
+    }
+
+    void arg(char *str) { arg((const char *)str); }
+
+    template<typename T>
+    void arg(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            put_value<uint8_t>(ARG_DOUBLE);
+            put_value<double>((double)value);
+        } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+            put_value<uint8_t>(ARG_POINTER);
+            put_value<uint64_t>((uint64_t)(uintptr_t)value);
+        } else if constexpr (std::is_enum_v<T>) {
+            arg((std::underlying_type_t<T>)value);
+        } else if constexpr (std::is_signed_v<T>) {
+            put_value<uint8_t>(ARG_INT);
+            put_value<int64_t>((int64_t)value);
+        } else {
+            put_value<uint8_t>(ARG_UINT);
+            put_value<uint64_t>((uint64_t)value);
+        }
+    }
+
+    const char *data() const { return buffer; }
+    size_t size() const { return used; }
+};
+
+}
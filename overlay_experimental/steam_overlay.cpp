@@ -330,7 +330,7 @@ void Steam_Overlay::load_audio()
 void Steam_Overlay::load_achievements_data()
 {
     PRINT_DEBUG_ENTRY();
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
 
     Steam_User_Stats* steamUserStats = get_steam_client()->steam_user_stats;
     uint32 achievements_num = steamUserStats->GetNumAchievements();
@@ -680,7 +680,7 @@ void Steam_Overlay::show_test_achievement()
 bool Steam_Overlay::is_friend_joinable(std::pair<const Friend, friend_window_state> &f)
 {
     PRINT_DEBUG("%" PRIu64 "", f.first.id());
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_Friends* steamFriends = get_steam_client()->steam_friends;
 
     if (std::string(steamFriends->get_friend_rich_presence_silent((uint64)f.first.id(), "connect")).length() > 0 ) {
@@ -701,7 +701,7 @@ bool Steam_Overlay::is_friend_joinable(std::pair<const Friend, friend_window_sta
 
 bool Steam_Overlay::got_lobby()
 {
-    std::lock_guard<std::recursive_mutex> lock(global_mutex);
+    Emu_Lock_Guard lock(global_mutex);
     Steam_Friends* steamFriends = get_steam_client()->steam_friends;
     if (std::string(steamFriends->get_friend_rich_presence_silent(settings->get_local_steam_id(), "connect")).length() > 0)
         return true;
@@ -2058,7 +2058,7 @@ void Steam_Overlay::AddAchievementNotification(const std::string &ach_name, nloh
         if (a.name == ach_name) {
             try {
                 // lock to prevent modifications to this json object
-                std::lock_guard<std::recursive_mutex> lock2(global_mutex);
+                Emu_Lock_Guard lock2(global_mutex);
 
                 a.achieved = ach.value("earned", false);
                 a.unlock_time = ach.value("earned_time", static_cast<uint32>(0));
@@ -140,6 +140,12 @@ newoption {
     default = os.date("%Y_%m_%d-%H_%M_%S"),
 }
 
+newoption {
+    category = 'build',
+    trigger = "bintrace",
+    description = "Make PRINT_DEBUG record a binary STEAM_LOG.bin in debug builds, decoded with tool_trace_decoder",
+}
+
 newoption {
     category = 'visual-includes',
     trigger = "incexamples",
@@ -181,6 +187,9 @@ end
 local common_emu_defines = { -- added to all filters, later defines will be appended
     "UTF_CPP_CPLUSPLUS=201703L", "CURL_STATICLIB", "CONTROLLER_SUPPORT", "EMU_BUILD_STRING=" .. _OPTIONS["emubuild"],
 }
+if _OPTIONS["bintrace"] then
+    table.insert(common_emu_defines, "EMU_BINARY_TRACE")
+end
 
 -- include dirs
 ---------
@@ -274,8 +283,8 @@ local deps_link = {
     lib_prefix .. "curl" .. static_postfix,
     "mbedcrypto"         .. static_postfix,
 }
--- add protobuf libs
-table_append(deps_link, {
+-- protobuf libs, also linked alone by the tools which only need net.proto
+local protobuf_link = {
     lib_prefix .. "protobuf-lite"                 .. static_postfix,
     "absl_bad_any_cast_impl"                      .. static_postfix,
     "absl_bad_optional_access"                    .. static_postfix,
@@ -365,7 +374,9 @@ table_append(deps_link, {
     "absl_vlog_config_internal"                   .. static_postfix,
     "utf8_range"                                  .. static_postfix,
     "utf8_validity"                               .. static_postfix,
-})
+}
+-- add protobuf libs
+table_append(deps_link, protobuf_link)
 
 local common_link_win = {
     -- os specific
@@ -1143,6 +1154,476 @@ project "tool_generate_interfaces"
 -- End tool_generate_interfaces
 
 
+-- Project tool_trace_decoder
+project "tool_trace_decoder"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/trace_decoder")
+    targetname "trace_decoder_%{cfg.platform}"
+
+
+    -- common source & header files
+    ---------
+    files {
+        "tools/trace_decoder/trace_decoder.cpp",
+        "helpers/dbg_log/dbg_log_trace.hpp",
+    }
+-- End tool_trace_decoder
+
+
+-- Project bench_ticket_signer
+project "bench_ticket_signer"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/benchmarks")
+    targetname "ticket_signer_bench_%{cfg.platform}"
+
+
+    -- defines
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    defines { -- added to all filters, later defines will be appended
+        "NO_DISK_WRITES",
+    }
+    removedefines {
+        "CONTROLLER_SUPPORT",
+    }
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files { -- added to all filters, later defines will be appended
+        common_files,
+        -- bench files
+        'tools/benchmarks/ticket_signer/ticket_signer_bench.cpp',
+    }
+    removefiles {
+        "libs/gamepad/**",
+        detours_files,
+    }
+
+
+    -- libs to link
+    ---------
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            common_link_win,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            common_link_linux,
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+-- End bench_ticket_signer
+
+
+-- Project bench_epoll_tick
+project "bench_epoll_tick"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/benchmarks")
+    targetname "epoll_tick_bench_%{cfg.platform}"
+
+
+    -- defines
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    defines { -- added to all filters, later defines will be appended
+        "NO_DISK_WRITES",
+    }
+    removedefines {
+        "CONTROLLER_SUPPORT",
+    }
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files { -- added to all filters, later defines will be appended
+        common_files,
+        -- bench files
+        'tools/benchmarks/epoll_tick/epoll_tick_bench.cpp',
+    }
+    removefiles {
+        "libs/gamepad/**",
+        detours_files,
+    }
+
+
+    -- libs to link
+    ---------
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            common_link_win,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            common_link_linux,
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+-- End bench_epoll_tick
+
+
+-- Project bench_tcp_framing
+project "bench_tcp_framing"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/benchmarks")
+    targetname "tcp_framing_bench_%{cfg.platform}"
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files {
+        "tools/benchmarks/tcp_framing/tcp_framing_bench.cpp",
+        'proto_gen/' .. os_iden .. '/**',
+    }
+
+
+    -- libs to link
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    links {
+        protobuf_link,
+    }
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            "Ws2_32" .. static_postfix,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            "pthread",
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+-- End bench_tcp_framing
+
+
+-- Project bench_udp_batch
+project "bench_udp_batch"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/benchmarks")
+    targetname "udp_batch_bench_%{cfg.platform}"
+
+
+    -- defines
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    defines { -- added to all filters, later defines will be appended
+        "NO_DISK_WRITES",
+    }
+    removedefines {
+        "CONTROLLER_SUPPORT",
+    }
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files { -- added to all filters, later defines will be appended
+        common_files,
+        -- bench files
+        'tools/benchmarks/udp_batch/udp_batch_bench.cpp',
+    }
+    removefiles {
+        "libs/gamepad/**",
+        detours_files,
+    }
+
+
+    -- libs to link
+    ---------
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            common_link_win,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            common_link_linux,
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+-- End bench_udp_batch
+
+
+-- Project bench_message_pool
+project "bench_message_pool"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tools/benchmarks")
+    targetname "message_pool_bench_%{cfg.platform}"
+
+
+    -- defines
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    defines { -- added to all filters, later defines will be appended
+        "NO_DISK_WRITES",
+    }
+    removedefines {
+        "CONTROLLER_SUPPORT",
+    }
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files { -- added to all filters, later defines will be appended
+        common_files,
+        -- bench files
+        'tools/benchmarks/message_pool/message_pool_bench.cpp',
+    }
+    removefiles {
+        "libs/gamepad/**",
+        detours_files,
+    }
+
+
+    -- libs to link
+    ---------
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            common_link_win,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            common_link_linux,
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+-- End bench_message_pool
+
+
+-- Project test_networking_sockets
+---------
+project "test_networking_sockets"
+    kind "ConsoleApp"
+    location "%{wks.location}/%{prj.name}"
+    targetdir("build/" .. os_iden .. "/%{_ACTION}/%{cfg.buildcfg}/tests/networking_sockets")
+    targetname "test_networking_sockets_%{cfg.platform}"
+
+
+    -- defines
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    defines { -- added to all filters, later defines will be appended
+        "NO_DISK_WRITES",
+    }
+    removedefines {
+        "CONTROLLER_SUPPORT",
+    }
+
+
+    -- include dir
+    ---------
+    -- x32 include dir
+    filter { "platforms:x32", }
+        includedirs {
+            x32_deps_include,
+        }
+    -- x64 include dir
+    filter { "platforms:x64", }
+        includedirs {
+            x64_deps_include,
+        }
+
+
+    -- common source & header files
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    files { -- added to all filters, later defines will be appended
+        common_files,
+        -- test files
+        'tests/test_networking_sockets.cpp',
+    }
+    removefiles {
+        "libs/gamepad/**",
+        detours_files,
+    }
+
+
+    -- libs to link
+    ---------
+    -- Windows libs to link
+    filter { "system:windows", }
+        links {
+            common_link_win,
+        }
+    -- Linux libs to link
+    filter { "system:not windows", }
+        links {
+            common_link_linux,
+        }
+
+
+    -- libs search dir
+    ---------
+    -- x32 libs search dir
+    filter { "platforms:x32", }
+        libdirs {
+            x32_deps_libdir,
+        }
+    -- x64 libs search dir
+    filter { "platforms:x64", }
+        libdirs {
+            x64_deps_libdir,
+        }
+
+
+    -- post build
+    ---------
+    filter {} -- reset the filter and remove all active keywords
+    postbuildcommands {
+        '%[%{!cfg.buildtarget.abspath}]',
+    }
+-- End test_networking_sockets
+
+
 -- Project lib_steamnetworkingsockets START
 project "lib_steamnetworkingsockets"
     kind "SharedLib"
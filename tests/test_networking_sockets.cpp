@@ -0,0 +1,196 @@
+#include "dll/steam_networking_sockets.h"
+
+#include <iostream>
+
+// a reliable message buffered behind a gap must reach the poll group once the gap times out,
+// even when no other packet arrives on the connection
+static bool test_gap_timeout_on_poll_group(Steam_Networking_Sockets *sockets)
+{
+    SteamNetworkingIdentity remote{};
+    remote.SetSteamID64(76561197960287930ULL);
+    HSteamNetConnection conn = sockets->ConnectP2P(remote, 0);
+    HSteamNetPollGroup group_a = sockets->CreatePollGroup();
+    HSteamNetPollGroup group_b = sockets->CreatePollGroup();
+    if (conn == k_HSteamNetConnection_Invalid || !sockets->SetConnectionPollGroup(conn, group_a)) {
+        std::cerr << "failed to create the connection" << std::endl;
+        return false;
+    }
+
+    {
+        // reliable message 2 arrived, 1 never did
+        auto sbcs = sockets->get_shared_between_client_server();
+        Emu_Lock_Guard lock(sbcs->mutex);
+        auto &connect_socket = sbcs->connect_sockets[conn];
+        connect_socket.status = CONNECT_SOCKET_CONNECTED;
+        connect_socket.reorder_ring.resize(256);
+        auto &slot = connect_socket.reorder_ring[2 % connect_socket.reorder_ring.size()];
+        slot.set_type(Networking_Sockets::DATA);
+        slot.set_reliable_number(2);
+        slot.set_data("after the gap");
+        connect_socket.reorder_count = 1;
+        connect_socket.gap_since = std::chrono::steady_clock::now() - std::chrono::minutes(1);
+    }
+
+    sockets->RunCallbacks();
+
+    // moving it away and back must not queue it twice in the first group
+    sockets->SetConnectionPollGroup(conn, group_b);
+    sockets->SetConnectionPollGroup(conn, group_a);
+
+    SteamNetworkingMessage_t *msgs[4]{};
+    int count = sockets->ReceiveMessagesOnPollGroup(group_a, msgs, 4);
+    if (count != 1 || msgs[0]->m_conn != conn || std::string((char *)msgs[0]->m_pData, msgs[0]->m_cbSize) != "after the gap") {
+        std::cerr << "expected the released message on the poll group, got " << count << std::endl;
+        return false;
+    }
+    msgs[0]->Release();
+
+    {
+        auto sbcs = sockets->get_shared_between_client_server();
+        Emu_Lock_Guard lock(sbcs->mutex);
+        if (sbcs->poll_groups[group_a].ready.size() || sbcs->poll_groups[group_b].ready.size()) {
+            std::cerr << "connection left in a ready list" << std::endl;
+            return false;
+        }
+    }
+
+    sockets->CloseConnection(conn, 0, nullptr, false);
+    sockets->DestroyPollGroup(group_a);
+    sockets->DestroyPollGroup(group_b);
+    return true;
+}
+
+// both ends of the connection live in one instance, what one of them sends loops back to the other
+// the sending end starts out pointed at a peer that isn't reachable, like before its TCP connection received anything
+static bool make_loopback(Steam_Networking_Sockets *sockets, CSteamID self, HSteamNetConnection &conn_a, HSteamNetConnection &conn_b)
+{
+    SteamNetworkingIdentity stranger{};
+    stranger.SetSteamID64(76561197960287932ULL);
+    conn_a = sockets->ConnectP2P(stranger, 0);
+    conn_b = sockets->ConnectP2P(stranger, 0);
+    if (conn_a == k_HSteamNetConnection_Invalid || conn_b == k_HSteamNetConnection_Invalid) {
+        std::cerr << "failed to create the connections" << std::endl;
+        return false;
+    }
+
+    SteamNetworkingIdentity own{};
+    own.SetSteamID(self);
+    auto sbcs = sockets->get_shared_between_client_server();
+    Emu_Lock_Guard lock(sbcs->mutex);
+    auto &a = sbcs->connect_sockets[conn_a];
+    auto &b = sbcs->connect_sockets[conn_b];
+    a.status = CONNECT_SOCKET_CONNECTED;
+    a.remote_id = conn_b;
+    b.status = CONNECT_SOCKET_CONNECTED;
+    b.remote_id = conn_a;
+    b.remote_identity = own;
+    return true;
+}
+
+static void make_reachable(Steam_Networking_Sockets *sockets, CSteamID self, HSteamNetConnection conn)
+{
+    auto sbcs = sockets->get_shared_between_client_server();
+    Emu_Lock_Guard lock(sbcs->mutex);
+    sbcs->connect_sockets[conn].remote_identity.SetSteamID(self);
+}
+
+static bool expect_only_message(Steam_Networking_Sockets *sockets, HSteamNetConnection conn, const std::string &expected)
+{
+    SteamNetworkingMessage_t *msgs[4]{};
+    int count = sockets->ReceiveMessagesOnConnection(conn, msgs, 4);
+    bool ok = count == 1 && std::string((char *)msgs[0]->m_pData, msgs[0]->m_cbSize) == expected;
+    if (!ok) std::cerr << "expected '" << expected << "' right away, got " << count << " messages" << std::endl;
+    for (int i = 0; i < count; ++i) msgs[i]->Release();
+    return ok;
+}
+
+// a reliable send that failed must not use up a reliable number, or the peer holds back
+// every later reliable message until the gap times out
+static bool test_failed_reliable_send(Steam_Networking_Sockets *sockets, Networking *network, CSteamID self)
+{
+    HSteamNetConnection conn_a{}, conn_b{};
+    if (!make_loopback(sockets, self, conn_a, conn_b)) return false;
+
+    const char lost[] = "lost";
+    if (sockets->SendMessageToConnection(conn_a, lost, sizeof(lost) - 1, k_nSteamNetworkingSend_Reliable | k_nSteamNetworkingSend_NoNagle, nullptr) != k_EResultFail) {
+        std::cerr << "expected the send to an unreachable peer to fail" << std::endl;
+        return false;
+    }
+
+    make_reachable(sockets, self, conn_a);
+    const char delivered[] = "after the failed send";
+    if (sockets->SendMessageToConnection(conn_a, delivered, sizeof(delivered) - 1, k_nSteamNetworkingSend_Reliable | k_nSteamNetworkingSend_NoNagle, nullptr) != k_EResultOK) {
+        std::cerr << "failed to send over the loopback" << std::endl;
+        return false;
+    }
+
+    network->Run();
+    sockets->RunCallbacks();
+    if (!expect_only_message(sockets, conn_b, delivered)) return false;
+
+    sockets->CloseConnection(conn_a, 0, nullptr, false);
+    sockets->CloseConnection(conn_b, 0, nullptr, false);
+    return true;
+}
+
+// messages held by the Nagle timer were already accepted, a flush that fails must keep them for the next one
+static bool test_failed_flush_keeps_queue(Steam_Networking_Sockets *sockets, Networking *network, CSteamID self)
+{
+    HSteamNetConnection conn_a{}, conn_b{};
+    if (!make_loopback(sockets, self, conn_a, conn_b)) return false;
+
+    const char queued[] = "queued";
+    if (sockets->SendMessageToConnection(conn_a, queued, sizeof(queued) - 1, k_nSteamNetworkingSend_Reliable, nullptr) != k_EResultOK) {
+        std::cerr << "failed to queue the message" << std::endl;
+        return false;
+    }
+
+    if (sockets->FlushMessagesOnConnection(conn_a) != k_EResultFail) {
+        std::cerr << "expected the flush to an unreachable peer to fail" << std::endl;
+        return false;
+    }
+
+    make_reachable(sockets, self, conn_a);
+    if (sockets->FlushMessagesOnConnection(conn_a) != k_EResultOK) {
+        std::cerr << "failed to flush over the loopback" << std::endl;
+        return false;
+    }
+
+    network->Run();
+    sockets->RunCallbacks();
+    if (!expect_only_message(sockets, conn_b, queued)) return false;
+
+    sockets->CloseConnection(conn_a, 0, nullptr, false);
+    sockets->CloseConnection(conn_b, 0, nullptr, false);
+    return true;
+}
+
+int main()
+{
+    CSteamID steam_id((uint64)76561197960287931ULL);
+    Settings settings(steam_id, CGameID(480), "test", "english", true);
+    Networking network(steam_id, 480, 47584, nullptr, true, false);
+    RunEveryRunCB run_every_runcb{};
+    SteamCallResults callback_results(run_every_runcb.get_timers());
+    SteamCallBacks callbacks(&callback_results);
+    Steam_Networking_Sockets sockets(&settings, &network, &callback_results, &callbacks, &run_every_runcb, nullptr);
+
+    if (!test_gap_timeout_on_poll_group(&sockets)) {
+        std::cerr << "Failed!" << std::endl;
+        return 1;
+    }
+
+    {
+        // sending needs a network with its sockets open, messages without NoNagle wait for the flush
+        settings.nagle_time_us = 1000000;
+        Networking live_network(steam_id, 480, 47585, nullptr, false);
+        Steam_Networking_Sockets live_sockets(&settings, &live_network, &callback_results, &callbacks, &run_every_runcb, nullptr);
+        if (!test_failed_reliable_send(&live_sockets, &live_network, steam_id) || !test_failed_flush_keeps_queue(&live_sockets, &live_network, steam_id)) {
+            std::cerr << "Failed!" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Success!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,258 @@
+// syscalls and time per Networking::Run() tick of a host as the number of peers grows, every peer is a real Networking
+// instance on loopback connected to the host (two TCP sockets per peer on the host like any Connection)
+// the host runs once with its epoll set and once without it (epoll_create1() failing), where Run() services every socket
+// the socket calls of the host's Run() are counted by wrapping them here, the peers are run outside of the measured part
+// usage: epoll_tick_bench [ticks]
+
+#include "dll/network.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <cstdarg>
+#include <dlfcn.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const unsigned peer_counts[] = { 1, 8, 32, 64 };
+// peers sending one message before a tick, the rest are idle
+static const unsigned active_counts[] = { 0, 4 };
+#define BENCH_HOST_PORT 47900
+#define BENCH_PEER_PORT 48000
+#define BENCH_APPID 480
+#define BENCH_HOST_ID 76561197960287930ULL
+// how long the peers get to announce themselves and open both TCP connections
+#define BENCH_CONNECT_SECONDS 10.0
+
+static bool counting = false;
+static bool fail_epoll_create = false;
+static unsigned long long syscalls = 0;
+
+template<typename Fn>
+static Fn next_symbol(Fn &fn, const char *name)
+{
+    if (!fn) fn = (Fn)dlsym(RTLD_NEXT, name);
+    if (counting) ++syscalls;
+    return fn;
+}
+
+extern "C" int epoll_create1(int flags) __THROW
+{
+    static int (*real)(int);
+    if (fail_epoll_create) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return next_symbol(real, "epoll_create1")(flags);
+}
+
+extern "C" int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    static int (*real)(int, struct epoll_event *, int, int);
+    return next_symbol(real, "epoll_wait")(epfd, events, maxevents, timeout);
+}
+
+extern "C" int ioctl(int fd, unsigned long request, ...) __THROW
+{
+    static int (*real)(int, unsigned long, ...);
+    va_list args;
+    va_start(args, request);
+    void *arg = va_arg(args, void *);
+    va_end(args);
+    return next_symbol(real, "ioctl")(fd, request, arg);
+}
+
+extern "C" int accept(int fd, struct sockaddr *addr, socklen_t *addr_len)
+{
+    static int (*real)(int, struct sockaddr *, socklen_t *);
+    return next_symbol(real, "accept")(fd, addr, addr_len);
+}
+
+extern "C" ssize_t recv(int fd, void *buf, size_t len, int flags)
+{
+    static ssize_t (*real)(int, void *, size_t, int);
+    return next_symbol(real, "recv")(fd, buf, len, flags);
+}
+
+extern "C" ssize_t recvfrom(int fd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addr_len)
+{
+    static ssize_t (*real)(int, void *, size_t, int, struct sockaddr *, socklen_t *);
+    return next_symbol(real, "recvfrom")(fd, buf, len, flags, addr, addr_len);
+}
+
+extern "C" int recvmmsg(int fd, struct mmsghdr *msgs, unsigned int count, int flags, struct timespec *timeout)
+{
+    static int (*real)(int, struct mmsghdr *, unsigned int, int, struct timespec *);
+    return next_symbol(real, "recvmmsg")(fd, msgs, count, flags, timeout);
+}
+
+extern "C" ssize_t send(int fd, const void *buf, size_t len, int flags)
+{
+    static ssize_t (*real)(int, const void *, size_t, int);
+    return next_symbol(real, "send")(fd, buf, len, flags);
+}
+
+extern "C" ssize_t sendto(int fd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addr_len)
+{
+    static ssize_t (*real)(int, const void *, size_t, int, const struct sockaddr *, socklen_t);
+    return next_symbol(real, "sendto")(fd, buf, len, flags, addr, addr_len);
+}
+
+extern "C" int sendmmsg(int fd, struct mmsghdr *msgs, unsigned int count, int flags)
+{
+    static int (*real)(int, struct mmsghdr *, unsigned int, int);
+    return next_symbol(real, "sendmmsg")(fd, msgs, count, flags);
+}
+
+extern "C" int getsockopt(int fd, int level, int name, void *value, socklen_t *len) __THROW
+{
+    static int (*real)(int, int, int, void *, socklen_t *);
+    return next_symbol(real, "getsockopt")(fd, level, name, value, len);
+}
+
+struct Mesh {
+    Networking *host{};
+    std::vector<Networking *> peers{};
+    std::vector<CSteamID> peer_ids{};
+};
+
+static void run_peers(Mesh &mesh)
+{
+    for (auto peer : mesh.peers) peer->Run();
+}
+
+static bool make_mesh(Mesh &mesh, unsigned peers, bool epoll)
+{
+    fail_epoll_create = !epoll;
+    mesh.host = new Networking(CSteamID((uint64)BENCH_HOST_ID), BENCH_APPID, BENCH_HOST_PORT, nullptr, false);
+    fail_epoll_create = false;
+
+    // the peers only announce themselves to the host
+    std::set<IP_PORT> host_address{};
+    IP_PORT ip_port{};
+    ip_port.ip = 0x7F000001;
+    ip_port.port = BENCH_HOST_PORT;
+    host_address.insert(ip_port);
+    for (unsigned i = 0; i < peers; ++i) {
+        CSteamID id((uint64)BENCH_HOST_ID + 1 + i);
+        mesh.peer_ids.push_back(id);
+        mesh.peers.push_back(new Networking(id, BENCH_APPID, BENCH_PEER_PORT, &host_address, false));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto connected = start;
+    bool all_known = false;
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < BENCH_CONNECT_SECONDS) {
+        mesh.host->Run();
+        run_peers(mesh);
+        usleep(1000);
+
+        if (!all_known) {
+            all_known = true;
+            for (auto &id : mesh.peer_ids) {
+                if (!mesh.host->getIP(id)) all_known = false;
+            }
+
+            connected = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - connected > std::chrono::milliseconds(500)) {
+            // both TCP connections of every peer had the time to come up
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void close_mesh(Mesh &mesh)
+{
+    for (auto peer : mesh.peers) delete peer;
+    delete mesh.host;
+    mesh = Mesh{};
+}
+
+struct Result {
+    double syscalls_per_tick;
+    double us_per_tick;
+};
+
+static Result run_ticks(Mesh &mesh, unsigned ticks, unsigned active)
+{
+    std::string payload(100, '\0');
+    unsigned long long start_syscalls = syscalls;
+    std::chrono::steady_clock::duration spent{};
+    for (unsigned t = 0; t < ticks; ++t) {
+        // the peers sending this tick
+        for (unsigned a = 0; a < active && a < mesh.peers.size(); ++a) {
+            unsigned peer = (t * active + a) % mesh.peers.size();
+            Common_Message msg{};
+            msg.set_source_id(mesh.peer_ids[peer].ConvertToUint64());
+            msg.set_dest_id((uint64)BENCH_HOST_ID);
+            msg.mutable_network()->set_data(payload);
+            mesh.peers[peer]->sendTo(&msg, true);
+        }
+
+        run_peers(mesh);
+        // let loopback deliver before the tick, so both modes see the same data
+        if (active) usleep(50);
+
+        auto start = std::chrono::steady_clock::now();
+        counting = true;
+        mesh.host->Run();
+        counting = false;
+        spent += std::chrono::steady_clock::now() - start;
+    }
+
+    return {
+        (double)(syscalls - start_syscalls) / ticks,
+        std::chrono::duration<double, std::micro>(spent).count() / ticks,
+    };
+}
+
+int main(int argc, char **argv)
+{
+    unsigned ticks = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 2000;
+    if (!ticks) ticks = 2000;
+
+    std::printf("%u ticks of the host, 2 TCP sockets per peer + UDP + listen socket\n", ticks);
+    std::printf("  peers active       polling: syscalls  us/tick        epoll: syscalls  us/tick\n");
+    for (unsigned peers : peer_counts) {
+        Result results[2][sizeof(active_counts) / sizeof(active_counts[0])]{};
+        for (int epoll = 0; epoll < 2; ++epoll) {
+            Mesh mesh{};
+            if (!make_mesh(mesh, peers, epoll)) {
+                std::fprintf(stderr, "%u peers did not connect to the host\n", peers);
+                return 1;
+            }
+
+            for (size_t a = 0; a < sizeof(active_counts) / sizeof(active_counts[0]); ++a) {
+                results[epoll][a] = run_ticks(mesh, ticks, active_counts[a]);
+            }
+
+            close_mesh(mesh);
+        }
+
+        for (size_t a = 0; a < sizeof(active_counts) / sizeof(active_counts[0]); ++a) {
+            std::printf("  %5u %6u %24.1f %8.2f %22.1f %8.2f\n", peers, active_counts[a],
+                results[0][a].syscalls_per_tick, results[0][a].us_per_tick, results[1][a].syscalls_per_tick, results[1][a].us_per_tick);
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::printf("the epoll backend of Networking::Run() only exists on Linux\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,225 @@
+// heap allocations and messages per second for ReceiveMessagesOnPollGroup() + Release() with many connections,
+// a copy of the old receive path (new header + malloc + memcpy of the payload for every message) against the pooled one
+// the allocations made while the messages are queued (the received protobufs) are counted apart, both paths pay them
+// usage: message_pool_bench [rounds]
+
+#include "dll/steam_networking_sockets.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+
+// the connections in the poll group and what each has waiting per round
+#define BENCH_CONNECTIONS 32
+#define BENCH_MESSAGES_PER_CONNECTION 16
+// a typical game state update, too big for the small string buffer, and one above MESSAGE_POOL_MAX_KEPT_PAYLOAD
+static const unsigned message_sizes[] = { 120, 4096 };
+
+static std::atomic<bool> counting{};
+static std::atomic<unsigned long long> allocations{};
+
+#if defined(__GLIBC__)
+
+// catches the operator new of libstdc++ and every plain malloc()
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_realloc(ptr, size);
+}
+
+#else
+
+void *operator new(size_t size)
+{
+    if (counting) ++allocations;
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+// same as get_steam_message_connection() before the pool
+static void free_copied_message_data(SteamNetworkingMessage_t *pMsg)
+{
+    free(pMsg->m_pData);
+    pMsg->m_pData = NULL;
+}
+
+static void delete_copied_message(SteamNetworkingMessage_t *pMsg)
+{
+    if (pMsg->m_pfnFreeData) pMsg->m_pfnFreeData(pMsg);
+    delete pMsg;
+}
+
+static SteamNetworkingMessage_t *get_copied_message(Connect_Socket &connect_socket, HSteamNetConnection hConn)
+{
+    if (connect_socket.data.empty()) return NULL;
+    SteamNetworkingMessage_t *pMsg = new SteamNetworkingMessage_t();
+    auto &front = connect_socket.data.front();
+    unsigned long size = static_cast<unsigned long>(front.data().size());
+    pMsg->m_pData = malloc(size);
+    pMsg->m_cbSize = size;
+    memcpy(pMsg->m_pData, front.data().data(), size);
+    pMsg->m_conn = hConn;
+    pMsg->m_identityPeer = connect_socket.remote_identity;
+    pMsg->m_nConnUserData = connect_socket.user_data;
+    pMsg->m_nMessageNumber = front.message_number();
+    pMsg->m_pfnFreeData = &free_copied_message_data;
+    pMsg->m_pfnRelease = &delete_copied_message;
+    pMsg->m_nChannel = 0;
+    connect_socket.data.pop_front();
+    return pMsg;
+}
+
+// same walk over the ready list as ReceiveMessagesOnPollGroup()
+static int receive_copied(shared_between_client_server *sbcs, HSteamNetPollGroup group, SteamNetworkingMessage_t **msgs, int max_messages)
+{
+    Emu_Lock_Guard lock(global_mutex);
+    Emu_Lock_Guard sockets_lock(sbcs->mutex);
+    auto &ready = sbcs->poll_groups[group].ready;
+    int messages = 0;
+    while (messages < max_messages && ready.size()) {
+        HSteamNetConnection c = ready.front();
+        ready.pop_front();
+        auto &connect_socket = sbcs->connect_sockets[c];
+        connect_socket.poll_ready = false;
+        if (SteamNetworkingMessage_t *msg = get_copied_message(connect_socket, c)) msgs[messages++] = msg;
+        if (connect_socket.data.size()) {
+            ready.push_back(c);
+            connect_socket.poll_ready = true;
+        }
+    }
+
+    return messages;
+}
+
+// queues a round of received messages on every connection, like push_received_data() does, not timed
+static void queue_round(shared_between_client_server *sbcs, HSteamNetPollGroup group, const std::vector<HSteamNetConnection> &conns, const std::string &payload)
+{
+    Emu_Lock_Guard lock(sbcs->mutex);
+    for (auto c : conns) {
+        auto &connect_socket = sbcs->connect_sockets[c];
+        for (unsigned i = 0; i < BENCH_MESSAGES_PER_CONNECTION; ++i) {
+            auto &message = connect_socket.data.emplace_back();
+            message.set_type(Networking_Sockets::DATA);
+            message.set_data(payload);
+        }
+
+        if (!connect_socket.poll_ready) {
+            sbcs->poll_groups[group].ready.push_back(c);
+            connect_socket.poll_ready = true;
+        }
+    }
+}
+
+struct Result {
+    double queue_allocations_per_message;
+    double allocations_per_message;
+    double messages_per_second;
+};
+
+template<typename Receive>
+static Result run_rounds(shared_between_client_server *sbcs, HSteamNetPollGroup group, const std::vector<HSteamNetConnection> &conns, unsigned rounds, unsigned message_size, Receive receive)
+{
+    std::string payload(message_size, 'x');
+    SteamNetworkingMessage_t *msgs[64];
+    unsigned long long received = 0;
+    unsigned long long queue_allocations = 0;
+    unsigned long long receive_allocations = 0;
+    std::chrono::steady_clock::duration spent{};
+    for (unsigned r = 0; r < rounds; ++r) {
+        unsigned long long start_allocations = allocations;
+        counting = true;
+        queue_round(sbcs, group, conns, payload);
+        counting = false;
+        queue_allocations += allocations - start_allocations;
+
+        start_allocations = allocations;
+        auto start = std::chrono::steady_clock::now();
+        counting = true;
+        int count;
+        while ((count = receive(msgs, 64)) > 0) {
+            for (int i = 0; i < count; ++i) msgs[i]->Release();
+            received += count;
+        }
+        counting = false;
+        spent += std::chrono::steady_clock::now() - start;
+        receive_allocations += allocations - start_allocations;
+    }
+
+    return {
+        received ? (double)queue_allocations / received : 0,
+        received ? (double)receive_allocations / received : 0,
+        received / std::chrono::duration<double>(spent).count(),
+    };
+}
+
+int main(int argc, char **argv)
+{
+    unsigned rounds = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 2000;
+    if (!rounds) rounds = 2000;
+
+    CSteamID steam_id((uint64)76561197960287931ULL);
+    Settings settings(steam_id, CGameID(480), "bench", "english", true);
+    Networking network(steam_id, 480, 47584, nullptr, true, false);
+    RunEveryRunCB run_every_runcb{};
+    SteamCallResults callback_results(run_every_runcb.get_timers());
+    SteamCallBacks callbacks(&callback_results);
+    Steam_Networking_Sockets sockets(&settings, &network, &callback_results, &callbacks, &run_every_runcb, nullptr);
+    auto sbcs = sockets.get_shared_between_client_server();
+
+    HSteamNetPollGroup group = sockets.CreatePollGroup();
+    std::vector<HSteamNetConnection> conns{};
+    for (unsigned i = 0; i < BENCH_CONNECTIONS; ++i) {
+        SteamNetworkingIdentity remote{};
+        remote.SetSteamID64(76561197960287932ULL + i);
+        HSteamNetConnection conn = sockets.ConnectP2P(remote, 0);
+        if (conn == k_HSteamNetConnection_Invalid || !sockets.SetConnectionPollGroup(conn, group)) {
+            std::fprintf(stderr, "failed to create the connections\n");
+            return 1;
+        }
+
+        Emu_Lock_Guard lock(sbcs->mutex);
+        sbcs->connect_sockets[conn].status = CONNECT_SOCKET_CONNECTED;
+        conns.push_back(conn);
+    }
+
+    std::printf("%u rounds of %u messages on each of %u connections, allocations per message\n", rounds, BENCH_MESSAGES_PER_CONNECTION, BENCH_CONNECTIONS);
+    std::printf("   size  queued          copied: received       msg/s          pooled: received       msg/s\n");
+    for (unsigned message_size : message_sizes) {
+        Result before = run_rounds(sbcs, group, conns, rounds, message_size, [&](SteamNetworkingMessage_t **msgs, int max) { return receive_copied(sbcs, group, msgs, max); });
+        Result after = run_rounds(sbcs, group, conns, rounds, message_size, [&](SteamNetworkingMessage_t **msgs, int max) { return sockets.ReceiveMessagesOnPollGroup(group, msgs, max); });
+
+        std::printf("  %5u %7.2f %25.2f %11.0f %25.2f %11.0f (x%.2f)\n", message_size, after.queue_allocations_per_message,
+            before.allocations_per_message, before.messages_per_second, after.allocations_per_message, after.messages_per_second,
+            after.messages_per_second / before.messages_per_second);
+    }
+
+    for (auto c : conns) sockets.CloseConnection(c, 0, nullptr, false);
+    sockets.DestroyPollGroup(group);
+    return 0;
+}
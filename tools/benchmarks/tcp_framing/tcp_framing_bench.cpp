@@ -0,0 +1,214 @@
+// pushes small lobby/networking messages through a loopback TCP pair with the framing of Networking
+// (u32 size + serialized Common_Message), once with the old std::vector buffers which erase() consumed
+// bytes from the front and once with TCP_Buffer
+// usage: tcp_framing_bench [messages]
+
+#include "dll/network.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(__WINDOWS__)
+    typedef int socklen_t;
+    #define close_socket closesocket
+#else
+    #include <netinet/tcp.h>
+    #define close_socket close
+#endif
+
+// messages queued per tick, the larger ones build a backlog once the socket buffers are full
+static const unsigned bursts[] = { 1, 100, 1000 };
+// small socket buffers so the sender backs up like it does on a slow peer
+#define BENCH_SOCKET_BUFFER (64 * 1024)
+
+// what TCP_Socket used before TCP_Buffer
+struct Vector_Buffer {
+    std::vector<char> storage{};
+
+    size_t size() const { return storage.size(); }
+    char *data() { return storage.data(); }
+
+    char *extend(size_t count)
+    {
+        size_t old_size = storage.size();
+        storage.resize(old_size + count);
+        return storage.data() + old_size;
+    }
+
+    void unextend(size_t count) { storage.resize(storage.size() - count); }
+    void consume(size_t count) { storage.erase(storage.begin(), storage.begin() + count); }
+};
+
+static bool set_nonblocking(sock_t sock)
+{
+#if defined(__WINDOWS__)
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    return fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+}
+
+static unsigned int pending_bytes(sock_t sock)
+{
+#if defined(__WINDOWS__)
+    u_long count = 0;
+    ioctlsocket(sock, FIONREAD, &count);
+#else
+    int count = 0;
+    ioctl(sock, FIONREAD, &count);
+#endif
+    return (unsigned int)count;
+}
+
+static bool make_pair(sock_t &sender, sock_t &receiver)
+{
+    sock_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, (struct sockaddr *)&addr, &addr_len) != 0) {
+        return false;
+    }
+
+    sender = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (connect(sender, (struct sockaddr *)&addr, sizeof(addr)) != 0) return false;
+    receiver = accept(listener, nullptr, nullptr);
+    close_socket(listener);
+
+    int buffer_size = BENCH_SOCKET_BUFFER;
+    int one = 1;
+    setsockopt(sender, SOL_SOCKET, SO_SNDBUF, (const char *)&buffer_size, sizeof(buffer_size));
+    setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, (const char *)&buffer_size, sizeof(buffer_size));
+    setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof(one));
+    return set_nonblocking(sender) && set_nonblocking(receiver);
+}
+
+// same steps as send_buffer_tcp()/send_tcp_pending()
+template<typename Buffer>
+static void send_frame(sock_t sock, Buffer &buffer, Common_Message &msg)
+{
+    uint32 size = static_cast<uint32>(msg.ByteSizeLong());
+    char *frame = buffer.extend(sizeof(uint32) + size);
+    memcpy(frame, &size, sizeof(size));
+    msg.SerializeToArray(frame + sizeof(uint32), size);
+
+    int len = send(sock, buffer.data(), static_cast<int>(buffer.size()), MSG_NOSIGNAL);
+    if (len > 0) buffer.consume(len);
+}
+
+template<typename Buffer>
+static void send_pending(sock_t sock, Buffer &buffer)
+{
+    if (!buffer.size()) return;
+    int len = send(sock, buffer.data(), static_cast<int>(buffer.size()), MSG_NOSIGNAL);
+    if (len > 0) buffer.consume(len);
+}
+
+// same steps as recv_tcp() then unbuffer_tcp() until no complete frame is left
+template<typename Buffer>
+static unsigned receive_frames(sock_t sock, Buffer &buffer, Common_Message &msg)
+{
+    unsigned int size = pending_bytes(sock);
+    if (size) {
+        char *dest = buffer.extend(size);
+        int len = recv(sock, dest, size, MSG_NOSIGNAL);
+        buffer.unextend(size - (len > 0 ? len : 0));
+    }
+
+    unsigned frames = 0;
+    while (buffer.size() >= sizeof(uint32)) {
+        uint32 length = 0;
+        memcpy(&length, buffer.data(), sizeof(length));
+        if (sizeof(length) + length > buffer.size()) break;
+        if (!msg.ParseFromArray(buffer.data() + sizeof(uint32), length)) return frames;
+        buffer.consume(sizeof(length) + length);
+        ++frames;
+    }
+
+    return frames;
+}
+
+static Common_Message make_message(unsigned i)
+{
+    Common_Message msg{};
+    msg.set_source_id(76561197960287930ULL);
+    msg.set_dest_id(76561197960287931ULL);
+    if (i % 2) {
+        auto lobby = new Lobby_Messages();
+        lobby->set_id(109775240917843968ULL);
+        lobby->set_type(Lobby_Messages::CHAT_MESSAGE);
+        lobby->set_bdata(std::string(48, 'c'));
+        msg.set_allocated_lobby_messages(lobby);
+    } else {
+        auto network = new Network_pb();
+        network->set_channel(i % 4);
+        network->set_type(Network_pb::DATA);
+        network->set_data(std::string(96, 'n'));
+        msg.set_allocated_network(network);
+    }
+
+    return msg;
+}
+
+template<typename Buffer>
+static double messages_per_second(const std::vector<Common_Message> &messages, unsigned burst)
+{
+    sock_t sender, receiver;
+    if (!make_pair(sender, receiver)) return -1;
+
+    Buffer send_buffer{}, recv_buffer{};
+    Common_Message parsed{};
+    size_t sent = 0, received = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (received < messages.size()) {
+        for (unsigned i = 0; i < burst && sent < messages.size(); ++i, ++sent) {
+            send_frame(sender, send_buffer, const_cast<Common_Message &>(messages[sent]));
+        }
+
+        send_pending(sender, send_buffer);
+        received += receive_frames(receiver, recv_buffer, parsed);
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    close_socket(sender);
+    close_socket(receiver);
+    return messages.size() / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+#if defined(__WINDOWS__)
+    WSADATA wsa_data{};
+    WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+    unsigned count = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 100000;
+    if (!count) count = 100000;
+
+    std::vector<Common_Message> messages{};
+    messages.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        messages.push_back(make_message(i));
+    }
+
+    std::printf("%u messages, %zu bytes each on average\n", count, (size_t)(messages[0].ByteSizeLong() + messages[1].ByteSizeLong()) / 2);
+    std::printf("  per tick     std::vector      TCP_Buffer\n");
+    for (unsigned burst : bursts) {
+        double before = messages_per_second<Vector_Buffer>(messages, burst);
+        double after = messages_per_second<TCP_Buffer>(messages, burst);
+        if (before < 0 || after < 0) {
+            std::fprintf(stderr, "failed to set up the loopback pair\n");
+            return 1;
+        }
+
+        std::printf("  %8u %10.0f msg/s %10.0f msg/s (x%.2f)\n", burst, before, after, after / before);
+    }
+
+    return 0;
+}
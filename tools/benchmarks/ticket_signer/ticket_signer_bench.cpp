@@ -0,0 +1,135 @@
+// measures app tickets signed per second, the way sign_auth_data() used to do it
+// (new entropy source + CTR-DRBG seed + PEM key parse for every ticket) against the real Ticket_Signer
+// (all of that done once), one sign() per ticket and sign_batch() for a batch of tickets under one lock
+// usage: ticket_signer_bench [tickets] [batch size]
+
+#include "dll/auth.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// same size as the app ticket key, so the parse and sign costs match
+#define BENCH_KEY_BITS 1024
+// a typical serialized ticket data layout
+#define BENCH_TICKET_SIZE 170
+#define BENCH_BATCH_SIZE 16
+
+static std::string make_key_pem()
+{
+    mbedtls_entropy_context entropy_ctx;
+    mbedtls_ctr_drbg_context ctr_drbg_ctx;
+    mbedtls_pk_context pk_ctx;
+    mbedtls_entropy_init(&entropy_ctx);
+    mbedtls_ctr_drbg_init(&ctr_drbg_ctx);
+    mbedtls_pk_init(&pk_ctx);
+
+    std::string pem(4096, '\0');
+    if (mbedtls_ctr_drbg_seed(&ctr_drbg_ctx, mbedtls_entropy_func, &entropy_ctx, nullptr, 0) != 0 ||
+        mbedtls_pk_setup(&pk_ctx, mbedtls_pk_info_from_type(MBEDTLS_PK_RSA)) != 0 ||
+        mbedtls_rsa_gen_key(mbedtls_pk_rsa(pk_ctx), mbedtls_ctr_drbg_random, &ctr_drbg_ctx, BENCH_KEY_BITS, 65537) != 0 ||
+        mbedtls_pk_write_key_pem(&pk_ctx, (unsigned char *)&pem[0], pem.size()) != 0) {
+        pem.clear();
+    } else {
+        pem.resize(pem.find('\0'));
+    }
+
+    mbedtls_pk_free(&pk_ctx);
+    mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
+    mbedtls_entropy_free(&entropy_ctx);
+    return pem;
+}
+
+static bool sign_with(mbedtls_pk_context *pk_ctx, mbedtls_ctr_drbg_context *ctr_drbg_ctx, const std::vector<uint8_t> &ticket, std::vector<uint8_t> &signature)
+{
+    uint8_t hash[20]{};
+    if (mbedtls_sha1(ticket.data(), ticket.size(), hash) != 0) return false;
+
+    signature.resize(mbedtls_pk_get_len(pk_ctx));
+    return mbedtls_rsa_pkcs1_sign(mbedtls_pk_rsa(*pk_ctx), mbedtls_ctr_drbg_random, ctr_drbg_ctx, MBEDTLS_MD_SHA1, sizeof(hash), hash, signature.data()) == 0;
+}
+
+// everything set up and torn down around each signature
+static bool sign_uncached(const std::string &pem, const std::vector<uint8_t> &ticket, std::vector<uint8_t> &signature)
+{
+    mbedtls_entropy_context entropy_ctx;
+    mbedtls_ctr_drbg_context ctr_drbg_ctx;
+    mbedtls_pk_context pk_ctx;
+    mbedtls_entropy_init(&entropy_ctx);
+    mbedtls_ctr_drbg_init(&ctr_drbg_ctx);
+    mbedtls_pk_init(&pk_ctx);
+
+    bool ok = mbedtls_ctr_drbg_seed(&ctr_drbg_ctx, mbedtls_entropy_func, &entropy_ctx, nullptr, 0) == 0 &&
+        mbedtls_pk_parse_key(&pk_ctx, (const unsigned char *)pem.c_str(), pem.size() + 1, nullptr, 0, mbedtls_ctr_drbg_random, &ctr_drbg_ctx) == 0 &&
+        sign_with(&pk_ctx, &ctr_drbg_ctx, ticket, signature);
+
+    mbedtls_pk_free(&pk_ctx);
+    mbedtls_ctr_drbg_free(&ctr_drbg_ctx);
+    mbedtls_entropy_free(&entropy_ctx);
+    return ok;
+}
+
+template<typename F>
+static double tickets_per_second(unsigned tickets, F sign_one)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < tickets; ++i) {
+        if (!sign_one()) return -1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return tickets / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned tickets = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 2000;
+    if (!tickets) tickets = 2000;
+    unsigned batch_size = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : BENCH_BATCH_SIZE;
+    if (!batch_size) batch_size = BENCH_BATCH_SIZE;
+    // whole batches only, so all three runs sign the same number of tickets
+    tickets = (tickets + batch_size - 1) / batch_size * batch_size;
+
+    std::string pem = make_key_pem();
+    if (pem.empty()) {
+        std::fprintf(stderr, "failed to generate the RSA key\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> ticket(BENCH_TICKET_SIZE, 0x5a);
+    std::vector<uint8_t> signature{};
+
+    double before = tickets_per_second(tickets, [&]{ return sign_uncached(pem, ticket, signature); });
+
+    // the first ticket parses the key and seeds the generator, keep that out of the timed runs
+    Ticket_Signer &signer = Ticket_Signer::instance();
+    if (signer.sign(ticket.data(), ticket.size()).size() != STEAM_APPTICKET_SIGLEN) {
+        std::fprintf(stderr, "failed to set up Ticket_Signer\n");
+        return 1;
+    }
+
+    double single = tickets_per_second(tickets, [&]{ return signer.sign(ticket.data(), ticket.size()).size() == STEAM_APPTICKET_SIGLEN; });
+
+    std::vector<std::pair<const uint8_t *, size_t>> batch(batch_size, std::make_pair(ticket.data(), ticket.size()));
+    double batched = tickets_per_second(tickets / batch_size, [&]{
+        auto signatures = signer.sign_batch(batch);
+        for (const auto &s : signatures) {
+            if (s.size() != STEAM_APPTICKET_SIGLEN) return false;
+        }
+        return signatures.size() == batch.size();
+    }) * batch_size;
+
+    if (before < 0 || single < 0 || batched < 0) {
+        std::fprintf(stderr, "signing failed\n");
+        return 1;
+    }
+
+    std::printf("%u tickets, %d bit key, batches of %u\n", tickets, BENCH_KEY_BITS, batch_size);
+    std::printf("  setup per ticket:       %10.1f tickets/s\n", before);
+    std::printf("  Ticket_Signer::sign():  %10.1f tickets/s (x%.2f)\n", single, single / before);
+    std::printf("  sign_batch():           %10.1f tickets/s (x%.2f)\n", batched, batched / before);
+    return 0;
+}
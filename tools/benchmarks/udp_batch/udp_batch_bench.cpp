@@ -0,0 +1,246 @@
+// datagram throughput over loopback for one tick of Networking with many peers, every peer is a real Networking
+// instance: the host fans an unreliable message out to every peer with sendToAll() (sendmmsg() batches of UDP_BATCH_SIZE),
+// every peer answers with one datagram and the host's Run() drains them (recvmmsg() batches)
+// the host also announces itself to every peer (send_broadcasts()) every BROADCAST_INTERVAL like it does in a game,
+// so those announces and their answers are spread over the ticks that fall in that time
+// the socket calls and heap allocations of the host are counted by wrapping them here, the peers run outside of the measured part
+// usage: udp_batch_bench [ticks]
+
+#include "dll/network.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const unsigned peer_counts[] = { 8, 32, 64 };
+#define BENCH_HOST_PORT 47900
+#define BENCH_PEER_PORT 48000
+#define BENCH_APPID 480
+#define BENCH_HOST_ID 76561197960287930ULL
+// a typical unreliable P2P packet
+#define BENCH_PAYLOAD_SIZE 200
+// how long the peers get to answer the announces and open their connections
+#define BENCH_CONNECT_SECONDS 10.0
+
+static bool counting = false;
+static unsigned long long syscalls = 0;
+static unsigned long long allocations = 0;
+
+#if defined(__GLIBC__)
+
+// catches the operator new of libstdc++ and every plain malloc()
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (counting) ++allocations;
+    return __libc_realloc(ptr, size);
+}
+
+#endif
+
+template<typename Fn>
+static Fn next_symbol(Fn &fn, const char *name)
+{
+    if (!fn) fn = (Fn)dlsym(RTLD_NEXT, name);
+    if (counting) ++syscalls;
+    return fn;
+}
+
+extern "C" int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    static int (*real)(int, struct epoll_event *, int, int);
+    return next_symbol(real, "epoll_wait")(epfd, events, maxevents, timeout);
+}
+
+extern "C" ssize_t recvfrom(int fd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addr_len)
+{
+    static ssize_t (*real)(int, void *, size_t, int, struct sockaddr *, socklen_t *);
+    return next_symbol(real, "recvfrom")(fd, buf, len, flags, addr, addr_len);
+}
+
+extern "C" int recvmmsg(int fd, struct mmsghdr *msgs, unsigned int count, int flags, struct timespec *timeout)
+{
+    static int (*real)(int, struct mmsghdr *, unsigned int, int, struct timespec *);
+    return next_symbol(real, "recvmmsg")(fd, msgs, count, flags, timeout);
+}
+
+extern "C" ssize_t sendto(int fd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addr_len)
+{
+    static ssize_t (*real)(int, const void *, size_t, int, const struct sockaddr *, socklen_t);
+    return next_symbol(real, "sendto")(fd, buf, len, flags, addr, addr_len);
+}
+
+extern "C" int sendmmsg(int fd, struct mmsghdr *msgs, unsigned int count, int flags)
+{
+    static int (*real)(int, struct mmsghdr *, unsigned int, int);
+    return next_symbol(real, "sendmmsg")(fd, msgs, count, flags);
+}
+
+struct Mesh {
+    Networking *host{};
+    std::vector<Networking *> peers{};
+    std::vector<CSteamID> peer_ids{};
+};
+
+static Common_Message make_message(CSteamID from, const std::string &payload)
+{
+    Common_Message msg{};
+    msg.set_source_id(from.ConvertToUint64());
+    msg.mutable_network()->set_data(payload);
+    return msg;
+}
+
+static bool make_mesh(Mesh &mesh, unsigned peers)
+{
+    // the host announces itself to every peer, like custom_broadcasts.txt listing them
+    std::set<IP_PORT> peer_addresses{};
+    for (unsigned i = 0; i < peers; ++i) {
+        CSteamID id((uint64)BENCH_HOST_ID + 1 + i);
+        mesh.peer_ids.push_back(id);
+        mesh.peers.push_back(new Networking(id, BENCH_APPID, BENCH_PEER_PORT + i, nullptr, false));
+
+        IP_PORT ip_port{};
+        ip_port.ip = 0x7F000001;
+        ip_port.port = BENCH_PEER_PORT + i;
+        peer_addresses.insert(ip_port);
+    }
+
+    mesh.host = new Networking(CSteamID((uint64)BENCH_HOST_ID), BENCH_APPID, BENCH_HOST_PORT, &peer_addresses, false);
+
+    // messages only take the UDP path once the other side answered a ping, the announces take care of it
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < BENCH_CONNECT_SECONDS) {
+        mesh.host->Run();
+        for (auto peer : mesh.peers) peer->Run();
+        usleep(1000);
+
+        bool all_known = true;
+        for (auto &id : mesh.peer_ids) {
+            if (!mesh.host->getIP(id)) all_known = false;
+        }
+
+        if (all_known && std::chrono::steady_clock::now() - start > std::chrono::milliseconds(500)) return true;
+    }
+
+    return false;
+}
+
+static void close_mesh(Mesh &mesh)
+{
+    for (auto peer : mesh.peers) delete peer;
+    delete mesh.host;
+    mesh = Mesh{};
+}
+
+// counts what the host receives, to check that the datagrams made it
+static unsigned long long delivered = 0;
+static void count_message(void *object, Common_Message *msg)
+{
+    ++delivered;
+}
+
+struct Result {
+    double datagrams_per_second;
+    double syscalls_per_tick;
+    double allocations_per_tick;
+    double delivered_per_tick;
+};
+
+static Result run_ticks(Mesh &mesh, unsigned ticks)
+{
+    std::string payload(BENCH_PAYLOAD_SIZE, '\0');
+    Common_Message from_host = make_message(CSteamID((uint64)BENCH_HOST_ID), payload);
+    std::vector<Common_Message> from_peers{};
+    for (auto &id : mesh.peer_ids) {
+        from_peers.push_back(make_message(id, payload));
+        from_peers.back().set_dest_id((uint64)BENCH_HOST_ID);
+    }
+
+    mesh.host->setCallback(CALLBACK_ID_NETWORKING, CSteamID((uint64)BENCH_HOST_ID), count_message, nullptr);
+    unsigned long long start_syscalls = syscalls;
+    unsigned long long start_allocations = allocations;
+    unsigned long long start_delivered = delivered;
+    std::chrono::steady_clock::duration spent{};
+    for (unsigned t = 0; t < ticks; ++t) {
+        auto start = std::chrono::steady_clock::now();
+        counting = true;
+        mesh.host->sendToAll(&from_host, false);
+        counting = false;
+        spent += std::chrono::steady_clock::now() - start;
+
+        // the peers drain what the host sent, then each of them answers with one datagram
+        for (size_t i = 0; i < mesh.peers.size(); ++i) {
+            mesh.peers[i]->Run();
+            mesh.peers[i]->sendTo(&from_peers[i], false);
+        }
+
+        start = std::chrono::steady_clock::now();
+        counting = true;
+        mesh.host->Run();
+        counting = false;
+        spent += std::chrono::steady_clock::now() - start;
+    }
+
+    mesh.host->rmCallback(CALLBACK_ID_NETWORKING, CSteamID((uint64)BENCH_HOST_ID), count_message, nullptr);
+    return {
+        (double)ticks * mesh.peers.size() * 2 / std::chrono::duration<double>(spent).count(),
+        (double)(syscalls - start_syscalls) / ticks,
+        (double)(allocations - start_allocations) / ticks,
+        (double)(delivered - start_delivered) / ticks,
+    };
+}
+
+int main(int argc, char **argv)
+{
+    unsigned ticks = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 2000;
+    if (!ticks) ticks = 2000;
+
+    std::printf("%u ticks, a %u byte datagram to and from every peer plus the periodic announces\n", ticks, BENCH_PAYLOAD_SIZE);
+    std::printf("  peers    dgram/s  syscalls/tick  allocations/tick  delivered/tick\n");
+    for (unsigned peers : peer_counts) {
+        Mesh mesh{};
+        if (!make_mesh(mesh, peers)) {
+            std::fprintf(stderr, "%u peers did not connect to the host\n", peers);
+            return 1;
+        }
+
+        Result result = run_ticks(mesh, ticks);
+        close_mesh(mesh);
+        std::printf("  %5u %10.0f %14.1f %17.1f %15.1f\n", peers,
+            result.datagrams_per_second, result.syscalls_per_tick, result.allocations_per_tick, result.delivered_per_tick);
+    }
+
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::printf("recvmmsg()/sendmmsg() batching of Networking only exists on Linux\n");
+    return 0;
+}
+
+#endif
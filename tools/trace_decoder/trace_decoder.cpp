@@ -0,0 +1,320 @@
+// turns the binary STEAM_LOG.bin written by EMU_BINARY_TRACE builds back into the text of STEAM_LOG.txt
+// usage: trace_decoder <STEAM_LOG.bin> [output.txt]
+
+#include "dbg_log/dbg_log_trace.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iterator>
+
+struct trace_format {
+    std::string function{};
+    std::string format{};
+};
+
+struct trace_arg {
+    uint8_t type{};
+    int64_t i{};
+    uint64_t u{};
+    double d{};
+    std::string s{};
+};
+
+struct trace_record {
+    uint8_t kind{};
+    uint64_t stamp{};
+    const char *payload{};
+    uint32_t size{};
+};
+
+class payload_reader {
+    const char *data;
+    size_t size;
+    size_t pos = 0;
+
+public:
+    payload_reader(const char *data, size_t size) : data(data), size(size) {}
+
+    bool done() const { return pos >= size; }
+
+    template<typename T>
+    bool read(T &value)
+    {
+        if (size - pos < sizeof(value)) return false;
+        std::memcpy(&value, data + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    bool read(std::string &str, size_t count)
+    {
+        if (size - pos < count) return false;
+        str.assign(data + pos, count);
+        pos += count;
+        return true;
+    }
+
+    std::string rest()
+    {
+        std::string str(data + pos, size - pos);
+        pos = size;
+        return str;
+    }
+};
+
+static bool read_args(payload_reader &reader, std::vector<trace_arg> &args)
+{
+    while (!reader.done()) {
+        trace_arg arg{};
+        if (!reader.read(arg.type)) return false;
+
+        switch (arg.type) {
+        case dbg_log_trace::ARG_INT: if (!reader.read(arg.i)) return false; arg.u = (uint64_t)arg.i; arg.d = (double)arg.i; break;
+        case dbg_log_trace::ARG_UINT:
+        case dbg_log_trace::ARG_POINTER: if (!reader.read(arg.u)) return false; arg.i = (int64_t)arg.u; arg.d = (double)arg.u; break;
+        case dbg_log_trace::ARG_DOUBLE: if (!reader.read(arg.d)) return false; break;
+        case dbg_log_trace::ARG_STRING: {
+            uint32_t size = 0;
+            if (!reader.read(size) || !reader.read(arg.s, size)) return false;
+            break;
+        }
+        default: return false;
+        }
+
+        args.push_back(std::move(arg));
+    }
+
+    return true;
+}
+
+template<typename T>
+static std::string format_one(const std::string &spec, T value)
+{
+    char buf[256];
+    int size = std::snprintf(buf, sizeof(buf), spec.c_str(), value);
+    if (size < 0) return std::string();
+    if ((size_t)size < sizeof(buf)) return std::string(buf, (size_t)size);
+
+    std::string big((size_t)size + 1, '\0');
+    std::snprintf(&big[0], big.size(), spec.c_str(), value);
+    big.resize((size_t)size);
+    return big;
+}
+
+// integers were widened to 64 bits when recorded, narrow them back like printf would have
+static uint64_t narrow(uint64_t value, const std::string &length)
+{
+    if (length == "hh") return value & 0xFF;
+    if (length == "h") return value & 0xFFFF;
+    if (length.empty()) return value & 0xFFFFFFFF;
+    return value;
+}
+
+static int64_t narrow_signed(int64_t value, const std::string &length)
+{
+    if (length == "hh") return (int8_t)value;
+    if (length == "h") return (int16_t)value;
+    if (length.empty()) return (int32_t)value;
+    return value;
+}
+
+// printf() with the recorded arguments, every conversion is redone with its own snprintf() call
+static std::string format_line(const std::string &format, const std::vector<trace_arg> &args)
+{
+    std::string out{};
+    size_t next_arg = 0;
+    auto take = [&]() -> const trace_arg * {
+        return next_arg < args.size() ? &args[next_arg++] : nullptr;
+    };
+
+    for (size_t i = 0; i < format.size(); ++i) {
+        if (format[i] != '%') {
+            out.push_back(format[i]);
+            continue;
+        }
+
+        if (i + 1 < format.size() && format[i + 1] == '%') {
+            out.push_back('%');
+            ++i;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion, a '*' takes its value from the arguments
+        std::string spec("%");
+        size_t j = i + 1;
+        while (j < format.size() && std::strchr("-+ #0", format[j])) spec.push_back(format[j++]);
+        for (int part = 0; part < 2; ++part) {
+            if (part == 1) {
+                if (j >= format.size() || format[j] != '.') break;
+                spec.push_back(format[j++]);
+            }
+
+            if (j < format.size() && format[j] == '*') {
+                auto arg = take();
+                spec += std::to_string(arg ? arg->i : 0);
+                ++j;
+            } else {
+                while (j < format.size() && format[j] >= '0' && format[j] <= '9') spec.push_back(format[j++]);
+            }
+        }
+
+        std::string length{};
+        while (j < format.size() && std::strchr("hlLqjztI0123456789", format[j])) length.push_back(format[j++]);
+        if (j >= format.size()) {
+            out += format.substr(i);
+            break;
+        }
+
+        char conversion = format[j];
+        i = j;
+        if (conversion == 'n') continue;
+
+        auto arg = take();
+        if (!arg) {
+            out += "(missing)";
+            continue;
+        }
+
+        switch (conversion) {
+        case 'd': case 'i':
+            out += format_one(spec + "lld", (long long)narrow_signed(arg->i, length));
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            out += format_one(spec + "ll" + conversion, (unsigned long long)narrow(arg->u, length));
+            break;
+        case 'c':
+            out += format_one(spec + "c", (int)arg->i);
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            out += format_one(spec + conversion, arg->d);
+            break;
+        case 's': case 'S':
+            out += format_one(spec + "s", arg->type == dbg_log_trace::ARG_STRING ? arg->s.c_str() : "(?)");
+            break;
+        case 'p':
+            out += format_one(spec + "p", (void *)(uintptr_t)arg->u);
+            break;
+        default:
+            out += spec + length + conversion;
+            break;
+        }
+    }
+
+    return out;
+}
+
+static std::vector<trace_record> read_records(const std::vector<char> &file, size_t &pos)
+{
+    std::vector<trace_record> records{};
+    constexpr size_t header_size = sizeof(dbg_log_trace::magic) + sizeof(uint32_t);
+    constexpr size_t record_size = sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t);
+    while (file.size() - pos >= record_size) {
+        // another run appended to the file
+        if (file.size() - pos >= header_size && std::memcmp(&file[pos], dbg_log_trace::magic, sizeof(dbg_log_trace::magic)) == 0) break;
+
+        trace_record record{};
+        std::memcpy(&record.kind, &file[pos], sizeof(record.kind));
+        std::memcpy(&record.stamp, &file[pos + 1], sizeof(record.stamp));
+        std::memcpy(&record.size, &file[pos + 9], sizeof(record.size));
+        if (file.size() - pos - record_size < record.size) {
+            std::fprintf(stderr, "truncated record at offset %zu\n", pos);
+            pos = file.size();
+            break;
+        }
+
+        record.payload = file.data() + pos + record_size;
+        records.push_back(record);
+        pos += record_size + record.size;
+    }
+
+    return records;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <STEAM_LOG.bin> [output.txt]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::fprintf(stderr, "failed to open '%s'\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::FILE *out = stdout;
+    if (argc > 2) {
+        out = std::fopen(argv[2], "w");
+        if (!out) {
+            std::fprintf(stderr, "failed to create '%s'\n", argv[2]);
+            return 1;
+        }
+    }
+
+    size_t pos = 0;
+    size_t bad = 0;
+    while (pos < file.size()) {
+        if (file.size() - pos < sizeof(dbg_log_trace::magic) + sizeof(uint32_t) ||
+            std::memcmp(&file[pos], dbg_log_trace::magic, sizeof(dbg_log_trace::magic)) != 0) {
+            std::fprintf(stderr, "not a trace file, or corrupted at offset %zu\n", pos);
+            break;
+        }
+
+        uint32_t version = 0;
+        std::memcpy(&version, &file[pos + sizeof(dbg_log_trace::magic)], sizeof(version));
+        pos += sizeof(dbg_log_trace::magic) + sizeof(version);
+        if (version != dbg_log_trace::version) {
+            std::fprintf(stderr, "unsupported trace version %u\n", version);
+            break;
+        }
+
+        // a run's formats may be written after the first lines using them, so they are all read first
+        auto records = read_records(file, pos);
+        std::map<uint32_t, trace_format> formats{};
+        for (const auto &record : records) {
+            if (record.kind != dbg_log_trace::KIND_FORMAT) continue;
+
+            payload_reader reader(record.payload, record.size);
+            uint32_t id = 0, function_size = 0;
+            trace_format format{};
+            if (reader.read(id) && reader.read(function_size) && reader.read(format.function, function_size)) {
+                format.format = reader.rest();
+                formats[id] = std::move(format);
+            }
+        }
+
+        for (const auto &record : records) {
+            std::string text{};
+            if (record.kind == dbg_log_trace::KIND_TEXT) {
+                text.assign(record.payload, record.size);
+            } else if (record.kind == dbg_log_trace::KIND_LINE) {
+                payload_reader reader(record.payload, record.size);
+                uint32_t id = 0;
+                int64_t tid = 0;
+                std::vector<trace_arg> args{};
+                auto format = formats.end();
+                if (!reader.read(id) || !reader.read(tid) || !read_args(reader, args) || (format = formats.find(id)) == formats.end()) {
+                    ++bad;
+                    continue;
+                }
+
+                text = "[tid " + std::to_string(tid) + "] " + format->second.function + " " + format_line(format->second.format, args);
+            } else {
+                continue;
+            }
+
+            std::fprintf(out, "[%llu ms, %llu us] %s\n", (unsigned long long)(record.stamp / 1000), (unsigned long long)record.stamp, text.c_str());
+        }
+    }
+
+    if (bad) std::fprintf(stderr, "%zu records could not be decoded\n", bad);
+    if (out != stdout) std::fclose(out);
+    return 0;
+}